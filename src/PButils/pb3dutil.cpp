@@ -5,6 +5,7 @@
 //   pb3dutil --list-clips  <file.glb>
 //   pb3dutil --dump-bones  <file.glb>
 //   pb3dutil --simplify-bones <file.glb> [--max-bones N] [--threshold F] [--output <file>]
+//   pb3dutil --pbm-info    <file.pbm>
 //   pb3dutil --help
 //
 // Commands:
@@ -13,6 +14,9 @@
 //   --dump-bones     Dump unified bone hierarchy and check bind-pose correctness
 //   --simplify-bones Analyse bone weight contributions and save a keep/remove list.
 //                    Output is auto-saved to <stem>_<N>bones.txt (or use --output <file>).
+//   --pbm-info       Validate a pre-processed model file written by PB3D::pb3dExportModel()
+//                    and print its meshes, textures, skeleton and clips.  The table's .pbm files
+//                    are written by running the game with --export-pbm.
 //
 // Options:
 //   --max-bones N    Maximum bones to keep (default: 1024, matching PB3D_MAX_BONES on Pi 5)
@@ -24,6 +28,7 @@
 // Attribution-NonCommercial 4.0 International License.
 
 #include "../3rdparty/cgltf.h"
+#include "../system/PB3DModelFile.h"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -516,6 +521,124 @@ static int cmdSimplifyBones(const char* path, int maxBones, float threshold, con
     return 0;
 }
 
+// ============================================================================
+// --pbm-info command
+// ============================================================================
+
+static int cmdPbmInfo(const char* path) {
+    std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+    if (!ifs) {
+        std::cerr << "Error: cannot open: " << path << "\n";
+        return 1;
+    }
+    std::vector<unsigned char> file((size_t)ifs.tellg());
+    ifs.seekg(0);
+    ifs.read((char*)file.data(), (std::streamsize)file.size());
+
+    const st3DFileHeader* header = pb3dFileGetHeader(file.data(), file.size());
+    if (!header) {
+        std::cerr << "Error: not a PB3D model file of version " << PB3D_MODEL_FILE_VERSION << ": " << path << "\n";
+        return 1;
+    }
+    const unsigned char* base = file.data();
+    const char* strings = (const char*)(base + header->stringOffset);
+    int problems = 0;
+
+    std::cout << "PB3D model file: " << path << "\n";
+    printSeparator();
+    std::cout << "  Size:      " << header->fileSize << " bytes\n"
+              << "  Flags:     " << ((header->flags & PB3D_MODEL_FLAG_STATIC) ? "STATIC " : "")
+                                 << ((header->flags & PB3D_MODEL_FLAG_SKELETON) ? "SKELETON " : "")
+                                 << ((header->flags & PB3D_MODEL_FLAG_BONE_LIST) ? "BONE_LIST" : "") << "\n"
+              << "  LODs:      " << header->lodLevels << " requested\n"
+              << "  Normalise: scale=" << header->normScale << " centre=(" << header->normCX << ", "
+                                 << header->normCY << ", " << header->normCZ << ")\n";
+
+    std::cout << "\n--- MESHES (" << header->meshCount << ") ---\n";
+    const st3DFileMesh* meshes = (const st3DFileMesh*)(base + header->meshOffset);
+    for (uint32_t mi = 0; mi < header->meshCount; mi++) {
+        const st3DFileMesh& m = meshes[mi];
+        uint64_t lodIndexTotal = 0;
+        for (uint32_t li = 0; li < m.lodCount && li < PB3D_MODEL_FILE_MAX_LODS; li++) lodIndexTotal += m.lodIndexCount[li];
+        bool ok = pb3dFileRangeOk(header, m.vertexOffset, (uint64_t)m.vertexCount * m.floatsPerVertex * sizeof(float))
+               && pb3dFileRangeOk(header, m.indexOffset, (uint64_t)m.indexCount * sizeof(uint32_t))
+               && m.lodCount >= 1 && m.lodCount <= PB3D_MODEL_FILE_MAX_LODS && lodIndexTotal == m.indexCount;
+        if (ok) {
+            const uint32_t* idx = (const uint32_t*)(base + m.indexOffset);
+            for (uint32_t ii = 0; ii < m.indexCount; ii++) {
+                if (idx[ii] >= m.vertexCount) { ok = false; break; }
+            }
+        }
+        if (!ok) problems++;
+        std::string lodText;
+        for (uint32_t li = 0; li < m.lodCount && li < PB3D_MODEL_FILE_MAX_LODS; li++) {
+            lodText += (li == 0 ? "" : "/") + std::to_string(m.lodIndexCount[li] / 3);
+        }
+        std::cout << "  [" << mi << "] v=" << m.vertexCount << " idx=" << m.indexCount << " tris/LOD=" << lodText
+                  << ((m.flags & PB3D_MESH_FLAG_SKINNED) ? " [SKINNED]" : " [STATIC]")
+                  << ((m.flags & PB3D_MESH_FLAG_BLEND) ? " [BLEND]" : " [OPAQUE]")
+                  << " alpha=" << m.materialBaseAlpha << " tex="
+                  << (m.textureIndex == PB3D_MODEL_FILE_NO_TEXTURE ? std::string("fallback") : std::to_string(m.textureIndex))
+                  << " bounds=(" << m.boundsMin[0] << ", " << m.boundsMin[1] << ", " << m.boundsMin[2] << ")-("
+                  << m.boundsMax[0] << ", " << m.boundsMax[1] << ", " << m.boundsMax[2] << ")"
+                  << (ok ? "" : "  --> BAD RANGE/INDEX") << "\n";
+    }
+
+    std::cout << "\n--- TEXTURES (" << header->textureCount << ") ---\n";
+    const st3DFileTexture* textures = (const st3DFileTexture*)(base + header->textureOffset);
+    for (uint32_t ti = 0; ti < header->textureCount; ti++) {
+        const st3DFileTexture& t = textures[ti];
+        bool ok = (uint64_t)t.pixelSize == (uint64_t)t.width * t.height * 4
+               && pb3dFileRangeOk(header, t.pixelOffset, t.pixelSize);
+        if (!ok) problems++;
+        std::cout << "  [" << ti << "] " << t.width << "x" << t.height << " RGBA8 (" << t.pixelSize << " bytes)"
+                  << (ok ? "" : "  --> BAD RANGE") << "\n";
+    }
+
+    std::cout << "\n--- SKELETON ---\n"
+              << "  Bones: " << header->boneCount << " (" << header->paletteBoneCount << " skinning)"
+              << "  Skins: " << header->skinCount << "\n";
+    if (header->paletteBoneCount > header->boneCount) problems++;
+    const st3DFileBone* bones = (const st3DFileBone*)(base + header->boneOffset);
+    for (uint32_t bi = 0; bi < header->boneCount; bi++) {
+        if ((uint64_t)bones[bi].nameOffset + bones[bi].nameLength > header->stringSize) problems++;
+    }
+
+    std::cout << "\n--- CLIPS (" << header->clipCount << ") ---\n";
+    const st3DFileClip* clips = (const st3DFileClip*)(base + header->clipOffset);
+    for (uint32_t ci = 0; ci < header->clipCount; ci++) {
+        const st3DFileClip& c = clips[ci];
+        bool ok = (uint64_t)c.nameOffset + c.nameLength <= header->stringSize
+               && pb3dFileRangeOk(header, c.channelOffset, (uint64_t)c.channelCount * sizeof(st3DFileChannel));
+        uint32_t keys = 0;
+        if (ok) {
+            const st3DFileChannel* channels = (const st3DFileChannel*)(base + c.channelOffset);
+            for (uint32_t chi = 0; chi < c.channelCount; chi++) {
+                const st3DFileChannel& ch = channels[chi];
+                if (!pb3dFileRangeOk(header, ch.timesOffset, (uint64_t)ch.keyCount * sizeof(float))
+                    || !pb3dFileRangeOk(header, ch.valuesOffset, (uint64_t)ch.keyCount * 4 * sizeof(float))
+                    || ch.boneIndex < 0 || (uint32_t)ch.boneIndex >= header->boneCount) {
+                    ok = false;
+                }
+                keys += ch.keyCount;
+            }
+        }
+        if (!ok) problems++;
+        std::string clipName = ok ? std::string(strings + c.nameOffset, c.nameLength) : "(bad name)";
+        std::cout << "  [" << ci << "] \"" << clipName << "\"  " << (int)(c.duration * 1000) << "ms  "
+                  << c.channelCount << " channels  " << keys << " keyframes"
+                  << (ok ? "" : "  --> BAD RANGE") << "\n";
+    }
+
+    printSeparator();
+    if (problems > 0) {
+        std::cout << problems << " problem(s) found - re-export the model\n";
+        return 1;
+    }
+    std::cout << "File OK\n";
+    return 0;
+}
+
 // ============================================================================
 // Help
 // ============================================================================
@@ -780,6 +903,7 @@ static void printHelp(const char* argv0) {
               << "  " << argv0 << " --list-clips  <file.glb>\n"
               << "  " << argv0 << " --dump-bones  <file.glb>\n"
               << "  " << argv0 << " --simplify-bones <file.glb> [--max-bones N] [--threshold F] [--output <file>]\n"
+              << "  " << argv0 << " --pbm-info    <file.pbm>\n"
               << "  " << argv0 << " --help\n\n"
               << "Commands:\n"
               << "  --info           Print full model info (meshes, materials, textures, bones, clips)\n"
@@ -790,8 +914,10 @@ static void printHelp(const char* argv0) {
               << "                   --max-bones N   Maximum bone count target (default: 1024)\n"
               << "                   --threshold F   Min normalised weight to keep bone (default: 0.01)\n"
               << "                   --output <file> Override the auto-generated output filename\n"
+              << "  --pbm-info       Validate a pre-processed .pbm model file and print its contents\n"
+              << "                   (.pbm files are written by running the game with --export-pbm)\n"
               << "  --help           Print this help message\n\n"
-              << "Supported formats: GLB (glTF 2.0 binary)\n";
+              << "Supported formats: GLB (glTF 2.0 binary), PBM (PB3D pre-processed model)\n";
 }
 
 // ============================================================================
@@ -869,6 +995,14 @@ int main(int argc, char* argv[]) {
         return cmdSimplifyBones(filePath, maxBones, threshold, outFile);
     }
 
+    if (cmd == "--pbm-info") {
+        if (argc < 3) {
+            std::cerr << "Error: --pbm-info requires a file path\n";
+            return 1;
+        }
+        return cmdPbmInfo(argv[2]);
+    }
+
     std::cerr << "Unknown command: " << cmd << "\n";
     printHelp(argv[0]);
     return 1;
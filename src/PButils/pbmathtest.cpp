@@ -0,0 +1,337 @@
+// pbmathtest — SIMD kernel self-test for RasPin Pinball
+//
+// Usage:
+//   pbmathtest [--verbose]
+//
+// Runs every NEON/SSE kernel in PB3DMath.h and PBSoundMath.h against its scalar reference on
+// fixed-seed random inputs and prints one PASS/FAIL line per kernel.  Returns a non-zero exit
+// code when any kernel is outside its tolerance, so it can gate a build.  Build it for the Pi
+// to check the NEON paths and for Windows/Linux to check the SSE paths.
+//
+// Options:
+//   --verbose   Print the first mismatching value of each failing kernel
+//   --help      Print this help message
+
+// Copyright (c) 2025 Jeffrey D. Bock, unless otherwise noted. Licensed under a Creative Commons
+// Attribution-NonCommercial 4.0 International License.
+
+#include "../system/PB3DMath.h"
+#include "../system/PBSoundMath.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+// Float kernels must match within this relative error (SIMD reorders and may fuse the adds)
+static const float MATH_TOLERANCE = 1e-5f;
+
+// 16-bit conversion may differ by one step on exact .5 ties (ARMv7 NEON rounds half away from zero)
+static const int SAMPLE_TOLERANCE = 1;
+
+static const int RANDOM_CASES = 2000;
+
+static bool g_verbose = false;
+static bool g_mismatchShown = false;   // --verbose prints one mismatch per kernel
+static int  g_failures = 0;
+static std::mt19937 g_rng(0x5EED1234u);
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static float randRange(float lo, float hi) {
+    return std::uniform_real_distribution<float>(lo, hi)(g_rng);
+}
+
+static void randQuat(float q[4]) {
+    float len = 0.0f;
+    do {
+        for (int i = 0; i < 4; i++) q[i] = randRange(-1.0f, 1.0f);
+        len = sqrtf(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+    } while (len < 0.1f);
+    for (int i = 0; i < 4; i++) q[i] /= len;
+}
+
+static void randMat4(float m[16]) {
+    for (int i = 0; i < 16; i++) m[i] = randRange(-2.0f, 2.0f);
+}
+
+// Random well-conditioned affine matrix (unit quaternion, scale 0.5-2, translation +/-10)
+static void randAffine(float m[16]) {
+    float t[3] = { randRange(-10.0f, 10.0f), randRange(-10.0f, 10.0f), randRange(-10.0f, 10.0f) };
+    float s[3] = { randRange(0.5f, 2.0f), randRange(0.5f, 2.0f), randRange(0.5f, 2.0f) };
+    float r[4];
+    randQuat(r);
+    pb3dMathMat4FromTRSScalar(t, r, s, m);
+}
+
+// Largest relative error of 'got' against 'want'; with --verbose, shows the first value over tolerance
+static float compareFloats(const char* label, const float* got, const float* want, int count) {
+    float worst = 0.0f;
+    for (int i = 0; i < count; i++) {
+        float err = fabsf(got[i] - want[i]) / std::max(1.0f, fabsf(want[i]));
+        if (!(err <= worst)) worst = err;   // also catches NaN
+        if (g_verbose && !g_mismatchShown && !(err <= MATH_TOLERANCE)) {
+            std::cout << "    " << label << "[" << i << "]: got " << got[i] << ", expected " << want[i] << "\n";
+            g_mismatchShown = true;
+        }
+    }
+    return worst;
+}
+
+static void report(const char* name, float worstError, int cases, bool ok) {
+    std::cout << (ok ? "PASS  " : "FAIL  ") << std::left << std::setw(34) << name << std::right
+              << " max err " << std::scientific << std::setprecision(2) << worstError << std::defaultfloat
+              << "  (" << cases << " cases)\n";
+    if (!ok) g_failures++;
+    g_mismatchShown = false;
+}
+
+static void reportFloatTest(const char* name, float worstError, int cases) {
+    report(name, worstError, cases, worstError <= MATH_TOLERANCE);
+}
+
+// ============================================================================
+// PB3DMath kernels
+// ============================================================================
+
+static void testMat4Mul() {
+    float worst = 0.0f;
+    for (int c = 0; c < RANDOM_CASES; c++) {
+        float a[16], b[16], want[16], got[16];
+        randMat4(a);
+        randMat4(b);
+        pb3dMathMat4MulScalar(a, b, want);
+        pb3dMathMat4Mul(a, b, got);
+        worst = std::max(worst, compareFloats("Mat4Mul", got, want, 16));
+    }
+    reportFloatTest("Mat4Mul", worst, RANDOM_CASES);
+}
+
+static void testMat4MulAliased() {
+    float worst = 0.0f;
+    for (int c = 0; c < RANDOM_CASES; c++) {
+        float a[16], b[16], want[16], outA[16], outB[16], outAB[16];
+        randMat4(a);
+        randMat4(b);
+        pb3dMathMat4MulScalar(a, b, want);
+
+        // out == a
+        memcpy(outA, a, sizeof(outA));
+        pb3dMathMat4Mul(outA, b, outA);
+        worst = std::max(worst, compareFloats("Mat4Mul out=a", outA, want, 16));
+
+        // out == b
+        memcpy(outB, b, sizeof(outB));
+        pb3dMathMat4Mul(a, outB, outB);
+        worst = std::max(worst, compareFloats("Mat4Mul out=b", outB, want, 16));
+
+        // out == a == b (squaring in place)
+        float square[16];
+        pb3dMathMat4MulScalar(a, a, square);
+        memcpy(outAB, a, sizeof(outAB));
+        pb3dMathMat4Mul(outAB, outAB, outAB);
+        worst = std::max(worst, compareFloats("Mat4Mul out=a=b", outAB, square, 16));
+    }
+    reportFloatTest("Mat4Mul (aliased output)", worst, RANDOM_CASES * 3);
+}
+
+static void testMat4MulBatch() {
+    const int count = 64;
+    std::vector<float> a(count * 16), b(count * 16), want(count * 16), got(count * 16);
+    for (int i = 0; i < count; i++) {
+        randMat4(&a[i * 16]);
+        randMat4(&b[i * 16]);
+        pb3dMathMat4MulScalar(&a[i * 16], &b[i * 16], &want[i * 16]);
+    }
+    pb3dMathMat4MulBatch(a.data(), b.data(), got.data(), count);
+    reportFloatTest("Mat4MulBatch", compareFloats("Mat4MulBatch", got.data(), want.data(), count * 16), count);
+}
+
+static void testMat4FromTRS() {
+    float worst = 0.0f;
+    for (int c = 0; c < RANDOM_CASES; c++) {
+        float t[3] = { randRange(-10.0f, 10.0f), randRange(-10.0f, 10.0f), randRange(-10.0f, 10.0f) };
+        float s[3] = { randRange(-2.0f, 2.0f), randRange(-2.0f, 2.0f), randRange(-2.0f, 2.0f) };
+        float r[4], want[16], got[16];
+        randQuat(r);
+        pb3dMathMat4FromTRSScalar(t, r, s, want);
+        pb3dMathMat4FromTRS(t, r, s, got);
+        worst = std::max(worst, compareFloats("Mat4FromTRS", got, want, 16));
+    }
+    reportFloatTest("Mat4FromTRS", worst, RANDOM_CASES);
+}
+
+static void testMat4InvertAffine() {
+    float worst = 0.0f;
+    bool resultsMatch = true;
+    for (int c = 0; c < RANDOM_CASES; c++) {
+        float m[16], want[16], got[16];
+        randAffine(m);
+        bool okWant = pb3dMathMat4InvertAffineScalar(m, want);
+        bool okGot  = pb3dMathMat4InvertAffine(m, got);
+        if (okWant != okGot) { resultsMatch = false; continue; }
+        if (okWant) worst = std::max(worst, compareFloats("Mat4InvertAffine", got, want, 16));
+    }
+
+    // A singular matrix (zero scale on one axis) must be rejected by both
+    float t[3] = { 1.0f, 2.0f, 3.0f }, s[3] = { 1.0f, 0.0f, 1.0f }, r[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    float singular[16], out[16];
+    pb3dMathMat4FromTRSScalar(t, r, s, singular);
+    if (pb3dMathMat4InvertAffineScalar(singular, out) || pb3dMathMat4InvertAffine(singular, out)) resultsMatch = false;
+
+    if (!resultsMatch && g_verbose && !g_mismatchShown) std::cout << "    Mat4InvertAffine: singular / non-singular result differs from scalar\n";
+    report("Mat4InvertAffine", worst, RANDOM_CASES + 1, resultsMatch && worst <= MATH_TOLERANCE);
+}
+
+// Pairs of unit quaternions whose dot product is positive, negative, or nearly parallel
+enum quatPairKind { QUAT_PAIR_POSITIVE, QUAT_PAIR_NEGATIVE, QUAT_PAIR_NEAR_PARALLEL };
+
+static void randQuatPair(quatPairKind kind, float qa[4], float qb[4]) {
+    randQuat(qa);
+    if (kind == QUAT_PAIR_NEAR_PARALLEL) {
+        // Tiny perturbation keeps |dot| above the 0.9995 slerp cut-off; flip half of them to cover -q too
+        for (int i = 0; i < 4; i++) qb[i] = qa[i] + randRange(-0.01f, 0.01f);
+        float len = sqrtf(qb[0]*qb[0] + qb[1]*qb[1] + qb[2]*qb[2] + qb[3]*qb[3]);
+        float sign = (g_rng() & 1) ? -1.0f : 1.0f;
+        for (int i = 0; i < 4; i++) qb[i] = sign * qb[i] / len;
+        return;
+    }
+    float dot;
+    do {
+        randQuat(qb);
+        dot = qa[0]*qb[0] + qa[1]*qb[1] + qa[2]*qb[2] + qa[3]*qb[3];
+    } while (fabsf(dot) > 0.99f || (kind == QUAT_PAIR_POSITIVE) != (dot > 0.0f));
+}
+
+static void testQuatInterp(const char* name, bool slerp, quatPairKind kind) {
+    float worst = 0.0f;
+    for (int c = 0; c < RANDOM_CASES; c++) {
+        float qa[4], qb[4], want[4], got[4];
+        randQuatPair(kind, qa, qb);
+        float t = randRange(0.0f, 1.0f);
+        if (slerp) {
+            pb3dMathQuatSlerpScalar(qa, qb, t, want);
+            pb3dMathQuatSlerp(qa, qb, t, got);
+        } else {
+            pb3dMathQuatNlerpScalar(qa, qb, t, want);
+            pb3dMathQuatNlerp(qa, qb, t, got);
+        }
+        worst = std::max(worst, compareFloats(name, got, want, 4));
+    }
+    reportFloatTest(name, worst, RANDOM_CASES);
+}
+
+static void testConcatHierarchy() {
+    // Random tree, parents always listed before children, several roots
+    const int count = 128;
+    std::vector<int> order(count), parents(count);
+    for (int i = 0; i < count; i++) {
+        order[i] = (i * 37) % count;   // bone indices need not follow the walk order
+        parents[i] = (i < 3) ? -1 : order[g_rng() % i];
+    }
+    std::vector<float> local(count * 16), want(count * 16), got(count * 16);
+    for (int i = 0; i < count; i++) randAffine(&local[i * 16]);
+
+    pb3dMathConcatHierarchyScalar(order.data(), parents.data(), count, local.data(), want.data());
+    pb3dMathConcatHierarchy(order.data(), parents.data(), count, local.data(), got.data());
+
+    // Errors compound down the chains, so compare against the magnitude of each matrix
+    float worst = 0.0f;
+    for (int i = 0; i < count * 16; i += 16) {
+        float scale = 1.0f;
+        for (int j = 0; j < 16; j++) scale = std::max(scale, fabsf(want[i + j]));
+        for (int j = 0; j < 16; j++) worst = std::max(worst, fabsf(got[i + j] - want[i + j]) / scale);
+    }
+    if (g_verbose && !(worst <= MATH_TOLERANCE)) compareFloats("ConcatHierarchy", got.data(), want.data(), count * 16);
+    reportFloatTest("ConcatHierarchy", worst, count);
+}
+
+// ============================================================================
+// PBSoundMath kernels
+// ============================================================================
+
+static void testFloatToS16() {
+    // Odd length exercises the scalar tail; the range includes clipped samples and exact .5 ties
+    const int count = 4096 + 5;
+    std::vector<float> in(count);
+    std::vector<int16_t> want(count), got(count);
+    for (int i = 0; i < count; i++) in[i] = randRange(-1.25f, 1.25f);
+    for (int i = 0; i < 64; i++) in[i] = ((float)(i - 32) + 0.5f) / 32767.0f;
+
+    int worst = 0;
+    const float gains[] = { 1.0f, 0.8f, 0.0f };
+    for (float gain : gains) {
+        pbsMathFloatToS16Scalar(in.data(), want.data(), count, gain);
+        pbsMathFloatToS16(in.data(), got.data(), count, gain);
+        for (int i = 0; i < count; i++) {
+            int diff = abs((int)got[i] - (int)want[i]);
+            if (g_verbose && !g_mismatchShown && diff > SAMPLE_TOLERANCE) {
+                std::cout << "    FloatToS16 gain " << gain << " [" << i << "]: got " << got[i] << ", expected " << want[i] << "\n";
+                g_mismatchShown = true;
+            }
+            worst = std::max(worst, diff);
+        }
+    }
+    report("FloatToS16", (float)worst, count * 3, worst <= SAMPLE_TOLERANCE);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+static void printHelp(const char* argv0) {
+    std::cout << "pbmathtest — SIMD kernel self-test for RasPin Pinball\n\n"
+              << "Usage:\n"
+              << "  " << argv0 << " [--verbose]\n\n"
+              << "Compares every NEON/SSE kernel in PB3DMath.h and PBSoundMath.h with its scalar\n"
+              << "reference.  Exits with a non-zero code if any kernel is out of tolerance.\n\n"
+              << "Options:\n"
+              << "  --verbose   Print the first mismatching value of each failing kernel\n"
+              << "  --help      Print this help message\n";
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--verbose") {
+            g_verbose = true;
+        } else if (arg == "--help" || arg == "-h") {
+            printHelp(argv[0]);
+            return 0;
+        } else {
+            std::cerr << "Error: Unknown option '" << arg << "'\n";
+            printHelp(argv[0]);
+            return 1;
+        }
+    }
+
+    std::cout << "PB3DMath: " << PB3D_MATH_ISA << "   PBSoundMath: " << PBS_MATH_ISA << "\n";
+    std::cout << "------------------------------------------------------------\n";
+
+    testMat4Mul();
+    testMat4MulAliased();
+    testMat4MulBatch();
+    testMat4FromTRS();
+    testMat4InvertAffine();
+    testQuatInterp("QuatNlerp (dot > 0)",          false, QUAT_PAIR_POSITIVE);
+    testQuatInterp("QuatNlerp (dot < 0)",          false, QUAT_PAIR_NEGATIVE);
+    testQuatInterp("QuatSlerp (dot > 0)",          true,  QUAT_PAIR_POSITIVE);
+    testQuatInterp("QuatSlerp (dot < 0)",          true,  QUAT_PAIR_NEGATIVE);
+    testQuatInterp("QuatSlerp (near parallel)",    true,  QUAT_PAIR_NEAR_PARALLEL);
+    testConcatHierarchy();
+    testFloatToS16();
+
+    std::cout << "------------------------------------------------------------\n";
+    if (g_failures > 0) {
+        std::cout << "FAILED: " << g_failures << " kernel(s) do not match their scalar reference\n";
+        return 1;
+    }
+    std::cout << "All kernels match their scalar reference\n";
+    return 0;
+}
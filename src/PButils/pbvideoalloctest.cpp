@@ -0,0 +1,213 @@
+// pbvideoalloctest — steady-state allocation test for PBVideo
+//
+// Usage:
+//   pbvideoalloctest [--seconds N] [video file]
+//
+// Plays a video through PBVideo the way PBVideoPlayer does - the caller polls pbvUpdateFrame() and
+// drains the audio ring while the decode thread runs ahead - and counts every heap allocation made
+// by any thread (malloc family and operator new).  Once the decode-ahead ring has filled it counts
+// for N seconds of playback, once with RGBA frames and once with planar frames, and returns a
+// non-zero exit code if either pass allocated, so it can gate a build.  Linux only (glibc).
+//
+// Options:
+//   --seconds N   Seconds of steady-state playback to count (default 5)
+//   --help        Print this help message
+//
+// The default video is the sandbox video; run it from the repository root (ctest does).
+
+// Copyright (c) 2025 Jeffrey D. Bock, unless otherwise noted. Licensed under a Creative Commons
+// Attribution-NonCommercial 4.0 International License.
+
+#include "../system/PBVideo.h"
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <new>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+// Playback before counting starts: lets the frame ring, the conversion pool and the decoder's own
+// frame pool fill up
+static const float WARMUP_SEC = 2.0f;
+
+// Playback covered by a pass must be at least this long for the result to mean anything
+static const float MIN_COUNTED_SEC = 1.0f;
+
+static const int AUDIO_DRAIN_FRAMES = 2048;
+
+static std::atomic<bool> g_counting(false);
+static std::atomic<unsigned long> g_allocations(0);
+
+// ============================================================================
+// Allocation hooks
+// ============================================================================
+
+// These replace the C library's entry points for the whole process, FFmpeg included, and forward to
+// glibc's own allocator.  Counting is off until a pass reaches steady state.
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void* malloc(size_t size) {
+    if (g_counting.load(std::memory_order_relaxed)) g_allocations++;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    if (g_counting.load(std::memory_order_relaxed)) g_allocations++;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (g_counting.load(std::memory_order_relaxed)) g_allocations++;
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    if (g_counting.load(std::memory_order_relaxed)) g_allocations++;
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    if (g_counting.load(std::memory_order_relaxed)) g_allocations++;
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) {
+    if (g_counting.load(std::memory_order_relaxed)) g_allocations++;
+    void* mem = __libc_memalign(alignment, size);
+    if (!mem) return ENOMEM;
+    *ptr = mem;
+    return 0;
+}
+}
+
+// operator new is counted through malloc, which these forward to
+void* operator new(size_t size) {
+    void* mem = malloc(size ? size : 1);
+    if (!mem) throw std::bad_alloc();
+    return mem;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return malloc(size ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete[](void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { free(ptr); }
+
+// ============================================================================
+// Playback pass
+// ============================================================================
+
+static unsigned long nowMs() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// One frame of the render loop: take the frame that is due and drain the audio the mixer would have
+static void pumpPlayback(PBVideo& video, float* audioBuffer) {
+    video.pbvUpdateFrame(nowMs());
+    while (video.pbvGetAudioSamples(audioBuffer, AUDIO_DRAIN_FRAMES) == AUDIO_DRAIN_FRAMES) {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+}
+
+// Returns false if the pass failed (allocations seen, or the video could not be played long enough)
+static bool runPass(const std::string& videoPath, bool planar, float countSeconds) {
+    static float audioBuffer[AUDIO_DRAIN_FRAMES * 2];
+    const char* label = planar ? "Planar frames" : "RGBA frames  ";
+
+    PBVideo video;
+    video.pbvInitialize();
+    if (!video.pbvLoadVideo(videoPath, planar, false)) {
+        std::cout << "  FAIL  " << label << "  could not load '" << videoPath << "'\n";
+        return false;
+    }
+    video.pbvSetLooping(false);   // a loop is a seek, not steady-state decode
+    video.pbvPlay();
+
+    while (video.pbvGetPlaybackState() == PBV_PLAYING && video.pbvGetCurrentTimeSec() < WARMUP_SEC) {
+        pumpPlayback(video, audioBuffer);
+    }
+
+    float startSec = video.pbvGetCurrentTimeSec();
+    g_allocations = 0;
+    g_counting = true;
+    while (video.pbvGetPlaybackState() == PBV_PLAYING && video.pbvGetCurrentTimeSec() - startSec < countSeconds) {
+        pumpPlayback(video, audioBuffer);
+    }
+    g_counting = false;
+    float countedSec = video.pbvGetCurrentTimeSec() - startSec;
+    unsigned long allocations = g_allocations;
+
+    std::string decoder = video.pbvGetDecoderInfo();
+    video.pbvStop();
+    video.pbvShutdown();
+
+    if (countedSec < MIN_COUNTED_SEC) {
+        std::cout << "  FAIL  " << label << "  only " << countedSec << "s of playback after warm-up (video too short?)\n";
+        return false;
+    }
+    std::cout << "  " << (allocations == 0 ? "PASS" : "FAIL") << "  " << label << "  " << allocations
+              << " allocation(s) in " << countedSec << "s  [" << decoder << "]\n";
+    return allocations == 0;
+}
+
+static void printHelp(const char* prog) {
+    std::cout << "Usage: " << prog << " [--seconds N] [video file]\n"
+              << "  Counts heap allocations during steady-state PBVideo playback; any allocation fails.\n"
+              << "  --seconds N   Seconds of steady-state playback to count (default 5)\n"
+              << "  --help        Print this help message\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string videoPath = "src/user/resources/videos/darktown_sound_h264.mp4";
+    float countSeconds = 5.0f;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) {
+            countSeconds = (float)atof(argv[++i]);
+        } else if (arg == "--help" || arg == "-h") {
+            printHelp(argv[0]);
+            return 0;
+        } else if (arg[0] == '-') {
+            std::cerr << "Error: Unknown option '" << arg << "'\n";
+            printHelp(argv[0]);
+            return 1;
+        } else {
+            videoPath = arg;
+        }
+    }
+
+    std::cout << "PBVideo steady-state allocations: " << videoPath << "\n";
+    std::cout << "------------------------------------------------------------\n";
+
+    int failures = 0;
+    if (!runPass(videoPath, false, countSeconds)) failures++;
+    if (!runPass(videoPath, true, countSeconds)) failures++;
+
+    std::cout << "------------------------------------------------------------\n";
+    if (failures > 0) {
+        std::cout << "FAILED: " << failures << " pass(es) allocated during steady-state playback or could not play\n";
+        return 1;
+    }
+    std::cout << "No allocations during steady-state playback\n";
+    return 0;
+}
@@ -6,6 +6,8 @@
 // Additional details can also be found in the license file in the root of the project.
 
 #include "PB3D.h"
+#include "PB3DMath.h"
+#include "PB3DModelFile.h"
 #include "3rdparty/cgltf.h"
 #include "3rdparty/linmath.h"
 #include "3rdparty/stb_image.h"
@@ -15,16 +17,29 @@
 #include <cmath>
 #include <random>
 #include <set>
+#include <unordered_map>
+#include <sys/stat.h>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 // ============================================================================
 // 3D Shader Sources (GLSL ES 3.0)
 // ============================================================================
 
+// Attribute locations are fixed so the instanced variant can draw from the same VAOs.
 const char* PB3D::vertexShader3DSource = R"(#version 300 es
     precision mediump float;
-    in vec3 aPosition;
-    in vec3 aNormal;
-    in vec2 aTexCoord;
+    layout(location = 0) in vec3 aPosition;
+    layout(location = 1) in vec3 aNormal;
+    layout(location = 2) in vec2 aTexCoord;
     uniform mat4 uMVP;
     uniform mat4 uModel;
     out vec2 vTexCoord;
@@ -38,6 +53,27 @@ const char* PB3D::vertexShader3DSource = R"(#version 300 es
     }
 )";
 
+// Instanced static-mesh vertex shader: the model matrix is a per-instance attribute (location
+// OGL_3D_INSTANCE_ATTRIB) so a run of identical opaque meshes is one draw.  Uses the static fragment shader.
+const char* PB3D::vertexShader3DInstancedSource = R"(#version 300 es
+    precision mediump float;
+    layout(location = 0) in vec3 aPosition;
+    layout(location = 1) in vec3 aNormal;
+    layout(location = 2) in vec2 aTexCoord;
+    layout(location = 3) in mat4 iModel;
+    uniform mat4 uViewProj;
+    out vec2 vTexCoord;
+    out vec3 vNormal;
+    out vec3 vWorldPos;
+    void main() {
+        vec4 worldPos = iModel * vec4(aPosition, 1.0);
+        gl_Position = uViewProj * worldPos;
+        vWorldPos = worldPos.xyz;
+        vNormal = mat3(iModel) * aNormal;
+        vTexCoord = aTexCoord;
+    }
+)";
+
 const char* PB3D::fragmentShader3DSource = R"(#version 300 es
     precision mediump float;
     in vec2 vTexCoord;
@@ -95,6 +131,45 @@ const char* PB3D::vertexShader3DSkinnedSource = R"(#version 300 es
     }
 )";
 
+// Skinned-mesh vertex shader, bone palette variant: bones are read from an RGBA32F texture holding
+// the top three rows of each matrix (one row of three texels per bone).  Only the uploaded bones
+// cost anything, and the bone count is not limited by GL_MAX_VERTEX_UNIFORM_VECTORS.
+const char* PB3D::vertexShader3DSkinnedPaletteSource = R"(#version 300 es
+    precision mediump float;
+    in vec3 aPosition;
+    in vec3 aNormal;
+    in vec2 aTexCoord;
+    in vec4 aJoints;   // bone indices (stored as float, cast to int in shader)
+    in vec4 aWeights;  // blend weights (sum to 1.0)
+    uniform mat4 uMVP;
+    uniform mat4 uModel;
+    uniform highp sampler2D uBonePalette;
+    out vec2 vTexCoord;
+    out vec3 vNormal;
+    out vec3 vWorldPos;
+    mat4 boneMatrix(int bone) {
+        highp vec4 r0 = texelFetch(uBonePalette, ivec2(0, bone), 0);
+        highp vec4 r1 = texelFetch(uBonePalette, ivec2(1, bone), 0);
+        highp vec4 r2 = texelFetch(uBonePalette, ivec2(2, bone), 0);
+        return mat4(r0.x, r1.x, r2.x, 0.0,
+                    r0.y, r1.y, r2.y, 0.0,
+                    r0.z, r1.z, r2.z, 0.0,
+                    r0.w, r1.w, r2.w, 1.0);
+    }
+    void main() {
+        mat4 skinMat = aWeights.x * boneMatrix(int(aJoints.x))
+                     + aWeights.y * boneMatrix(int(aJoints.y))
+                     + aWeights.z * boneMatrix(int(aJoints.z))
+                     + aWeights.w * boneMatrix(int(aJoints.w));
+        vec4 skinnedPos = skinMat * vec4(aPosition, 1.0);
+        gl_Position = uMVP * skinnedPos;
+        vWorldPos   = (uModel * skinnedPos).xyz;
+        mat3 skinNorm = mat3(skinMat);
+        vNormal   = normalize(skinNorm * aNormal);
+        vTexCoord = aTexCoord;
+    }
+)";
+
 // ============================================================================
 // Constructor / Destructor
 // ============================================================================
@@ -106,6 +181,22 @@ PB3D::PB3D() {
     m_sceneDirty = true;
     m_skinnedShaderActive = false;
 
+    m_poseNextJob = 0;
+    m_poseJobsDone = 0;
+    m_poseShutdown = false;
+    m_posePending = false;
+    m_poseParallel = true;
+    m_3dIdentityPalette = 0;
+    m_3dModelCapture = nullptr;
+    m_frustumValid = false;
+    m_cullingEnabled = true;
+    m_culledInstances = 0;
+    m_culledPoses = 0;
+    m_lodPixelRadius[0] = 0.0f;
+    m_lodPixelRadius[1] = PB3D_LOD1_PIXEL_RADIUS;
+    m_lodPixelRadius[2] = PB3D_LOD2_PIXEL_RADIUS;
+    m_lodInstances = 0;
+
     // Default camera: eye straight back on Z axis so Z=0 maps to screen surface.
     // FOV=45, aspect handled at render time. eyeZ=8 gives a comfortable frustum size.
     m_camera = {0.0f, 0.0f, 8.0f,   0.0f, 0.0f, 0.0f,   0.0f, 1.0f, 0.0f,   45.0f,   0.1f, 100.0f};
@@ -120,6 +211,8 @@ PB3D::PB3D() {
 }
 
 PB3D::~PB3D() {
+    pb3dShutdownPoseWorkers();
+
     // Clean up all 3D models (release GPU resources via PBOGLES)
     for (auto& pair : m_3dModelList) {
         for (auto& mesh : pair.second.meshes) {
@@ -129,8 +222,13 @@ PB3D::~PB3D() {
             ogl3dDestroyTexture(texId);
         }
     }
+    for (auto& pair : m_3dInstanceList) {
+        if (pair.second.skelState.paletteTexture) ogl3dDestroyTexture(pair.second.skelState.paletteTexture);
+    }
+    if (m_3dIdentityPalette) ogl3dDestroyTexture(m_3dIdentityPalette);
     ogl3dDestroyShader();
     ogl3dDestroySkinnedShader();
+    ogl3dDestroyInstancedShader();
 }
 
 // ============================================================================
@@ -152,8 +250,19 @@ bool PB3D::pb3dInit() {
         pb3dSendConsole("PB3D: Failed to create 3D shader program");
         return false;
     }
+    // Instanced variant for repeated static meshes.  Created before any model loads so every static
+    // VAO gets the instance attributes.  Non-fatal: the render queue then draws each mesh on its own.
+    if (!ogl3dInitInstancedShader(vertexShader3DInstancedSource, fragmentShader3DSource)) {
+        pb3dSendConsole("PB3D: instanced 3D shader unavailable; repeated meshes are drawn individually", true);
+    }
     // Compile and link the skinned 3D shader (for models with bone skeletons)
-    // Fragment shader is shared with the static path.
+    // Fragment shader is shared with the static path.  Prefer the bone palette texture variant and
+    // fall back to the uBones[] uniform array if the driver rejects it.
+    if (ogl3dInitSkinnedShader(vertexShader3DSkinnedPaletteSource, fragmentShader3DSource) && ogl3dUsesBonePalette()) {
+        pb3dSendConsole("PB3D: skinned meshes use bone palette textures", true);
+        return true;
+    }
+    ogl3dDestroySkinnedShader();
     if (!ogl3dInitSkinnedShader(vertexShader3DSkinnedSource, fragmentShader3DSource)) {
         pb3dSendConsole("PB3D: WARNING - Failed to create skinned 3D shader; skeleton animation disabled");
         // Non-fatal: models without skins still work
@@ -187,7 +296,175 @@ static void cgltf_accessor_read_float_buffer(const cgltf_accessor* accessor, flo
     }
 }
 
-unsigned int PB3D::pb3dLoadModel(const char* glbFilePath, bool forceStatic) {
+// Helper: set a mesh's AABB and the bounding sphere around it
+static void pb3dSetMeshBounds(st3DMesh& mesh, const float minP[3], const float maxP[3]) {
+    float halfDiag2 = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        mesh.boundsMin[i]    = minP[i];
+        mesh.boundsMax[i]    = maxP[i];
+        mesh.boundsCenter[i] = (minP[i] + maxP[i]) * 0.5f;
+        float half = (maxP[i] - minP[i]) * 0.5f;
+        halfDiag2 += half * half;
+    }
+    mesh.boundsRadius = sqrtf(halfDiag2);
+}
+
+// Helper: bounds of the positions in an interleaved vertex buffer (position is the first 3 floats)
+static void pb3dScanMeshBounds(st3DMesh& mesh, const float* vertData, size_t vertexCount, size_t floatsPerVertex) {
+    float minP[3] = {  1e30f,  1e30f,  1e30f };
+    float maxP[3] = { -1e30f, -1e30f, -1e30f };
+    for (size_t v = 0; v < vertexCount; v++) {
+        const float* p = vertData + v * floatsPerVertex;
+        for (int i = 0; i < 3; i++) {
+            if (p[i] < minP[i]) minP[i] = p[i];
+            if (p[i] > maxP[i]) maxP[i] = p[i];
+        }
+    }
+    if (vertexCount == 0) {
+        for (int i = 0; i < 3; i++) minP[i] = maxP[i] = 0.0f;
+    }
+    pb3dSetMeshBounds(mesh, minP, maxP);
+}
+
+// Helper: set up a mesh's detail levels.  Simplified levels are appended to indices after the full
+// mesh and share its vertices.  Each is built by vertex clustering: positions are snapped to a grid
+// over the mesh bounds, every vertex is replaced by the first vertex in its cell and collapsed
+// triangles are dropped.  The grid is coarsened until the level has at most half (then a quarter) of
+// the triangles, and a level that does not remove a quarter of the previous one is not kept.
+static void pb3dBuildMeshLods(st3DMesh& mesh, const float* vertData, size_t vertexCount, size_t floatsPerVertex,
+                              std::vector<unsigned int>& indices, unsigned int lodLevels) {
+    unsigned int fullCount = (unsigned int)indices.size();
+    mesh.indexCount       = fullCount;
+    mesh.lodCount         = 1;
+    mesh.lodIndexCount[0] = fullCount;
+    mesh.lodFirstIndex[0] = 0;
+    if (lodLevels > PB3D_MAX_LODS) lodLevels = PB3D_MAX_LODS;
+    if (lodLevels < 2 || fullCount / 3 < PB3D_LOD_MIN_TRIANGLES) return;
+
+    float extent = 0.0f;
+    for (int i = 0; i < 3; i++) extent = std::max(extent, mesh.boundsMax[i] - mesh.boundsMin[i]);
+    if (extent <= 0.0f) return;
+
+    std::unordered_map<uint64_t, unsigned int> cells;
+    std::vector<unsigned int> remap(vertexCount);
+    std::vector<unsigned int> lodIndices;
+    unsigned int previousCount = fullCount;
+    for (unsigned int level = 1; level < lodLevels; level++) {
+        unsigned int targetTriangles = (fullCount / 3) >> level;
+        for (unsigned int cellsPerAxis = 64; cellsPerAxis >= 4; cellsPerAxis = cellsPerAxis * 3 / 4) {
+            float cellScale = (float)cellsPerAxis / extent;
+            cells.clear();
+            for (size_t v = 0; v < vertexCount; v++) {
+                const float* p = vertData + v * floatsPerVertex;
+                uint64_t key = 0;
+                for (int i = 0; i < 3; i++) {
+                    unsigned int cell = (unsigned int)((p[i] - mesh.boundsMin[i]) * cellScale);
+                    key |= (uint64_t)std::min(cell, cellsPerAxis - 1) << (i * 21);
+                }
+                remap[v] = cells.emplace(key, (unsigned int)v).first->second;
+            }
+            lodIndices.clear();
+            for (unsigned int t = 0; t + 2 < fullCount; t += 3) {
+                if (indices[t] >= vertexCount || indices[t + 1] >= vertexCount || indices[t + 2] >= vertexCount) continue;
+                unsigned int a = remap[indices[t]], b = remap[indices[t + 1]], c = remap[indices[t + 2]];
+                if (a == b || b == c || a == c) continue;
+                lodIndices.push_back(a);
+                lodIndices.push_back(b);
+                lodIndices.push_back(c);
+            }
+            if (lodIndices.size() / 3 <= targetTriangles) break;
+        }
+        if (lodIndices.empty() || lodIndices.size() > (size_t)previousCount * 3 / 4) break;
+
+        mesh.lodFirstIndex[level] = (unsigned int)indices.size();
+        mesh.lodIndexCount[level] = (unsigned int)lodIndices.size();
+        indices.insert(indices.end(), lodIndices.begin(), lodIndices.end());
+        mesh.lodCount = level + 1;
+        previousCount = (unsigned int)lodIndices.size();
+    }
+}
+
+// Helper: names listed under REMOVE in a pb3dutil --simplify-bones file.  Entries are
+// "<weight> <name>"; comments, blank lines and the KEEP section are skipped.
+static bool pb3dReadBoneList(const char* path, std::set<std::string>& outRemoved) {
+    std::ifstream ifs(path);
+    if (!ifs.is_open()) return false;
+    bool inRemove = false;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        if (line.compare(0, 5, "KEEP ") == 0)   { inRemove = false; continue; }
+        if (line.compare(0, 7, "REMOVE ") == 0) { inRemove = true;  continue; }
+        size_t space = line.find(' ');
+        if (inRemove && space != std::string::npos) outRemoved.insert(line.substr(space + 1));
+    }
+    return true;
+}
+
+// Helper: bounding sphere around all of a model's mesh AABBs, and the most detail levels of any mesh
+static void pb3dComputeModelBounds(st3DModel& model) {
+    float minP[3] = {  1e30f,  1e30f,  1e30f };
+    float maxP[3] = { -1e30f, -1e30f, -1e30f };
+    model.lodCount = 1;
+    for (const st3DMesh& mesh : model.meshes) {
+        model.lodCount = std::max(model.lodCount, mesh.lodCount);
+        for (int i = 0; i < 3; i++) {
+            if (mesh.boundsMin[i] < minP[i]) minP[i] = mesh.boundsMin[i];
+            if (mesh.boundsMax[i] > maxP[i]) maxP[i] = mesh.boundsMax[i];
+        }
+    }
+    float halfDiag2 = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        if (minP[i] > maxP[i]) minP[i] = maxP[i] = 0.0f;
+        model.boundsCenter[i] = (minP[i] + maxP[i]) * 0.5f;
+        float half = (maxP[i] - minP[i]) * 0.5f;
+        halfDiag2 += half * half;
+    }
+    model.boundsRadius = sqrtf(halfDiag2);
+}
+
+unsigned int PB3D::pb3dLoadModel(const char* glbFilePath, bool forceStatic, const char* boneListPath, unsigned int lodLevels) {
+    // Resident models are shared: the same file and load options return the same model.
+    // The export capture always needs a fresh load, so it bypasses the cache.
+    std::string path = glbFilePath;
+    if (lodLevels < 1) lodLevels = 1;
+    if (lodLevels > PB3D_MAX_LODS) lodLevels = PB3D_MAX_LODS;
+    std::string cacheKey = path + (forceStatic ? "|static" : "");
+    if (boneListPath) cacheKey += "|bones=" + std::string(boneListPath);
+    if (lodLevels > 1) cacheKey += "|lod" + std::to_string(lodLevels);
+    if (!m_3dModelCapture) {
+        auto cacheIt = m_3dModelCache.find(cacheKey);
+        if (cacheIt != m_3dModelCache.end()) {
+            m_3dModelList[cacheIt->second].refCount++;
+            return cacheIt->second;
+        }
+    }
+
+    // Pre-processed model file: map it and upload directly, no glTF work at all
+    unsigned int modelId = 0;
+    std::string ext = PB3D_MODEL_FILE_EXT;
+    if (path.size() > ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0) {
+        modelId = pb3dLoadModelFile(glbFilePath, forceStatic);
+    } else {
+        if (!m_3dModelCapture) {
+            std::string pbmPath = path.substr(0, path.find_last_of('.')) + ext;
+            if (pb3dModelFileIsCurrent(path, pbmPath, forceStatic, boneListPath, lodLevels)) {
+                modelId = pb3dLoadModelFile(pbmPath.c_str(), forceStatic);
+                if (modelId == 0) pb3dSendConsole("PB3D: Falling back to glTF for: " + path);
+            }
+        }
+        if (modelId == 0) modelId = pb3dLoadModelGltf(glbFilePath, forceStatic, boneListPath, lodLevels);
+    }
+
+    if (modelId != 0 && !m_3dModelCapture) {
+        m_3dModelList[modelId].cacheKey = cacheKey;
+        m_3dModelCache[cacheKey] = modelId;
+    }
+    return modelId;
+}
+
+unsigned int PB3D::pb3dLoadModelGltf(const char* glbFilePath, bool forceStatic, const char* boneListPath, unsigned int lodLevels) {
     cgltf_options options = {};
     cgltf_data* data = nullptr;
 
@@ -208,8 +485,10 @@ unsigned int PB3D::pb3dLoadModel(const char* glbFilePath, bool forceStatic) {
 
     st3DModel model;
     model.name = glbFilePath;
+    model.refCount = 1;
     model.isLoaded = true;
     model.hasSkeleton = false;
+    model.skeleton.paletteBoneCount = 0;
     model.normScale  = 1.0f;
     model.normCX = model.normCY = model.normCZ = 0.0f;
 
@@ -315,6 +594,59 @@ unsigned int PB3D::pb3dLoadModel(const char* glbFilePath, bool forceStatic) {
         }
     }
 
+    // Bone reduction list: a bone named under REMOVE hands its vertex weights to its nearest joint
+    // ancestor that is kept, and is renumbered behind the kept bones so it needs no palette slot (it
+    // is still evaluated, to carry the hierarchy).  A listed bone with no kept ancestor stays.
+    std::vector<int> boneRedirect;   // unified bone -> kept bone taking its weights; empty without a list
+    int paletteBoneCount = (int)nodeToGlobalBone.size();
+    if (boneListPath && !forceStatic && !nodeToGlobalBone.empty()) {
+        std::set<std::string> removeNames;
+        if (!pb3dReadBoneList(boneListPath, removeNames)) {
+            pb3dSendConsole("PB3D: WARNING - Could not read bone list '" + std::string(boneListPath) + "', keeping all bones");
+        } else {
+            auto isListed = [&](const cgltf_node* node) { return node->name && removeNames.count(node->name) > 0; };
+            std::vector<const cgltf_node*> boneNodes(nodeToGlobalBone.size());
+            for (auto& kv : nodeToGlobalBone) boneNodes[kv.second] = kv.first;
+
+            // The nearest unlisted joint ancestor is the nearest kept one: every listed bone between
+            // them has that ancestor too, so is removed as well
+            std::vector<const cgltf_node*> weightTarget(boneNodes.size());
+            for (size_t bi = 0; bi < boneNodes.size(); bi++) {
+                weightTarget[bi] = boneNodes[bi];
+                if (!isListed(boneNodes[bi])) continue;
+                for (const cgltf_node* anc = boneNodes[bi]->parent; anc; anc = anc->parent) {
+                    if (nodeToGlobalBone.count(anc) && !isListed(anc)) {
+                        weightTarget[bi] = anc;
+                        break;
+                    }
+                }
+            }
+
+            std::vector<int> newIndex(boneNodes.size());
+            int next = 0;
+            for (size_t bi = 0; bi < boneNodes.size(); bi++) {
+                if (weightTarget[bi] == boneNodes[bi]) newIndex[bi] = next++;
+            }
+            paletteBoneCount = next;
+            for (size_t bi = 0; bi < boneNodes.size(); bi++) {
+                if (weightTarget[bi] != boneNodes[bi]) newIndex[bi] = next++;
+            }
+            boneRedirect.resize(boneNodes.size());
+            for (size_t bi = 0; bi < boneNodes.size(); bi++) {
+                boneRedirect[newIndex[bi]] = newIndex[nodeToGlobalBone.at(weightTarget[bi])];
+            }
+            for (auto& kv : nodeToGlobalBone) kv.second = newIndex[kv.second];
+            for (auto& kv : skinLocalToGlobal) {
+                for (int& globalIdx : kv.second) {
+                    if (globalIdx >= 0 && globalIdx < (int)newIndex.size()) globalIdx = newIndex[globalIdx];
+                }
+            }
+            pb3dSendConsole("PB3D: Bone list '" + std::string(boneListPath) + "': "
+                            + std::to_string(paletteBoneCount) + " of " + std::to_string(boneNodes.size())
+                            + " bones kept", true);
+        }
+    }
+
     // --- Pass 2: build GPU resources for each triangle primitive ---
     for (cgltf_size mi = 0; mi < data->meshes_count; mi++) {
         cgltf_mesh* mesh = &data->meshes[mi];
@@ -462,9 +794,31 @@ unsigned int PB3D::pb3dLoadModel(const char* glbFilePath, bool forceStatic) {
                                         ? (*l2g)[localIdx] : localIdx;
                         if (globalIdx < 0 || globalIdx >= PB3D_MAX_BONES)
                             globalIdx = PB3D_MAX_BONES - 1;
+                        if (globalIdx < (int)boneRedirect.size()) globalIdx = boneRedirect[globalIdx];
                         joints[v*4+c] = (float)globalIdx;
                     }
                 }
+                // Removed bones can leave a vertex with the same kept bone twice: merge those
+                // influences and renormalise
+                if (!boneRedirect.empty()) {
+                    for (cgltf_size v = 0; v < vertexCount; v++) {
+                        float* j = &joints[v*4];
+                        float* w = &weights[v*4];
+                        for (int c = 1; c < 4; c++) {
+                            for (int d = 0; d < c; d++) {
+                                if (j[c] == j[d]) {
+                                    w[d] += w[c];
+                                    w[c] = 0.0f;
+                                    break;
+                                }
+                            }
+                        }
+                        float sum = w[0] + w[1] + w[2] + w[3];
+                        if (sum > 0.0f) {
+                            for (int c = 0; c < 4; c++) w[c] /= sum;
+                        }
+                    }
+                }
             }
 
             // Skip unskinned primitives in a model that has skeleton/skin data.
@@ -534,13 +888,18 @@ unsigned int PB3D::pb3dLoadModel(const char* glbFilePath, bool forceStatic) {
                     for (cgltf_size ii = 0; ii < vertexCount; ii++) indices[ii] = (unsigned int)ii;
                 }
 
+                pb3dScanMeshBounds(gpuMesh, interleavedData.data(), vertexCount, 16);
+                pb3dBuildMeshLods(gpuMesh, interleavedData.data(), vertexCount, 16, indices, lodLevels);
                 if (!ogl3dCreateSkinnedMesh(interleavedData.data(), interleavedData.size(),
                                        indices.data(), indices.size(),
                                        gpuMesh.vao, gpuMesh.vboVertices, gpuMesh.eboIndices)) {
                     pb3dSendConsole("PB3D: ERROR - GPU skinned mesh creation failed (out of GPU memory?)");
                     continue;
                 }
-                gpuMesh.indexCount = (unsigned int)indices.size();
+                if (m_3dModelCapture) {
+                    m_3dModelCapture->vertices[gpuMesh.vao] = interleavedData;
+                    m_3dModelCapture->indices[gpuMesh.vao]  = indices;
+                }
             } else {
                 // Static layout: [posX, posY, posZ, normX, normY, normZ, u, v]
                 std::vector<float> interleavedData(vertexCount * 8);
@@ -566,13 +925,18 @@ unsigned int PB3D::pb3dLoadModel(const char* glbFilePath, bool forceStatic) {
                     for (cgltf_size ii = 0; ii < vertexCount; ii++) indices[ii] = (unsigned int)ii;
                 }
 
+                pb3dScanMeshBounds(gpuMesh, interleavedData.data(), vertexCount, 8);
+                pb3dBuildMeshLods(gpuMesh, interleavedData.data(), vertexCount, 8, indices, lodLevels);
                 if (!ogl3dCreateMesh(interleavedData.data(), interleavedData.size(),
                                 indices.data(), indices.size(),
                                 gpuMesh.vao, gpuMesh.vboVertices, gpuMesh.eboIndices)) {
                     pb3dSendConsole("PB3D: ERROR - GPU mesh creation failed (out of GPU memory?)");
                     continue;
                 }
-                gpuMesh.indexCount = (unsigned int)indices.size();
+                if (m_3dModelCapture) {
+                    m_3dModelCapture->vertices[gpuMesh.vao] = interleavedData;
+                    m_3dModelCapture->indices[gpuMesh.vao]  = indices;
+                }
             }
 
             // Load texture from material — deduplicate via localTexCache so primitives
@@ -594,6 +958,12 @@ unsigned int PB3D::pb3dLoadModel(const char* glbFilePath, bool forceStatic) {
                         unsigned char* pixels = stbi_load_from_memory(imgData, imgSize, &texW, &texH, &texC, STBI_rgb_alpha);
                         if (pixels) {
                             unsigned int texId = ogl3dCreateTexture(pixels, texW, texH);
+                            if (m_3dModelCapture && texId != 0) {
+                                st3DCapturedTexture& captured = m_3dModelCapture->textures[texId];
+                                captured.width  = texW;
+                                captured.height = texH;
+                                captured.pixels.assign(pixels, pixels + (size_t)texW * texH * 4);
+                            }
                             stbi_image_free(pixels);
                             gpuMesh.textureId = texId;
                             localTexCache[img] = texId;
@@ -777,6 +1147,7 @@ unsigned int PB3D::pb3dLoadModel(const char* glbFilePath, bool forceStatic) {
                         + std::string(glbFilePath), true);
 
         model.skeleton.bones.resize(totalBones);
+        model.skeleton.paletteBoneCount = std::min(paletteBoneCount, totalBones);
 
         // --- Step 3: Fill bone data from each skin's joints ---
         for (cgltf_size si = 0; si < data->skins_count; si++) {
@@ -1039,6 +1410,9 @@ unsigned int PB3D::pb3dLoadModel(const char* glbFilePath, bool forceStatic) {
             st3DAnimClip clip;
             clip.name     = anim->name ? anim->name : ("clip_" + std::to_string(ai));
             clip.duration = 0.0f;
+            clip.bakedRate       = 0.0f;
+            clip.bakedFrameCount = 0;
+            clip.bakedBoneCount  = 0;
 
             for (cgltf_size ci = 0; ci < anim->channels_count; ci++) {
                 const cgltf_animation_channel* ch   = &anim->channels[ci];
@@ -1077,25 +1451,25 @@ unsigned int PB3D::pb3dLoadModel(const char* glbFilePath, bool forceStatic) {
                 int valComponents  = (channel.type == ANIM_CHANNEL_ROTATION) ? 4 : 3;
                 int stride = (channel.interpolation == ANIM_INTERP_CUBICSPLINE) ? 3 : 1;
 
+                channel.times.resize(kfCount);
+                channel.values.assign(kfCount * 4, 0.0f);
                 for (cgltf_size ki = 0; ki < kfCount; ki++) {
-                    st3DAnimKeyframe kf;
-                    cgltf_accessor_read_float(smp->input, ki, &kf.time, 1);
-                    if (kf.time > clip.duration) clip.duration = kf.time;
+                    cgltf_accessor_read_float(smp->input, ki, &channel.times[ki], 1);
+                    if (channel.times[ki] > clip.duration) clip.duration = channel.times[ki];
 
                     cgltf_size outIdx = (channel.interpolation == ANIM_INTERP_CUBICSPLINE)
                                        ? ((cgltf_size)stride * ki + 1) : ki;
-                    kf.value[3] = 0.0f;
                     cgltf_accessor_read_float(smp->output, outIdx,
-                                              kf.value, (cgltf_size)valComponents);
-                    channel.keyframes.push_back(kf);
+                                              &channel.values[ki * 4], (cgltf_size)valComponents);
                 }
 
-                if (!channel.keyframes.empty()) {
+                if (!channel.times.empty()) {
                     clip.channels.push_back(channel);
                 }
             }
 
             if (!clip.channels.empty()) {
+                pb3dSkelIndexClipChannels(clip, (int)model.skeleton.bones.size());
                 model.skeleton.clips.push_back(clip);
             }
         }
@@ -1207,21 +1581,486 @@ unsigned int PB3D::pb3dLoadModel(const char* glbFilePath, bool forceStatic) {
         return 0;
     }
 
+    pb3dComputeModelBounds(model);
     unsigned int modelId = m_next3dModelId++;
     m_3dModelList[modelId] = model;
 
-    // Reset 2D texture cache: texture uploads during loading are outside
-    // PBOGLES's m_lastTextureId tracking, which would cause 2D sprites to
-    // silently skip their bind and render with the wrong texture.
-    oglResetTextureCache();
+    // Texture uploads during loading bind through PBOGLES's state cache,
+    // so the 2D texture tracking stays valid without a reset here.
 
     return modelId;
 }
 
+// ============================================================================
+// Pre-processed model files (.pbm) - see PB3DModelFile.h for the layout
+// ============================================================================
+
+static_assert(PB3D_MODEL_FILE_MAX_LODS == PB3D_MAX_LODS, "model file detail levels must match PB3D_MAX_LODS");
+
+// Read-only mapping of a whole file.  The pages come straight from the page cache and are only
+// touched once, while being handed to the GPU.  Returns nullptr when the file cannot be mapped.
+static const unsigned char* pb3dMapFile(const char* path, size_t& outSize) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) return nullptr;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);   // the view keeps the mapping alive
+    if (!view) return nullptr;
+    outSize = (size_t)fileSize.QuadPart;
+    return (const unsigned char*)view;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+    void* view = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) return nullptr;
+    madvise(view, (size_t)fileStat.st_size, MADV_SEQUENTIAL);
+    outSize = (size_t)fileStat.st_size;
+    return (const unsigned char*)view;
+#endif
+}
+
+static void pb3dUnmapFile(const unsigned char* data, size_t size) {
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(data);
+#else
+    munmap((void*)data, size);
+#endif
+}
+
+// Appends size bytes at the next PB3D_MODEL_FILE_ALIGN boundary and returns their file offset
+static uint32_t pb3dFileAppend(std::vector<unsigned char>& buffer, const void* data, size_t size) {
+    size_t offset = (buffer.size() + PB3D_MODEL_FILE_ALIGN - 1) & ~(size_t)(PB3D_MODEL_FILE_ALIGN - 1);
+    buffer.resize(offset + size, 0);
+    if (size > 0) memcpy(buffer.data() + offset, data, size);
+    return (uint32_t)offset;
+}
+
+bool PB3D::pb3dExportModel(const char* glbFilePath, const char* outFilePath, bool forceStatic,
+                           const char* boneListPath, unsigned int lodLevels) {
+    std::string outPath;
+    if (outFilePath) {
+        outPath = outFilePath;
+    } else {
+        std::string path = glbFilePath;
+        outPath = path.substr(0, path.find_last_of('.')) + PB3D_MODEL_FILE_EXT;
+    }
+
+    // Run the normal glTF loader with capture on, so the file holds exactly what it uploads
+    st3DModelCapture capture;
+    m_3dModelCapture = &capture;
+    unsigned int modelId = pb3dLoadModel(glbFilePath, forceStatic, boneListPath, lodLevels);
+    m_3dModelCapture = nullptr;
+    if (modelId == 0) return false;
+
+    lodLevels = std::min(std::max(lodLevels, 1u), (unsigned int)PB3D_MAX_LODS);
+    bool result = pb3dWriteModelFile(m_3dModelList[modelId], capture, forceStatic, boneListPath != nullptr,
+                                     lodLevels, outPath.c_str());
+    pb3dUnloadModel(modelId);
+
+    if (result) {
+        pb3dSendConsole("PB3D: Exported '" + std::string(glbFilePath) + "' to '" + outPath + "'", true);
+    }
+    return (result);
+}
+
+bool PB3D::pb3dWriteModelFile(const st3DModel& model, const st3DModelCapture& capture, bool forceStatic,
+                              bool boneListApplied, unsigned int lodLevels, const char* outFilePath) {
+    std::vector<unsigned char> buffer(sizeof(st3DFileHeader), 0);
+    std::string strings;
+
+    // Textures in handle order; the shared fallback is not stored, it is recreated at load
+    std::map<unsigned int, uint32_t> textureIndex;
+    std::vector<st3DFileTexture> textures;
+    for (const auto& pair : capture.textures) {
+        st3DFileTexture fileTex;
+        fileTex.width       = (uint32_t)pair.second.width;
+        fileTex.height      = (uint32_t)pair.second.height;
+        fileTex.pixelSize   = (uint32_t)pair.second.pixels.size();
+        fileTex.pixelOffset = pb3dFileAppend(buffer, pair.second.pixels.data(), pair.second.pixels.size());
+        textureIndex[pair.first] = (uint32_t)textures.size();
+        textures.push_back(fileTex);
+    }
+
+    // Meshes in the model's (already opaque-first) order
+    std::vector<st3DFileMesh> meshes;
+    for (const st3DMesh& mesh : model.meshes) {
+        auto vertIt = capture.vertices.find(mesh.vao);
+        auto idxIt  = capture.indices.find(mesh.vao);
+        if (vertIt == capture.vertices.end() || idxIt == capture.indices.end()) {
+            pb3dSendConsole("PB3D: Export failed - mesh data was not captured for: " + model.name);
+            return false;
+        }
+        st3DFileMesh fileMesh;
+        fileMesh.flags = (mesh.isSkinned ? PB3D_MESH_FLAG_SKINNED : 0) | (mesh.needsBlend ? PB3D_MESH_FLAG_BLEND : 0);
+        auto texIt = textureIndex.find(mesh.textureId);
+        fileMesh.textureIndex      = (texIt != textureIndex.end()) ? texIt->second : PB3D_MODEL_FILE_NO_TEXTURE;
+        fileMesh.materialBaseAlpha = mesh.materialBaseAlpha;
+        fileMesh.floatsPerVertex   = mesh.isSkinned ? 16 : 8;
+        fileMesh.vertexCount       = (uint32_t)(vertIt->second.size() / fileMesh.floatsPerVertex);
+        fileMesh.vertexOffset      = pb3dFileAppend(buffer, vertIt->second.data(), vertIt->second.size() * sizeof(float));
+        fileMesh.indexCount        = (uint32_t)idxIt->second.size();
+        fileMesh.indexOffset       = pb3dFileAppend(buffer, idxIt->second.data(), idxIt->second.size() * sizeof(unsigned int));
+        memcpy(fileMesh.boundsMin, mesh.boundsMin, sizeof(fileMesh.boundsMin));
+        memcpy(fileMesh.boundsMax, mesh.boundsMax, sizeof(fileMesh.boundsMax));
+        fileMesh.lodCount = mesh.lodCount;
+        for (unsigned int li = 0; li < PB3D_MODEL_FILE_MAX_LODS; li++) {
+            fileMesh.lodIndexCount[li] = (li < mesh.lodCount) ? mesh.lodIndexCount[li] : 0;
+        }
+        meshes.push_back(fileMesh);
+    }
+
+    // Skeleton and clips, as unified by the loader
+    const st3DSkeleton& skel = model.skeleton;
+    std::vector<st3DFileBone> bones;
+    std::vector<st3DFileClip> clips;
+    uint32_t skinCount = 0;
+    if (model.hasSkeleton) {
+        skinCount = (uint32_t)skel.skinCount;
+        if (skinCount > PB3D_MAX_SKINS) skinCount = PB3D_MAX_SKINS;
+
+        for (const st3DBone& bone : skel.bones) {
+            st3DFileBone fileBone;
+            fileBone.nameOffset  = (uint32_t)strings.size();
+            fileBone.nameLength  = (uint32_t)bone.name.size();
+            strings += bone.name;
+            fileBone.parentIndex = bone.parentIndex;
+            fileBone.skinIndex   = bone.skinIndex;
+            memcpy(fileBone.inverseBindMatrix,  bone.inverseBindMatrix,  sizeof(fileBone.inverseBindMatrix));
+            memcpy(fileBone.parentOffsetMatrix, bone.parentOffsetMatrix, sizeof(fileBone.parentOffsetMatrix));
+            memcpy(fileBone.restTranslation,    bone.restTranslation,    sizeof(fileBone.restTranslation));
+            memcpy(fileBone.restRotation,       bone.restRotation,       sizeof(fileBone.restRotation));
+            memcpy(fileBone.restScale,          bone.restScale,          sizeof(fileBone.restScale));
+            bones.push_back(fileBone);
+        }
+
+        for (const st3DAnimClip& clip : skel.clips) {
+            std::vector<st3DFileChannel> channels;
+            for (const st3DAnimChannel& ch : clip.channels) {
+                st3DFileChannel fileCh;
+                fileCh.boneIndex     = ch.boneIndex;
+                fileCh.type          = (int32_t)ch.type;
+                fileCh.interpolation = (int32_t)ch.interpolation;
+                fileCh.keyCount      = (uint32_t)ch.times.size();
+                fileCh.timesOffset   = pb3dFileAppend(buffer, ch.times.data(), ch.times.size() * sizeof(float));
+                fileCh.valuesOffset  = pb3dFileAppend(buffer, ch.values.data(), ch.values.size() * sizeof(float));
+                channels.push_back(fileCh);
+            }
+            st3DFileClip fileClip;
+            fileClip.nameOffset    = (uint32_t)strings.size();
+            fileClip.nameLength    = (uint32_t)clip.name.size();
+            strings += clip.name;
+            fileClip.duration      = clip.duration;
+            fileClip.channelCount  = (uint32_t)channels.size();
+            fileClip.channelOffset = pb3dFileAppend(buffer, channels.data(), channels.size() * sizeof(st3DFileChannel));
+            clips.push_back(fileClip);
+        }
+    }
+
+    st3DFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic         = PB3D_MODEL_FILE_MAGIC;
+    header.version       = PB3D_MODEL_FILE_VERSION;
+    header.flags         = (forceStatic ? PB3D_MODEL_FLAG_STATIC : 0) | (model.hasSkeleton ? PB3D_MODEL_FLAG_SKELETON : 0)
+                         | (boneListApplied ? PB3D_MODEL_FLAG_BONE_LIST : 0);
+    header.normScale     = model.normScale;
+    header.normCX        = model.normCX;
+    header.normCY        = model.normCY;
+    header.normCZ        = model.normCZ;
+    header.skinCount     = skinCount;
+    header.skinOffset    = pb3dFileAppend(buffer, skel.meshNodeGlobalInv, skinCount * 16 * sizeof(float));
+    header.meshCount     = (uint32_t)meshes.size();
+    header.meshOffset    = pb3dFileAppend(buffer, meshes.data(), meshes.size() * sizeof(st3DFileMesh));
+    header.textureCount  = (uint32_t)textures.size();
+    header.textureOffset = pb3dFileAppend(buffer, textures.data(), textures.size() * sizeof(st3DFileTexture));
+    header.boneCount     = (uint32_t)bones.size();
+    header.boneOffset    = pb3dFileAppend(buffer, bones.data(), bones.size() * sizeof(st3DFileBone));
+    header.clipCount     = (uint32_t)clips.size();
+    header.clipOffset    = pb3dFileAppend(buffer, clips.data(), clips.size() * sizeof(st3DFileClip));
+    header.stringSize    = (uint32_t)strings.size();
+    header.stringOffset  = pb3dFileAppend(buffer, strings.data(), strings.size());
+    header.paletteBoneCount = model.hasSkeleton ? (uint32_t)skel.paletteBoneCount : 0;
+    header.lodLevels        = lodLevels;
+
+    if (buffer.size() > UINT32_MAX) {
+        pb3dSendConsole("PB3D: Export failed - model file would exceed 4 GB: " + model.name);
+        return false;
+    }
+    header.fileSize = (uint32_t)buffer.size();
+    memcpy(buffer.data(), &header, sizeof(header));
+
+    std::ofstream ofs(outFilePath, std::ios::binary | std::ios::trunc);
+    if (!ofs.write((const char*)buffer.data(), (std::streamsize)buffer.size())) {
+        pb3dSendConsole("PB3D: Export failed - could not write: " + std::string(outFilePath));
+        return false;
+    }
+    return true;
+}
+
+// True when pbmFilePath exists, is a model file of this version exported with the same forceStatic,
+// bone list and lodLevels settings, and is not older than the .glb or the bone list (a missing .glb
+// is fine - the .pbm can ship on its own).
+bool PB3D::pb3dModelFileIsCurrent(const std::string& glbFilePath, const std::string& pbmFilePath, bool forceStatic,
+                                  const char* boneListPath, unsigned int lodLevels) {
+    struct stat pbmStat;
+    if (stat(pbmFilePath.c_str(), &pbmStat) != 0) return false;
+
+    struct stat glbStat;
+    if (stat(glbFilePath.c_str(), &glbStat) == 0 && glbStat.st_mtime > pbmStat.st_mtime) {
+        pb3dSendConsole("PB3D: Ignoring model file older than its .glb: " + pbmFilePath);
+        return false;
+    }
+    struct stat listStat;
+    if (boneListPath && stat(boneListPath, &listStat) == 0 && listStat.st_mtime > pbmStat.st_mtime) {
+        pb3dSendConsole("PB3D: Ignoring model file older than its bone list: " + pbmFilePath);
+        return false;
+    }
+
+    st3DFileHeader header;
+    std::ifstream ifs(pbmFilePath, std::ios::binary);
+    if (!ifs.read((char*)&header, sizeof(header))) return false;
+    if (header.magic != PB3D_MODEL_FILE_MAGIC || header.version != PB3D_MODEL_FILE_VERSION) {
+        pb3dSendConsole("PB3D: Ignoring model file from another version: " + pbmFilePath);
+        return false;
+    }
+    return (((header.flags & PB3D_MODEL_FLAG_STATIC) != 0) == forceStatic
+            && ((header.flags & PB3D_MODEL_FLAG_BONE_LIST) != 0) == (boneListPath != nullptr)
+            && header.lodLevels == lodLevels);
+}
+
+unsigned int PB3D::pb3dLoadModelFile(const char* pbmFilePath, bool forceStatic) {
+    size_t fileSize = 0;
+    const unsigned char* base = pb3dMapFile(pbmFilePath, fileSize);
+    if (!base) {
+        pb3dSendConsole("PB3D: Failed to map model file: " + std::string(pbmFilePath));
+        return 0;
+    }
+    const st3DFileHeader* header = pb3dFileGetHeader(base, fileSize);
+    if (!header) {
+        pb3dSendConsole("PB3D: Invalid or out-of-date model file (re-export it): " + std::string(pbmFilePath));
+        pb3dUnmapFile(base, fileSize);
+        return 0;
+    }
+    if (forceStatic && !(header->flags & PB3D_MODEL_FLAG_STATIC)) {
+        pb3dSendConsole("PB3D: WARNING - '" + std::string(pbmFilePath)
+                        + "' was exported with skinning, forceStatic is ignored");
+    }
+
+    st3DModel model;
+    model.name        = pbmFilePath;
+    model.refCount    = 1;
+    model.isLoaded    = true;
+    model.hasSkeleton = false;
+    model.normScale   = header->normScale;
+    model.normCX      = header->normCX;
+    model.normCY      = header->normCY;
+    model.normCZ      = header->normCZ;
+    model.skeleton.skinCount = 0;
+    model.skeleton.paletteBoneCount = 0;
+    bool valid = true;
+
+    // Textures: decoded pixels go to the GPU straight from the map
+    const st3DFileTexture* textures = (const st3DFileTexture*)(base + header->textureOffset);
+    std::vector<unsigned int> textureIds(header->textureCount, 0);
+    for (uint32_t ti = 0; ti < header->textureCount; ti++) {
+        const st3DFileTexture& fileTex = textures[ti];
+        if ((uint64_t)fileTex.pixelSize != (uint64_t)fileTex.width * fileTex.height * 4
+            || !pb3dFileRangeOk(header, fileTex.pixelOffset, fileTex.pixelSize)) {
+            valid = false;
+            break;
+        }
+        textureIds[ti] = ogl3dCreateTexture(base + fileTex.pixelOffset, (int)fileTex.width, (int)fileTex.height);
+        if (textureIds[ti] != 0) model.ownedTextures.insert(textureIds[ti]);
+    }
+
+    // Meshes: interleaved vertex and index blobs are already in the VAO layout
+    const st3DFileMesh* meshes = (const st3DFileMesh*)(base + header->meshOffset);
+    unsigned int fallbackTex = 0;
+    for (uint32_t mi = 0; valid && mi < header->meshCount; mi++) {
+        const st3DFileMesh& fileMesh = meshes[mi];
+        bool isSkinned = (fileMesh.flags & PB3D_MESH_FLAG_SKINNED) != 0;
+        uint64_t lodIndexTotal = 0;
+        for (uint32_t li = 0; li < fileMesh.lodCount && li < PB3D_MODEL_FILE_MAX_LODS; li++) lodIndexTotal += fileMesh.lodIndexCount[li];
+        if (fileMesh.floatsPerVertex != (isSkinned ? 16u : 8u)
+            || fileMesh.lodCount < 1 || fileMesh.lodCount > PB3D_MAX_LODS || lodIndexTotal != fileMesh.indexCount
+            || !pb3dFileRangeOk(header, fileMesh.vertexOffset, (uint64_t)fileMesh.vertexCount * fileMesh.floatsPerVertex * sizeof(float))
+            || !pb3dFileRangeOk(header, fileMesh.indexOffset, (uint64_t)fileMesh.indexCount * sizeof(unsigned int))) {
+            valid = false;
+            break;
+        }
+
+        st3DMesh gpuMesh = {};
+        gpuMesh.isSkinned         = isSkinned;
+        gpuMesh.needsBlend        = (fileMesh.flags & PB3D_MESH_FLAG_BLEND) != 0;
+        gpuMesh.materialBaseAlpha = fileMesh.materialBaseAlpha;
+
+        const float*        vertData = (const float*)(base + fileMesh.vertexOffset);
+        const unsigned int* idxData  = (const unsigned int*)(base + fileMesh.indexOffset);
+        size_t vertFloatCount = (size_t)fileMesh.vertexCount * fileMesh.floatsPerVertex;
+        bool created = isSkinned
+            ? ogl3dCreateSkinnedMesh(vertData, vertFloatCount, idxData, fileMesh.indexCount,
+                                     gpuMesh.vao, gpuMesh.vboVertices, gpuMesh.eboIndices)
+            : ogl3dCreateMesh(vertData, vertFloatCount, idxData, fileMesh.indexCount,
+                              gpuMesh.vao, gpuMesh.vboVertices, gpuMesh.eboIndices);
+        if (!created) {
+            pb3dSendConsole("PB3D: ERROR - GPU mesh creation failed (out of GPU memory?)");
+            continue;
+        }
+        gpuMesh.lodCount = fileMesh.lodCount;
+        unsigned int firstIndex = 0;
+        for (uint32_t li = 0; li < fileMesh.lodCount; li++) {
+            gpuMesh.lodFirstIndex[li] = firstIndex;
+            gpuMesh.lodIndexCount[li] = fileMesh.lodIndexCount[li];
+            firstIndex += fileMesh.lodIndexCount[li];
+        }
+        gpuMesh.indexCount = gpuMesh.lodIndexCount[0];
+        pb3dSetMeshBounds(gpuMesh, fileMesh.boundsMin, fileMesh.boundsMax);
+
+        gpuMesh.textureId = (fileMesh.textureIndex < header->textureCount) ? textureIds[fileMesh.textureIndex] : 0;
+        if (gpuMesh.textureId == 0) {
+            if (fallbackTex == 0) {
+                fallbackTex = ogl3dCreateFallbackTexture();
+                model.ownedTextures.insert(fallbackTex);
+            }
+            gpuMesh.textureId = fallbackTex;
+        }
+        model.meshes.push_back(gpuMesh);
+    }
+
+    // Skeleton
+    const char* strings = (const char*)(base + header->stringOffset);
+    if (valid && (header->flags & PB3D_MODEL_FLAG_SKELETON)) {
+        st3DSkeleton& skel = model.skeleton;
+        for (int si = 0; si < PB3D_MAX_SKINS; si++) {
+            memset(skel.meshNodeGlobalInv[si], 0, 64);
+            skel.meshNodeGlobalInv[si][0] = skel.meshNodeGlobalInv[si][5] = 1.0f;
+            skel.meshNodeGlobalInv[si][10] = skel.meshNodeGlobalInv[si][15] = 1.0f;
+        }
+        skel.skinCount = (int)(header->skinCount < PB3D_MAX_SKINS ? header->skinCount : PB3D_MAX_SKINS);
+        memcpy(skel.meshNodeGlobalInv, base + header->skinOffset, (size_t)skel.skinCount * 16 * sizeof(float));
+
+        const st3DFileBone* bones = (const st3DFileBone*)(base + header->boneOffset);
+        int numBones = (int)header->boneCount;
+        if (numBones > PB3D_MAX_BONES || header->paletteBoneCount > header->boneCount) valid = false;
+        skel.paletteBoneCount = (int)header->paletteBoneCount;
+        for (int bi = 0; valid && bi < numBones; bi++) {
+            const st3DFileBone& fileBone = bones[bi];
+            // Parent and skin indexes drive array lookups every frame; -1 marks a root / virtual bone
+            if ((uint64_t)fileBone.nameOffset + fileBone.nameLength > header->stringSize
+                || fileBone.parentIndex < -1 || fileBone.parentIndex >= numBones
+                || fileBone.skinIndex < -1 || fileBone.skinIndex >= skel.skinCount) {
+                valid = false;
+                break;
+            }
+            st3DBone bone;
+            bone.name        = std::string(strings + fileBone.nameOffset, fileBone.nameLength);
+            bone.parentIndex = fileBone.parentIndex;
+            bone.skinIndex   = fileBone.skinIndex;
+            memcpy(bone.inverseBindMatrix,  fileBone.inverseBindMatrix,  sizeof(bone.inverseBindMatrix));
+            memcpy(bone.parentOffsetMatrix, fileBone.parentOffsetMatrix, sizeof(bone.parentOffsetMatrix));
+            memcpy(bone.restTranslation,    fileBone.restTranslation,    sizeof(bone.restTranslation));
+            memcpy(bone.restRotation,       fileBone.restRotation,       sizeof(bone.restRotation));
+            memcpy(bone.restScale,          fileBone.restScale,          sizeof(bone.restScale));
+            skel.bones.push_back(bone);
+        }
+
+        const st3DFileClip* clips = (const st3DFileClip*)(base + header->clipOffset);
+        for (uint32_t ci = 0; valid && ci < header->clipCount; ci++) {
+            const st3DFileClip& fileClip = clips[ci];
+            if ((uint64_t)fileClip.nameOffset + fileClip.nameLength > header->stringSize
+                || !pb3dFileRangeOk(header, fileClip.channelOffset, (uint64_t)fileClip.channelCount * sizeof(st3DFileChannel))) {
+                valid = false;
+                break;
+            }
+            st3DAnimClip clip;
+            clip.name            = std::string(strings + fileClip.nameOffset, fileClip.nameLength);
+            clip.duration        = fileClip.duration;
+            clip.bakedRate       = 0.0f;
+            clip.bakedFrameCount = 0;
+            clip.bakedBoneCount  = 0;
+
+            const st3DFileChannel* channels = (const st3DFileChannel*)(base + fileClip.channelOffset);
+            for (uint32_t chi = 0; chi < fileClip.channelCount; chi++) {
+                const st3DFileChannel& fileCh = channels[chi];
+                if (fileCh.boneIndex < 0 || fileCh.boneIndex >= numBones
+                    || fileCh.type < ANIM_CHANNEL_TRANSLATION || fileCh.type > ANIM_CHANNEL_SCALE
+                    || fileCh.interpolation < ANIM_INTERP_LINEAR || fileCh.interpolation > ANIM_INTERP_CUBICSPLINE
+                    || !pb3dFileRangeOk(header, fileCh.timesOffset, (uint64_t)fileCh.keyCount * sizeof(float))
+                    || !pb3dFileRangeOk(header, fileCh.valuesOffset, (uint64_t)fileCh.keyCount * 4 * sizeof(float))) {
+                    valid = false;
+                    break;
+                }
+                if (fileCh.keyCount == 0) continue;
+                st3DAnimChannel channel;
+                channel.boneIndex     = fileCh.boneIndex;
+                channel.type          = (e3DAnimChannelType)fileCh.type;
+                channel.interpolation = (e3DInterpolationType)fileCh.interpolation;
+                const float* times  = (const float*)(base + fileCh.timesOffset);
+                const float* values = (const float*)(base + fileCh.valuesOffset);
+                channel.times.assign(times, times + fileCh.keyCount);
+                channel.values.assign(values, values + (size_t)fileCh.keyCount * 4);
+                clip.channels.push_back(channel);
+            }
+            if (valid && !clip.channels.empty()) {
+                pb3dSkelIndexClipChannels(clip, numBones);
+                skel.clips.push_back(clip);
+            }
+        }
+        model.hasSkeleton = valid && !skel.bones.empty();
+    }
+
+    pb3dUnmapFile(base, fileSize);
+
+    if (!valid) {
+        pb3dSendConsole("PB3D: Corrupt model file: " + std::string(pbmFilePath));
+        for (auto& mesh : model.meshes) ogl3dDestroyMesh(mesh.vao, mesh.vboVertices, mesh.eboIndices);
+        for (unsigned int texId : model.ownedTextures) ogl3dDestroyTexture(texId);
+        return 0;
+    }
+    if (model.meshes.empty()) {
+        pb3dSendConsole("PB3D: No meshes found in: " + std::string(pbmFilePath));
+        for (unsigned int texId : model.ownedTextures) ogl3dDestroyTexture(texId);
+        return 0;
+    }
+
+    pb3dSendConsole("PB3D: '" + std::string(pbmFilePath) + "' mapped: "
+                    + std::to_string(model.meshes.size()) + " mesh primitive(s), "
+                    + std::to_string(model.ownedTextures.size()) + " unique texture(s), "
+                    + std::to_string(model.skeleton.bones.size()) + " bones, "
+                    + std::to_string(model.skeleton.clips.size()) + " clips", true);
+
+    pb3dComputeModelBounds(model);
+    unsigned int modelId = m_next3dModelId++;
+    m_3dModelList[modelId] = model;
+    return modelId;
+}
+
 bool PB3D::pb3dUnloadModel(unsigned int modelId) {
+    pb3dWaitSkelPoses();
     auto it = m_3dModelList.find(modelId);
     if (it == m_3dModelList.end()) return false;
 
+    // Shared model: only the last reference releases it
+    if (it->second.refCount > 1) {
+        it->second.refCount--;
+        return true;
+    }
+    if (!it->second.cacheKey.empty()) m_3dModelCache.erase(it->second.cacheKey);
+
     for (auto& mesh : it->second.meshes) {
         ogl3dDestroyMesh(mesh.vao, mesh.vboVertices, mesh.eboIndices);
     }
@@ -1236,6 +2075,7 @@ bool PB3D::pb3dUnloadModel(unsigned int modelId) {
     for (auto instIt = m_3dInstanceList.begin(); instIt != m_3dInstanceList.end(); ) {
         if (instIt->second.modelId == modelId) {
             m_3dAnimateList.erase(instIt->first); // safe no-op if no animation entry exists
+            if (instIt->second.skelState.paletteTexture) ogl3dDestroyTexture(instIt->second.skelState.paletteTexture);
             instIt = m_3dInstanceList.erase(instIt);
         } else {
             ++instIt;
@@ -1268,6 +2108,10 @@ unsigned int PB3D::pb3dCreateInstance(unsigned int modelId) {
     instance.skelState.looping         = false;
     instance.skelState.isPlaying       = false;
     instance.skelState.lastUpdateTick  = 0;
+    instance.skelState.paletteTexture  = 0;
+    instance.skelState.poseVersion     = 0;
+    instance.skelState.uploadedVersion = 0;
+    instance.skelState.poseStale       = false;
     // Only allocate bone matrix storage for skinned models.
     const st3DModel& model = m_3dModelList.at(modelId);
     if (model.hasSkeleton) {
@@ -1286,8 +2130,10 @@ unsigned int PB3D::pb3dCreateInstance(unsigned int modelId) {
 }
 
 bool PB3D::pb3dDestroyInstance(unsigned int instanceId) {
+    pb3dWaitSkelPoses();
     auto it = m_3dInstanceList.find(instanceId);
     if (it == m_3dInstanceList.end()) return false;
+    if (it->second.skelState.paletteTexture) ogl3dDestroyTexture(it->second.skelState.paletteTexture);
     m_3dInstanceList.erase(it);
     m_3dAnimateList.erase(instanceId);  // remove stale animation so it isn't processed next frame
     return true;
@@ -1403,8 +2249,12 @@ void PB3D::pb3dPixelToWorld(float pixelX, float pixelY, float depthZ, float& out
 // ============================================================================
 
 void PB3D::pb3dBegin() {
+    pb3dWaitSkelPoses();
     ogl3dBeginPass();
     m_skinnedShaderActive = false;
+    m_3dSubmissions.clear();
+    m_culledInstances = 0;
+    m_lodInstances = 0;
 
     // Re-upload light uniforms and recompute view/projection matrices only when
     // the scene has changed (camera or lighting).  Neither changes at runtime in
@@ -1443,11 +2293,38 @@ void PB3D::pb3dBegin() {
         mat4x4_perspective(proj, fovRad, aspect, m_camera.nearPlane, m_camera.farPlane);
         memcpy(m_projMatrix, proj, sizeof(m_projMatrix));
 
+        // Frustum planes from the rows of projection * view (Gribb / Hartmann), normalised so the
+        // plane distance of a point can be compared directly against a sphere radius
+        mat4x4 viewProj;
+        mat4x4_mul(viewProj, proj, view);
+        for (int pi = 0; pi < 6; pi++) {
+            int   row  = pi / 2;
+            float sign = (pi & 1) ? -1.0f : 1.0f;
+            float* plane = m_frustumPlanes[pi];
+            for (int col = 0; col < 4; col++) plane[col] = viewProj[col][3] + sign * viewProj[col][row];
+            float len = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            if (len > 1e-6f) for (int col = 0; col < 4; col++) plane[col] /= len;
+        }
+        m_frustumValid = true;
+
+        // Instanced shader scene uniforms - it also needs the combined view/projection
+        if (ogl3dInstancingAvailable()) {
+            ogl3dSetInstancedSceneUniforms(
+                m_light.dirX,     m_light.dirY,     m_light.dirZ,
+                m_light.r,        m_light.g,        m_light.b,
+                m_light.ambientR, m_light.ambientG, m_light.ambientB,
+                m_camera.eyeX,    m_camera.eyeY,    m_camera.eyeZ,
+                (const float*)viewProj);
+            ogl3dActivateStaticShader();
+        }
+
         m_sceneDirty = false;
     }
 }
 
 void PB3D::pb3dEnd() {
+    pb3dFlushQueue();
+
     // Ensure static shader is restored before going back to 2D
     if (m_skinnedShaderActive) {
         ogl3dActivateStaticShader();
@@ -1456,16 +2333,13 @@ void PB3D::pb3dEnd() {
     oglRestore2DState();
 }
 
-void PB3D::pb3dRenderInstance(unsigned int instanceId) {
-    auto instIt = m_3dInstanceList.find(instanceId);
-    if (instIt == m_3dInstanceList.end()) return;
-
-    st3DInstance& inst = instIt->second;
-    if (!inst.visible) return;
-
-    auto modelIt = m_3dModelList.find(inst.modelId);
-    if (modelIt == m_3dModelList.end()) return;
-
+// Build the model matrix and MVP for an instance.
+// Vertex positions in VBOs are raw model-space coordinates (not normalized).
+// We fold the normalization (center + scale) into the matrix chain so that
+// the model displays at a consistent unit size regardless of original authoring
+// scale, and so that IBMs work correctly in the skinned path:
+//   world = T * R * S_user * S_norm * translate(-center) * P_original
+void PB3D::pb3dBuildInstanceMatrices(const st3DInstance& inst, const st3DModel& model3d, float outModel[16], float outMVP[16]) {
     // Pixel anchor: compute Z-depth perspective correction into local render
     // position — do NOT mutate inst.posX/Y, which would compound each frame.
     // Delta = worldXY_at_currentZ - worldXY_at_Z0 keeps the object at the same
@@ -1479,14 +2353,6 @@ void PB3D::pb3dRenderInstance(unsigned int instanceId) {
         renderY += (wyZ - inst.anchorBaseY);
     }
 
-    // Build model matrix.
-    // Vertex positions in VBOs are raw model-space coordinates (not normalized).
-    // We fold the normalization (center + scale) into the matrix chain so that
-    // the model displays at a consistent unit size regardless of original authoring
-    // scale, and so that IBMs work correctly in the skinned path:
-    //   world = T * R * S_user * S_norm * translate(-center) * P_original
-    const st3DModel& model3d = modelIt->second;
-
     mat4x4 model, identMat;
     mat4x4_identity(identMat);
 
@@ -1526,28 +2392,127 @@ void PB3D::pb3dRenderInstance(unsigned int instanceId) {
     mat4x4_mul(rotYXZSC, rotYXZS,  centerMat);
     mat4x4_mul(model,    translateMat, rotYXZSC);
 
+    memcpy(outModel, model, sizeof(model));
+    if (!outMVP) return;   // culling only needs the model matrix
+
     // Compute MVP = projection * view * model
     mat4x4 view, proj, viewModel, mvp;
     memcpy(view, m_viewMatrix, sizeof(view));
     memcpy(proj, m_projMatrix, sizeof(proj));
     mat4x4_mul(viewModel, view, model);
     mat4x4_mul(mvp, proj, viewModel);
+    memcpy(outMVP, mvp, sizeof(mvp));
+}
 
-    // Set per-instance uniforms and transparency blend state
-    //
-    // A skinned mesh VAO is built with attribute pointers keyed to the SKINNED
-    // shader's attribute locations (m_3dSk_PosAttrib etc.).  If we switch to the
-    // static shader for the same VAO, the static shader's attribute locations may
-    // differ, causing the GPU to misread vertex data entirely.
-    //
-    // Rule: a mesh is drawn with the skinned shader whenever it was uploaded as a
-    // skinned VAO (mesh.isSkinned == true), regardless of whether an animation clip
-    // is currently playing.  When no clip is active, identity bone matrices are used,
-    // which trivially produces skinnedPos == rawPos (weights sum to 1 × identity).
-    //
-    // needSkinned only gates BONE MATRIX COMPUTATION, not shader selection.
+// ============================================================================
+// Culling
+// ============================================================================
+
+void PB3D::pb3dSetCulling(bool enable) {
+    m_cullingEnabled = enable;
+}
+
+// Instances culled since the last pb3dBegin, and skeleton poses skipped by the last pb3dAnimateInstance(0, ...)
+void PB3D::pb3dGetCullStats(unsigned int& instancesCulled, unsigned int& posesSkipped) {
+    instancesCulled = m_culledInstances;
+    posesSkipped    = m_culledPoses;
+}
+
+// True when a model-space sphere is at least partly inside the frustum.  The model matrix has a
+// uniform scale, so the length of its first column scales the radius.
+bool PB3D::pb3dSphereInFrustum(const float modelMat[16], const float center[3], float radius) {
+    float wx = modelMat[0] * center[0] + modelMat[4] * center[1] + modelMat[8]  * center[2] + modelMat[12];
+    float wy = modelMat[1] * center[0] + modelMat[5] * center[1] + modelMat[9]  * center[2] + modelMat[13];
+    float wz = modelMat[2] * center[0] + modelMat[6] * center[1] + modelMat[10] * center[2] + modelMat[14];
+    float worldRadius = radius * sqrtf(modelMat[0] * modelMat[0] + modelMat[1] * modelMat[1] + modelMat[2] * modelMat[2]);
+
+    for (int pi = 0; pi < 6; pi++) {
+        const float* plane = m_frustumPlanes[pi];
+        if (plane[0] * wx + plane[1] * wy + plane[2] * wz + plane[3] < -worldRadius) return false;
+    }
+    return true;
+}
+
+// Whole-instance test against the model's bounding sphere.  Always true until pb3dBegin has
+// produced the frustum, or when culling is off.
+bool PB3D::pb3dInstanceInFrustum(const st3DModel& model3d, const float modelMat[16]) {
+    if (!m_cullingEnabled || !m_frustumValid) return true;
+    float radius = model3d.boundsRadius * (model3d.hasSkeleton ? PB3D_SKINNED_BOUNDS_SCALE : 1.0f);
+    return pb3dSphereInFrustum(modelMat, model3d.boundsCenter, radius);
+}
+
+// Per-mesh test, only worth doing for models with more than one mesh
+bool PB3D::pb3dMeshInFrustum(const st3DModel& model3d, const st3DMesh& mesh, const float modelMat[16]) {
+    if (!m_cullingEnabled || !m_frustumValid || model3d.meshes.size() < 2) return true;
+    float radius = mesh.boundsRadius * (mesh.isSkinned ? PB3D_SKINNED_BOUNDS_SCALE : 1.0f);
+    return pb3dSphereInFrustum(modelMat, mesh.boundsCenter, radius);
+}
+
+// ============================================================================
+// Detail levels
+// ============================================================================
+
+void PB3D::pb3dSetLodPixelRadius(float lod1Radius, float lod2Radius) {
+    m_lodPixelRadius[1] = lod1Radius;
+    m_lodPixelRadius[2] = lod2Radius;
+}
+
+unsigned int PB3D::pb3dGetLodInstances() {
+    return (m_lodInstances);
+}
+
+// Detail level for an instance from the projected radius of the model's bounding sphere, in pixels.
+// Level 0 until pb3dBegin has produced the matrices, or for models without simplified levels.
+unsigned int PB3D::pb3dSelectLod(const st3DModel& model3d, const float modelMat[16]) {
+    if (model3d.lodCount < 2 || !m_frustumValid) return 0;
+
+    const float* c = model3d.boundsCenter;
+    float wx = modelMat[0] * c[0] + modelMat[4] * c[1] + modelMat[8]  * c[2] + modelMat[12];
+    float wy = modelMat[1] * c[0] + modelMat[5] * c[1] + modelMat[9]  * c[2] + modelMat[13];
+    float wz = modelMat[2] * c[0] + modelMat[6] * c[1] + modelMat[10] * c[2] + modelMat[14];
+    float depth = -(m_viewMatrix[2] * wx + m_viewMatrix[6] * wy + m_viewMatrix[10] * wz + m_viewMatrix[14]);
+    if (depth <= m_camera.nearPlane) return 0;
+
+    // projection[5] is 1 / tan(fov / 2): it maps a view space height at unit depth to half the viewport
+    float worldRadius = model3d.boundsRadius * sqrtf(modelMat[0] * modelMat[0] + modelMat[1] * modelMat[1] + modelMat[2] * modelMat[2]);
+    float pixelRadius = worldRadius * m_projMatrix[5] * 0.5f * (float)oglGetScreenHeight() / depth;
+
+    unsigned int lod = 0;
+    for (unsigned int li = 1; li < model3d.lodCount && li < PB3D_MAX_LODS; li++) {
+        if (pixelRadius < m_lodPixelRadius[li]) lod = li;
+    }
+    if (lod > 0) m_lodInstances++;
+    return lod;
+}
+
+// Called for a playing instance after its clip time has advanced.  Hidden and off-screen instances
+// skip the pose evaluation; the pose is marked stale and evaluated when the instance is next drawn.
+// The frustum from the last pb3dBegin is used, so nothing is skipped while the camera is changing.
+bool PB3D::pb3dSkipCulledPose(st3DInstance& inst, const st3DModel& model3d) {
+    if (!m_cullingEnabled) return false;
+    if (inst.visible) {
+        if (!m_frustumValid || m_sceneDirty) return false;
+        float modelMat[16];
+        pb3dBuildInstanceMatrices(inst, model3d, modelMat, nullptr);
+        if (pb3dInstanceInFrustum(model3d, modelMat)) return false;
+    }
+    inst.skelState.poseStale = true;
+    m_culledPoses++;
+    return true;
+}
+
+// Pick the bone data for an instance's skinned meshes: the instance's palette texture (palette
+// path) or bone matrix array (uniform path) when a clip is active, identity otherwise.
+void PB3D::pb3dPrepareInstanceBones(st3DInstance& inst, const st3DModel& model3d,
+                                    const float*& outBones, int& outBoneCount, unsigned int& outPaletteTex) {
     bool hasActiveClip = model3d.hasSkeleton && (inst.skelState.clipIndex >= 0);
 
+    // The pose was skipped while the instance was culled - catch up now it is being drawn
+    st3DSkelState& skelState = inst.skelState;
+    if (skelState.poseStale && hasActiveClip && skelState.clipIndex < (int)model3d.skeleton.clips.size()) {
+        pb3dEvalPoseJob({ &skelState, &model3d.skeleton, &model3d.skeleton.clips[skelState.clipIndex] });
+    }
+
     // Prepare bone matrices: use instance's bone matrices if a clip is active,
     // otherwise a local identity array so the shader gets valid data.
     static float s_identityBones[PB3D_MAX_BONES * 16] = {};
@@ -1559,46 +2524,121 @@ void PB3D::pb3dRenderInstance(unsigned int instanceId) {
         }
         s_identityBonesInit = true;
     }
-    const float* activeBones   = hasActiveClip ? inst.skelState.boneMatrices.data() : s_identityBones;
-    int          activeBoneCount = (int)model3d.skeleton.bones.size();
-    if (activeBoneCount > PB3D_MAX_BONES) activeBoneCount = PB3D_MAX_BONES;
+    outBones     = hasActiveClip ? inst.skelState.boneMatrices.data() : s_identityBones;
+    outBoneCount = model3d.skeleton.paletteBoneCount;
+    if (outBoneCount > PB3D_MAX_BONES) outBoneCount = PB3D_MAX_BONES;
+
+    // Palette path: the instance's palette texture is only re-uploaded when its pose has changed since
+    // the last upload, so drawing an instance several times (or several meshes) costs one bind each.
+    outPaletteTex = 0;
+    if (ogl3dUsesBonePalette() && model3d.hasSkeleton) {
+        st3DSkelState& ss = inst.skelState;
+        if (hasActiveClip && outBoneCount > 0 && ss.bonePalette.size() >= (size_t)outBoneCount * 12) {
+            if (ss.paletteTexture == 0) {
+                ss.paletteTexture  = ogl3dCreateBonePalette(outBoneCount);
+                ss.uploadedVersion = ss.poseVersion - 1;
+            }
+            if (ss.uploadedVersion != ss.poseVersion) {
+                ogl3dUpdateBonePalette(ss.paletteTexture, ss.bonePalette.data(), outBoneCount);
+                ss.uploadedVersion = ss.poseVersion;
+            }
+            outPaletteTex = ss.paletteTexture;
+        } else {
+            if (m_3dIdentityPalette == 0) {
+                std::vector<float> identity((size_t)PB3D_MAX_BONES * 12, 0.0f);
+                for (int bi = 0; bi < PB3D_MAX_BONES; bi++) {
+                    identity[bi*12 + 0] = identity[bi*12 + 5] = identity[bi*12 + 10] = 1.0f;
+                }
+                m_3dIdentityPalette = ogl3dCreateBonePalette(PB3D_MAX_BONES);
+                ogl3dUpdateBonePalette(m_3dIdentityPalette, identity.data(), PB3D_MAX_BONES);
+            }
+            outPaletteTex = m_3dIdentityPalette;
+        }
+    }
+}
+
+// Draw one mesh of an instance with the per-instance uniforms.  Blend state is the caller's.
+//
+// A skinned mesh VAO is built with attribute pointers keyed to the SKINNED
+// shader's attribute locations (m_3dSk_PosAttrib etc.).  If we switch to the
+// static shader for the same VAO, the static shader's attribute locations may
+// differ, causing the GPU to misread vertex data entirely.
+//
+// Rule: a mesh is drawn with the skinned shader whenever it was uploaded as a
+// skinned VAO (mesh.isSkinned == true), regardless of whether an animation clip
+// is currently playing.  When no clip is active, identity bone matrices are used,
+// which trivially produces skinnedPos == rawPos (weights sum to 1 × identity).
+void PB3D::pb3dDrawInstanceMesh(const st3DMesh& mesh, const float model[16], const float mvp[16], float alpha,
+                                const float* bones, int boneCount, unsigned int paletteTex, unsigned int lod) {
+    // Always request the program: an instanced draw may have replaced it, and the
+    // state cache skips the bind when it is already current.
+    if (mesh.isSkinned) {
+        ogl3dActivateSkinnedShader();
+        m_skinnedShaderActive = true;
+    } else {
+        ogl3dActivateStaticShader();
+        m_skinnedShaderActive = false;
+    }
+
+    // Upload per-mesh uniforms with the effective alpha for this mesh.
+    // Always upload so that the alpha (which can vary per mesh) is current.
+    if (m_skinnedShaderActive && paletteTex) {
+        ogl3dSetSkinnedPaletteUniforms(mvp, model, alpha, paletteTex);
+    } else if (m_skinnedShaderActive) {
+        ogl3dSetSkinnedInstanceUniforms(mvp, model, alpha, bones, boneCount);
+    } else {
+        ogl3dSetInstanceUniforms(mvp, model, alpha);
+    }
+
+    // A mesh too small to simplify draws its last level
+    if (lod >= mesh.lodCount) lod = mesh.lodCount - 1;
+    ogl3dDrawMeshPrimitive(mesh.vao, mesh.textureId, mesh.lodIndexCount[lod], mesh.lodFirstIndex[lod]);
+}
+
+void PB3D::pb3dRenderInstance(unsigned int instanceId) {
+    pb3dWaitSkelPoses();
+    auto instIt = m_3dInstanceList.find(instanceId);
+    if (instIt == m_3dInstanceList.end()) return;
+
+    st3DInstance& inst = instIt->second;
+    if (!inst.visible) return;
+
+    auto modelIt = m_3dModelList.find(inst.modelId);
+    if (modelIt == m_3dModelList.end()) return;
+    const st3DModel& model3d = modelIt->second;
+
+    float model[16], mvp[16];
+    pb3dBuildInstanceMatrices(inst, model3d, model, mvp);
+    if (!pb3dInstanceInFrustum(model3d, model)) {
+        m_culledInstances++;
+        return;
+    }
+    unsigned int lod = pb3dSelectLod(model3d, model);
+
+    const float* bones;
+    int          boneCount;
+    unsigned int paletteTex;
+    pb3dPrepareInstanceBones(inst, model3d, bones, boneCount, paletteTex);
 
     bool currentBlend = (inst.alpha < 1.0f);
     ogl3dSetBlend(currentBlend);
 
     for (auto& mesh : model3d.meshes) {
+        if (!pb3dMeshInFrustum(model3d, mesh, model)) continue;
+
         // Effective alpha = instance alpha × material base_color_factor alpha.
         // This honours per-material transparency (e.g. glass with materialBaseAlpha < 1)
         // independently of any animation or instance-level alpha fade.
         float effectiveAlpha = inst.alpha * mesh.materialBaseAlpha;
         bool meshBlend = (effectiveAlpha < 1.0f) || mesh.needsBlend;
 
-        // Use skinned shader for skinned VAOs, static shader for non-skinned VAOs.
-        // This must match how each VAO's attribute pointers were originally set up.
-        if (mesh.isSkinned && !m_skinnedShaderActive) {
-            ogl3dActivateSkinnedShader();
-            m_skinnedShaderActive = true;
-        } else if (!mesh.isSkinned && m_skinnedShaderActive) {
-            ogl3dActivateStaticShader();
-            m_skinnedShaderActive = false;
-        }
-
         // Switch blend state if it differs from current
         if (meshBlend != currentBlend) {
             ogl3dSetBlend(meshBlend);
             currentBlend = meshBlend;
         }
 
-        // Upload per-mesh uniforms with the effective alpha for this mesh.
-        // Always upload so that effectiveAlpha (which can vary per mesh) is current.
-        if (m_skinnedShaderActive) {
-            ogl3dSetSkinnedInstanceUniforms((const float*)mvp, (const float*)model,
-                                            effectiveAlpha, activeBones, activeBoneCount);
-        } else {
-            ogl3dSetInstanceUniforms((const float*)mvp, (const float*)model, effectiveAlpha);
-        }
-
-        ogl3dDrawMeshPrimitive(mesh.vao, mesh.textureId, mesh.indexCount);
+        pb3dDrawInstanceMesh(mesh, model, mvp, effectiveAlpha, bones, boneCount, paletteTex, lod);
     }
 
     // Ensure blend is disabled after this instance so the next draw call is clean
@@ -1607,11 +2647,135 @@ void PB3D::pb3dRenderInstance(unsigned int instanceId) {
     }
 }
 
+// Queue an instance for the sorted draw in pb3dEnd().  The transform and alpha are captured now,
+// so the instance can be changed (or submitted again) before the queue is flushed.
+void PB3D::pb3dSubmitInstance(unsigned int instanceId) {
+    auto instIt = m_3dInstanceList.find(instanceId);
+    if (instIt == m_3dInstanceList.end()) return;
+
+    const st3DInstance& inst = instIt->second;
+    if (!inst.visible) return;
+
+    auto modelIt = m_3dModelList.find(inst.modelId);
+    if (modelIt == m_3dModelList.end()) return;
+
+    if (m_3dSubmissions.size() >= PB3D_RENDER_QUEUE_MAX) pb3dFlushQueue();
+
+    m_3dSubmissions.emplace_back();
+    st3DSubmission& sub = m_3dSubmissions.back();
+    sub.instanceId = instanceId;
+    sub.alpha      = inst.alpha;
+    pb3dBuildInstanceMatrices(inst, modelIt->second, sub.model, sub.mvp);
+    if (!pb3dInstanceInFrustum(modelIt->second, sub.model)) {
+        m_3dSubmissions.pop_back();
+        m_culledInstances++;
+        return;
+    }
+    sub.lod = pb3dSelectLod(modelIt->second, sub.model);
+
+    // View space depth of the instance origin (the view looks down -Z)
+    sub.depth = -(m_viewMatrix[2] * sub.model[12] + m_viewMatrix[6] * sub.model[13] +
+                  m_viewMatrix[10] * sub.model[14] + m_viewMatrix[14]);
+}
+
+// Draw everything submitted since the last flush.  Opaque meshes go first, grouped by shader,
+// texture and mesh so state changes are minimal and near meshes fill the depth buffer first;
+// runs of the same static mesh become one instanced draw.  Transparent meshes follow far to near.
+void PB3D::pb3dFlushQueue() {
+    if (m_3dSubmissions.empty()) return;
+    pb3dWaitSkelPoses();
+
+    // One item per mesh.  An instance destroyed since it was submitted is skipped.
+    m_3dDrawItems.clear();
+    for (unsigned int si = 0; si < (unsigned int)m_3dSubmissions.size(); si++) {
+        const st3DSubmission& sub = m_3dSubmissions[si];
+        auto instIt = m_3dInstanceList.find(sub.instanceId);
+        if (instIt == m_3dInstanceList.end()) continue;
+        auto modelIt = m_3dModelList.find(instIt->second.modelId);
+        if (modelIt == m_3dModelList.end()) continue;
+
+        for (const st3DMesh& mesh : modelIt->second.meshes) {
+            if (!pb3dMeshInFrustum(modelIt->second, mesh, sub.model)) continue;
+            st3DDrawItem item;
+            item.submission = si;
+            item.instance   = &instIt->second;
+            item.model      = &modelIt->second;
+            item.mesh       = &mesh;
+            item.vao        = mesh.vao;
+            item.textureId  = mesh.textureId;
+            unsigned int lod = std::min(sub.lod, mesh.lodCount - 1);
+            item.indexCount = mesh.lodIndexCount[lod];
+            item.firstIndex = mesh.lodFirstIndex[lod];
+            item.isSkinned  = mesh.isSkinned;
+            item.alpha      = sub.alpha * mesh.materialBaseAlpha;
+            item.blend      = (item.alpha < 1.0f) || mesh.needsBlend;
+            item.depth      = sub.depth;
+            m_3dDrawItems.push_back(item);
+        }
+    }
+
+    // Opaque items to the front
+    auto transparentStart = std::stable_partition(m_3dDrawItems.begin(), m_3dDrawItems.end(),
+        [](const st3DDrawItem& item) { return !item.blend; });
+    std::sort(m_3dDrawItems.begin(), transparentStart, [](const st3DDrawItem& a, const st3DDrawItem& b) {
+        if (a.isSkinned != b.isSkinned)   return !a.isSkinned;
+        if (a.textureId != b.textureId)   return a.textureId < b.textureId;
+        if (a.vao != b.vao)               return a.vao < b.vao;
+        if (a.firstIndex != b.firstIndex) return a.firstIndex < b.firstIndex;
+        return a.depth < b.depth;
+    });
+    std::stable_sort(transparentStart, m_3dDrawItems.end(), [](const st3DDrawItem& a, const st3DDrawItem& b) {
+        return a.depth > b.depth;
+    });
+
+    size_t opaqueCount = (size_t)(transparentStart - m_3dDrawItems.begin());
+    bool instancing = ogl3dInstancingAvailable();
+    ogl3dSetBlend(false);
+
+    size_t i = 0;
+    while (i < m_3dDrawItems.size()) {
+        const st3DDrawItem& item = m_3dDrawItems[i];
+        if (i == opaqueCount) ogl3dSetBlend(true);
+
+        // Run of the same static opaque mesh: one instanced draw
+        if (instancing && i < opaqueCount && !item.isSkinned) {
+            size_t runEnd = i + 1;
+            while (runEnd < opaqueCount && !m_3dDrawItems[runEnd].isSkinned &&
+                   m_3dDrawItems[runEnd].vao == item.vao && m_3dDrawItems[runEnd].textureId == item.textureId &&
+                   m_3dDrawItems[runEnd].firstIndex == item.firstIndex) {
+                runEnd++;
+            }
+            if (runEnd - i >= 2) {
+                m_3dInstanceMatrices.resize((runEnd - i) * 16);
+                for (size_t r = i; r < runEnd; r++) {
+                    memcpy(&m_3dInstanceMatrices[(r - i) * 16], m_3dSubmissions[m_3dDrawItems[r].submission].model, 16 * sizeof(float));
+                }
+                ogl3dDrawMeshInstanced(item.vao, item.textureId, item.indexCount, item.firstIndex,
+                                       m_3dInstanceMatrices.data(), (unsigned int)(runEnd - i));
+                i = runEnd;
+                continue;
+            }
+        }
+
+        const st3DSubmission& sub = m_3dSubmissions[item.submission];
+        const float* bones = nullptr;
+        int          boneCount = 0;
+        unsigned int paletteTex = 0;
+        if (item.isSkinned) pb3dPrepareInstanceBones(*item.instance, *item.model, bones, boneCount, paletteTex);
+
+        pb3dDrawInstanceMesh(*item.mesh, sub.model, sub.mvp, item.alpha, bones, boneCount, paletteTex, sub.lod);
+        i++;
+    }
+
+    ogl3dSetBlend(false);
+    m_3dSubmissions.clear();
+}
+
 void PB3D::pb3dRenderAll() {
     pb3dBegin();
     for (auto& pair : m_3dInstanceList) {
         if (pair.second.visible) {
-            pb3dRenderInstance(pair.first);
+            pb3dSubmitInstance(pair.first);
         }
     }
     pb3dEnd();
@@ -1655,6 +2819,9 @@ bool PB3D::pb3dCreateAnimation(st3DAnimateData anim, bool replaceExisting) {
 }
 
 bool PB3D::pb3dAnimateInstance(unsigned int instanceId, unsigned int currentTick) {
+    // Poses from the previous call must be finished before instance state is touched again
+    pb3dWaitSkelPoses();
+
     if (instanceId == 0) {
         // Update all active transform animations
         bool anyActive = false;
@@ -1664,17 +2831,49 @@ bool PB3D::pb3dAnimateInstance(unsigned int instanceId, unsigned int currentTick
                 anyActive = true;
             }
         }
-        // Update all active skeleton animations
+        // Advance all active skeleton animations here, then evaluate the poses on the worker pool
+        m_culledPoses = 0;
+        std::vector<st3DPoseJob> jobs;
         for (auto& pair : m_3dInstanceList) {
             st3DInstance& inst = pair.second;
             if (inst.skelState.isPlaying) {
                 auto modelIt = m_3dModelList.find(inst.modelId);
                 if (modelIt != m_3dModelList.end() && modelIt->second.hasSkeleton) {
-                    pb3dUpdateSkelState(inst, modelIt->second.skeleton, currentTick);
+                    const st3DSkeleton& skel = modelIt->second.skeleton;
+                    st3DSkelState& ss = inst.skelState;
+                    if (ss.clipIndex < 0 || ss.clipIndex >= (int)skel.clips.size()) continue;
+                    pb3dAdvanceSkelTime(ss, skel, currentTick);
                     anyActive = true;
+                    if (pb3dSkipCulledPose(inst, modelIt->second)) continue;
+                    jobs.push_back({ &ss, &skel, &skel.clips[ss.clipIndex] });
                 }
             }
         }
+
+        // A single pose is not worth a thread hand-off
+        if (!m_poseParallel || jobs.size() < 2) {
+            for (const auto& job : jobs) pb3dEvalPoseJob(job);
+            return anyActive;
+        }
+
+        if (m_poseWorkers.empty()) {
+            unsigned int threadCount = std::thread::hardware_concurrency();
+            threadCount = (threadCount > 1) ? threadCount - 1 : 1;
+            if (threadCount > PB3D_POSE_THREADS) threadCount = PB3D_POSE_THREADS;
+            m_poseShutdown = false;
+            for (unsigned int i = 0; i < threadCount; i++) {
+                m_poseWorkers.emplace_back(&PB3D::pb3dPoseWorker, this);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_poseMutex);
+            m_poseJobs.swap(jobs);
+            m_poseNextJob = 0;
+            m_poseJobsDone = 0;
+        }
+        m_poseCondition.notify_all();
+        m_posePending = true;
         return anyActive;
     }
 
@@ -1692,7 +2891,14 @@ bool PB3D::pb3dAnimateInstance(unsigned int instanceId, unsigned int currentTick
     if (instIt != m_3dInstanceList.end() && instIt->second.skelState.isPlaying) {
         auto modelIt = m_3dModelList.find(instIt->second.modelId);
         if (modelIt != m_3dModelList.end() && modelIt->second.hasSkeleton) {
-            pb3dUpdateSkelState(instIt->second, modelIt->second.skeleton, currentTick);
+            st3DSkelState& ss = instIt->second.skelState;
+            const st3DSkeleton& skel = modelIt->second.skeleton;
+            if (ss.clipIndex >= 0 && ss.clipIndex < (int)skel.clips.size()) {
+                pb3dAdvanceSkelTime(ss, skel, currentTick);
+                if (!pb3dSkipCulledPose(instIt->second, modelIt->second)) {
+                    pb3dEvalPoseJob({ &ss, &skel, &skel.clips[ss.clipIndex] });
+                }
+            }
             anyActive = true;
         }
     }
@@ -2015,6 +3221,7 @@ bool PB3D::pb3dPlayAnimClip(unsigned int instanceId, const std::string& clipName
 }
 
 bool PB3D::pb3dPlayAnimClip(unsigned int instanceId, int clipIndex, bool loop) {
+    pb3dWaitSkelPoses();
     auto instIt = m_3dInstanceList.find(instanceId);
     if (instIt == m_3dInstanceList.end()) return false;
     auto modelIt = m_3dModelList.find(instIt->second.modelId);
@@ -2027,12 +3234,14 @@ bool PB3D::pb3dPlayAnimClip(unsigned int instanceId, int clipIndex, bool loop) {
     ss.looping        = loop;
     ss.isPlaying      = true;
     ss.lastUpdateTick = 0;
+    ss.channelCursors.assign(modelIt->second.skeleton.clips[clipIndex].channels.size(), 0);
     // Compute initial bone matrices for time 0
     pb3dUpdateSkelState(instIt->second, modelIt->second.skeleton, 0);
     return true;
 }
 
 bool PB3D::pb3dStopAnimClip(unsigned int instanceId) {
+    pb3dWaitSkelPoses();
     auto instIt = m_3dInstanceList.find(instanceId);
     if (instIt == m_3dInstanceList.end()) return false;
     st3DSkelState& ss = instIt->second.skelState;
@@ -2055,6 +3264,7 @@ float PB3D::pb3dGetAnimClipTime(unsigned int instanceId) const {
 }
 
 bool PB3D::pb3dSetAnimClipTime(unsigned int instanceId, float timeSec) {
+    pb3dWaitSkelPoses();
     auto instIt = m_3dInstanceList.find(instanceId);
     if (instIt == m_3dInstanceList.end()) return false;
     auto modelIt = m_3dModelList.find(instIt->second.modelId);
@@ -2064,6 +3274,67 @@ bool PB3D::pb3dSetAnimClipTime(unsigned int instanceId, float timeSec) {
     return true;
 }
 
+unsigned long PB3D::pb3dBakeAnimClips(unsigned int modelId, float sampleRate) {
+    auto modelIt = m_3dModelList.find(modelId);
+    if (modelIt == m_3dModelList.end() || !modelIt->second.hasSkeleton || sampleRate <= 0.0f) return 0;
+
+    // Running pose jobs hold pointers into the clips being rewritten
+    pb3dWaitSkelPoses();
+
+    st3DSkeleton& skel = modelIt->second.skeleton;
+    unsigned int boneCount = (unsigned int)std::min(skel.paletteBoneCount, PB3D_MAX_BONES);
+    std::vector<float> pose(PB3D_MAX_BONES * 16);
+    unsigned long totalBytes = 0;
+
+    for (auto& clip : skel.clips) {
+        unsigned int frameCount = (unsigned int)ceilf(clip.duration * sampleRate) + 1;
+        if (frameCount < 2) frameCount = 2;
+
+        clip.bakedRate = 0.0f;  // sample live while baking
+        clip.bakedPalettes.assign((size_t)frameCount * boneCount * 12, 0.0f);
+        for (unsigned int f = 0; f < frameCount; f++) {
+            float time = std::min((float)f / sampleRate, clip.duration);
+            pb3dComputeBoneMatrices(skel, clip, time, pose.data(), nullptr);
+            float* dst = &clip.bakedPalettes[(size_t)f * boneCount * 12];
+            for (unsigned int bi = 0; bi < boneCount; bi++) {
+                const float* m = &pose[bi * 16];
+                for (int col = 0; col < 4; col++) {
+                    dst[bi*12 + col*3 + 0] = m[col*4 + 0];
+                    dst[bi*12 + col*3 + 1] = m[col*4 + 1];
+                    dst[bi*12 + col*3 + 2] = m[col*4 + 2];
+                }
+            }
+        }
+        clip.bakedRate       = sampleRate;
+        clip.bakedFrameCount = frameCount;
+        clip.bakedBoneCount  = boneCount;
+        totalBytes += clip.bakedPalettes.size() * sizeof(float);
+    }
+
+    pb3dSendConsole("3D: baked " + std::to_string(skel.clips.size()) + " clip(s) at " +
+                    std::to_string((int)sampleRate) + " fps, " + std::to_string(totalBytes / 1024) + " KB", true);
+    return totalBytes;
+}
+
+void PB3D::pb3dUnbakeAnimClips(unsigned int modelId) {
+    auto modelIt = m_3dModelList.find(modelId);
+    if (modelIt == m_3dModelList.end()) return;
+
+    pb3dWaitSkelPoses();
+    for (auto& clip : modelIt->second.skeleton.clips) {
+        clip.bakedRate       = 0.0f;
+        clip.bakedFrameCount = 0;
+        clip.bakedBoneCount  = 0;
+        std::vector<float>().swap(clip.bakedPalettes);
+    }
+    // Cursors were not maintained while baked - restart them from the first interval
+    for (auto& pair : m_3dInstanceList) {
+        if (pair.second.modelId == modelId) {
+            std::fill(pair.second.skelState.channelCursors.begin(), pair.second.skelState.channelCursors.end(), 0);
+        }
+    }
+}
+
 // ============================================================================
 // Skeleton Animation Internal Helpers
 // ============================================================================
@@ -2074,6 +3345,12 @@ void PB3D::pb3dUpdateSkelState(st3DInstance& inst, const st3DSkeleton& skel, uns
     st3DSkelState& ss = inst.skelState;
     if (!ss.isPlaying || ss.clipIndex < 0 || ss.clipIndex >= (int)skel.clips.size()) return;
 
+    pb3dAdvanceSkelTime(ss, skel, currentTick);
+    pb3dEvalPoseJob({ &ss, &skel, &skel.clips[ss.clipIndex] });
+}
+
+// Advance playback time (and handle looping / end of clip).  Always runs on the main thread.
+void PB3D::pb3dAdvanceSkelTime(st3DSkelState& ss, const st3DSkeleton& skel, unsigned int currentTick) {
     // Advance time if currentTick is valid
     if (currentTick > 0 && ss.lastUpdateTick > 0 && currentTick > ss.lastUpdateTick) {
         float dt = (currentTick - ss.lastUpdateTick) / 1000.0f;
@@ -2089,174 +3366,271 @@ void PB3D::pb3dUpdateSkelState(st3DInstance& inst, const st3DSkeleton& skel, uns
         }
     }
     ss.lastUpdateTick = currentTick;
+}
 
-    pb3dComputeBoneMatrices(skel, skel.clips[ss.clipIndex], ss.currentTime, ss.boneMatrices.data());
+// Evaluate one instance's pose.  Safe on any thread: reads the shared skeleton and writes only to
+// the instance's own bone matrices and keyframe cursors.
+void PB3D::pb3dEvalPoseJob(const st3DPoseJob& job) {
+    st3DSkelState& ss = *job.skelState;
+    if (job.clip->bakedRate > 0.0f) {
+        pb3dSampleBakedClip(*job.clip, ss.currentTime, ss.boneMatrices.data());
+    } else {
+        unsigned int* cursors = (ss.channelCursors.size() == job.clip->channels.size()) ? ss.channelCursors.data() : nullptr;
+        pb3dComputeBoneMatrices(*job.skeleton, *job.clip, ss.currentTime, ss.boneMatrices.data(), cursors);
+    }
+
+    // Pack the top three rows of each matrix for the palette texture (done here so it runs on the workers).
+    // Only bones referenced by vertices are packed.
+    int numBones = std::min(job.skeleton->paletteBoneCount, PB3D_MAX_BONES);
+    ss.bonePalette.resize((size_t)numBones * 12);
+    for (int bi = 0; bi < numBones; bi++) {
+        const float* m = &ss.boneMatrices[bi * 16];
+        float* row = &ss.bonePalette[bi * 12];
+        row[0] = m[0]; row[1] = m[4]; row[2]  = m[8];  row[3]  = m[12];
+        row[4] = m[1]; row[5] = m[5]; row[6]  = m[9];  row[7]  = m[13];
+        row[8] = m[2]; row[9] = m[6]; row[10] = m[10]; row[11] = m[14];
+    }
+    ss.poseVersion++;
+    ss.poseStale = false;
+}
+
+// Blend the two baked palettes either side of time and expand them back to 4×4 skinning matrices
+void PB3D::pb3dSampleBakedClip(const st3DAnimClip& clip, float time, float* outMatrices) {
+    float position = std::max(time, 0.0f) * clip.bakedRate;
+    unsigned int frame = (unsigned int)position;
+    float t = position - (float)frame;
+    if (frame >= clip.bakedFrameCount - 1) {
+        frame = clip.bakedFrameCount - 2;
+        t = 1.0f;
+    }
+
+    size_t paletteSize = (size_t)clip.bakedBoneCount * 12;
+    const float* p0 = &clip.bakedPalettes[frame * paletteSize];
+    const float* p1 = p0 + paletteSize;
+    for (unsigned int bi = 0; bi < clip.bakedBoneCount; bi++) {
+        float* m = outMatrices + bi * 16;
+        for (int col = 0; col < 4; col++) {
+            const float* a = p0 + bi*12 + col*3;
+            const float* b = p1 + bi*12 + col*3;
+            m[col*4 + 0] = a[0] + (b[0] - a[0]) * t;
+            m[col*4 + 1] = a[1] + (b[1] - a[1]) * t;
+            m[col*4 + 2] = a[2] + (b[2] - a[2]) * t;
+            m[col*4 + 3] = (col == 3) ? 1.0f : 0.0f;
+        }
+    }
+}
+
+// Worker thread - claims pose jobs one at a time until the batch is empty, then sleeps.
+// Makes no GL calls.
+void PB3D::pb3dPoseWorker() {
+    std::unique_lock<std::mutex> lock(m_poseMutex);
+    while (true) {
+        m_poseCondition.wait(lock, [this] { return (m_poseShutdown || m_poseNextJob < m_poseJobs.size()); });
+        if (m_poseShutdown) return;
+
+        size_t index = m_poseNextJob++;
+        lock.unlock();
+        pb3dEvalPoseJob(m_poseJobs[index]);
+        lock.lock();
+
+        if (++m_poseJobsDone == m_poseJobs.size()) m_poseDoneCondition.notify_all();
+    }
+}
+
+// Block until every dispatched pose is finished.  The calling thread works through any jobs the
+// workers have not claimed yet rather than sitting idle.
+void PB3D::pb3dWaitSkelPoses() {
+    if (!m_posePending) return;
+
+    std::unique_lock<std::mutex> lock(m_poseMutex);
+    while (m_poseNextJob < m_poseJobs.size()) {
+        size_t index = m_poseNextJob++;
+        lock.unlock();
+        pb3dEvalPoseJob(m_poseJobs[index]);
+        lock.lock();
+        ++m_poseJobsDone;
+    }
+    m_poseDoneCondition.wait(lock, [this] { return (m_poseJobsDone == m_poseJobs.size()); });
+    m_posePending = false;
+}
+
+void PB3D::pb3dSetParallelPoses(bool enable) {
+    pb3dWaitSkelPoses();
+    m_poseParallel = enable;
+}
+
+// Stop and join the pose workers
+void PB3D::pb3dShutdownPoseWorkers() {
+    if (m_poseWorkers.empty()) return;
+
+    pb3dWaitSkelPoses();
+    {
+        std::lock_guard<std::mutex> lock(m_poseMutex);
+        m_poseShutdown = true;
+    }
+    m_poseCondition.notify_all();
+
+    for (auto& worker : m_poseWorkers) {
+        if (worker.joinable()) worker.join();
+    }
+    m_poseWorkers.clear();
 }
 
 // Evaluate a single animation channel at the given time; writes 3 or 4 floats to out[].
-void PB3D::pb3dSkelEvalChannel(const st3DAnimChannel& ch, float time, float out[4]) {
-    if (ch.keyframes.empty()) {
+// cursor (may be nullptr) holds the keyframe interval found last time.  During forward playback the
+// new time is almost always in the same or the next interval, so the lookup is amortised O(1);
+// anything else (seeks, loop wrap) falls back to a binary search over the packed times[].
+void PB3D::pb3dSkelEvalChannel(const st3DAnimChannel& ch, float time, float out[4], unsigned int* cursor) {
+    size_t keyCount = ch.times.size();
+    if (keyCount == 0) {
         out[0] = out[1] = out[2] = 0.0f; out[3] = 1.0f;
         return;
     }
 
     // Clamp to first / last keyframe
-    if (time <= ch.keyframes.front().time) {
-        memcpy(out, ch.keyframes.front().value, sizeof(float) * 4);
+    if (time <= ch.times[0]) {
+        memcpy(out, &ch.values[0], sizeof(float) * 4);
+        if (cursor) *cursor = 0;
         return;
     }
-    if (time >= ch.keyframes.back().time) {
-        memcpy(out, ch.keyframes.back().value, sizeof(float) * 4);
+    if (time >= ch.times[keyCount - 1]) {
+        memcpy(out, &ch.values[(keyCount - 1) * 4], sizeof(float) * 4);
+        if (cursor) *cursor = (unsigned int)(keyCount - 1);
         return;
     }
 
-    // Find surrounding keyframes (linear search; typical clips have few keyframes per bone)
-    size_t k = 0;
-    while (k + 1 < ch.keyframes.size() && ch.keyframes[k + 1].time <= time) k++;
+    // Find k such that times[k] <= time < times[k + 1]
+    size_t k = cursor ? *cursor : 0;
+    if (cursor && k + 1 < keyCount && ch.times[k] <= time && time < ch.times[k + 1]) {
+        // Same interval as last frame
+    } else if (cursor && k + 2 < keyCount && ch.times[k + 1] <= time && time < ch.times[k + 2]) {
+        k++;
+    } else {
+        const float* first = ch.times.data();
+        k = (size_t)(std::upper_bound(first, first + keyCount, time) - first) - 1;
+    }
+    if (cursor) *cursor = (unsigned int)k;
 
-    const st3DAnimKeyframe& kf0 = ch.keyframes[k];
-    const st3DAnimKeyframe& kf1 = ch.keyframes[k + 1];
-    float span = kf1.time - kf0.time;
-    float t    = (span > 1e-8f) ? (time - kf0.time) / span : 0.0f;
+    const float* v0 = &ch.values[k * 4];
+    const float* v1 = &ch.values[(k + 1) * 4];
+    float span = ch.times[k + 1] - ch.times[k];
+    float t    = (span > 1e-8f) ? (time - ch.times[k]) / span : 0.0f;
 
     if (ch.interpolation == ANIM_INTERP_STEP) {
-        memcpy(out, kf0.value, sizeof(float) * 4);
+        memcpy(out, v0, sizeof(float) * 4);
     } else if (ch.type == ANIM_CHANNEL_ROTATION) {
-        pb3dSkelSlerpQuat(kf0.value, kf1.value, t, out);
+        pb3dSkelSlerpQuat(v0, v1, t, out);
     } else {
         // LINEAR translation or scale
-        out[0] = pb3dSkelInterpolateFloat(kf0.value[0], kf1.value[0], t);
-        out[1] = pb3dSkelInterpolateFloat(kf0.value[1], kf1.value[1], t);
-        out[2] = pb3dSkelInterpolateFloat(kf0.value[2], kf1.value[2], t);
+        out[0] = pb3dSkelInterpolateFloat(v0[0], v1[0], t);
+        out[1] = pb3dSkelInterpolateFloat(v0[1], v1[1], t);
+        out[2] = pb3dSkelInterpolateFloat(v0[2], v1[2], t);
         out[3] = 0.0f;
     }
 }
 
+// Build the bone -> channel lookup so pose evaluation does not scan every channel for every bone.
+// If a clip has several channels for the same bone and property the last one wins, as before.
+void PB3D::pb3dSkelIndexClipChannels(st3DAnimClip& clip, int numBones) {
+    clip.boneChannels.assign((size_t)numBones * 3, -1);
+    for (size_t ci = 0; ci < clip.channels.size(); ci++) {
+        int bi = clip.channels[ci].boneIndex;
+        if (bi < 0 || bi >= numBones) continue;
+        clip.boneChannels[(size_t)bi * 3 + (int)clip.channels[ci].type] = (int)ci;
+    }
+}
+
+// Build a synthetic skeleton for the pose evaluation benchmark: a single chain of numBones bones with
+// translation, rotation and scale channels on every bone, each with keysPerChannel evenly spaced keys.
+void PB3D::pb3dBuildBenchSkeleton(st3DSkeleton& skel, int numBones, int keysPerChannel, float duration) {
+    if (numBones > PB3D_MAX_BONES) numBones = PB3D_MAX_BONES;
+    if (keysPerChannel < 2) keysPerChannel = 2;
+
+    skel.bones.clear();
+    skel.clips.clear();
+    skel.skinCount = 0;
+    skel.paletteBoneCount = numBones;
+
+    static const float identity[16] = { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 };
+    for (int bi = 0; bi < numBones; bi++) {
+        st3DBone bone;
+        bone.name        = "bench_" + std::to_string(bi);
+        bone.parentIndex = bi - 1;
+        bone.skinIndex   = -1;
+        memcpy(bone.inverseBindMatrix,  identity, sizeof(identity));
+        memcpy(bone.parentOffsetMatrix, identity, sizeof(identity));
+        bone.restTranslation[0] = 0.0f; bone.restTranslation[1] = 0.01f; bone.restTranslation[2] = 0.0f;
+        bone.restRotation[0] = bone.restRotation[1] = bone.restRotation[2] = 0.0f; bone.restRotation[3] = 1.0f;
+        bone.restScale[0] = bone.restScale[1] = bone.restScale[2] = 1.0f;
+        skel.bones.push_back(bone);
+    }
+
+    st3DAnimClip clip;
+    clip.name     = "bench";
+    clip.duration = duration;
+    clip.bakedRate       = 0.0f;
+    clip.bakedFrameCount = 0;
+    clip.bakedBoneCount  = 0;
+    for (int bi = 0; bi < numBones; bi++) {
+        for (int type = ANIM_CHANNEL_TRANSLATION; type <= ANIM_CHANNEL_SCALE; type++) {
+            st3DAnimChannel channel;
+            channel.boneIndex     = bi;
+            channel.type          = (e3DAnimChannelType)type;
+            channel.interpolation = ANIM_INTERP_LINEAR;
+            channel.times.resize(keysPerChannel);
+            channel.values.assign((size_t)keysPerChannel * 4, 0.0f);
+            for (int ki = 0; ki < keysPerChannel; ki++) {
+                float phase = (float)ki / (float)(keysPerChannel - 1);
+                float* v    = &channel.values[(size_t)ki * 4];
+                channel.times[ki] = phase * duration;
+                if (type == ANIM_CHANNEL_ROTATION) {
+                    float half = 0.25f * sinf(phase * 6.2831853f + bi * 0.1f);
+                    v[2] = sinf(half);
+                    v[3] = cosf(half);
+                } else if (type == ANIM_CHANNEL_SCALE) {
+                    v[0] = v[1] = v[2] = 1.0f + 0.05f * sinf(phase * 6.2831853f);
+                } else {
+                    v[1] = 0.01f + 0.002f * sinf(phase * 6.2831853f);
+                }
+            }
+            clip.channels.push_back(channel);
+        }
+    }
+    pb3dSkelIndexClipChannels(clip, numBones);
+    skel.clips.push_back(clip);
+}
+
 float PB3D::pb3dSkelInterpolateFloat(float a, float b, float t) {
     return a + (b - a) * t;
 }
 
-// Spherical linear interpolation for unit quaternions (xyzw).
+// Spherical linear interpolation for unit quaternions (xyzw), shortest arc.
 void PB3D::pb3dSkelSlerpQuat(const float qa[4], const float qb[4], float t, float out[4]) {
-    float dot = qa[0]*qb[0] + qa[1]*qb[1] + qa[2]*qb[2] + qa[3]*qb[3];
-    float qb2[4] = {qb[0], qb[1], qb[2], qb[3]};
-    if (dot < 0.0f) {
-        // Flip qb to take the shorter arc
-        dot = -dot;
-        qb2[0] = -qb2[0]; qb2[1] = -qb2[1]; qb2[2] = -qb2[2]; qb2[3] = -qb2[3];
-    }
-    if (dot > 0.9995f) {
-        // Quaternions nearly identical — linear lerp to avoid division by zero
-        out[0] = qa[0] + t*(qb2[0]-qa[0]);
-        out[1] = qa[1] + t*(qb2[1]-qa[1]);
-        out[2] = qa[2] + t*(qb2[2]-qa[2]);
-        out[3] = qa[3] + t*(qb2[3]-qa[3]);
-        float len = sqrtf(out[0]*out[0]+out[1]*out[1]+out[2]*out[2]+out[3]*out[3]);
-        if (len > 1e-8f) { out[0]/=len; out[1]/=len; out[2]/=len; out[3]/=len; }
-        return;
-    }
-    float theta0 = acosf(dot);
-    float theta  = theta0 * t;
-    float sinT0  = sinf(theta0);
-    float sinT   = sinf(theta);
-    float s0 = cosf(theta) - dot * sinT / sinT0;
-    float s1 = sinT / sinT0;
-    out[0] = s0*qa[0] + s1*qb2[0];
-    out[1] = s0*qa[1] + s1*qb2[1];
-    out[2] = s0*qa[2] + s1*qb2[2];
-    out[3] = s0*qa[3] + s1*qb2[3];
+    pb3dMathQuatSlerp(qa, qb, t, out);
 }
 
 // Build a 4×4 matrix (column-major) from TRS components.
 // Quaternion rotation is in xyzw order.
 void PB3D::pb3dMat4FromTRS(const float t[3], const float r[4], const float s[3], float out[16]) {
-    float qx = r[0], qy = r[1], qz = r[2], qw = r[3];
-    float x2 = qx+qx, y2 = qy+qy, z2 = qz+qz;
-    float xx = qx*x2, xy = qx*y2, xz = qx*z2;
-    float yy = qy*y2, yz = qy*z2, zz = qz*z2;
-    float wx = qw*x2, wy = qw*y2, wz = qw*z2;
-
-    // Column 0
-    out[0]  = (1.0f - (yy+zz)) * s[0];
-    out[1]  = (xy + wz)         * s[0];
-    out[2]  = (xz - wy)         * s[0];
-    out[3]  = 0.0f;
-    // Column 1
-    out[4]  = (xy - wz)         * s[1];
-    out[5]  = (1.0f - (xx+zz)) * s[1];
-    out[6]  = (yz + wx)         * s[1];
-    out[7]  = 0.0f;
-    // Column 2
-    out[8]  = (xz + wy)         * s[2];
-    out[9]  = (yz - wx)         * s[2];
-    out[10] = (1.0f - (xx+yy)) * s[2];
-    out[11] = 0.0f;
-    // Column 3
-    out[12] = t[0];
-    out[13] = t[1];
-    out[14] = t[2];
-    out[15] = 1.0f;
+    pb3dMathMat4FromTRS(t, r, s, out);
 }
 
 // Multiply two column-major 4×4 matrices: out = a * b
 void PB3D::pb3dMat4Mul(const float a[16], const float b[16], float out[16]) {
-    for (int col = 0; col < 4; col++) {
-        for (int row = 0; row < 4; row++) {
-            out[col*4+row] = a[0*4+row]*b[col*4+0]
-                           + a[1*4+row]*b[col*4+1]
-                           + a[2*4+row]*b[col*4+2]
-                           + a[3*4+row]*b[col*4+3];
-        }
-    }
+    pb3dMathMat4Mul(a, b, out);
 }
 
 // Invert an affine 4×4 matrix (column-major).
 // Works for any combination of rotation, scale, and translation (non-singular 3×3 part).
 // Returns false if the matrix is singular (det ≈ 0).
 bool PB3D::pb3dMat4InvertAffine(const float m[16], float out[16]) {
-    // Extract 3×3 upper-left (column-major: col0=[0,1,2], col1=[4,5,6], col2=[8,9,10])
-    float a00 = m[0], a01 = m[4], a02 = m[8];
-    float a10 = m[1], a11 = m[5], a12 = m[9];
-    float a20 = m[2], a21 = m[6], a22 = m[10];
-    float tx  = m[12], ty = m[13], tz = m[14];
-
-    // Cofactors for 3×3 inverse
-    float c00 = a11*a22 - a12*a21;
-    float c01 = a12*a20 - a10*a22;
-    float c02 = a10*a21 - a11*a20;
-    float c10 = a02*a21 - a01*a22;
-    float c11 = a00*a22 - a02*a20;
-    float c12 = a01*a20 - a00*a21;
-    float c20 = a01*a12 - a02*a11;
-    float c21 = a02*a10 - a00*a12;
-    float c22 = a00*a11 - a01*a10;
-
-    float det = a00*c00 + a01*c01 + a02*c02;
-    if (fabsf(det) < 1e-12f) return false;
-    float invDet = 1.0f / det;
-
-    // inv(A) = cofactorMatrix^T / det  (note: cofactors above are already transposed)
-    float i00 = c00*invDet, i01 = c10*invDet, i02 = c20*invDet;
-    float i10 = c01*invDet, i11 = c11*invDet, i12 = c21*invDet;
-    float i20 = c02*invDet, i21 = c12*invDet, i22 = c22*invDet;
-
-    // Translation: -inv(A) * t
-    float itx = -(i00*tx + i01*ty + i02*tz);
-    float ity = -(i10*tx + i11*ty + i12*tz);
-    float itz = -(i20*tx + i21*ty + i22*tz);
-
-    // Column-major output
-    out[0]  = i00;  out[1]  = i10;  out[2]  = i20;  out[3]  = 0.0f;
-    out[4]  = i01;  out[5]  = i11;  out[6]  = i21;  out[7]  = 0.0f;
-    out[8]  = i02;  out[9]  = i12;  out[10] = i22;  out[11] = 0.0f;
-    out[12] = itx;  out[13] = ity;  out[14] = itz;  out[15] = 1.0f;
-    return true;
+    return pb3dMathMat4InvertAffine(m, out);
 }
 
 // Compute final skinning matrices for all bones in a clip at a given time.
 // outMatrices is laid out as [bone0_mat16, bone1_mat16, ...] column-major.
 void PB3D::pb3dComputeBoneMatrices(const st3DSkeleton& skel, const st3DAnimClip& clip,
-                                    float time, float* outMatrices) {
+                                    float time, float* outMatrices, unsigned int* channelCursors) {
     int numBones = (int)skel.bones.size();
     if (numBones > PB3D_MAX_BONES) numBones = PB3D_MAX_BONES;
 
@@ -2268,7 +3642,7 @@ void PB3D::pb3dComputeBoneMatrices(const st3DSkeleton& skel, const st3DAnimClip&
     memset(worldMatrices, 0, sizeof(worldMatrices));
 
     // Evaluate each bone's animated TRS (fall back to rest pose if no channel)
-    // (For small bone counts a linear search per bone is fast enough)
+    bool indexed = (clip.boneChannels.size() >= (size_t)numBones * 3);
     for (int bi = 0; bi < numBones; bi++) {
         const st3DBone& bone = skel.bones[bi];
         float T[3], R[4], S[3];
@@ -2279,11 +3653,21 @@ void PB3D::pb3dComputeBoneMatrices(const st3DSkeleton& skel, const st3DAnimClip&
         memcpy(S, bone.restScale,       12);
 
         // Override with animation channels if present
-        for (const auto& ch : clip.channels) {
-            if (ch.boneIndex != bi) continue;
+        for (int type = ANIM_CHANNEL_TRANSLATION; type <= ANIM_CHANNEL_SCALE; type++) {
+            int ci = -1;
+            if (indexed) {
+                ci = clip.boneChannels[(size_t)bi * 3 + type];
+            } else {
+                // Clip built without an index - scan (last matching channel wins)
+                for (size_t c = 0; c < clip.channels.size(); c++) {
+                    if (clip.channels[c].boneIndex == bi && clip.channels[c].type == type) ci = (int)c;
+                }
+            }
+            if (ci < 0) continue;
+
             float val[4] = {0,0,0,1};
-            pb3dSkelEvalChannel(ch, time, val);
-            switch (ch.type) {
+            pb3dSkelEvalChannel(clip.channels[ci], time, val, channelCursors ? &channelCursors[ci] : nullptr);
+            switch (type) {
                 case ANIM_CHANNEL_TRANSLATION:
                     T[0]=val[0]; T[1]=val[1]; T[2]=val[2]; break;
                 case ANIM_CHANNEL_ROTATION:
@@ -2341,20 +3725,16 @@ void PB3D::pb3dComputeBoneMatrices(const st3DSkeleton& skel, const st3DAnimClip&
     //   - Root bones (parent<0): parentWorldMatrix = identity, so worldMatrix = parentOffsetMatrix × localTRS
     //   - Non-root bones: parentOffsetMatrix accounts for any non-joint nodes between parent and
     //     this bone (identity for normal bones; clavicle-local-TRS for arm roots etc.)
-    float tmp16[16];  // scratch for intermediate multiply
+    // The offset is folded into the local matrix first (independent per bone), leaving a single
+    // dependent multiply per bone for the batched hierarchy kernel.
+    int topoParent[PB3D_MAX_BONES];
     for (int ti = 0; ti < topoCount; ti++) {
         int bi     = topoOrder[ti];
         int parent = skel.bones[bi].parentIndex;
-        if (parent < 0 || parent >= numBones) {
-            // Root: worldMatrix = parentOffsetMatrix × localTRS
-            pb3dMat4Mul(skel.bones[bi].parentOffsetMatrix, localMatrices + bi*16,
-                        worldMatrices + bi*16);
-        } else {
-            // Non-root: worldMatrix = worldMatrix[parent] × parentOffsetMatrix × localTRS
-            pb3dMat4Mul(worldMatrices + parent*16, skel.bones[bi].parentOffsetMatrix, tmp16);
-            pb3dMat4Mul(tmp16, localMatrices + bi*16, worldMatrices + bi*16);
-        }
+        topoParent[ti] = (parent < 0 || parent >= numBones) ? -1 : parent;
+        pb3dMathMat4Mul(skel.bones[bi].parentOffsetMatrix, localMatrices + bi*16, localMatrices + bi*16);
     }
+    pb3dMathConcatHierarchy(topoOrder, topoParent, topoCount, localMatrices, worldMatrices);
 
     // Skinning matrix = meshNodeGlobalInv[skinIndex] × worldMatrix × IBM
     // glTF spec: IBM = inv(jointWorldBind) × meshNodeWorldBind, so
@@ -14,6 +14,9 @@
 #include <set>
 #include <vector>
 #include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 // Maximum bones per skinned mesh uploaded to the GPU shader.
 // Must match the uBones[] array size declared in vertexShader3DSkinnedSource.
@@ -23,8 +26,32 @@
 // 2048 vectors / 4 = 512 bones as a safe cross-platform maximum.
 // pb3dInit() queries the actual hardware value at startup and logs a warning if
 // PB3D_MAX_BONES exceeds what the current GPU can support.
+// When the skinned shader uses bone palette textures (the default where supported) the uniform
+// budget no longer applies; the palette only needs one texture row per bone.
 #define PB3D_MAX_BONES 512
 
+// Maximum worker threads used to evaluate skeleton poses (the main thread also helps when it has to wait)
+#define PB3D_POSE_THREADS 3
+
+// Default sample rate (frames per second) for pb3dBakeAnimClips
+#define PB3D_BAKE_DEFAULT_RATE 30.0f
+
+// Submissions the render queue holds before pb3dSubmitInstance flushes it early
+#define PB3D_RENDER_QUEUE_MAX 1024
+
+// Skinned meshes are culled against their bind-pose bounds scaled by this factor, since animated
+// vertices can move outside them.  Errs towards drawing.
+#define PB3D_SKINNED_BOUNDS_SCALE 2.0f
+
+// Detail levels per mesh (level 0 is the full mesh).  Simplified levels are only built when a model
+// is loaded with lodLevels > 1, for meshes of at least PB3D_LOD_MIN_TRIANGLES triangles.
+#define PB3D_MAX_LODS          3
+#define PB3D_LOD_MIN_TRIANGLES 256
+
+// Default on-screen radius (pixels) of a model's bounding sphere below which LOD 1 and LOD 2 are drawn
+#define PB3D_LOD1_PIXEL_RADIUS 120.0f
+#define PB3D_LOD2_PIXEL_RADIUS 48.0f
+
 // Path for 3D model resources
 #define PB3D_MODEL_PATH "src/user/resources/3d/"
 
@@ -46,18 +73,15 @@ enum e3DAnimChannelType {
     ANIM_CHANNEL_SCALE       = 2
 };
 
-// A single keyframe value: xyz0 for translation/scale, xyzw quaternion for rotation
-struct st3DAnimKeyframe {
-    float time;      // seconds from start of clip
-    float value[4];  // translation: xyz0  |  rotation: xyzw quat  |  scale: xyz0
-};
-
-// One animation channel drives a single property on a single bone
+// One animation channel drives a single property on a single bone.
+// Keyframes are stored structure-of-arrays: the key search only touches the packed times[] array,
+// values[] holds 4 floats per key (translation: xyz0  |  rotation: xyzw quat  |  scale: xyz0).
 struct st3DAnimChannel {
     int boneIndex;
     e3DAnimChannelType type;
     e3DInterpolationType interpolation;
-    std::vector<st3DAnimKeyframe> keyframes;
+    std::vector<float> times;    // seconds from start of clip, ascending
+    std::vector<float> values;   // 4 floats per keyframe
 };
 
 // One named animation clip (corresponds to one glTF animation)
@@ -65,6 +89,13 @@ struct st3DAnimClip {
     std::string name;
     float duration;   // seconds (max input sampler time)
     std::vector<st3DAnimChannel> channels;
+    std::vector<int> boneChannels;  // [boneIndex * 3 + e3DAnimChannelType] -> index into channels, -1 = none
+    // Baked playback (pb3dBakeAnimClips): skinning palettes sampled at bakedRate, stored as the top
+    // three rows of each matrix (12 floats per bone).  bakedRate = 0 means the clip is evaluated live.
+    float bakedRate;
+    unsigned int bakedFrameCount;
+    unsigned int bakedBoneCount;
+    std::vector<float> bakedPalettes;
 };
 
 // One bone in the skeleton hierarchy
@@ -92,6 +123,8 @@ struct st3DSkeleton {
     std::vector<st3DBone>    bones;
     std::vector<st3DAnimClip> clips;
     int    skinCount;                                     // number of skins in this model
+    int    paletteBoneCount;                              // bones referenced by vertex joints, uploaded to the GPU;
+                                                          // later bones (removed by a bone list, virtual) only feed the hierarchy
     float  meshNodeGlobalInv[PB3D_MAX_SKINS][16];         // inv(meshNodeWorldTransform) per skin
 };
 
@@ -102,6 +135,12 @@ struct st3DSkelState {
     bool  looping;
     bool  isPlaying;
     unsigned int lastUpdateTick;                   // millisecond tick of last update
+    std::vector<unsigned int> channelCursors;      // last keyframe interval sampled per channel of the playing clip
+    std::vector<float> bonePalette;                // bone matrices packed as 4×3 rows (12 floats per bone) for the palette texture
+    unsigned int paletteTexture;                   // GPU bone palette, 0 = not created yet
+    unsigned int poseVersion;                      // bumped every time the bone matrices are recomputed
+    unsigned int uploadedVersion;                  // poseVersion last uploaded to paletteTexture
+    bool  poseStale;                               // time advanced while culled, pose not evaluated yet
     std::vector<float> boneMatrices;               // final skinning matrices (flattened column-major); allocated only for skinned models
 };
 
@@ -142,16 +181,27 @@ struct st3DMesh {
     bool isSkinned;           // true when JOINTS_0/WEIGHTS_0 were present (uses skinned VAO layout)
     bool needsBlend;          // true when material alpha_mode is BLEND or MASK (transparent areas)
     float materialBaseAlpha;  // base_color_factor[3] from glTF PBR material (1.0 when absent)
+    float boundsMin[3], boundsMax[3];  // model-space AABB of the vertex positions (bind pose when skinned)
+    float boundsCenter[3];             // bounding sphere around the AABB
+    float boundsRadius;
+    unsigned int lodCount;                        // detail levels in the index buffer, 1 = full mesh only
+    unsigned int lodIndexCount[PB3D_MAX_LODS];    // indexCount is lodIndexCount[0]
+    unsigned int lodFirstIndex[PB3D_MAX_LODS];    // start of each level in the index buffer
 };
 
 struct st3DModel {
     std::vector<st3DMesh> meshes;
     std::set<unsigned int> ownedTextures;  // unique GPU texture handles owned by this model (ref-safe cleanup)
     std::string name;
+    std::string cacheKey;  // key in the model cache (path + load options), empty when not cached
+    unsigned int refCount; // pb3dLoadModel calls sharing this model; freed when it drops to 0
     bool isLoaded;
     bool hasSkeleton;    // true when skin + bone hierarchy was loaded from the glTF
     float normScale;     // 1 / max_model_extent — the global normalization factor applied to vertex positions
     float normCX, normCY, normCZ;  // bounding-box centre used by the normalization (pre-normalization space)
+    float boundsCenter[3];         // bounding sphere around every mesh (pre-normalization space)
+    float boundsRadius;
+    unsigned int lodCount;         // most detail levels of any mesh
     st3DSkeleton skeleton;
 };
 
@@ -248,9 +298,26 @@ public:
     // uploaded using the 8-float static VAO layout and rendered with the static shader.
     // Use this for debugging geometry without skinning, or for models whose skin data
     // is not needed (e.g. static decorative objects authored with a rig).
-    unsigned int pb3dLoadModel(const char* glbFilePath, bool forceStatic = false);
+    // A path ending in .pbm loads a pre-processed model file (see pb3dExportModel).  For a .glb path,
+    // a sibling .pbm exported with the same forceStatic setting and newer than the .glb is used instead.
+    // Models are cached by path + load options: loading a resident model returns the same model ID and
+    // adds a reference, and pb3dUnloadModel only frees it when the last reference is released.  Model
+    // state (e.g. baked clips) is shared, and each caller should destroy its own instances before unloading.
+    // boneListPath: a keep/remove list written by pb3dutil --simplify-bones.  Removed bones hand their
+    // vertex weights to the nearest kept ancestor and are no longer uploaded to the GPU.
+    // lodLevels: 2 or 3 builds simplified index buffers for large meshes, drawn by on-screen size.
+    // Both apply to .glb loads; a .pbm carries whatever it was exported with.
+    unsigned int pb3dLoadModel(const char* glbFilePath, bool forceStatic = false,
+                               const char* boneListPath = nullptr, unsigned int lodLevels = 1);
     bool         pb3dUnloadModel(unsigned int modelId);
 
+    // Load a .glb and write its processed GPU-ready data (interleaved vertices, indices, decoded
+    // textures, skeleton and clips) to a memory-mappable .pbm file.  Needs a GL context (after
+    // pb3dInit), since it runs the normal loader.  outFilePath = nullptr writes <name>.pbm next to the .glb.
+    // boneListPath and lodLevels are applied as in pb3dLoadModel and stored in the file.
+    bool         pb3dExportModel(const char* glbFilePath, const char* outFilePath = nullptr, bool forceStatic = false,
+                                 const char* boneListPath = nullptr, unsigned int lodLevels = 1);
+
     // -----------------------------------------------------------------------
     // Instance management
     // -----------------------------------------------------------------------
@@ -284,8 +351,19 @@ public:
     // -----------------------------------------------------------------------
     void pb3dBegin();
     void pb3dEnd();
-    void pb3dRenderInstance(unsigned int instanceId);
-    void pb3dRenderAll();
+    void pb3dRenderInstance(unsigned int instanceId);   // draws immediately, in call order
+    void pb3dSubmitInstance(unsigned int instanceId);   // queued, drawn sorted by pb3dEnd()
+    void pb3dRenderAll();                               // submits every visible instance
+
+    // Frustum culling - instances (and meshes of multi-mesh models) whose bounding sphere is outside
+    // the camera frustum are not drawn, and their skeleton poses are not evaluated.  On by default.
+    void pb3dSetCulling(bool enable);
+    void pb3dGetCullStats(unsigned int& instancesCulled, unsigned int& posesSkipped);
+
+    // Detail level selection for models loaded with lodLevels > 1: below lod1Radius pixels of on-screen
+    // bounding sphere radius LOD 1 is drawn, below lod2Radius LOD 2.  0 disables a level.
+    void pb3dSetLodPixelRadius(float lod1Radius, float lod2Radius);
+    unsigned int pb3dGetLodInstances();   // instances drawn at a reduced level since the last pb3dBegin
 
     // -----------------------------------------------------------------------
     // Skeleton animation API
@@ -294,6 +372,12 @@ public:
     std::vector<std::string> pb3dListAnimClips(unsigned int modelId);
     int  pb3dFindAnimClip(unsigned int modelId, const std::string& clipName);
 
+    // Pre-sample every clip of a model into per-frame skinning palettes.  Playback then blends two
+    // stored palettes instead of evaluating channels and the bone hierarchy.  Best for looping clips
+    // on models with many instances; costs bones * 48 bytes per frame.  Returns bytes used (0 = failed).
+    unsigned long pb3dBakeAnimClips(unsigned int modelId, float sampleRate = PB3D_BAKE_DEFAULT_RATE);
+    void pb3dUnbakeAnimClips(unsigned int modelId);
+
     // Play a skeleton animation clip on an instance (-1 clipIndex or unknown name stops)
     bool pb3dPlayAnimClip(unsigned int instanceId, const std::string& clipName, bool loop = true);
     bool pb3dPlayAnimClip(unsigned int instanceId, int clipIndex, bool loop = true);
@@ -302,6 +386,12 @@ public:
     float pb3dGetAnimClipTime(unsigned int instanceId) const;  // current playback time in seconds
     bool pb3dSetAnimClipTime(unsigned int instanceId, float timeSec);
 
+    // Skeleton poses for pb3dAnimateInstance(0, tick) are evaluated on worker threads and may still be
+    // running when it returns, so 2D rendering overlaps the pose work.  Rendering and the skeleton API
+    // wait automatically; call pb3dWaitSkelPoses() before reading bone data any other way.
+    void pb3dWaitSkelPoses();
+    void pb3dSetParallelPoses(bool enable);   // false = evaluate serially on the calling thread
+
     // -----------------------------------------------------------------------
     // Animation (high-level transform animation — position/rotation/scale/alpha)
     // -----------------------------------------------------------------------
@@ -321,11 +411,18 @@ protected:
     // Console output — default uses stdout; overridden in PBEngine to route to the on-screen console
     virtual void pb3dSendConsole(const std::string& msg, bool debug = false);
 
+    // Pose evaluation - exposed to the engine for the skeletal animation benchmark.
+    // channelCursors (may be nullptr) caches the keyframe interval per channel between calls.
+    void  pb3dComputeBoneMatrices(const st3DSkeleton& skel, const st3DAnimClip& clip,
+                                  float time, float* outMatrices, unsigned int* channelCursors);
+    void  pb3dBuildBenchSkeleton(st3DSkeleton& skel, int numBones, int keysPerChannel, float duration);
+
 private:
     // Data storage
     std::map<unsigned int, st3DModel>        m_3dModelList;
     std::map<unsigned int, st3DInstance>      m_3dInstanceList;
     std::map<unsigned int, st3DAnimateData>   m_3dAnimateList;
+    std::map<std::string, unsigned int>       m_3dModelCache;   // path + forceStatic -> resident model ID
 
     // Camera and light state
     st3DCamera m_camera;
@@ -345,6 +442,89 @@ private:
     // Tracks whether the skinned shader is currently active (for mid-frame switching)
     bool m_skinnedShaderActive;
 
+    // Frustum planes (a, b, c, d with unit normals pointing inwards) in world space, extracted from
+    // projection * view whenever pb3dBegin recomputes the matrices
+    float m_frustumPlanes[6][4];
+    bool  m_frustumValid;
+    bool  m_cullingEnabled;
+    unsigned int m_culledInstances;   // since the last pb3dBegin
+    unsigned int m_culledPoses;       // during the last pb3dAnimateInstance(0, ...)
+
+    // Detail level thresholds (m_lodPixelRadius[0] is unused) and instances drawn below level 0
+    float        m_lodPixelRadius[PB3D_MAX_LODS];
+    unsigned int m_lodInstances;
+
+    // Render queue - pb3dSubmitInstance snapshots the instance's matrices, pb3dFlushQueue expands the
+    // submissions into one item per mesh, sorts them and draws.  Opaque items are ordered shader ->
+    // texture -> mesh -> near to far, transparent items far to near.
+    struct st3DSubmission {
+        unsigned int instanceId;
+        float        model[16];
+        float        mvp[16];
+        float        alpha;
+        float        depth;        // view space distance in front of the camera
+        unsigned int lod;          // detail level picked from the on-screen size
+    };
+    struct st3DDrawItem {
+        unsigned int       submission;   // index into m_3dSubmissions
+        st3DInstance*      instance;     // resolved at flush, valid until it returns
+        const st3DModel*   model;
+        const st3DMesh*    mesh;
+        unsigned int       vao;
+        unsigned int       textureId;
+        unsigned int       indexCount;   // of the chosen detail level
+        unsigned int       firstIndex;
+        bool               isSkinned;
+        bool               blend;
+        float              alpha;        // instance alpha x material alpha
+        float              depth;
+    };
+    std::vector<st3DSubmission> m_3dSubmissions;
+    std::vector<st3DDrawItem>   m_3dDrawItems;
+    std::vector<float>          m_3dInstanceMatrices;   // model matrices for one instanced draw
+
+    // Pose worker pool - one job per playing instance.  Times are advanced serially before dispatch and
+    // each job only writes its own instance's bone matrices, so results do not depend on scheduling.
+    struct st3DPoseJob {
+        st3DSkelState*      skelState;
+        const st3DSkeleton* skeleton;
+        const st3DAnimClip* clip;
+    };
+    std::vector<std::thread>  m_poseWorkers;
+    std::vector<st3DPoseJob>  m_poseJobs;          // guarded by m_poseMutex while jobs are outstanding
+    std::mutex                m_poseMutex;
+    std::condition_variable   m_poseCondition;     // workers: new jobs or shutdown
+    std::condition_variable   m_poseDoneCondition; // main thread: all jobs finished
+    size_t                    m_poseNextJob;
+    size_t                    m_poseJobsDone;
+    bool                      m_poseShutdown;
+    bool                      m_posePending;       // main thread only: jobs dispatched but not yet waited on
+    bool                      m_poseParallel;
+
+    // Model export capture - while pb3dExportModel runs, pb3dLoadModel copies the data it hands
+    // to PBOGLES here, keyed by VAO / texture handle so the opaque-first mesh sort does not matter.
+    struct st3DCapturedTexture {
+        int width;
+        int height;
+        std::vector<unsigned char> pixels;
+    };
+    struct st3DModelCapture {
+        std::map<unsigned int, std::vector<float>>        vertices;
+        std::map<unsigned int, std::vector<unsigned int>> indices;
+        std::map<unsigned int, st3DCapturedTexture>       textures;
+    };
+    st3DModelCapture* m_3dModelCapture;   // nullptr except during pb3dExportModel
+
+    // glTF loading (pb3dLoadModel handles the cache and .pbm files)
+    unsigned int pb3dLoadModelGltf(const char* glbFilePath, bool forceStatic, const char* boneListPath, unsigned int lodLevels);
+
+    // Pre-processed model files (.pbm)
+    unsigned int pb3dLoadModelFile(const char* pbmFilePath, bool forceStatic);
+    bool         pb3dModelFileIsCurrent(const std::string& glbFilePath, const std::string& pbmFilePath, bool forceStatic,
+                                        const char* boneListPath, unsigned int lodLevels);
+    bool         pb3dWriteModelFile(const st3DModel& model, const st3DModelCapture& capture, bool forceStatic,
+                                    bool boneListApplied, unsigned int lodLevels, const char* outFilePath);
+
     // Animation handlers
     void pb3dProcessAnimation(st3DAnimateData& anim, unsigned int currentTick);
     void pb3dAnimateNormal(st3DAnimateData& anim, unsigned int currentTick, float timeSinceStart, float percentComplete);
@@ -359,16 +539,33 @@ private:
     void pb3dPixelToWorld(float pixelX, float pixelY, float depthZ, float& outX, float& outY);
     void pb3dSetCamera(st3DCamera camera);  // internal — camera is managed automatically
 
+    // Rendering helpers shared by the immediate path and the render queue
+    void pb3dBuildInstanceMatrices(const st3DInstance& inst, const st3DModel& model3d, float outModel[16], float outMVP[16]);
+    void pb3dPrepareInstanceBones(st3DInstance& inst, const st3DModel& model3d,
+                                  const float*& outBones, int& outBoneCount, unsigned int& outPaletteTex);
+    void pb3dDrawInstanceMesh(const st3DMesh& mesh, const float model[16], const float mvp[16], float alpha,
+                              const float* bones, int boneCount, unsigned int paletteTex, unsigned int lod);
+    void pb3dFlushQueue();
+    bool pb3dSphereInFrustum(const float modelMat[16], const float center[3], float radius);
+    bool pb3dInstanceInFrustum(const st3DModel& model3d, const float modelMat[16]);
+    bool pb3dMeshInFrustum(const st3DModel& model3d, const st3DMesh& mesh, const float modelMat[16]);
+    bool pb3dSkipCulledPose(st3DInstance& inst, const st3DModel& model3d);
+    unsigned int pb3dSelectLod(const st3DModel& model3d, const float modelMat[16]);
+
     // Random number generation for animation
     float pb3dGetRandomFloat(float min, float max);
 
     // Skeleton animation helpers
     void  pb3dUpdateSkelState(st3DInstance& inst, const st3DSkeleton& skel, unsigned int currentTick);
-    void  pb3dComputeBoneMatrices(const st3DSkeleton& skel, const st3DAnimClip& clip,
-                                  float time, float* outMatrices);
+    void  pb3dAdvanceSkelTime(st3DSkelState& ss, const st3DSkeleton& skel, unsigned int currentTick);
+    void  pb3dEvalPoseJob(const st3DPoseJob& job);
+    void  pb3dSampleBakedClip(const st3DAnimClip& clip, float time, float* outMatrices);
+    void  pb3dPoseWorker();
+    void  pb3dShutdownPoseWorkers();
     float pb3dSkelInterpolateFloat(float a, float b, float t);
     void  pb3dSkelSlerpQuat(const float qa[4], const float qb[4], float t, float out[4]);
-    void  pb3dSkelEvalChannel(const st3DAnimChannel& ch, float time, float out[4]);
+    void  pb3dSkelEvalChannel(const st3DAnimChannel& ch, float time, float out[4], unsigned int* cursor);
+    void  pb3dSkelIndexClipChannels(st3DAnimClip& clip, int numBones);
     void  pb3dMat4Mul(const float a[16], const float b[16], float out[16]);
     void  pb3dMat4FromTRS(const float t[3], const float r[4], const float s[3], float out[16]);
     bool  pb3dMat4InvertAffine(const float m[16], float out[16]);
@@ -377,6 +574,11 @@ private:
     static const char* vertexShader3DSource;
     static const char* fragmentShader3DSource;
     static const char* vertexShader3DSkinnedSource;  // skinned-mesh variant (adds bone matrices)
+    static const char* vertexShader3DSkinnedPaletteSource;  // skinned variant reading bones from a float texture
+    static const char* vertexShader3DInstancedSource;       // static variant taking the model matrix per instance
+
+    // Shared all-identity palette for skinned instances with no active clip (palette path only)
+    unsigned int m_3dIdentityPalette;
 };
 
 #endif // PB3D_h
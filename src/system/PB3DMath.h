@@ -0,0 +1,350 @@
+// PB3DMath - matrix and quaternion kernels used by PB3D skeletal animation
+// NEON on ARM (Pi), SSE on x86 (Windows / Linux simulator), plain C++ everywhere else.
+// All matrices are 4×4 column-major float[16]; quaternions are xyzw float[4].
+// The *Scalar versions are always compiled - they are the reference the SIMD paths are checked against.
+
+// Copyright (c) 2025 Jeffrey D. Bock, unless otherwise noted. Licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+// The license can be found here: <https://creativecommons.org/licenses/by-nc/4.0/>.
+// Additional details can also be found in the license file in the root of the project.
+
+#ifndef PB3DMath_h
+#define PB3DMath_h
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PB3D_MATH_NEON
+#define PB3D_MATH_ISA "NEON"
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PB3D_MATH_SSE
+#define PB3D_MATH_ISA "SSE"
+#else
+#define PB3D_MATH_ISA "Scalar"
+#endif
+
+// ============================================================================
+// Scalar reference kernels
+// ============================================================================
+
+// out = a * b  (out must not alias a or b)
+inline void pb3dMathMat4MulScalar(const float a[16], const float b[16], float out[16]) {
+    for (int col = 0; col < 4; col++) {
+        for (int row = 0; row < 4; row++) {
+            out[col*4+row] = a[0*4+row]*b[col*4+0]
+                           + a[1*4+row]*b[col*4+1]
+                           + a[2*4+row]*b[col*4+2]
+                           + a[3*4+row]*b[col*4+3];
+        }
+    }
+}
+
+// Build a 4×4 matrix from translation, rotation quaternion and scale
+inline void pb3dMathMat4FromTRSScalar(const float t[3], const float r[4], const float s[3], float out[16]) {
+    float qx = r[0], qy = r[1], qz = r[2], qw = r[3];
+    float x2 = qx+qx, y2 = qy+qy, z2 = qz+qz;
+    float xx = qx*x2, xy = qx*y2, xz = qx*z2;
+    float yy = qy*y2, yz = qy*z2, zz = qz*z2;
+    float wx = qw*x2, wy = qw*y2, wz = qw*z2;
+
+    out[0]  = (1.0f - (yy+zz)) * s[0];
+    out[1]  = (xy + wz)         * s[0];
+    out[2]  = (xz - wy)         * s[0];
+    out[3]  = 0.0f;
+    out[4]  = (xy - wz)         * s[1];
+    out[5]  = (1.0f - (xx+zz)) * s[1];
+    out[6]  = (yz + wx)         * s[1];
+    out[7]  = 0.0f;
+    out[8]  = (xz + wy)         * s[2];
+    out[9]  = (yz - wx)         * s[2];
+    out[10] = (1.0f - (xx+yy)) * s[2];
+    out[11] = 0.0f;
+    out[12] = t[0];
+    out[13] = t[1];
+    out[14] = t[2];
+    out[15] = 1.0f;
+}
+
+// Invert an affine matrix (any non-singular rotation/scale plus translation).  Returns false if singular.
+inline bool pb3dMathMat4InvertAffineScalar(const float m[16], float out[16]) {
+    float a00 = m[0], a01 = m[4], a02 = m[8];
+    float a10 = m[1], a11 = m[5], a12 = m[9];
+    float a20 = m[2], a21 = m[6], a22 = m[10];
+    float tx  = m[12], ty = m[13], tz = m[14];
+
+    // Cofactors for 3×3 inverse
+    float c00 = a11*a22 - a12*a21;
+    float c01 = a12*a20 - a10*a22;
+    float c02 = a10*a21 - a11*a20;
+    float c10 = a02*a21 - a01*a22;
+    float c11 = a00*a22 - a02*a20;
+    float c12 = a01*a20 - a00*a21;
+    float c20 = a01*a12 - a02*a11;
+    float c21 = a02*a10 - a00*a12;
+    float c22 = a00*a11 - a01*a10;
+
+    float det = a00*c00 + a01*c01 + a02*c02;
+    if (fabsf(det) < 1e-12f) return false;
+    float invDet = 1.0f / det;
+
+    // inv(A) = cofactorMatrix^T / det  (note: cofactors above are already transposed)
+    float i00 = c00*invDet, i01 = c10*invDet, i02 = c20*invDet;
+    float i10 = c01*invDet, i11 = c11*invDet, i12 = c21*invDet;
+    float i20 = c02*invDet, i21 = c12*invDet, i22 = c22*invDet;
+
+    // Translation: -inv(A) * t
+    float itx = -(i00*tx + i01*ty + i02*tz);
+    float ity = -(i10*tx + i11*ty + i12*tz);
+    float itz = -(i20*tx + i21*ty + i22*tz);
+
+    out[0]  = i00;  out[1]  = i10;  out[2]  = i20;  out[3]  = 0.0f;
+    out[4]  = i01;  out[5]  = i11;  out[6]  = i21;  out[7]  = 0.0f;
+    out[8]  = i02;  out[9]  = i12;  out[10] = i22;  out[11] = 0.0f;
+    out[12] = itx;  out[13] = ity;  out[14] = itz;  out[15] = 1.0f;
+    return true;
+}
+
+// Normalised linear interpolation, shortest arc
+inline void pb3dMathQuatNlerpScalar(const float qa[4], const float qb[4], float t, float out[4]) {
+    float dot  = qa[0]*qb[0] + qa[1]*qb[1] + qa[2]*qb[2] + qa[3]*qb[3];
+    float sign = (dot < 0.0f) ? -1.0f : 1.0f;
+    for (int i = 0; i < 4; i++) out[i] = qa[i] + t * (sign * qb[i] - qa[i]);
+    float len = sqrtf(out[0]*out[0] + out[1]*out[1] + out[2]*out[2] + out[3]*out[3]);
+    if (len > 1e-8f) { float inv = 1.0f / len; for (int i = 0; i < 4; i++) out[i] *= inv; }
+}
+
+// Slerp blend weights for unit quaternions with the given dot product.  Returns false when the
+// quaternions are nearly identical and nlerp should be used instead (avoids division by ~0).
+inline bool pb3dMathSlerpWeights(float dot, float t, float& s0, float& s1) {
+    if (dot < 0.0f) dot = -dot;
+    if (dot > 0.9995f) return false;
+    float theta0 = acosf(dot);
+    float theta  = theta0 * t;
+    float sinT0  = sinf(theta0);
+    float sinT   = sinf(theta);
+    s0 = cosf(theta) - dot * sinT / sinT0;
+    s1 = sinT / sinT0;
+    return true;
+}
+
+// Spherical linear interpolation, shortest arc
+inline void pb3dMathQuatSlerpScalar(const float qa[4], const float qb[4], float t, float out[4]) {
+    float dot = qa[0]*qb[0] + qa[1]*qb[1] + qa[2]*qb[2] + qa[3]*qb[3];
+    float s0, s1;
+    if (!pb3dMathSlerpWeights(dot, t, s0, s1)) { pb3dMathQuatNlerpScalar(qa, qb, t, out); return; }
+    if (dot < 0.0f) s1 = -s1;
+    for (int i = 0; i < 4; i++) out[i] = s0 * qa[i] + s1 * qb[i];
+}
+
+// ============================================================================
+// SIMD kernels (fall back to the scalar versions when no SIMD is available)
+// ============================================================================
+
+#if defined(PB3D_MATH_NEON)
+
+// Rotate lanes xyz -> yzx (w lane is undefined)
+inline float32x4_t pb3dMathNeonYZX(float32x4_t v) {
+    return vcombine_f32(vext_f32(vget_low_f32(v), vget_high_f32(v), 1), vget_low_f32(v));
+}
+
+inline float32x4_t pb3dMathNeonCross(float32x4_t a, float32x4_t b) {
+    float32x4_t aYZX = pb3dMathNeonYZX(a), bYZX = pb3dMathNeonYZX(b);
+    float32x4_t aZXY = pb3dMathNeonYZX(aYZX), bZXY = pb3dMathNeonYZX(bYZX);
+    return vsubq_f32(vmulq_f32(aYZX, bZXY), vmulq_f32(aZXY, bYZX));
+}
+
+inline float pb3dMathNeonDot4(float32x4_t a, float32x4_t b) {
+    float32x4_t p = vmulq_f32(a, b);
+    float32x2_t s = vadd_f32(vget_low_f32(p), vget_high_f32(p));
+    return vget_lane_f32(vpadd_f32(s, s), 0);
+}
+
+#elif defined(PB3D_MATH_SSE)
+
+#define PB3D_MATH_SHUFFLE(v, x, y, z, w) _mm_shuffle_ps((v), (v), _MM_SHUFFLE((w), (z), (y), (x)))
+
+inline __m128 pb3dMathSseCross(__m128 a, __m128 b) {
+    __m128 aYZX = PB3D_MATH_SHUFFLE(a, 1, 2, 0, 3), bYZX = PB3D_MATH_SHUFFLE(b, 1, 2, 0, 3);
+    __m128 aZXY = PB3D_MATH_SHUFFLE(a, 2, 0, 1, 3), bZXY = PB3D_MATH_SHUFFLE(b, 2, 0, 1, 3);
+    return _mm_sub_ps(_mm_mul_ps(aYZX, bZXY), _mm_mul_ps(aZXY, bYZX));
+}
+
+inline float pb3dMathSseDot4(__m128 a, __m128 b) {
+    __m128 p = _mm_mul_ps(a, b);
+    p = _mm_add_ps(p, _mm_movehl_ps(p, p));
+    p = _mm_add_ss(p, PB3D_MATH_SHUFFLE(p, 1, 1, 1, 1));
+    return _mm_cvtss_f32(p);
+}
+
+#endif
+
+// out = a * b.  Safe when out aliases a or b.
+inline void pb3dMathMat4Mul(const float a[16], const float b[16], float out[16]) {
+#if defined(PB3D_MATH_NEON)
+    float32x4_t a0 = vld1q_f32(a), a1 = vld1q_f32(a + 4), a2 = vld1q_f32(a + 8), a3 = vld1q_f32(a + 12);
+    for (int col = 0; col < 4; col++) {
+        float32x4_t bc = vld1q_f32(b + col * 4);
+        float32x4_t r  = vmulq_n_f32(a0, vgetq_lane_f32(bc, 0));
+        r = vmlaq_n_f32(r, a1, vgetq_lane_f32(bc, 1));
+        r = vmlaq_n_f32(r, a2, vgetq_lane_f32(bc, 2));
+        r = vmlaq_n_f32(r, a3, vgetq_lane_f32(bc, 3));
+        vst1q_f32(out + col * 4, r);
+    }
+#elif defined(PB3D_MATH_SSE)
+    __m128 a0 = _mm_loadu_ps(a), a1 = _mm_loadu_ps(a + 4), a2 = _mm_loadu_ps(a + 8), a3 = _mm_loadu_ps(a + 12);
+    for (int col = 0; col < 4; col++) {
+        __m128 bc = _mm_loadu_ps(b + col * 4);
+        __m128 r  = _mm_mul_ps(a0, PB3D_MATH_SHUFFLE(bc, 0, 0, 0, 0));
+        r = _mm_add_ps(r, _mm_mul_ps(a1, PB3D_MATH_SHUFFLE(bc, 1, 1, 1, 1)));
+        r = _mm_add_ps(r, _mm_mul_ps(a2, PB3D_MATH_SHUFFLE(bc, 2, 2, 2, 2)));
+        r = _mm_add_ps(r, _mm_mul_ps(a3, PB3D_MATH_SHUFFLE(bc, 3, 3, 3, 3)));
+        _mm_storeu_ps(out + col * 4, r);
+    }
+#else
+    if (out == a || out == b) {
+        float tmp[16];
+        pb3dMathMat4MulScalar(a, b, tmp);
+        memcpy(out, tmp, sizeof(tmp));
+        return;
+    }
+    pb3dMathMat4MulScalar(a, b, out);
+#endif
+}
+
+inline void pb3dMathMat4FromTRS(const float t[3], const float r[4], const float s[3], float out[16]) {
+#if defined(PB3D_MATH_NEON) || defined(PB3D_MATH_SSE)
+    float qx = r[0], qy = r[1], qz = r[2], qw = r[3];
+    float x2 = qx+qx, y2 = qy+qy, z2 = qz+qz;
+    float xx = qx*x2, xy = qx*y2, xz = qx*z2;
+    float yy = qy*y2, yz = qy*z2, zz = qz*z2;
+    float wx = qw*x2, wy = qw*y2, wz = qw*z2;
+    const float c0[4] = { 1.0f - (yy+zz), xy + wz, xz - wy, 0.0f };
+    const float c1[4] = { xy - wz, 1.0f - (xx+zz), yz + wx, 0.0f };
+    const float c2[4] = { xz + wy, yz - wx, 1.0f - (xx+yy), 0.0f };
+    const float c3[4] = { t[0], t[1], t[2], 1.0f };
+#if defined(PB3D_MATH_NEON)
+    vst1q_f32(out,      vmulq_n_f32(vld1q_f32(c0), s[0]));
+    vst1q_f32(out + 4,  vmulq_n_f32(vld1q_f32(c1), s[1]));
+    vst1q_f32(out + 8,  vmulq_n_f32(vld1q_f32(c2), s[2]));
+    vst1q_f32(out + 12, vld1q_f32(c3));
+#else
+    _mm_storeu_ps(out,      _mm_mul_ps(_mm_loadu_ps(c0), _mm_set1_ps(s[0])));
+    _mm_storeu_ps(out + 4,  _mm_mul_ps(_mm_loadu_ps(c1), _mm_set1_ps(s[1])));
+    _mm_storeu_ps(out + 8,  _mm_mul_ps(_mm_loadu_ps(c2), _mm_set1_ps(s[2])));
+    _mm_storeu_ps(out + 12, _mm_loadu_ps(c3));
+#endif
+#else
+    pb3dMathMat4FromTRSScalar(t, r, s, out);
+#endif
+}
+
+// Affine inverse via cross products: the rows of inv(A) are (c1×c2, c2×c0, c0×c1) / det
+inline bool pb3dMathMat4InvertAffine(const float m[16], float out[16]) {
+#if defined(PB3D_MATH_NEON) || defined(PB3D_MATH_SSE)
+    const float cols[12] = { m[0], m[1], m[2], 0.0f,  m[4], m[5], m[6], 0.0f,  m[8], m[9], m[10], 0.0f };
+    float r0[4], r1[4], r2[4], det;
+#if defined(PB3D_MATH_NEON)
+    float32x4_t c0 = vld1q_f32(cols), c1 = vld1q_f32(cols + 4), c2 = vld1q_f32(cols + 8);
+    float32x4_t x0 = pb3dMathNeonCross(c1, c2), x1 = pb3dMathNeonCross(c2, c0), x2 = pb3dMathNeonCross(c0, c1);
+    det = pb3dMathNeonDot4(vsetq_lane_f32(0.0f, c0, 3), vsetq_lane_f32(0.0f, x0, 3));
+    if (fabsf(det) < 1e-12f) return false;
+    float32x4_t invDet = vdupq_n_f32(1.0f / det);
+    vst1q_f32(r0, vmulq_f32(x0, invDet));
+    vst1q_f32(r1, vmulq_f32(x1, invDet));
+    vst1q_f32(r2, vmulq_f32(x2, invDet));
+#else
+    __m128 c0 = _mm_loadu_ps(cols), c1 = _mm_loadu_ps(cols + 4), c2 = _mm_loadu_ps(cols + 8);
+    __m128 x0 = pb3dMathSseCross(c1, c2), x1 = pb3dMathSseCross(c2, c0), x2 = pb3dMathSseCross(c0, c1);
+    det = pb3dMathSseDot4(c0, x0);
+    if (fabsf(det) < 1e-12f) return false;
+    __m128 invDet = _mm_set1_ps(1.0f / det);
+    _mm_storeu_ps(r0, _mm_mul_ps(x0, invDet));
+    _mm_storeu_ps(r1, _mm_mul_ps(x1, invDet));
+    _mm_storeu_ps(r2, _mm_mul_ps(x2, invDet));
+#endif
+    float tx = m[12], ty = m[13], tz = m[14];
+    out[0]  = r0[0];  out[1]  = r1[0];  out[2]  = r2[0];  out[3]  = 0.0f;
+    out[4]  = r0[1];  out[5]  = r1[1];  out[6]  = r2[1];  out[7]  = 0.0f;
+    out[8]  = r0[2];  out[9]  = r1[2];  out[10] = r2[2];  out[11] = 0.0f;
+    out[12] = -(r0[0]*tx + r0[1]*ty + r0[2]*tz);
+    out[13] = -(r1[0]*tx + r1[1]*ty + r1[2]*tz);
+    out[14] = -(r2[0]*tx + r2[1]*ty + r2[2]*tz);
+    out[15] = 1.0f;
+    return true;
+#else
+    return pb3dMathMat4InvertAffineScalar(m, out);
+#endif
+}
+
+inline void pb3dMathQuatNlerp(const float qa[4], const float qb[4], float t, float out[4]) {
+#if defined(PB3D_MATH_NEON)
+    float32x4_t a = vld1q_f32(qa), b = vld1q_f32(qb);
+    if (pb3dMathNeonDot4(a, b) < 0.0f) b = vnegq_f32(b);
+    float32x4_t q = vmlaq_n_f32(a, vsubq_f32(b, a), t);
+    float len = sqrtf(pb3dMathNeonDot4(q, q));
+    if (len > 1e-8f) q = vmulq_n_f32(q, 1.0f / len);
+    vst1q_f32(out, q);
+#elif defined(PB3D_MATH_SSE)
+    __m128 a = _mm_loadu_ps(qa), b = _mm_loadu_ps(qb);
+    if (pb3dMathSseDot4(a, b) < 0.0f) b = _mm_sub_ps(_mm_setzero_ps(), b);
+    __m128 q = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_set1_ps(t)));
+    float len = sqrtf(pb3dMathSseDot4(q, q));
+    if (len > 1e-8f) q = _mm_mul_ps(q, _mm_set1_ps(1.0f / len));
+    _mm_storeu_ps(out, q);
+#else
+    pb3dMathQuatNlerpScalar(qa, qb, t, out);
+#endif
+}
+
+inline void pb3dMathQuatSlerp(const float qa[4], const float qb[4], float t, float out[4]) {
+#if defined(PB3D_MATH_NEON)
+    float32x4_t a = vld1q_f32(qa), b = vld1q_f32(qb);
+    float dot = pb3dMathNeonDot4(a, b);
+    float s0, s1;
+    if (!pb3dMathSlerpWeights(dot, t, s0, s1)) { pb3dMathQuatNlerp(qa, qb, t, out); return; }
+    if (dot < 0.0f) s1 = -s1;
+    vst1q_f32(out, vmlaq_n_f32(vmulq_n_f32(a, s0), b, s1));
+#elif defined(PB3D_MATH_SSE)
+    __m128 a = _mm_loadu_ps(qa), b = _mm_loadu_ps(qb);
+    float dot = pb3dMathSseDot4(a, b);
+    float s0, s1;
+    if (!pb3dMathSlerpWeights(dot, t, s0, s1)) { pb3dMathQuatNlerp(qa, qb, t, out); return; }
+    if (dot < 0.0f) s1 = -s1;
+    _mm_storeu_ps(out, _mm_add_ps(_mm_mul_ps(a, _mm_set1_ps(s0)), _mm_mul_ps(b, _mm_set1_ps(s1))));
+#else
+    pb3dMathQuatSlerpScalar(qa, qb, t, out);
+#endif
+}
+
+// ============================================================================
+// Batched kernels
+// ============================================================================
+
+// out[i] = a[i] * b[i] for count matrices laid out back to back
+inline void pb3dMathMat4MulBatch(const float* a, const float* b, float* out, int count) {
+    for (int i = 0; i < count; i++) pb3dMathMat4Mul(a + i*16, b + i*16, out + i*16);
+}
+
+// Concatenate a bone hierarchy: world[bone] = world[parent] * local[bone], or local[bone] for roots.
+// order[] lists bones parent-before-child and parents[i] is the parent of order[i] (-1 for roots).
+inline void pb3dMathConcatHierarchy(const int* order, const int* parents, int count,
+                                    const float* local, float* world) {
+    for (int i = 0; i < count; i++) {
+        int bi = order[i];
+        if (parents[i] < 0) memcpy(world + bi*16, local + bi*16, 64);
+        else pb3dMathMat4Mul(world + parents[i]*16, local + bi*16, world + bi*16);
+    }
+}
+
+inline void pb3dMathConcatHierarchyScalar(const int* order, const int* parents, int count,
+                                          const float* local, float* world) {
+    for (int i = 0; i < count; i++) {
+        int bi = order[i];
+        if (parents[i] < 0) memcpy(world + bi*16, local + bi*16, 64);
+        else pb3dMathMat4MulScalar(world + parents[i]*16, local + bi*16, world + bi*16);
+    }
+}
+
+#endif // PB3DMath_h
@@ -0,0 +1,129 @@
+// PB3DModelFile - on-disk layout of pre-processed PB3D model files (.pbm)
+// Written by PB3D::pb3dExportModel() and memory-mapped by pb3dLoadModel().  A .pbm holds
+// everything the glTF loader otherwise computes at startup: interleaved vertex blobs already in
+// the VAO layout, 32-bit index blobs, decoded RGBA8 texture pixels, the unified skeleton and all
+// animation clips.  Plain structs only (no GL) so pb3dutil can inspect files as well.
+
+// Copyright (c) 2025 Jeffrey D. Bock, unless otherwise noted. Licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+// The license can be found here: <https://creativecommons.org/licenses/by-nc/4.0/>.
+// Additional details can also be found in the license file in the root of the project.
+
+#ifndef PB3DModelFile_h
+#define PB3DModelFile_h
+
+#include <cstddef>
+#include <cstdint>
+
+// Files are little-endian (Pi 5 and x86 both are) and every offset is from the start of the file.
+// Blobs start on a 16 byte boundary so vertex data can be handed to the GPU straight from the map.
+#define PB3D_MODEL_FILE_MAGIC      0x4D334250u   // "PB3M"
+#define PB3D_MODEL_FILE_VERSION    3
+#define PB3D_MODEL_FILE_ALIGN      16
+#define PB3D_MODEL_FILE_EXT        ".pbm"
+#define PB3D_MODEL_FILE_NO_TEXTURE 0xFFFFFFFFu   // mesh uses the shared 1x1 white fallback texture
+#define PB3D_MODEL_FILE_MAX_LODS   3             // detail levels per mesh, matches PB3D_MAX_LODS
+
+// st3DFileHeader::flags
+#define PB3D_MODEL_FLAG_STATIC     0x1           // exported with forceStatic (no skinned meshes)
+#define PB3D_MODEL_FLAG_SKELETON   0x2
+#define PB3D_MODEL_FLAG_BONE_LIST  0x4           // exported with a bone reduction list applied
+
+// st3DFileMesh::flags
+#define PB3D_MESH_FLAG_SKINNED     0x1           // 16 floats/vertex, otherwise 8
+#define PB3D_MESH_FLAG_BLEND       0x2
+
+struct st3DFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t fileSize;
+    uint32_t flags;
+    float    normScale;
+    float    normCX, normCY, normCZ;
+    uint32_t meshCount,    meshOffset;       // st3DFileMesh table
+    uint32_t textureCount, textureOffset;    // st3DFileTexture table
+    uint32_t boneCount,    boneOffset;       // st3DFileBone table
+    uint32_t clipCount,    clipOffset;       // st3DFileClip table
+    uint32_t skinCount,    skinOffset;       // skinCount column-major 4x4 meshNodeGlobalInv matrices
+    uint32_t stringOffset, stringSize;       // bone and clip names, not NUL terminated
+    uint32_t paletteBoneCount;               // leading bones referenced by vertex joints
+    uint32_t lodLevels;                      // lodLevels the file was exported with
+};
+
+struct st3DFileMesh {
+    uint32_t flags;
+    uint32_t textureIndex;       // index into the texture table or PB3D_MODEL_FILE_NO_TEXTURE
+    float    materialBaseAlpha;
+    uint32_t floatsPerVertex;
+    uint32_t vertexCount;
+    uint32_t vertexOffset;       // vertexCount * floatsPerVertex floats
+    uint32_t indexCount;
+    uint32_t indexOffset;        // indexCount uint32 indices, every detail level back to back
+    float    boundsMin[3];       // model-space AABB of the vertex positions
+    float    boundsMax[3];
+    uint32_t lodCount;           // 1 .. PB3D_MODEL_FILE_MAX_LODS
+    uint32_t lodIndexCount[PB3D_MODEL_FILE_MAX_LODS];   // sums to indexCount over lodCount levels
+};
+
+struct st3DFileTexture {
+    uint32_t width, height;
+    uint32_t pixelOffset;        // width * height RGBA8 pixels
+    uint32_t pixelSize;
+};
+
+struct st3DFileBone {
+    uint32_t nameOffset, nameLength;   // into the string table
+    int32_t  parentIndex;
+    int32_t  skinIndex;
+    float    inverseBindMatrix[16];
+    float    parentOffsetMatrix[16];
+    float    restTranslation[3];
+    float    restRotation[4];
+    float    restScale[3];
+};
+
+struct st3DFileClip {
+    uint32_t nameOffset, nameLength;
+    float    duration;
+    uint32_t channelCount;
+    uint32_t channelOffset;      // channelCount st3DFileChannel records
+};
+
+struct st3DFileChannel {
+    int32_t  boneIndex;
+    int32_t  type;               // e3DAnimChannelType
+    int32_t  interpolation;      // e3DInterpolationType
+    uint32_t keyCount;
+    uint32_t timesOffset;        // keyCount floats
+    uint32_t valuesOffset;       // keyCount * 4 floats
+};
+
+static_assert(sizeof(st3DFileHeader)  == 88,  "st3DFileHeader layout changed - bump PB3D_MODEL_FILE_VERSION");
+static_assert(sizeof(st3DFileMesh)    == 72,  "st3DFileMesh layout changed - bump PB3D_MODEL_FILE_VERSION");
+static_assert(sizeof(st3DFileTexture) == 16,  "st3DFileTexture layout changed - bump PB3D_MODEL_FILE_VERSION");
+static_assert(sizeof(st3DFileBone)    == 184, "st3DFileBone layout changed - bump PB3D_MODEL_FILE_VERSION");
+static_assert(sizeof(st3DFileClip)    == 20,  "st3DFileClip layout changed - bump PB3D_MODEL_FILE_VERSION");
+static_assert(sizeof(st3DFileChannel) == 24,  "st3DFileChannel layout changed - bump PB3D_MODEL_FILE_VERSION");
+
+// True when [offset, offset + size) lies inside the file
+inline bool pb3dFileRangeOk(const st3DFileHeader* header, uint32_t offset, uint64_t size) {
+    return ((uint64_t)offset + size <= (uint64_t)header->fileSize);
+}
+
+// Checks the header and that every table fits in the file.  Blob ranges referenced by the
+// tables are checked by the reader as it walks them.  Returns nullptr when the data is not a
+// usable .pbm of this version.
+inline const st3DFileHeader* pb3dFileGetHeader(const void* data, size_t size) {
+    if (!data || size < sizeof(st3DFileHeader)) return nullptr;
+    const st3DFileHeader* header = (const st3DFileHeader*)data;
+    if (header->magic != PB3D_MODEL_FILE_MAGIC || header->version != PB3D_MODEL_FILE_VERSION) return nullptr;
+    if (header->fileSize != size) return nullptr;
+    if (!pb3dFileRangeOk(header, header->meshOffset,    (uint64_t)header->meshCount    * sizeof(st3DFileMesh)))    return nullptr;
+    if (!pb3dFileRangeOk(header, header->textureOffset, (uint64_t)header->textureCount * sizeof(st3DFileTexture))) return nullptr;
+    if (!pb3dFileRangeOk(header, header->boneOffset,    (uint64_t)header->boneCount    * sizeof(st3DFileBone)))    return nullptr;
+    if (!pb3dFileRangeOk(header, header->clipOffset,    (uint64_t)header->clipCount    * sizeof(st3DFileClip)))    return nullptr;
+    if (!pb3dFileRangeOk(header, header->skinOffset,    (uint64_t)header->skinCount    * 16 * sizeof(float)))      return nullptr;
+    if (!pb3dFileRangeOk(header, header->stringOffset,  header->stringSize))                                        return nullptr;
+    return header;
+}
+
+#endif // PB3DModelFile_h
@@ -11,11 +11,20 @@ PBGfx::PBGfx() {
     m_nextSystemSpriteId = 1;
     m_nextUserSpriteId = 100;
     m_systemFontSpriteId = NOSPRITE;
+    m_asyncShutdown = false;
+    m_asyncInFlight = 0;
+    m_textureBudgetBytes = (unsigned long)GFX_TEXTURE_BUDGET_MB * 1024 * 1024;
+    m_residentTextureBytes = 0;
+    m_frameNumber = 0;
+    m_textureEvictions = 0;
+    m_textureReloads = 0;
+    m_layerRedraws = 0;
 }
 
 // Destructor
 PBGfx::~PBGfx() {
-    // Cleanup code if needed
+    // Stop the texture decode workers before the sprite lists go away
+    gfxShutdownAsyncLoader();
 }
 
 // Must use std::chrono so tick count can be used in a cross-platform way
@@ -35,7 +44,7 @@ bool PBGfx::gfxInit(){
     }
 
     // Create the system font sprite
-    m_systemFontSpriteId = gfxSysLoadSprite({"System Font", SYSTEMFONTSPRITE, GFX_PNG, GFX_TEXTMAP, GFX_UPPERLEFT, true, true}, true);
+    m_systemFontSpriteId = gfxSysLoadSprite({"System Font", SYSTEMFONTSPRITE, GFX_PNG, GFX_TEXTMAP, GFX_UPPERLEFT, true, true}, true, false);
 
     if (m_systemFontSpriteId == NOSPRITE) return (false);
     else return (true);
@@ -48,8 +57,12 @@ bool PBGfx::gfxUnloadTexture(unsigned int spriteId) {
         if (m_spriteList[it->second.parentSpriteId].keepResident) return (false);
         else {
             oglUnloadTexture (m_spriteList[it->second.parentSpriteId].glTextureId);
+            gfxTrackTextureUnloaded(m_spriteList[it->second.parentSpriteId]);
             m_spriteList[it->second.parentSpriteId].glTextureId = 0;
             m_spriteList[it->second.parentSpriteId].isLoaded = false;
+            // Drop any decode still in flight so it doesn't get uploaded after the unload
+            m_spriteList[it->second.parentSpriteId].isLoading = false;
+            m_spriteList[it->second.parentSpriteId].loadGeneration++;
             return (true);
         }
     }
@@ -65,8 +78,11 @@ bool PBGfx::gfxUnloadAllTextures() {
     for (auto it = m_spriteList.begin(); it != m_spriteList.end(); ++it) {
         if (!it->second.keepResident) {
             oglUnloadTexture(it->second.glTextureId);
+            gfxTrackTextureUnloaded(it->second);
             it->second.glTextureId = 0;
             it->second.isLoaded = false;
+            it->second.isLoading = false;
+            it->second.loadGeneration++;
         }
     }
 
@@ -104,6 +120,9 @@ bool PBGfx::gfxReloadTexture(unsigned int spriteId) {
                 if (m_spriteList[it->second.parentSpriteId].glTextureId != 0) 
                 {
                     m_spriteList[it->second.parentSpriteId].isLoaded = true;
+                    m_spriteList[it->second.parentSpriteId].isLoading = false;
+                    gfxTrackTextureLoaded(m_spriteList[it->second.parentSpriteId], tempX, tempY);
+                    m_textureReloads++;
                     return (true);
                 }
             }
@@ -112,14 +131,18 @@ bool PBGfx::gfxReloadTexture(unsigned int spriteId) {
         return (false);
 }
 
-// Private function to create a sprite
-unsigned int PBGfx::gfxSysLoadSprite(stSpriteInfo spriteInfo, bool bSystem) {
+// Private function to create a sprite.  If bAsync is set, PNG / BMP textures are decoded on a worker
+// thread and the sprite is returned immediately in the loading state.
+unsigned int PBGfx::gfxSysLoadSprite(stSpriteInfo spriteInfo, bool bSystem, bool bAsync) {
     
     // Check if a sprite with this name already exists
     for (auto it = m_spriteList.begin(); it != m_spriteList.end(); ++it) {
         if (it->second.spriteName == spriteInfo.spriteName) {
             // Sprite already exists - reload its texture and return the existing ID
-            gfxReloadTexture(it->first);
+            if (bAsync && it->second.useTexture) {
+                if (!it->second.isLoaded && !it->second.isLoading) gfxQueueAsyncLoad(it->first);
+            }
+            else gfxReloadTexture(it->first);
             return it->first;
         }
     }
@@ -143,8 +166,24 @@ unsigned int PBGfx::gfxSysLoadSprite(stSpriteInfo spriteInfo, bool bSystem) {
         default: return (NOSPRITE);
     }
 
+    // Video textures are only an empty allocation, so there is nothing to stream
+    if (textureType == OGL_VIDEO) bAsync = false;
+
+    spriteInfo.isLoading = false;
+    spriteInfo.loadAsync = bAsync;
+    spriteInfo.loadGeneration = 0;
+    spriteInfo.gpuBytes = 0;
+    spriteInfo.lastRenderFrame = m_frameNumber;
+
     // If the texture file name is not empty, load the texture
-    if ((!spriteInfo.textureFileName.empty()) && (spriteInfo.useTexture)) {
+    // Async sprites leave the texture for the decode workers and report zero size until the upload is done
+    if ((!spriteInfo.textureFileName.empty()) && (spriteInfo.useTexture) && (bAsync)) {
+        spriteInfo.glTextureId = 0;
+        spriteInfo.baseWidth = 0;
+        spriteInfo.baseHeight = 0;
+        spriteInfo.isLoaded = false;
+    }
+    else if ((!spriteInfo.textureFileName.empty()) && (spriteInfo.useTexture)) {
         texture = oglLoadTexture(spriteInfo.textureFileName.c_str(), textureType, &width, &height);
         if (texture == 0) 
         {
@@ -161,6 +200,7 @@ unsigned int PBGfx::gfxSysLoadSprite(stSpriteInfo spriteInfo, bool bSystem) {
             spriteInfo.glTextureId = texture;
             spriteInfo.baseWidth = width;
             spriteInfo.baseHeight = height;
+            gfxTrackTextureLoaded(spriteInfo, width, height);
         }
     }
     else {
@@ -241,11 +281,14 @@ unsigned int PBGfx::gfxSysLoadSprite(stSpriteInfo spriteInfo, bool bSystem) {
     }
     
     // Only set isLoaded if it's a texture sprite and the texture was loaded successfully
-    if (spriteInfo.useTexture) spriteInfo.isLoaded = true;
+    if ((spriteInfo.useTexture) && (!bAsync)) spriteInfo.isLoaded = true;
 
     // Create the Sprite Info struct and add it to the map
     m_spriteList[spriteId] = spriteInfo;
 
+    // Hand the texture to the decode workers now that the sprite exists
+    if ((!spriteInfo.textureFileName.empty()) && (spriteInfo.useTexture) && (bAsync)) gfxQueueAsyncLoad(spriteId);
+
     // Create the first corresponding sprite instance automatically
     stSpriteInstance instance;    
     
@@ -367,7 +410,267 @@ unsigned int PBGfx::gfxLoadSprite(const std::string& spriteName, const std::stri
 
 // Public function to create a sprite
 unsigned int PBGfx::gfxLoadSprite(stSpriteInfo spriteInfo) {
-    return gfxSysLoadSprite(spriteInfo, false);
+    return gfxSysLoadSprite(spriteInfo, false, false);
+}
+
+// Same as gfxLoadSprite, but the texture file read and decode happen on a worker thread so the
+// calling screen load never stalls the render loop.  Use gfxIsLoading to check when it is ready.
+unsigned int PBGfx::gfxLoadSpriteAsync(const std::string& spriteName, const std::string& textureFileName, gfxTexType textureType,
+                                       gfxSpriteMap mapType, gfxTexCenter textureCenter, bool keepResident, bool useTexture) {
+
+    stSpriteInfo spriteInfo;
+
+    spriteInfo.spriteName = spriteName;
+    spriteInfo.textureFileName = textureFileName;
+    spriteInfo.textureType = textureType;
+    spriteInfo.mapType = mapType;
+    if ((mapType == GFX_TEXTMAP) || (mapType == GFX_SPRITEMAP)) spriteInfo.textureCenter = GFX_UPPERLEFT;
+    else spriteInfo.textureCenter = textureCenter;
+    spriteInfo.keepResident = keepResident;
+    spriteInfo.useTexture = useTexture;
+
+    spriteInfo.baseWidth = 0;
+    spriteInfo.baseHeight = 0;
+    spriteInfo.glTextureId = 0;
+    spriteInfo.isLoaded = false;
+
+    return gfxSysLoadSprite(spriteInfo, false, true);
+}
+
+// Returns true while the sprite's texture is queued, decoding or waiting for upload
+bool PBGfx::gfxIsLoading(unsigned int spriteId) {
+
+    auto it = m_instanceList.find(spriteId);
+    if (it != m_instanceList.end()) return (m_spriteList[it->second.parentSpriteId].isLoading);
+    else return (false);
+}
+
+// Number of async texture loads that have not been uploaded yet
+unsigned int PBGfx::gfxAsyncLoadsPending() {
+    return (m_asyncInFlight);
+}
+
+// Queue the texture of a base sprite for decoding on the worker threads.  Starts the workers on first use.
+bool PBGfx::gfxQueueAsyncLoad(unsigned int spriteId) {
+
+    auto it = m_spriteList.find(spriteId);
+    if (it == m_spriteList.end()) return (false);
+
+    stSpriteInfo& spriteInfo = it->second;
+    if ((spriteInfo.textureType != GFX_PNG) && (spriteInfo.textureType != GFX_BMP)) return (false);
+
+    spriteInfo.isLoading = true;
+    spriteInfo.loadGeneration++;
+
+    stAsyncTextureLoad request;
+    request.spriteId = spriteId;
+    request.loadGeneration = spriteInfo.loadGeneration;
+    request.textureFileName = spriteInfo.textureFileName;
+    request.textureType = spriteInfo.textureType;
+    request.image = {nullptr, 0, 0, 0, false};
+    request.decoded = false;
+
+    if (m_asyncWorkers.empty()) {
+        m_asyncShutdown = false;
+        for (int i = 0; i < GFX_ASYNC_LOAD_THREADS; i++) {
+            m_asyncWorkers.emplace_back(&PBGfx::gfxAsyncLoadWorker, this);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        m_asyncRequests.push_back(request);
+    }
+    m_asyncCondition.notify_one();
+    m_asyncInFlight++;
+
+    return (true);
+}
+
+// Worker thread - pulls requests, reads and decodes the file, and posts the pixels back for upload.
+// Makes no GL calls and never touches the sprite lists.
+void PBGfx::gfxAsyncLoadWorker() {
+
+    while (true) {
+        stAsyncTextureLoad request;
+        {
+            std::unique_lock<std::mutex> lock(m_asyncMutex);
+            m_asyncCondition.wait(lock, [this] { return (m_asyncShutdown || !m_asyncRequests.empty()); });
+            if (m_asyncShutdown) return;
+            request = m_asyncRequests.front();
+            m_asyncRequests.pop_front();
+        }
+
+        oglTexType textureType = (request.textureType == GFX_BMP) ? OGL_BMP : OGL_PNG;
+        request.decoded = oglDecodeTexture(request.textureFileName.c_str(), textureType, &request.image);
+
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        m_asyncResults.push_back(request);
+    }
+}
+
+// Render thread - upload decoded textures until the time budget is used up.  At least one texture is
+// uploaded per call so large images still make progress.  Returns the number of results consumed.
+unsigned int PBGfx::gfxProcessAsyncLoads(unsigned int budgetMs) {
+
+    if (m_asyncInFlight == 0) return (0);
+
+    auto startTime = std::chrono::steady_clock::now();
+    unsigned int processed = 0;
+
+    while (true) {
+        stAsyncTextureLoad result;
+        {
+            std::lock_guard<std::mutex> lock(m_asyncMutex);
+            if (m_asyncResults.empty()) break;
+            result = m_asyncResults.front();
+            m_asyncResults.pop_front();
+        }
+        m_asyncInFlight--;
+        processed++;
+
+        // The sprite may have been unloaded or re-requested while the decode was running
+        auto it = m_spriteList.find(result.spriteId);
+        bool current = (it != m_spriteList.end()) && (it->second.isLoading) && (!it->second.isLoaded) &&
+                       (it->second.loadGeneration == result.loadGeneration);
+
+        if (current) {
+            stSpriteInfo& spriteInfo = it->second;
+            GLuint texture = result.decoded ? oglUploadTexture(&result.image) : 0;
+            spriteInfo.isLoading = false;
+
+            if (texture == 0) {
+                // Same fallback as the synchronous load - render the quad without a texture
+                spriteInfo.useTexture = false;
+                spriteInfo.glTextureId = 0;
+                spriteInfo.baseWidth = 64;
+                spriteInfo.baseHeight = 64;
+                spriteInfo.isLoaded = false;
+            }
+            else {
+                spriteInfo.glTextureId = texture;
+                spriteInfo.baseWidth = result.image.width;
+                spriteInfo.baseHeight = result.image.height;
+                spriteInfo.isLoaded = true;
+                gfxTrackTextureLoaded(spriteInfo, result.image.width, result.image.height);
+
+                // Instances created while loading copied a zero size, give them the real texture size
+                for (auto& instance : m_instanceList) {
+                    if ((instance.second.parentSpriteId == result.spriteId) && (instance.second.width == 0) && (instance.second.height == 0)) {
+                        instance.second.width = result.image.width;
+                        instance.second.height = result.image.height;
+                    }
+                }
+            }
+        }
+
+        oglFreeImageData(&result.image);
+
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+        if (elapsedMs >= (long long)budgetMs) break;
+    }
+
+    return (processed);
+}
+
+// Stop and join the decode workers, releasing any results that were never uploaded
+void PBGfx::gfxShutdownAsyncLoader() {
+
+    if (m_asyncWorkers.empty()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        m_asyncShutdown = true;
+    }
+    m_asyncCondition.notify_all();
+
+    for (auto& worker : m_asyncWorkers) {
+        if (worker.joinable()) worker.join();
+    }
+    m_asyncWorkers.clear();
+
+    for (auto& result : m_asyncResults) oglFreeImageData(&result.image);
+    m_asyncResults.clear();
+    m_asyncRequests.clear();
+    m_asyncInFlight = 0;
+}
+
+// Set the GPU memory budget for textures.  Takes effect at the end of the current frame.
+void PBGfx::gfxSetTextureBudget(unsigned long budgetBytes) {
+    m_textureBudgetBytes = budgetBytes;
+}
+
+stTextureStats PBGfx::gfxGetTextureStats() {
+
+    stTextureStats stats;
+    stats.residentBytes = m_residentTextureBytes;
+    stats.budgetBytes = m_textureBudgetBytes;
+    stats.residentCount = 0;
+    stats.evictionCount = m_textureEvictions;
+    stats.reloadCount = m_textureReloads;
+    stats.layerCount = 0;
+    stats.layerBytes = 0;
+    stats.layerRedraws = m_layerRedraws;
+
+    for (auto it = m_layerList.begin(); it != m_layerList.end(); ++it) {
+        if (it->second.framebuffer != 0) {
+            stats.layerCount++;
+            stats.layerBytes += oglGetRenderTargetBytes();
+        }
+    }
+
+    for (auto it = m_spriteList.begin(); it != m_spriteList.end(); ++it) {
+        if (it->second.isLoaded) stats.residentCount++;
+    }
+
+    return (stats);
+}
+
+// Account for a texture that was just created on the GPU (BMP textures are RGB, videos report their planes and
+// upload sets, everything else RGBA)
+void PBGfx::gfxTrackTextureLoaded(stSpriteInfo& spriteInfo, unsigned int width, unsigned int height) {
+
+    unsigned long bytesPerPixel = (spriteInfo.textureType == GFX_BMP) ? 3 : 4;
+    unsigned long videoBytes = (spriteInfo.textureType == GFX_VIDEO) ? oglGetVideoTextureBytes(spriteInfo.glTextureId) : 0;
+
+    m_residentTextureBytes -= spriteInfo.gpuBytes;
+    spriteInfo.gpuBytes = (videoBytes != 0) ? videoBytes : (unsigned long)width * (unsigned long)height * bytesPerPixel;
+    spriteInfo.lastRenderFrame = m_frameNumber;
+    m_residentTextureBytes += spriteInfo.gpuBytes;
+}
+
+void PBGfx::gfxTrackTextureUnloaded(stSpriteInfo& spriteInfo) {
+    m_residentTextureBytes -= spriteInfo.gpuBytes;
+    spriteInfo.gpuBytes = 0;
+}
+
+// Evict the least-recently-rendered textures until the resident total fits in the budget.
+// keepResident and video textures are never evicted, nor is anything rendered in the current frame.
+// Evicted sprites reload automatically the next time they are rendered.
+void PBGfx::gfxEnforceTextureBudget() {
+
+    if (m_residentTextureBytes <= m_textureBudgetBytes) return;
+
+    std::vector<std::pair<unsigned long, unsigned int>> candidates;
+    for (auto it = m_spriteList.begin(); it != m_spriteList.end(); ++it) {
+        const stSpriteInfo& spriteInfo = it->second;
+        if (!spriteInfo.isLoaded || spriteInfo.keepResident || spriteInfo.textureType == GFX_VIDEO) continue;
+        if (spriteInfo.lastRenderFrame >= m_frameNumber) continue;
+        candidates.push_back({spriteInfo.lastRenderFrame, it->first});
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+
+    for (auto& candidate : candidates) {
+        if (m_residentTextureBytes <= m_textureBudgetBytes) break;
+
+        stSpriteInfo& spriteInfo = m_spriteList[candidate.second];
+        oglUnloadTexture(spriteInfo.glTextureId);
+        gfxTrackTextureUnloaded(spriteInfo);
+        spriteInfo.glTextureId = 0;
+        spriteInfo.isLoaded = false;
+        m_textureEvictions++;
+    }
 }
 
 // First two render functions are conveinence functions that will automatically set sprite intance values rather than calling discrete set functions
@@ -414,39 +717,17 @@ bool PBGfx::gfxRenderSprite(unsigned int spriteId){
         bool useCenter = m_spriteList[it->second.parentSpriteId].textureCenter == GFX_CENTER ? true : false;
 
         // Convert the integer x and y to float ranging from -1 to 1 based on the ratio of screen size in pixels
-        float x2, y2;
-        float x1 = (float)m_instanceList[spriteId].x / (float)oglGetScreenWidth() * 2.0f - 1.0f;
-        float y1 = 1.0f - (float)m_instanceList[spriteId].y / (float)oglGetScreenHeight() * 2.0f;
-        x2 = x1 + (float)m_instanceList[spriteId].width / (float)oglGetScreenWidth() * 2.0f;
-        y2 = y1 - (float)m_instanceList[spriteId].height / (float)oglGetScreenHeight() * 2.0f;
-        
-        // If using center, then need to move everything up and left by the right amount
-        if (useCenter){
-        
-            float shiftleft = (x2-x1)/2;
-            float shiftup = (y2-y1)/2;
-
-            x1 -= shiftleft;
-            x2 -= shiftleft;
-            y1 -= shiftup;
-            y2 -= shiftup;
-        }
+        float x1, y1, x2, y2;
+        gfxSpriteToNDC(it->second, useCenter, &x1, &y1, &x2, &y2);
 
         // Use alpha if the texture is a BMP or VIDEO (eg: use the the supplied alpha value, otherwise it is assumed PNG already has alpha)
         bool useTexAlpha = (m_spriteList[it->second.parentSpriteId].textureType == GFX_BMP || 
                            m_spriteList[it->second.parentSpriteId].textureType == GFX_VIDEO) ? true : false;
 
-        // Change the textureID to no texture if the sprite is not using a texture
-        unsigned int tempTextureId = (m_spriteList[it->second.parentSpriteId].glTextureId);
-        // if (!m_spriteList[it->second.parentSpriteId].useTexture) tempTextureId = 0;
-
-        // Check if a texture is being used, if it is, make sure the texture is loaded
-        // If the load fails, simply don't use a texture, which at least allows the render to continue, but the sprite will not be textured
-        if (m_spriteList[it->second.parentSpriteId].useTexture) {
-            if (!m_spriteList[it->second.parentSpriteId].isLoaded) {
-                if (!gfxReloadTexture(it->second.parentSpriteId)) return (tempTextureId == 0);
-            }
-        }
+        // Make sure the texture is ready, this may skip the draw while an async texture is streaming in
+        unsigned int tempTextureId = 0;
+        bool renderResult = true;
+        if (!gfxPrepareSpriteTexture(it->second.parentSpriteId, &tempTextureId, &renderResult)) return (renderResult);
 
         // Render the sprite quad
         oglRenderQuad(&x1, &y1, &x2, &y2, it->second.u1, it->second.v1, it->second.u2, it->second.v2, useCenter, useTexAlpha, it->second.textureAlpha, tempTextureId, it->second.vertRed, it->second.vertGreen, it->second.vertBlue, it->second.vertAlpha, it->second.scaleFactor, it->second.rotateDegrees, it->second.updateBoundingBox);
@@ -468,6 +749,152 @@ bool PBGfx::gfxRenderSprite(unsigned int spriteId){
     return (true);
 }
 
+// Convert a sprite instance's screen position and size to the NDC quad corners used by the renderer
+void PBGfx::gfxSpriteToNDC(const stSpriteInstance& instance, bool useCenter, float* x1, float* y1, float* x2, float* y2) {
+
+    *x1 = (float)instance.x / (float)oglGetScreenWidth() * 2.0f - 1.0f;
+    *y1 = 1.0f - (float)instance.y / (float)oglGetScreenHeight() * 2.0f;
+    *x2 = *x1 + (float)instance.width / (float)oglGetScreenWidth() * 2.0f;
+    *y2 = *y1 - (float)instance.height / (float)oglGetScreenHeight() * 2.0f;
+
+    // If using center, then need to move everything up and left by the right amount
+    if (useCenter) {
+        float shiftleft = (*x2 - *x1) / 2;
+        float shiftup = (*y2 - *y1) / 2;
+
+        *x1 -= shiftleft;
+        *x2 -= shiftleft;
+        *y1 -= shiftup;
+        *y2 -= shiftup;
+    }
+}
+
+// Make sure the parent sprite's texture is ready to draw.  Returns false if the draw should be skipped, in which
+// case renderResult holds the value the render call should return.
+bool PBGfx::gfxPrepareSpriteTexture(unsigned int parentSpriteId, unsigned int* textureId, bool* renderResult) {
+
+    stSpriteInfo& spriteInfo = m_spriteList[parentSpriteId];
+
+    // Change the textureID to no texture if the sprite is not using a texture
+    *textureId = spriteInfo.glTextureId;
+    *renderResult = true;
+
+    // Async sprites draw nothing until the upload finishes; an evicted async texture is re-queued rather than
+    // being decoded on the render thread
+    spriteInfo.lastRenderFrame = m_frameNumber;
+    if (spriteInfo.useTexture && spriteInfo.loadAsync) {
+        if (spriteInfo.isLoading) return (false);
+        if (!spriteInfo.isLoaded) {
+            gfxQueueAsyncLoad(parentSpriteId);
+            m_textureReloads++;
+            return (false);
+        }
+    }
+
+    // Check if a texture is being used, if it is, make sure the texture is loaded
+    // If the load fails, simply don't use a texture, which at least allows the render to continue, but the sprite will not be textured
+    if (spriteInfo.useTexture && !spriteInfo.isLoaded) {
+        if (!gfxReloadTexture(parentSpriteId)) {
+            *renderResult = (*textureId == 0);
+            return (false);
+        }
+        // Pick up the new texture ID (the texture may have been evicted by the residency manager)
+        *textureId = spriteInfo.glTextureId;
+    }
+
+    return (true);
+}
+
+// Convert a sprite instance to GPU instance data and add it to the pending batch
+void PBGfx::gfxQueueSpriteBatch(const stSpriteInstance& instance, bool useCenter) {
+
+    stOglSpriteInstance batchInstance;
+    gfxSpriteToNDC(instance, useCenter, &batchInstance.x1, &batchInstance.y1, &batchInstance.x2, &batchInstance.y2);
+    batchInstance.u1 = instance.u1;
+    batchInstance.v1 = instance.v1;
+    batchInstance.u2 = instance.u2;
+    batchInstance.v2 = instance.v2;
+    batchInstance.red = instance.vertRed;
+    batchInstance.green = instance.vertGreen;
+    batchInstance.blue = instance.vertBlue;
+    batchInstance.alpha = instance.vertAlpha;
+    batchInstance.scale = instance.scaleFactor;
+    batchInstance.rotateRadians = instance.rotateDegrees * 3.14159f / 180.0f;
+    batchInstance.pivotCenter = useCenter ? 1.0f : 0.0f;
+    batchInstance.texAlpha = instance.textureAlpha;
+    m_spriteBatch.push_back(batchInstance);
+}
+
+// Draw the queued sprite batch for one parent sprite and empty the queue
+void PBGfx::gfxFlushSpriteBatch(unsigned int parentSpriteId) {
+
+    if (m_spriteBatch.empty()) return;
+
+    bool useTexAlpha = (m_spriteList[parentSpriteId].textureType == GFX_BMP ||
+                        m_spriteList[parentSpriteId].textureType == GFX_VIDEO) ? true : false;
+
+    unsigned int textureId = 0;
+    bool renderResult = true;
+    if (gfxPrepareSpriteTexture(parentSpriteId, &textureId, &renderResult)) {
+        oglRenderQuadInstances(m_spriteBatch.data(), (unsigned int)m_spriteBatch.size(), useTexAlpha, textureId);
+    }
+
+    m_spriteBatch.clear();
+}
+
+// Render a list of sprite instances, batching consecutive instances of the same parent sprite into one draw call.
+// Draw order follows the list.  Returns false if any ID is not a valid sprite instance.
+bool PBGfx::gfxRenderSpriteBatch(const unsigned int* spriteIds, unsigned int count) {
+
+    if (spriteIds == nullptr) return (false);
+
+    bool result = true;
+    unsigned int batchParentId = 0;
+    m_spriteBatch.clear();
+
+    for (unsigned int i = 0; i < count; i++) {
+        auto it = m_instanceList.find(spriteIds[i]);
+        if (it == m_instanceList.end()) {
+            result = false;
+            continue;
+        }
+
+        // Sprites that need a bounding box keep using the CPU path, which computes it
+        if (it->second.updateBoundingBox) {
+            gfxFlushSpriteBatch(batchParentId);
+            if (!gfxRenderSprite(spriteIds[i])) result = false;
+            continue;
+        }
+
+        if (!m_spriteBatch.empty() && it->second.parentSpriteId != batchParentId) gfxFlushSpriteBatch(batchParentId);
+        batchParentId = it->second.parentSpriteId;
+
+        gfxQueueSpriteBatch(it->second, m_spriteList[batchParentId].textureCenter == GFX_CENTER);
+    }
+
+    gfxFlushSpriteBatch(batchParentId);
+    return (result);
+}
+
+// Render raw instance data (for particles and other effects that do not need a sprite ID per copy) using the
+// texture of spriteId's parent sprite.  The parentSpriteId and updateBoundingBox fields of the instances are ignored.
+bool PBGfx::gfxRenderSpriteBatch(unsigned int spriteId, const stSpriteInstance* instances, unsigned int count) {
+
+    auto it = m_instanceList.find(spriteId);
+    if (it == m_instanceList.end() || instances == nullptr) return (false);
+
+    unsigned int parentSpriteId = it->second.parentSpriteId;
+    bool useCenter = m_spriteList[parentSpriteId].textureCenter == GFX_CENTER ? true : false;
+
+    m_spriteBatch.clear();
+    for (unsigned int i = 0; i < count; i++) {
+        gfxQueueSpriteBatch(instances[i], useCenter);
+    }
+
+    gfxFlushSpriteBatch(parentSpriteId);
+    return (true);
+}
+
 // This version just uses the X and Y values from the sprite instance
 
 bool PBGfx::gfxRenderString(unsigned int spriteId, std::string input, unsigned int spacingPixels, gfxTextJustify justify) {
@@ -618,11 +1045,90 @@ int  PBGfx::gfxStringWidth(unsigned int spriteId, std::string input, unsigned in
                                 
 
 void PBGfx::gfxSwap() {
-    oglSwap(false);
+    gfxSwap(false);
 }
 
+// End of frame - apply the texture budget before the frame counter moves on
 void PBGfx::gfxSwap(bool flush) {
     oglSwap(flush);
+    gfxEnforceTextureBudget();
+    gfxReleaseIdleLayers();
+    m_frameNumber++;
+}
+
+// Start a retained layer.  Returns true if the caller needs to draw the layer content this frame.
+bool PBGfx::gfxBeginLayer(unsigned int layerId, unsigned long stateKey) {
+
+    stGfxLayer& layer = m_layerList[layerId];
+
+    // A layer that skipped a frame belongs to a screen that was just re-entered - anything may have changed meanwhile
+    if (layer.lastUsedFrame + 1 < m_frameNumber) layer.valid = false;
+    layer.lastUsedFrame = m_frameNumber;
+    layer.drawnThisFrame = false;
+
+    if (layer.valid && layer.stateKey == stateKey) return (false);
+
+    if (layer.framebuffer == 0) {
+        GLuint framebuffer = 0, textureId = 0;
+        if (oglCreateRenderTarget(&framebuffer, &textureId)) {
+            layer.framebuffer = framebuffer;
+            layer.textureId = textureId;
+        }
+    }
+
+    // No render target available - the caller draws straight to the screen every frame
+    layer.valid = false;
+    if (layer.framebuffer == 0) return (true);
+
+    oglBeginRenderTarget(layer.framebuffer);
+    layer.stateKey = stateKey;
+    layer.capturing = true;
+    m_layerRedraws++;
+    return (true);
+}
+
+// Finish a retained layer and draw it over the frame
+void PBGfx::gfxEndLayer(unsigned int layerId) {
+
+    auto it = m_layerList.find(layerId);
+    if (it == m_layerList.end()) return;
+    stGfxLayer& layer = it->second;
+
+    if (layer.capturing) {
+        oglEndRenderTarget();
+        layer.capturing = false;
+        layer.drawnThisFrame = true;
+        // Sprites still streaming in drew nothing, so keep redrawing until they have all arrived
+        layer.valid = (gfxAsyncLoadsPending() == 0);
+    }
+
+    if (layer.framebuffer != 0 && (layer.valid || layer.drawnThisFrame)) oglCompositeRenderTarget(layer.textureId);
+}
+
+void PBGfx::gfxInvalidateLayer(unsigned int layerId) {
+    auto it = m_layerList.find(layerId);
+    if (it != m_layerList.end()) it->second.valid = false;
+}
+
+void PBGfx::gfxInvalidateAllLayers() {
+    for (auto it = m_layerList.begin(); it != m_layerList.end(); ++it) it->second.valid = false;
+}
+
+// Fold a value into a layer state key (hash combine), start with key = 0
+unsigned long PBGfx::gfxLayerKey(unsigned long key, long value) {
+    key ^= (unsigned long)value + 0x9E3779B9UL + (key << 6) + (key >> 2);
+    return (key * 0x01000193UL);
+}
+
+// Free the render targets of layers whose screen is no longer shown
+void PBGfx::gfxReleaseIdleLayers() {
+    for (auto it = m_layerList.begin(); it != m_layerList.end(); ) {
+        if (it->second.lastUsedFrame + GFX_LAYER_IDLE_FRAMES < m_frameNumber) {
+            oglDestroyRenderTarget(it->second.framebuffer, it->second.textureId);
+            it = m_layerList.erase(it);
+        }
+        else ++it;
+    }
 }
 
 void PBGfx::gfxClear(float red, float blue, float green, float alpha, bool doFlip){
@@ -1511,3 +2017,42 @@ bool PBGfx::gfxUpdateVideoTexture(unsigned int spriteId, const uint8_t* frameDat
     // Update the OpenGL texture with new frame data
     return oglUpdateTexture(m_spriteList[it->second.parentSpriteId].glTextureId, frameData, width, height);
 }
+
+// Update a planar video texture (sprite loaded from a "WxH:i420" or "WxH:nv12" texture name) with a decoded
+// frame's Y/U/V or Y/UV planes.  Colour conversion happens in the shader at draw time.
+bool PBGfx::gfxUpdateVideoPlanes(unsigned int spriteId, const uint8_t* const planes[3], const int strides[3],
+                                 unsigned int width, unsigned int height, bool bt709, bool fullRange) {
+
+    auto it = m_instanceList.find(spriteId);
+    if (it == m_instanceList.end()) {
+        return false;
+    }
+
+    const stSpriteInfo& spriteInfo = m_spriteList[it->second.parentSpriteId];
+    if (spriteInfo.textureType != GFX_VIDEO || !spriteInfo.isLoaded) {
+        return false;
+    }
+
+    if (width != spriteInfo.baseWidth || height != spriteInfo.baseHeight) {
+        return false;
+    }
+
+    return oglUpdateVideoPlanes(spriteInfo.glTextureId, planes, strides, width, height, bt709, fullRange);
+}
+
+// Show a decoder frame held in DMA buffers in a "WxH:dmabuf" video texture without copying it.  Returns false
+// when the frame could not be imported; the caller should upload its planes with gfxUpdateVideoPlanes instead.
+bool PBGfx::gfxUpdateVideoDmabuf(unsigned int spriteId, const stOglDmabufFrame& frame) {
+
+    auto it = m_instanceList.find(spriteId);
+    if (it == m_instanceList.end()) {
+        return false;
+    }
+
+    const stSpriteInfo& spriteInfo = m_spriteList[it->second.parentSpriteId];
+    if (spriteInfo.textureType != GFX_VIDEO || !spriteInfo.isLoaded) {
+        return false;
+    }
+
+    return oglUpdateVideoDmabuf(spriteInfo.glTextureId, frame);
+}
@@ -26,12 +26,27 @@
 #include <cmath>
 #include <chrono>
 #include <random>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "3rdparty/json.hpp"
 #include "PB3D.h"
  
 #define NOSPRITE 0
 #define SYSTEMFONTSPRITE "src/user/resources/fonts/Ubuntu-Regular_24_256.png"
 
+// Async texture streaming - worker threads decode image files, the render thread uploads them
+#define GFX_ASYNC_LOAD_THREADS     2    // Number of decode worker threads used by gfxLoadSpriteAsync
+#define GFX_ASYNC_UPLOAD_BUDGET_MS 4    // Default per-frame time budget for texture uploads in gfxProcessAsyncLoads
+
+// Texture residency - non keepResident textures are evicted least-recently-rendered first when over budget
+#define GFX_TEXTURE_BUDGET_MB      192  // Default GPU texture memory budget, change at runtime with gfxSetTextureBudget
+
+// Retained layers - static screen content is drawn once into an off-screen target and composited each frame
+#define GFX_LAYER_IDLE_FRAMES      120  // Layers not used for this many frames release their render target
+
 using json = nlohmann::json;
 
 // Define an enum for different texture file sources
@@ -89,6 +104,34 @@ struct stSpriteInfo {
     unsigned int baseHeight;
     unsigned int glTextureId;
     bool isLoaded;
+    bool isLoading;               // Texture is being decoded / waiting for upload (async sprites only)
+    bool loadAsync;               // Sprite was created with gfxLoadSpriteAsync, reloads also go through the async loader
+    unsigned int loadGeneration;  // Incremented on every async request so stale decode results are dropped
+    unsigned long gpuBytes;       // GPU memory used by the texture while loaded (0 when not loaded)
+    unsigned long lastRenderFrame; // Frame number the sprite was last rendered, used for LRU eviction
+};
+
+// Texture residency statistics reported by gfxGetTextureStats
+struct stTextureStats {
+    unsigned long residentBytes;
+    unsigned long budgetBytes;
+    unsigned int  residentCount;
+    unsigned int  evictionCount;
+    unsigned int  reloadCount;
+    unsigned int  layerCount;       // Retained layers holding a render target
+    unsigned long layerBytes;
+    unsigned int  layerRedraws;     // Layer content re-renders since startup (everything else was a cache hit)
+};
+
+// A retained layer: screen sized render target plus the state key its content was drawn with
+struct stGfxLayer {
+    unsigned int  framebuffer;
+    unsigned int  textureId;
+    unsigned long stateKey;
+    unsigned long lastUsedFrame;
+    bool          valid;            // Render target holds content matching stateKey
+    bool          capturing;        // Between gfxBeginLayer and gfxEndLayer, drawing into the render target
+    bool          drawnThisFrame;   // Render target was (re)drawn this frame, composite it even if it is now invalid
 };
 
 // Holds the current rendering information of the sprite instance - all things that can change or be animated
@@ -110,6 +153,16 @@ struct stSpriteInstance {
     stBoundingBox boundingBox;
 };
 
+// Work item passed between the render thread and the texture decode workers
+struct stAsyncTextureLoad {
+    unsigned int spriteId;
+    unsigned int loadGeneration;
+    std::string textureFileName;
+    gfxTexType textureType;
+    stOglImageData image;
+    bool decoded;
+};
+
 struct stTextMapData {
     unsigned int width;
     unsigned int height;
@@ -180,6 +233,28 @@ public:
     bool         gfxUnloadAllTextures();
     bool         gfxReloadTexture(unsigned int spriteId);
     bool         gfxTextureLoaded(unsigned int spriteId);
+
+    // Asynchronous sprite creation - returns the sprite ID immediately, the texture is decoded on a worker
+    // thread and uploaded by gfxProcessAsyncLoads.  The sprite renders nothing until the upload completes.
+    unsigned int gfxLoadSpriteAsync(const std::string& spriteName, const std::string& textureFileName, gfxTexType textureType,
+                                    gfxSpriteMap mapType, gfxTexCenter textureCenter, bool keepResident, bool useTexture);
+    bool         gfxIsLoading(unsigned int spriteId);
+    unsigned int gfxAsyncLoadsPending();
+    unsigned int gfxProcessAsyncLoads(unsigned int budgetMs);
+
+    // Texture residency management
+    void           gfxSetTextureBudget(unsigned long budgetBytes);
+    stTextureStats gfxGetTextureStats();
+
+    // Retained layers.  gfxBeginLayer returns true when the caller must draw the layer content (first use, state
+    // key changed, or invalidated); the content is captured until gfxEndLayer, which composites the layer either way.
+    // When it returns false skip the drawing and just call gfxEndLayer.  The state key should change whenever
+    // anything that affects the layer's content changes - gfxLayerKey helps combine several values into one.
+    bool           gfxBeginLayer(unsigned int layerId, unsigned long stateKey);
+    void           gfxEndLayer(unsigned int layerId);
+    void           gfxInvalidateLayer(unsigned int layerId);
+    void           gfxInvalidateAllLayers();
+    static unsigned long gfxLayerKey(unsigned long key, long value);
     
     unsigned int gfxInstanceSprite (unsigned int parentSpriteId, int x, int y, unsigned int textureAlpha, 
                                     unsigned int vertRed, unsigned int vertGreen, unsigned int vertBlue, unsigned int vertAlpha, float scaleFactor, float rotateDegrees);
@@ -193,6 +268,13 @@ public:
     bool         gfxRenderSprite(unsigned int spriteId, int x, int y);
     bool         gfxRenderSprite(unsigned int spriteId, int x, int y, float scaleFactor, float rotateDegrees);
 
+    // Instanced sprite batches - many copies of one texture in a single draw call, transformed on the GPU.
+    // The first form renders the given instance IDs (consecutive IDs sharing a parent sprite are batched together),
+    // the second renders raw instance data against the parent sprite of spriteId.  Bounding boxes are not updated
+    // by batches; instances with updateBoundingBox set are rendered individually through gfxRenderSprite.
+    bool         gfxRenderSpriteBatch(const unsigned int* spriteIds, unsigned int count);
+    bool         gfxRenderSpriteBatch(unsigned int spriteId, const stSpriteInstance* instances, unsigned int count);
+
     // Character rendering functions
     bool         gfxRenderString(unsigned int spriteId, std::string input, unsigned int spacingPixels, gfxTextJustify justify);
     bool         gfxRenderString(unsigned int spriteId, std::string input, int x, int y, int spacingPixels, gfxTextJustify justify);
@@ -248,9 +330,31 @@ public:
     
     // Video texture functions
     bool         gfxUpdateVideoTexture(unsigned int spriteId, const uint8_t* frameData, unsigned int width, unsigned int height);
+    bool         gfxUpdateVideoPlanes(unsigned int spriteId, const uint8_t* const planes[3], const int strides[3],
+                                      unsigned int width, unsigned int height, bool bt709, bool fullRange);
+    bool         gfxVideoPlanesAvailable() { return (oglVideoPlanesAvailable()); }
+    bool         gfxUpdateVideoDmabuf(unsigned int spriteId, const stOglDmabufFrame& frame);
+    bool         gfxDmabufImportAvailable() { return (oglDmabufImportAvailable()); }
     
 private:
-    unsigned int gfxSysLoadSprite(stSpriteInfo spriteInfo, bool bSystem);
+    unsigned int gfxSysLoadSprite(stSpriteInfo spriteInfo, bool bSystem, bool bAsync);
+
+    // Sprite render helpers shared by gfxRenderSprite and the batch path
+    bool gfxPrepareSpriteTexture(unsigned int parentSpriteId, unsigned int* textureId, bool* renderResult);
+    void gfxSpriteToNDC(const stSpriteInstance& instance, bool useCenter, float* x1, float* y1, float* x2, float* y2);
+    void gfxQueueSpriteBatch(const stSpriteInstance& instance, bool useCenter);
+    void gfxFlushSpriteBatch(unsigned int parentSpriteId);
+
+    // Async texture loader helpers
+    bool gfxQueueAsyncLoad(unsigned int spriteId);
+    void gfxAsyncLoadWorker();
+    void gfxShutdownAsyncLoader();
+
+    // Texture residency helpers
+    void gfxTrackTextureLoaded(stSpriteInfo& spriteInfo, unsigned int width, unsigned int height);
+    void gfxTrackTextureUnloaded(stSpriteInfo& spriteInfo);
+    void gfxEnforceTextureBudget();
+    void gfxReleaseIdleLayers();
     
     // Helper functions for animation types
     void gfxAnimateNormal(stAnimateData& animateData, unsigned int currentTick, float timeSinceStart, float percentComplete);
@@ -276,6 +380,29 @@ private:
     // Animation list
     std::map<unsigned int, stAnimateData> m_animateList; 
 
+    // Scratch storage for sprite batches, reused every call so batching does not allocate per frame
+    std::vector<stOglSpriteInstance> m_spriteBatch;
+
+    // Async texture loader state - requests and results are guarded by m_asyncMutex
+    std::vector<std::thread>       m_asyncWorkers;
+    std::deque<stAsyncTextureLoad> m_asyncRequests;
+    std::deque<stAsyncTextureLoad> m_asyncResults;
+    std::mutex                     m_asyncMutex;
+    std::condition_variable        m_asyncCondition;
+    bool                           m_asyncShutdown;
+    unsigned int                   m_asyncInFlight;    // Render thread only: requests queued but not yet consumed
+
+    // Texture residency state
+    unsigned long m_textureBudgetBytes;
+    unsigned long m_residentTextureBytes;
+    unsigned long m_frameNumber;
+    unsigned int  m_textureEvictions;
+    unsigned int  m_textureReloads;
+
+    // Retained layer state
+    std::map<unsigned int, stGfxLayer> m_layerList;
+    unsigned int  m_layerRedraws;
+
 };
 
 #endif // PBGfx_h
@@ -0,0 +1,606 @@
+// PBMusic - FFmpeg-based streaming music player with prebuffering, gapless queueing and crossfades
+// Copyright (c) 2025 Jeffrey D. Bock, unless otherwise noted. Licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+// The license can be found here: <https://creativecommons.org/licenses/by-nc/4.0/>.
+// Additional details can also be found in the license file in the root of the project.
+
+#include "PBMusic.h"
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libswresample/swresample.h>
+#include <libavutil/opt.h>
+#include <libavutil/channel_layout.h>
+}
+
+// Samples mixed per step on the audio thread
+static const int PBM_MIX_BLOCK = 512;
+
+PBMusic::PBMusic() : sampleRate(44100), paused(false), currentDeck(-1), claimCount(0), decodeThreadStop(false) {
+    for (int i = 0; i < PBM_DECKS; i++) {
+        stMusicDeck& deck = decks[i];
+        deck.claimOrder = 0;
+        deck.state = PBM_DECK_FREE;
+        deck.startMode = PBM_START_HOLD;
+        deck.startFadeMs = 0;
+        deck.stopFadeMs = -1;
+        deck.loop = false;
+        deck.endOfStream = false;
+        deck.formatContext = nullptr;
+        deck.codecContext = nullptr;
+        deck.swrContext = nullptr;
+        deck.packet = nullptr;
+        deck.frame = nullptr;
+        deck.streamIndex = -1;
+        deck.draining = false;
+        deck.ringWrite = 0;
+        deck.ringRead = 0;
+        deck.audible = false;
+        deck.gain = 0.0f;
+        deck.gainStep = 0.0f;
+    }
+}
+
+PBMusic::~PBMusic() {
+    pbmShutdown();
+}
+
+bool PBMusic::pbmInitialize(int outputSampleRate) {
+    if (decodeThread.joinable()) {
+        return true;
+    }
+
+    sampleRate = outputSampleRate;
+    decodeThreadStop = false;
+    decodeThread = std::thread(&PBMusic::decodeThreadMain, this);
+    return true;
+}
+
+void PBMusic::pbmShutdown() {
+    if (!decodeThread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(decodeMutex);
+        decodeThreadStop = true;
+    }
+    decodeCondition.notify_all();
+    decodeThread.join();
+    currentDeck = -1;
+}
+
+// ============================================================================
+// Main thread
+// ============================================================================
+
+bool PBMusic::pbmPlay(const std::string& filePath, int crossfadeMs, bool loop) {
+    if (!decodeThread.joinable()) {
+        return false;
+    }
+
+    int index = findPrebuffered(filePath);
+    if (index != -1) {
+        decks[index].loop = loop;
+    } else {
+        index = claimDeck(filePath, loop);
+        if (index == -1) {
+            return false;
+        }
+    }
+
+    // Anything still waiting to start is superseded; playing decks are faded out by the audio thread
+    // at the moment this one starts, so the crossfade lines up with the new track's first sample
+    cancelPending(index);
+    stMusicDeck& deck = decks[index];
+    deck.startFadeMs = std::max(0, crossfadeMs);
+    deck.startMode.store(PBM_START_NOW, std::memory_order_release);
+    currentDeck = index;
+    return true;
+}
+
+bool PBMusic::pbmQueue(const std::string& filePath, bool loop) {
+    if (!decodeThread.joinable()) {
+        return false;
+    }
+
+    // Nothing to follow - just play it
+    if (currentDeck == -1 || decks[currentDeck].startMode.load(std::memory_order_acquire) == PBM_START_HOLD) {
+        return pbmPlay(filePath, 0, loop);
+    }
+
+    int index = findPrebuffered(filePath);
+    if (index != -1) {
+        decks[index].loop = loop;
+    } else {
+        index = claimDeck(filePath, loop);
+        if (index == -1) {
+            return false;
+        }
+    }
+
+    // Only one track can be queued at a time
+    for (int i = 0; i < PBM_DECKS; i++) {
+        if (i != index && decks[i].startMode.load(std::memory_order_acquire) == PBM_START_AFTER_CURRENT) {
+            decks[i].stopFadeMs = 0;
+        }
+    }
+
+    // The current track plays out to its end instead of looping
+    decks[currentDeck].loop = false;
+    decks[index].startMode.store(PBM_START_AFTER_CURRENT, std::memory_order_release);
+    currentDeck = index;
+    return true;
+}
+
+bool PBMusic::pbmPrebuffer(const std::string& filePath) {
+    if (!decodeThread.joinable()) {
+        return false;
+    }
+    if (findPrebuffered(filePath) != -1) {
+        return true;
+    }
+    return claimDeck(filePath, true) != -1;
+}
+
+void PBMusic::pbmStop(int fadeMs) {
+    for (int i = 0; i < PBM_DECKS; i++) {
+        if (decks[i].startMode.load(std::memory_order_acquire) != PBM_START_HOLD) {
+            decks[i].stopFadeMs = std::max(0, fadeMs);
+        }
+    }
+    currentDeck = -1;
+}
+
+void PBMusic::pbmSetPaused(bool pause) {
+    paused = pause;
+}
+
+bool PBMusic::pbmIsPlaying() const {
+    for (int i = 0; i < PBM_DECKS; i++) {
+        int mode = decks[i].startMode.load(std::memory_order_acquire);
+        if (mode == PBM_START_PLAYING ||
+            (mode == PBM_START_NOW && decks[i].state.load(std::memory_order_acquire) != PBM_DECK_FAILED)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// A deck that was prebuffered for this file and is still waiting for a play request.  The state is read
+// again after the start mode: a deck the audio thread just finished with shows HOLD too, but is RELEASE by then.
+int PBMusic::findPrebuffered(const std::string& filePath) {
+    for (int i = 0; i < PBM_DECKS; i++) {
+        stMusicDeck& deck = decks[i];
+        if (deck.startMode.load(std::memory_order_acquire) != PBM_START_HOLD) {
+            continue;
+        }
+        int state = deck.state.load(std::memory_order_acquire);
+        if ((state == PBM_DECK_OPENING || state == PBM_DECK_LOADED) && deck.filePath == filePath) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Hand a free deck to the decode thread to open.  If every deck is busy, the oldest unused prebuffer
+// is released so the next request succeeds, and this one fails.
+int PBMusic::claimDeck(const std::string& filePath, bool loop) {
+    std::lock_guard<std::mutex> lock(decodeMutex);
+
+    int oldestHeld = -1;
+    for (int i = 0; i < PBM_DECKS; i++) {
+        stMusicDeck& deck = decks[i];
+        int state = deck.state.load(std::memory_order_acquire);
+        if (state == PBM_DECK_FREE || state == PBM_DECK_FAILED) {
+            deck.filePath = filePath;
+            deck.claimOrder = ++claimCount;
+            deck.startMode = PBM_START_HOLD;
+            deck.startFadeMs = 0;
+            deck.stopFadeMs = -1;
+            deck.loop = loop;
+            deck.endOfStream = false;
+            deck.state.store(PBM_DECK_OPENING, std::memory_order_release);
+            decodeCondition.notify_one();
+            return i;
+        }
+        if (state == PBM_DECK_LOADED && deck.startMode.load(std::memory_order_acquire) == PBM_START_HOLD &&
+            (oldestHeld == -1 || deck.claimOrder < decks[oldestHeld].claimOrder)) {
+            oldestHeld = i;
+        }
+    }
+
+    if (oldestHeld != -1) {
+        decks[oldestHeld].state.store(PBM_DECK_RELEASE, std::memory_order_release);
+        decodeCondition.notify_one();
+    }
+    return -1;
+}
+
+// Stop every deck other than keepDeck that was asked to start but has not yet
+void PBMusic::cancelPending(int keepDeck) {
+    for (int i = 0; i < PBM_DECKS; i++) {
+        int mode = decks[i].startMode.load(std::memory_order_acquire);
+        if (i != keepDeck && (mode == PBM_START_NOW || mode == PBM_START_AFTER_CURRENT)) {
+            decks[i].stopFadeMs = 0;
+        }
+    }
+}
+
+// ============================================================================
+// Decode thread
+// ============================================================================
+
+void PBMusic::decodeThreadMain() {
+    std::unique_lock<std::mutex> lock(decodeMutex);
+
+    while (!decodeThreadStop) {
+        bool busy = false;
+
+        // Open and close files - without the lock, so a claim on the main thread never waits on file I/O
+        for (int i = 0; i < PBM_DECKS; i++) {
+            stMusicDeck& deck = decks[i];
+            int state = deck.state.load(std::memory_order_acquire);
+            if (state == PBM_DECK_OPENING) {
+                lock.unlock();
+                bool opened = openDeck(deck);
+                lock.lock();
+                deck.state.store(opened ? PBM_DECK_LOADED : PBM_DECK_FAILED, std::memory_order_release);
+                busy = true;
+            } else if (state == PBM_DECK_RELEASE) {
+                lock.unlock();
+                closeDeck(deck);
+                lock.lock();
+                deck.state.store(PBM_DECK_FREE, std::memory_order_release);
+            }
+        }
+
+        // Top up every open ring, one decoder step per deck per pass so no track starves another
+        lock.unlock();
+        for (int i = 0; i < PBM_DECKS; i++) {
+            stMusicDeck& deck = decks[i];
+            if (deck.state.load(std::memory_order_acquire) != PBM_DECK_LOADED || deck.endOfStream.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            if (PBM_RING_SAMPLES - ringFill(deck) >= PBM_DECODE_HEADROOM && decodeStep(deck)) {
+                busy = true;
+            }
+        }
+        lock.lock();
+
+        if (!busy) {
+            decodeCondition.wait_for(lock, std::chrono::milliseconds(PBM_POLL_MS));
+        }
+    }
+
+    lock.unlock();
+    for (int i = 0; i < PBM_DECKS; i++) {
+        closeDeck(decks[i]);
+        decks[i].audible = false;
+        decks[i].startMode = PBM_START_HOLD;
+        decks[i].state = PBM_DECK_FREE;
+    }
+}
+
+bool PBMusic::openDeck(stMusicDeck& deck) {
+    deck.formatContext = nullptr;
+    if (avformat_open_input(&deck.formatContext, deck.filePath.c_str(), nullptr, nullptr) != 0) {
+        deck.formatContext = nullptr;
+        return false;
+    }
+    if (avformat_find_stream_info(deck.formatContext, nullptr) < 0) {
+        closeDeck(deck);
+        return false;
+    }
+
+    deck.streamIndex = -1;
+    for (unsigned int i = 0; i < deck.formatContext->nb_streams; i++) {
+        if (deck.formatContext->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
+            deck.streamIndex = (int)i;
+            break;
+        }
+    }
+    if (deck.streamIndex < 0) {
+        closeDeck(deck);
+        return false;
+    }
+
+    AVCodecParameters* codecParams = deck.formatContext->streams[deck.streamIndex]->codecpar;
+    const AVCodec* codec = avcodec_find_decoder(codecParams->codec_id);
+    if (!codec) {
+        closeDeck(deck);
+        return false;
+    }
+    deck.codecContext = avcodec_alloc_context3(codec);
+    if (!deck.codecContext || avcodec_parameters_to_context(deck.codecContext, codecParams) < 0 ||
+        avcodec_open2(deck.codecContext, codec, nullptr) < 0) {
+        closeDeck(deck);
+        return false;
+    }
+
+    // Resample to interleaved stereo float at the mixer's rate
+    deck.swrContext = swr_alloc();
+    if (!deck.swrContext) {
+        closeDeck(deck);
+        return false;
+    }
+    AVChannelLayout in_ch_layout = deck.codecContext->ch_layout;
+    AVChannelLayout out_ch_layout = AV_CHANNEL_LAYOUT_STEREO;
+    av_opt_set_chlayout(deck.swrContext, "in_chlayout", &in_ch_layout, 0);
+    av_opt_set_int(deck.swrContext, "in_sample_rate", deck.codecContext->sample_rate, 0);
+    av_opt_set_sample_fmt(deck.swrContext, "in_sample_fmt", deck.codecContext->sample_fmt, 0);
+    av_opt_set_chlayout(deck.swrContext, "out_chlayout", &out_ch_layout, 0);
+    av_opt_set_int(deck.swrContext, "out_sample_rate", sampleRate, 0);
+    av_opt_set_sample_fmt(deck.swrContext, "out_sample_fmt", AV_SAMPLE_FMT_FLT, 0);
+    if (swr_init(deck.swrContext) < 0) {
+        closeDeck(deck);
+        return false;
+    }
+
+    deck.packet = av_packet_alloc();
+    deck.frame = av_frame_alloc();
+    if (!deck.packet || !deck.frame) {
+        closeDeck(deck);
+        return false;
+    }
+
+    deck.draining = false;
+    deck.endOfStream = false;
+    deck.ringWrite = 0;
+    deck.ringRead = 0;
+    return true;
+}
+
+// Decode thread (or after it has stopped) - the audio thread no longer reads this deck's ring
+void PBMusic::closeDeck(stMusicDeck& deck) {
+    if (deck.frame) {
+        av_frame_free(&deck.frame);
+        deck.frame = nullptr;
+    }
+    if (deck.packet) {
+        av_packet_free(&deck.packet);
+        deck.packet = nullptr;
+    }
+    if (deck.swrContext) {
+        swr_free(&deck.swrContext);
+        deck.swrContext = nullptr;
+    }
+    if (deck.codecContext) {
+        avcodec_free_context(&deck.codecContext);
+        deck.codecContext = nullptr;
+    }
+    if (deck.formatContext) {
+        avformat_close_input(&deck.formatContext);
+        deck.formatContext = nullptr;
+    }
+    deck.streamIndex = -1;
+    deck.draining = false;
+    deck.ringWrite = 0;
+    deck.ringRead = 0;
+}
+
+// One decoder step: hand back a frame, or feed a packet.  Returns false once there is nothing more to do.
+// At the end of the file the decoder is drained first, so a looping track wraps with no gap and no lost tail.
+bool PBMusic::decodeStep(stMusicDeck& deck) {
+    int result = avcodec_receive_frame(deck.codecContext, deck.frame);
+    if (result == 0) {
+        float converted[PBM_DECODE_HEADROOM];
+        uint8_t* output = (uint8_t*)converted;
+        int frames = swr_convert(deck.swrContext, &output, PBM_DECODE_HEADROOM / 2,
+                                 (const uint8_t**)deck.frame->data, deck.frame->nb_samples);
+        av_frame_unref(deck.frame);
+        if (frames > 0) {
+            writeRing(deck, converted, frames * 2);
+        }
+        return true;
+    }
+
+    if (result != AVERROR(EAGAIN) || deck.draining) {
+        // End of file (or an unrecoverable decoder error)
+        if (deck.loop.load(std::memory_order_relaxed)) {
+            av_seek_frame(deck.formatContext, -1, 0, AVSEEK_FLAG_BACKWARD);
+            avcodec_flush_buffers(deck.codecContext);
+            deck.draining = false;
+            return true;
+        }
+        deck.endOfStream.store(true, std::memory_order_release);
+        return false;
+    }
+
+    if (av_read_frame(deck.formatContext, deck.packet) < 0) {
+        avcodec_send_packet(deck.codecContext, nullptr);
+        deck.draining = true;
+        return true;
+    }
+    if (deck.packet->stream_index == deck.streamIndex) {
+        avcodec_send_packet(deck.codecContext, deck.packet);  // a bad packet is skipped
+    }
+    av_packet_unref(deck.packet);
+    return true;
+}
+
+// Producer side: append samples to the ring (the headroom check before decoding means they always fit)
+void PBMusic::writeRing(stMusicDeck& deck, const float* samples, int count) {
+    unsigned int write = deck.ringWrite.load(std::memory_order_relaxed);
+    unsigned int space = PBM_RING_SAMPLES - (write - deck.ringRead.load(std::memory_order_acquire));
+    count = std::min(count, (int)space) & ~1;
+    int start = write & (PBM_RING_SAMPLES - 1);
+    int firstPart = std::min(count, PBM_RING_SAMPLES - start);
+    memcpy(deck.ring + start, samples, firstPart * sizeof(float));
+    memcpy(deck.ring, samples + firstPart, (count - firstPart) * sizeof(float));
+    deck.ringWrite.store(write + count, std::memory_order_release);
+}
+
+// ============================================================================
+// Audio thread
+// ============================================================================
+
+// Samples in a deck's ring (producer or consumer side)
+unsigned int PBMusic::ringFill(const stMusicDeck& deck) {
+    return deck.ringWrite.load(std::memory_order_acquire) - deck.ringRead.load(std::memory_order_acquire);
+}
+
+void PBMusic::pbmMix(float* output, int frames) {
+    memset(output, 0, frames * 2 * sizeof(float));
+    if (paused) {
+        return;
+    }
+
+    // Requests from the main thread - stops first, then starts.  Only loaded decks are touched; a request
+    // for a deck that is still opening waits until it has loaded.
+    bool anyAudible = false;
+    for (int i = 0; i < PBM_DECKS; i++) {
+        stMusicDeck& deck = decks[i];
+        if (deck.state.load(std::memory_order_acquire) != PBM_DECK_LOADED) {
+            continue;
+        }
+        if (deck.stopFadeMs.load(std::memory_order_relaxed) >= 0) {
+            int fadeMs = deck.stopFadeMs.exchange(-1);
+            if (deck.audible) {
+                fadeOutDeck(deck, fadeMs);
+            } else if (deck.startMode.load(std::memory_order_relaxed) != PBM_START_HOLD) {
+                releaseDeck(deck);
+                continue;
+            }
+        }
+        if (!deck.audible && deck.startMode.load(std::memory_order_acquire) == PBM_START_NOW &&
+            (ringFill(deck) >= PBM_START_SAMPLES || deck.endOfStream.load(std::memory_order_acquire))) {
+            // Crossfade: every other track fades out over the time this one fades in
+            int fadeMs = deck.startFadeMs;
+            for (int j = 0; j < PBM_DECKS; j++) {
+                if (j != i && decks[j].audible && decks[j].gainStep >= 0.0f) {
+                    fadeOutDeck(decks[j], fadeMs);
+                }
+            }
+            startDeck(deck, fadeMs);
+        }
+        anyAudible = anyAudible || deck.audible;
+    }
+
+    // A queued track with nothing in front of it (the previous one ended before it had loaded)
+    if (!anyAudible) {
+        for (int i = 0; i < PBM_DECKS; i++) {
+            stMusicDeck& deck = decks[i];
+            if (deck.state.load(std::memory_order_acquire) == PBM_DECK_LOADED &&
+                deck.startMode.load(std::memory_order_acquire) == PBM_START_AFTER_CURRENT &&
+                (ringFill(deck) >= PBM_START_SAMPLES || deck.endOfStream.load(std::memory_order_acquire))) {
+                startDeck(deck, 0);
+                break;
+            }
+        }
+    }
+
+    // Mix the decks that are audible now; a queued deck started below is mixed where the last one ended
+    bool mixNow[PBM_DECKS];
+    for (int i = 0; i < PBM_DECKS; i++) {
+        mixNow[i] = decks[i].audible;
+    }
+    for (int i = 0; i < PBM_DECKS; i++) {
+        if (!mixNow[i]) {
+            continue;
+        }
+        stMusicDeck& deck = decks[i];
+        int produced = mixDeck(deck, output, frames);
+        if (!deck.audible || produced == frames) {
+            continue;
+        }
+
+        // Ran dry - either an underrun (stay audible, the rest is silent) or the end of the track
+        if (!deck.endOfStream.load(std::memory_order_acquire) || ringFill(deck) != 0) {
+            continue;
+        }
+        bool fadingOut = deck.gainStep < 0.0f;
+        releaseDeck(deck);
+        if (fadingOut) {
+            continue;
+        }
+        for (int j = 0; j < PBM_DECKS; j++) {
+            stMusicDeck& next = decks[j];
+            if (next.state.load(std::memory_order_acquire) == PBM_DECK_LOADED &&
+                next.startMode.load(std::memory_order_acquire) == PBM_START_AFTER_CURRENT) {
+                startDeck(next, 0);
+                mixDeck(next, output + produced * 2, frames - produced);
+                break;
+            }
+        }
+    }
+}
+
+void PBMusic::startDeck(stMusicDeck& deck, int fadeMs) {
+    deck.audible = true;
+    if (fadeMs > 0) {
+        deck.gain = 0.0f;
+        deck.gainStep = 1000.0f / ((float)fadeMs * (float)sampleRate);
+    } else {
+        deck.gain = 1.0f;
+        deck.gainStep = 0.0f;
+    }
+    deck.startMode.store(PBM_START_PLAYING, std::memory_order_release);
+}
+
+void PBMusic::fadeOutDeck(stMusicDeck& deck, int fadeMs) {
+    if (fadeMs <= 0) {
+        releaseDeck(deck);
+        return;
+    }
+    deck.gainStep = -1000.0f / ((float)fadeMs * (float)sampleRate);
+}
+
+// Add up to 'frames' frames of the deck into output with its gain ramp.  Returns the frames read from the ring
+int PBMusic::mixDeck(stMusicDeck& deck, float* output, int frames) {
+    float block[PBM_MIX_BLOCK * 2];
+    int produced = 0;
+
+    while (produced < frames && deck.audible) {
+        int wanted = std::min(frames - produced, PBM_MIX_BLOCK);
+
+        unsigned int read = deck.ringRead.load(std::memory_order_relaxed);
+        unsigned int available = deck.ringWrite.load(std::memory_order_acquire) - read;
+        int count = std::min(wanted * 2, (int)available) & ~1;
+        int start = read & (PBM_RING_SAMPLES - 1);
+        int firstPart = std::min(count, PBM_RING_SAMPLES - start);
+        memcpy(block, deck.ring + start, firstPart * sizeof(float));
+        memcpy(block + firstPart, deck.ring, (count - firstPart) * sizeof(float));
+        deck.ringRead.store(read + count, std::memory_order_release);
+
+        int got = count / 2;
+        float* target = output + produced * 2;
+        float gain = deck.gain;
+        float step = deck.gainStep;
+        for (int i = 0; i < got; i++) {
+            gain += step;
+            if (gain >= 1.0f) {
+                gain = 1.0f;
+                step = (step > 0.0f) ? 0.0f : step;
+            } else if (gain <= 0.0f) {
+                gain = 0.0f;
+            }
+            target[i * 2] += block[i * 2] * gain;
+            target[i * 2 + 1] += block[i * 2 + 1] * gain;
+        }
+        deck.gain = gain;
+        deck.gainStep = step;
+        produced += got;
+
+        if (step < 0.0f && gain <= 0.0f) {
+            releaseDeck(deck);  // faded out
+            break;
+        }
+        if (got < wanted) {
+            break;
+        }
+    }
+    return produced;
+}
+
+// Audio thread: stop reading the deck and hand it back to the decode thread to close.  The state changes
+// before the start mode, so the main thread never takes a released deck for a prebuffered one.
+void PBMusic::releaseDeck(stMusicDeck& deck) {
+    deck.audible = false;
+    deck.gainStep = 0.0f;
+    deck.state.store(PBM_DECK_RELEASE, std::memory_order_release);
+    deck.startMode.store(PBM_START_HOLD, std::memory_order_release);
+}
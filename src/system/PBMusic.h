@@ -0,0 +1,155 @@
+// PBMusic - FFmpeg-based streaming music player with prebuffering, gapless queueing and crossfades
+// Copyright (c) 2025 Jeffrey D. Bock, unless otherwise noted. Licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+// The license can be found here: <https://creativecommons.org/licenses/by-nc/4.0/>.
+// Additional details can also be found in the license file in the root of the project.
+
+#ifndef PBMusic_h
+#define PBMusic_h
+
+#include "PBBuildSwitch.h"
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// Forward declarations for FFmpeg structures to avoid including FFmpeg headers in this header
+extern "C" {
+    struct AVFormatContext;
+    struct AVCodecContext;
+    struct AVFrame;
+    struct AVPacket;
+    struct SwrContext;
+}
+
+// Tracks that can be open at once: the playing track, one fading out, one queued or prebuffered, and a spare
+// so a new request never has to wait for a fade to finish.  Each deck holds PBM_RING_SAMPLES floats.
+#define PBM_DECKS 4
+
+// Decoded stereo float samples buffered per deck (power of two, about 0.75 s at 44.1kHz)
+#define PBM_RING_SAMPLES 65536
+
+// Free ring space the decode thread needs before decoding another frame (one resampled frame always fits)
+#define PBM_DECODE_HEADROOM 16384
+
+// Samples a deck must have buffered before it starts, so a track never starts into an underrun
+#define PBM_START_SAMPLES 16384
+
+// How often the decode thread tops up the rings when it has nothing else to do
+#define PBM_POLL_MS 10
+
+// Deck lifecycle.  The main thread claims FREE (or FAILED) decks, the decode thread opens and closes files,
+// and the audio thread releases decks it has finished playing.
+enum pbmDeckState {
+    PBM_DECK_FREE = 0,
+    PBM_DECK_OPENING,    // claimed, decode thread is opening the file
+    PBM_DECK_LOADED,     // open and decoding into its ring
+    PBM_DECK_FAILED,     // file could not be opened - nothing to close, may be claimed again
+    PBM_DECK_RELEASE     // done with - decode thread closes it and frees it
+};
+
+// When a loaded deck should become audible
+enum pbmStartMode {
+    PBM_START_HOLD = 0,      // prebuffered, waiting for a play request
+    PBM_START_NOW,           // start as soon as enough is buffered, crossfading any playing track out
+    PBM_START_AFTER_CURRENT, // start at the exact sample the playing track ends
+    PBM_START_PLAYING        // audible (set by the audio thread)
+};
+
+class PBMusic {
+public:
+    PBMusic();
+    ~PBMusic();
+
+    // Start the decode thread.  Output is interleaved stereo float at sampleRate
+    bool pbmInitialize(int sampleRate);
+    void pbmShutdown();
+
+    // Main thread controls - none of these touch the file system; opening and decoding happen on the
+    // decode thread, so they return immediately.
+
+    // Play a track, crossfading from whatever is playing once the new track has buffered (0 = cut).
+    // A track prebuffered with pbmPrebuffer starts without waiting.
+    bool pbmPlay(const std::string& filePath, int crossfadeMs, bool loop = true);
+
+    // Start a track with no gap when the current one reaches its end (the current track stops looping)
+    bool pbmQueue(const std::string& filePath, bool loop = true);
+
+    // Open and decode the start of a track ahead of a pbmPlay / pbmQueue for it
+    bool pbmPrebuffer(const std::string& filePath);
+
+    // Fade out (0 = cut) everything playing or waiting to play
+    void pbmStop(int fadeMs);
+
+    void pbmSetPaused(bool paused);
+    bool pbmIsPaused() const { return paused; }
+    bool pbmIsPlaying() const;
+
+    // Audio thread - mix the playing decks into 'output' (frames * 2 floats, overwritten).  Never blocks.
+    void pbmMix(float* output, int frames);
+
+private:
+    struct stMusicDeck {
+        // Written by the main thread while the deck is FREE / FAILED, read by the decode thread
+        std::string filePath;
+        unsigned long claimOrder;
+
+        std::atomic<int> state;           // pbmDeckState
+        std::atomic<int> startMode;       // pbmStartMode
+        std::atomic<int> startFadeMs;     // fade-in for PBM_START_NOW
+        std::atomic<int> stopFadeMs;      // pending stop request, -1 = none
+        std::atomic<bool> loop;           // read by the decode thread at end of file
+        std::atomic<bool> endOfStream;    // decode thread has written the last sample
+
+        // Decode thread only
+        AVFormatContext* formatContext;
+        AVCodecContext* codecContext;
+        SwrContext* swrContext;
+        AVPacket* packet;
+        AVFrame* frame;
+        int streamIndex;
+        bool draining;                    // end of file reached, collecting the decoder's last frames
+
+        // Single-producer / single-consumer ring, positions wrap naturally (see PBVideo's audio ring)
+        float ring[PBM_RING_SAMPLES];
+        std::atomic<unsigned int> ringWrite;
+        std::atomic<unsigned int> ringRead;
+
+        // Audio thread only
+        bool audible;
+        float gain;
+        float gainStep;                   // per frame; negative while fading out
+    };
+
+    stMusicDeck decks[PBM_DECKS];
+    int sampleRate;
+    std::atomic<bool> paused;
+    int currentDeck;                      // main thread: the deck most recently asked to play, -1 if none
+    unsigned long claimCount;
+
+    std::thread decodeThread;
+    std::mutex decodeMutex;
+    std::condition_variable decodeCondition;
+    bool decodeThreadStop;
+
+    // Main thread helpers
+    int findPrebuffered(const std::string& filePath);
+    int claimDeck(const std::string& filePath, bool loop);
+    void cancelPending(int keepDeck);
+
+    // Decode thread helpers
+    void decodeThreadMain();
+    bool openDeck(stMusicDeck& deck);
+    void closeDeck(stMusicDeck& deck);
+    bool decodeStep(stMusicDeck& deck);
+    void writeRing(stMusicDeck& deck, const float* samples, int count);
+
+    // Audio thread helpers
+    static unsigned int ringFill(const stMusicDeck& deck);
+    void startDeck(stMusicDeck& deck, int fadeMs);
+    void fadeOutDeck(stMusicDeck& deck, int fadeMs);
+    int mixDeck(stMusicDeck& deck, float* output, int frames);
+    void releaseDeck(stMusicDeck& deck);
+};
+
+#endif // PBMusic_h
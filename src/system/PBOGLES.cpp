@@ -6,6 +6,7 @@
 // Additional details can also be found in the license file in the root of the project.
 
 #include "PBOGLES.h"
+#include <chrono>
 
 PBOGLES::PBOGLES() {
 
@@ -13,12 +14,40 @@ PBOGLES::PBOGLES() {
     m_height = 0;
     m_width = 0;
     m_aspectRatio = 0.0f;
-    m_lastTextureId = 0;
     m_started = false;
     m_scissorEnabled    = false;
     m_depthTestEnabled  = false;
     m_cullFaceEnabled   = false;
     m_blendEnabled      = false;
+
+    // GL state cache starts at the GL defaults for a fresh context
+    m_boundProgram       = 0;
+    m_boundVao           = 0;
+    m_boundArrayBuffer   = 0;
+    m_boundElementBuffer = 0;
+    for (int i = 0; i < OGL_MAX_TEXTURE_UNITS; i++) m_boundTexture[i] = 0;
+    m_activeTextureUnit  = 0;
+    m_blendSrc           = GL_ONE;
+    m_blendDst           = GL_ZERO;
+    m_blendSrcAlpha      = GL_ONE;
+    m_blendDstAlpha      = GL_ZERO;
+    m_boundFramebuffer   = 0;
+    m_depthFunc          = GL_LESS;
+    m_depthMaskEnabled   = true;
+    m_scissorX = m_scissorY = m_scissorW = m_scissorH = -1;
+    m_2dAttribsSet       = false;
+    m_cachedTexAlpha = m_cachedUseTexAlpha = m_cachedUseTexture = -1.0f;
+    m_cached3dAlpha  = m_cached3dSkAlpha = -1.0f;
+    m_glCallCount        = 0;
+    m_glSkippedCount     = 0;
+    m_glCallsLastFrame   = 0;
+    m_glSkippedLastFrame = 0;
+    m_videoUploads = 0;
+    m_videoUploadsLastFrame = 0;
+    m_videoUploadBytes = 0;
+    m_videoUploadBytesLastFrame = 0;
+    m_videoUploadMicros = 0;
+    m_videoUploadMicrosLastFrame = 0;
 #ifdef SIMULATOR_SMALL_WINDOW
     m_surfaceWidth  = 0;
     m_surfaceHeight = 0;
@@ -37,6 +66,38 @@ PBOGLES::PBOGLES() {
     m_useTexture = 0;
     m_useTexAlpha = 0;
 
+    // Instanced sprite state
+    m_spriteInstProgram     = 0;
+    m_spriteInstVao         = 0;
+    m_spriteInstQuadVbo     = 0;
+    m_spriteInstEbo         = 0;
+    m_spriteInstVbo         = 0;
+    m_spriteInstCapacity    = 0;
+    m_spriteInstUseTexture  = -1;
+    m_spriteInstUseTexAlpha = -1;
+    m_cachedInstUseTexture = m_cachedInstUseTexAlpha = -1.0f;
+
+    // YUV video shader state
+    m_videoProgram          = 0;
+    m_videoTexAlpha         = -1;
+    m_videoUseTexAlpha      = -1;
+    m_videoInterleavedUV    = -1;
+    m_videoYuvMatrix        = -1;
+    m_videoYuvOffset        = -1;
+    m_videoUniformTexture   = 0;
+    m_cachedVideoTexAlpha = m_cachedVideoUseTexAlpha = -1.0f;
+
+    // DMA buffer video import state
+    m_dmabufImportAvailable    = false;
+    m_dmabufModifiersAvailable = false;
+    m_eglCreateImage            = nullptr;
+    m_eglDestroyImage           = nullptr;
+    m_glEGLImageTargetTexture2D = nullptr;
+    m_externalVideoProgram      = 0;
+    m_externalTexAlpha          = -1;
+    m_externalUseTexAlpha       = -1;
+    m_cachedExternalTexAlpha = m_cachedExternalUseTexAlpha = -1.0f;
+
     // 3D shader state
     m_3dShaderProgram    = 0;
     m_3dMVPUniform       = -1;
@@ -60,11 +121,22 @@ PBOGLES::PBOGLES() {
     m_3dSk_CameraEyeUniform= -1;
     m_3dSk_AlphaUniform    = -1;
     m_3dSk_BonesUniform    = -1;
+    m_3dSk_PaletteUniform  = -1;
     m_3dSk_PosAttrib       = -1;
     m_3dSk_NormalAttrib    = -1;
     m_3dSk_TexCoordAttrib  = -1;
     m_3dSk_JointsAttrib    = -1;
     m_3dSk_WeightsAttrib   = -1;
+
+    // Instanced 3D shader state
+    m_3dInstProgram            = 0;
+    m_3dInst_ViewProjUniform   = -1;
+    m_3dInst_LightDirUniform   = -1;
+    m_3dInst_LightColUniform   = -1;
+    m_3dInst_AmbientUniform    = -1;
+    m_3dInst_CameraEyeUniform  = -1;
+    m_3dInstVbo                = 0;
+    m_3dInstCapacity           = 0;
 }
 
 PBOGLES::~PBOGLES() {
@@ -157,28 +229,26 @@ bool PBOGLES::oglInit(long width, long height, NativeWindowType nativeWindow) {
 
     // Compile the quad shader for the sprite system
     m_shaderProgram = oglCreateProgram(vertexShaderSource, fragmentShaderSource);
-    glUseProgram(m_shaderProgram);
+    oglUseProgram(m_shaderProgram);
 
     // Set up the shader attributes and input variables
     m_posAttrib = glGetAttribLocation(m_shaderProgram, "vPosition");
-    glEnableVertexAttribArray(m_posAttrib);
     m_colorAttrib = glGetAttribLocation(m_shaderProgram, "vColor");
-    glEnableVertexAttribArray(m_colorAttrib);
     m_texCoordAttrib = glGetAttribLocation(m_shaderProgram, "vTexCoord");
-    glEnableVertexAttribArray(m_texCoordAttrib);
     m_uTexAlpha = glGetUniformLocation(m_shaderProgram, "uTexAlpha");
     m_useTexture = glGetUniformLocation(m_shaderProgram, "useTexture");
     m_useTexAlpha = glGetUniformLocation(m_shaderProgram, "useTexAlpha");
+    // Attrib enables and pointers are set once here (into m_quadVertices) and never change
+    oglSet2DAttribPointers();
 
-    glEnable(GL_BLEND);
-    m_blendEnabled = true;
+    oglSetCapability(GL_BLEND, true);
     // glBlendFunc(GL_SRC_COLOR, GL_ONE_MINUS_SRC_COLOR);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    oglBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     // glBlendFunc(GL_ONE, GL_ONE);
 
     // Depth writes are disabled for 2D rendering — the depth buffer is only used during
     // 3D passes. ogl3dBeginPass() re-enables writes before 3D draws.
-    glDepthMask(GL_FALSE);
+    oglDepthMask(false);
     
     // Set the internal variables and reflect that the basic rendering engine has been intialized
     m_width = width;
@@ -192,6 +262,23 @@ bool PBOGLES::oglInit(long width, long height, NativeWindowType nativeWindow) {
     m_surfaceHeight = height / 2;
 #endif
 
+    // Instanced sprite batches are optional - if the program fails the batch calls fall back to oglRenderQuad
+    if (!oglInitSpriteInstancing()) {
+        std::cout << "Warning: instanced sprite shader unavailable, sprite batches will render per quad\n";
+    }
+
+    // Same for planar video - without the YUV shader videos are colour converted on the CPU
+    if (!oglInitVideoShader()) {
+        std::cout << "Warning: YUV video shader unavailable, videos will be converted to RGBA on the CPU\n";
+    }
+
+#if ENABLE_VIDEO_DMABUF_IMPORT && !defined(EXE_MODE_WINDOWS)
+    // Zero-copy video needs the YUV shader as well, for frames that end up being uploaded after all
+    if (m_videoProgram != 0 && !oglInitDmabufImport()) {
+        std::cout << "Warning: DMA buffer import unavailable, hardware decoded video frames will be uploaded\n";
+    }
+#endif
+
     m_started = true;
     return true;
 }
@@ -207,6 +294,7 @@ bool PBOGLES::oglClear(float red, float blue, float green, float alpha, bool doF
         glClearColor(red, green, blue, alpha);
 
         glClear(GL_COLOR_BUFFER_BIT);  // Depth buffer is cleared by ogl3dBeginPass before 3D draws
+        m_glCallCount += 3;
 
         if (doFlip) {
             if (oglSwap(false) == false) return (false);
@@ -222,6 +310,18 @@ bool PBOGLES::oglSwap(bool flush){
     // if (flush) glFlush();
     // glFinish(); // This is an alternative to glFlush, but it waits for all commands to complete
     if (flush) glFinish();  
+
+    // Roll the per-frame GL call counters over for the overlay
+    m_glCallsLastFrame = m_glCallCount;
+    m_glSkippedLastFrame = m_glSkippedCount;
+    m_glCallCount = 0;
+    m_glSkippedCount = 0;
+    m_videoUploadsLastFrame = m_videoUploads;
+    m_videoUploadBytesLastFrame = m_videoUploadBytes;
+    m_videoUploadMicrosLastFrame = m_videoUploadMicros;
+    m_videoUploads = 0;
+    m_videoUploadBytes = 0;
+    m_videoUploadMicros = 0;
     
     if (eglSwapBuffers(m_display, m_surface) != EGL_TRUE) return (false);
     return (true);
@@ -232,10 +332,7 @@ void PBOGLES::oglSetScissor(bool enable, int x1, int y1, int x2, int y2) {
     if (enable) {
         // Enable scissor test — only call glEnable if not already enabled to avoid
         // redundant D3D11 rasterizer state creation (ANGLE warning #55 SETPRIVATEDATA_CHANGINGPARAMS)
-        if (!m_scissorEnabled) {
-            glEnable(GL_SCISSOR_TEST);
-            m_scissorEnabled = true;
-        }
+        oglSetCapability(GL_SCISSOR_TEST, true);
         
         // Convert screen space coordinates to OpenGL scissor coordinates
         // OpenGL scissor uses bottom-left origin, so we need to convert Y coordinate
@@ -258,13 +355,15 @@ void PBOGLES::oglSetScissor(bool enable, int x1, int y1, int x2, int y2) {
 #endif
 
         // Set the scissor rectangle
-        glScissor(x, y, width, height);
+        if ((x != m_scissorX) || (y != m_scissorY) || (width != m_scissorW) || (height != m_scissorH)) {
+            glScissor(x, y, width, height);
+            m_scissorX = x; m_scissorY = y; m_scissorW = width; m_scissorH = height;
+            m_glCallCount++;
+        }
+        else m_glSkippedCount++;
     } else {
         // Disable scissor test — only call glDisable if currently enabled
-        if (m_scissorEnabled) {
-            glDisable(GL_SCISSOR_TEST);
-            m_scissorEnabled = false;
-        }
+        oglSetCapability(GL_SCISSOR_TEST, false);
     }
 }
 
@@ -326,14 +425,16 @@ void PBOGLES::oglRenderQuad (float* X1, float* Y1, float* X2, float* Y2, float U
                              float vertRed, float vertGreen, float vertBlue, float vertAlpha, 
                              float scale, float rotateDegrees, bool returnBoundingBox) {
 
-    // Create the vertices for the quad 
-    GLfloat vertices[] = {
+    // Create the vertices for the quad in the fixed vertex store the 2D attrib pointers reference
+    const GLfloat quad[] = {
     // Pos (3 XYZ)      // Colors (4 RGBA)      // Texture Coords
     *X1,  *Y1, 0.0f,      vertRed, vertGreen, vertBlue, vertAlpha, U1, V2, // Top Left
     *X1,  *Y2, 0.0f,      vertRed, vertGreen, vertBlue, vertAlpha, U1, V1, // Bottom-left
     *X2,  *Y1, 0.0f,      vertRed, vertGreen, vertBlue, vertAlpha, U2, V2, // Top right
     *X2,  *Y2, 0.0f,      vertRed, vertGreen, vertBlue, vertAlpha, U2, V1  // Bottom-right
     };
+    GLfloat* vertices = m_quadVertices;
+    for (int i = 0; i < 4 * 9; i++) vertices[i] = quad[i];
 
     //  Transfor the quad if rotateDegrees are not the default (no scale / rotate) values
     if ((scale != 1.0f) || (rotateDegrees != 0.0f)) {
@@ -392,35 +493,48 @@ void PBOGLES::oglRenderQuad (float* X1, float* Y1, float* X2, float* Y2, float U
     }
 
     // Define the indices for the quad
-    GLushort indices[] = {
+    static const GLushort indices[] = {
         1, 0, 2,
         1, 2, 3
     };
 
-    // Specify how the data for each attribute is retrieved from the array
-    glVertexAttribPointer(m_posAttrib, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(GLfloat), vertices);
-    glVertexAttribPointer(m_colorAttrib, 4, GL_FLOAT, GL_FALSE, 9 * sizeof(GLfloat), vertices + 3);
-    glVertexAttribPointer(m_texCoordAttrib, 2, GL_FLOAT, GL_FALSE, 9 * sizeof(GLfloat), vertices + 7);
-
-    // Set the input variable for the alpha and enable/bind the texture if needed
-    glUniform1f(m_uTexAlpha, texAlpha);
-    if (useTexAlpha) glUniform1f(m_useTexAlpha, 1);
-    else glUniform1f(m_useTexAlpha, 0);
-
-    if (textureId == 0) {
-        glUniform1i(m_useTexture, 0);
-        m_lastTextureId = textureId;
-    }
-    else {
-        if (textureId != m_lastTextureId) {
-            glUniform1i(m_useTexture, 1);
-            glBindTexture(GL_TEXTURE_2D, textureId);
-            m_lastTextureId = textureId;
+    // Planar video textures draw through the YUV program.  It shares the vertex shader and attribute locations,
+    // so the VAO 0 setup below serves both programs.  RGBA video textures draw their latest upload set as usual.
+    if (textureId != 0 && !m_videoPlaneList.empty()) {
+        std::map<GLuint, stOglVideoPlanes>::iterator it = m_videoPlaneList.find(textureId);
+        if (it != m_videoPlaneList.end() && it->second.format == OGL_VIDEO_RGBA) {
+            textureId = it->second.planeTex[it->second.currentSet][0];
+        } else if (it != m_videoPlaneList.end()) {
+            if (it->second.externalTex != 0) {
+                oglUseExternalVideoProgram(it->second, useTexAlpha, texAlpha);
+            } else if (it->second.planesAllocated) {
+                oglUseVideoProgram(textureId, it->second, useTexAlpha, texAlpha);
+            } else {
+                return;  // DMA buffer video that has not received a frame yet
+            }
+            oglBindVertexArray(0);
+            oglSet2DAttribPointers();
+            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, indices);
+            m_glCallCount++;
+            return;
         }
     }
+
+    // Sprite batches use their own program and VAO, so make sure the 2D quad state is current (usually skipped by the cache).
+    // Attrib pointers already reference m_quadVertices, so oglSet2DAttribPointers only does work once.
+    oglUseProgram(m_shaderProgram);
+    oglBindVertexArray(0);
+    oglSet2DAttribPointers();
+
+    // Set the input variable for the alpha and enable/bind the texture if needed (cached, unchanged values are skipped)
+    oglSetUniform1f(m_uTexAlpha, texAlpha, &m_cachedTexAlpha);
+    oglSetUniform1f(m_useTexAlpha, useTexAlpha ? 1.0f : 0.0f, &m_cachedUseTexAlpha);
+    oglSetUniform1f(m_useTexture, (textureId != 0) ? 1.0f : 0.0f, &m_cachedUseTexture);
+    if (textureId != 0) oglBindTexture(0, textureId);
       
      // Finally, draw the quad!
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, indices);
+    m_glCallCount++;
 }
 
 void PBOGLES::scaleAndRotateVertices(float* x, float* y, float scale, float rotateDegrees){
@@ -443,8 +557,443 @@ void PBOGLES::scaleAndRotateVertices(float* x, float* y, float scale, float rota
     }
 }
 
+// Build the instanced sprite program and its buffers.  The unit quad and indices are static, per-instance data is streamed.
+bool PBOGLES::oglInitSpriteInstancing() {
+
+    m_spriteInstProgram = oglCreateProgram(spriteInstVertexShaderSource, spriteInstFragmentShaderSource);
+    if (m_spriteInstProgram == 0) return (false);
+
+    GLint cornerAttrib = glGetAttribLocation(m_spriteInstProgram, "aCorner");
+    GLint rectAttrib   = glGetAttribLocation(m_spriteInstProgram, "iRect");
+    GLint uvAttrib     = glGetAttribLocation(m_spriteInstProgram, "iUV");
+    GLint colorAttrib  = glGetAttribLocation(m_spriteInstProgram, "iColor");
+    GLint xformAttrib  = glGetAttribLocation(m_spriteInstProgram, "iXform");
+    if (cornerAttrib < 0 || rectAttrib < 0 || uvAttrib < 0 || colorAttrib < 0 || xformAttrib < 0) {
+        oglForgetProgram(m_spriteInstProgram);
+        glDeleteProgram(m_spriteInstProgram);
+        m_spriteInstProgram = 0;
+        return (false);
+    }
+
+    m_spriteInstUseTexture  = glGetUniformLocation(m_spriteInstProgram, "useTexture");
+    m_spriteInstUseTexAlpha = glGetUniformLocation(m_spriteInstProgram, "useTexAlpha");
+
+    // The aspect ratio and sampler unit never change, set them once
+    oglUseProgram(m_spriteInstProgram);
+    glUniform1f(glGetUniformLocation(m_spriteInstProgram, "uAspect"), m_aspectRatio);
+    glUniform1i(glGetUniformLocation(m_spriteInstProgram, "uTexture"), 0);
+
+    // Corner order and indices match oglRenderQuad: top-left, bottom-left, top-right, bottom-right
+    static const GLfloat corners[] = { 0.0f, 0.0f,   0.0f, 1.0f,   1.0f, 0.0f,   1.0f, 1.0f };
+    static const GLushort indices[] = { 1, 0, 2,   1, 2, 3 };
+
+    glGenVertexArrays(1, &m_spriteInstVao);
+    glGenBuffers(1, &m_spriteInstQuadVbo);
+    glGenBuffers(1, &m_spriteInstEbo);
+    glGenBuffers(1, &m_spriteInstVbo);
+
+    oglBindVertexArray(m_spriteInstVao);
+
+    oglBindBuffer(GL_ARRAY_BUFFER, m_spriteInstQuadVbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(cornerAttrib);
+    glVertexAttribPointer(cornerAttrib, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (void*)0);
+
+    oglBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_spriteInstEbo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+    // Per-instance attributes: four vec4s advancing once per instance
+    oglBindBuffer(GL_ARRAY_BUFFER, m_spriteInstVbo);
+    const GLint instAttribs[4] = { rectAttrib, uvAttrib, colorAttrib, xformAttrib };
+    for (int i = 0; i < 4; i++) {
+        glEnableVertexAttribArray(instAttribs[i]);
+        glVertexAttribPointer(instAttribs[i], 4, GL_FLOAT, GL_FALSE, sizeof(stOglSpriteInstance), (void*)(i * 4 * sizeof(GLfloat)));
+        glVertexAttribDivisor(instAttribs[i], 1);
+    }
+
+    oglBindVertexArray(0);
+    oglBindBuffer(GL_ARRAY_BUFFER, 0);
+    oglUseProgram(m_shaderProgram);
+
+    return (true);
+}
+
+// Build the YUV video program.  It reuses the 2D vertex shader, and oglRenderQuad only sets the 2D attribute
+// pointers up once, so the attribute locations have to match the 2D program's or the path stays disabled.
+bool PBOGLES::oglInitVideoShader() {
+
+    m_videoProgram = oglCreateProgram(vertexShaderSource, videoFragmentShaderSource);
+    if (m_videoProgram == 0) return (false);
+
+    if (glGetAttribLocation(m_videoProgram, "vPosition") != m_posAttrib ||
+        glGetAttribLocation(m_videoProgram, "vColor") != m_colorAttrib ||
+        glGetAttribLocation(m_videoProgram, "vTexCoord") != m_texCoordAttrib) {
+        oglForgetProgram(m_videoProgram);
+        glDeleteProgram(m_videoProgram);
+        m_videoProgram = 0;
+        return (false);
+    }
+
+    m_videoTexAlpha      = glGetUniformLocation(m_videoProgram, "uTexAlpha");
+    m_videoUseTexAlpha   = glGetUniformLocation(m_videoProgram, "useTexAlpha");
+    m_videoInterleavedUV = glGetUniformLocation(m_videoProgram, "uInterleavedUV");
+    m_videoYuvMatrix     = glGetUniformLocation(m_videoProgram, "uYuvMatrix");
+    m_videoYuvOffset     = glGetUniformLocation(m_videoProgram, "uYuvOffset");
+
+    // Sampler units never change, set them once
+    oglUseProgram(m_videoProgram);
+    glUniform1i(glGetUniformLocation(m_videoProgram, "uTexY"), 0);
+    glUniform1i(glGetUniformLocation(m_videoProgram, "uTexU"), OGL_VIDEO_CHROMA_UNIT);
+    glUniform1i(glGetUniformLocation(m_videoProgram, "uTexV"), OGL_VIDEO_CHROMA_UNIT + 1);
+    oglUseProgram(m_shaderProgram);
+
+    return (true);
+}
+
+// Select the YUV program and bind a planar video texture's planes.  The colour conversion uniforms only change
+// when a different video (or a video whose colour description changed) is drawn.
+void PBOGLES::oglUseVideoProgram(GLuint textureId, const stOglVideoPlanes& planes, bool useTexAlpha, float texAlpha) {
+
+    oglUseProgram(m_videoProgram);
+    oglSetUniform1f(m_videoTexAlpha, texAlpha, &m_cachedVideoTexAlpha);
+    oglSetUniform1f(m_videoUseTexAlpha, useTexAlpha ? 1.0f : 0.0f, &m_cachedVideoUseTexAlpha);
+
+    if (m_videoUniformTexture != textureId) {
+        // Columns of the YUV -> RGB matrix (GL is column-major): R = Y + cr*V, G = Y - gu*U - gv*V, B = Y + bu*U
+        float cr = planes.bt709 ? 1.5748f   : 1.402f;
+        float gu = planes.bt709 ? 0.187324f : 0.344136f;
+        float gv = planes.bt709 ? 0.468124f : 0.714136f;
+        float bu = planes.bt709 ? 1.8556f   : 1.772f;
+
+        // Video levels put Y in 16-235 and chroma in 16-240, stretch both to the full 0-1 range
+        float ys = planes.fullRange ? 1.0f : 255.0f / 219.0f;
+        float cs = planes.fullRange ? 1.0f : 255.0f / 224.0f;
+        const GLfloat matrix[9] = { ys,       ys,            ys,
+                                    0.0f,     -gu * cs,      bu * cs,
+                                    cr * cs,  -gv * cs,      0.0f };
+        glUniformMatrix3fv(m_videoYuvMatrix, 1, GL_FALSE, matrix);
+        glUniform3f(m_videoYuvOffset, planes.fullRange ? 0.0f : 16.0f / 255.0f, 128.0f / 255.0f, 128.0f / 255.0f);
+        glUniform1i(m_videoInterleavedUV, (planes.format == OGL_VIDEO_NV12) ? 1 : 0);
+        m_videoUniformTexture = textureId;
+        m_glCallCount += 3;
+    }
+
+    const GLuint* set = planes.planeTex[planes.currentSet];
+    oglBindTexture(0, set[0]);
+    oglBindTexture(OGL_VIDEO_CHROMA_UNIT, set[1]);
+    if (planes.format == OGL_VIDEO_I420) oglBindTexture(OGL_VIDEO_CHROMA_UNIT + 1, set[2]);
+}
+
+// ============================================================================
+// Zero-copy video — decoder frames that live in DMA buffers are wrapped in
+// EGLImages and sampled as external textures, so nothing is copied or uploaded.
+// ============================================================================
+
+// Resolve the EGL / GL entry points and build the external texture program.  Every piece is optional in the
+// driver, so any one missing leaves the import disabled and videos use the plane upload path.
+bool PBOGLES::oglInitDmabufImport() {
+
+    const char* eglExtensions = eglQueryString(m_display, EGL_EXTENSIONS);
+    const char* glExtensions = (const char*)glGetString(GL_EXTENSIONS);
+    if (eglExtensions == nullptr || glExtensions == nullptr) return (false);
+    if (strstr(eglExtensions, "EGL_EXT_image_dma_buf_import") == nullptr ||
+        strstr(glExtensions, "GL_OES_EGL_image_external") == nullptr) return (false);
+    m_dmabufModifiersAvailable = (strstr(eglExtensions, "EGL_EXT_image_dma_buf_import_modifiers") != nullptr);
+
+    m_eglCreateImage = (PFNEGLCREATEIMAGEKHRPROC)eglGetProcAddress("eglCreateImageKHR");
+    m_eglDestroyImage = (PFNEGLDESTROYIMAGEKHRPROC)eglGetProcAddress("eglDestroyImageKHR");
+    m_glEGLImageTargetTexture2D = (oglEGLImageTargetTexture2DProc)eglGetProcAddress("glEGLImageTargetTexture2DOES");
+    if (m_eglCreateImage == nullptr || m_eglDestroyImage == nullptr || m_glEGLImageTargetTexture2D == nullptr) return (false);
+
+    // Same vertex shader and attribute locations as the 2D program, see oglInitVideoShader
+    m_externalVideoProgram = oglCreateProgram(vertexShaderSource, externalVideoFragmentShaderSource);
+    if (m_externalVideoProgram == 0) return (false);
+
+    if (glGetAttribLocation(m_externalVideoProgram, "vPosition") != m_posAttrib ||
+        glGetAttribLocation(m_externalVideoProgram, "vColor") != m_colorAttrib ||
+        glGetAttribLocation(m_externalVideoProgram, "vTexCoord") != m_texCoordAttrib) {
+        oglForgetProgram(m_externalVideoProgram);
+        glDeleteProgram(m_externalVideoProgram);
+        m_externalVideoProgram = 0;
+        return (false);
+    }
+
+    m_externalTexAlpha    = glGetUniformLocation(m_externalVideoProgram, "uTexAlpha");
+    m_externalUseTexAlpha = glGetUniformLocation(m_externalVideoProgram, "useTexAlpha");
+
+    oglUseProgram(m_externalVideoProgram);
+    glUniform1i(glGetUniformLocation(m_externalVideoProgram, "uTexture"), 0);
+    oglUseProgram(m_shaderProgram);
+
+    m_dmabufImportAvailable = true;
+    return (true);
+}
+
+// Show a DMA buffer frame in a "WxH:dmabuf" video texture.  Buffers seen before reuse their EGLImage, new ones
+// are imported (evicting the least recently shown once the cache is full).  Returns false if the driver cannot
+// import this layout; the caller should then upload the frame's planes with oglUpdateVideoPlanes instead.
+bool PBOGLES::oglUpdateVideoDmabuf(GLuint textureId, const stOglDmabufFrame& frame) {
+    std::map<GLuint, stOglVideoPlanes>::iterator it = m_videoPlaneList.find(textureId);
+    if (it == m_videoPlaneList.end() || !it->second.dmabuf || !m_dmabufImportAvailable) return (false);
+
+    stOglVideoPlanes& videoPlanes = it->second;
+    if (frame.width != videoPlanes.width || frame.height != videoPlanes.height) return (false);
+    if (frame.planeCount == 0 || frame.planeCount > OGL_DMABUF_MAX_PLANES) return (false);
+
+    videoPlanes.importCount++;
+
+    // Decoders recycle a fixed set of buffers, so the same fd / layout means the same memory
+    for (size_t i = 0; i < videoPlanes.dmabufImages.size(); i++) {
+        stOglDmabufImage& cached = videoPlanes.dmabufImages[i];
+        bool same = (cached.frame.fourcc == frame.fourcc && cached.frame.modifier == frame.modifier &&
+                     cached.frame.planeCount == frame.planeCount &&
+                     cached.frame.bt709 == frame.bt709 && cached.frame.fullRange == frame.fullRange);
+        for (unsigned int p = 0; same && p < frame.planeCount; p++) {
+            same = (cached.frame.fd[p] == frame.fd[p] && cached.frame.offset[p] == frame.offset[p] &&
+                    cached.frame.pitch[p] == frame.pitch[p]);
+        }
+        if (same) {
+            cached.lastUsed = videoPlanes.importCount;
+            videoPlanes.externalTex = cached.texture;
+            return (true);
+        }
+    }
+
+    // Tiled buffers can only be described with the modifiers extension, linear is the default layout without it
+    bool sendModifier = (frame.modifier != OGL_DMABUF_NO_MODIFIER && m_dmabufModifiersAvailable);
+    if (frame.modifier != OGL_DMABUF_NO_MODIFIER && frame.modifier != OGL_DMABUF_LINEAR_MODIFIER &&
+        !m_dmabufModifiersAvailable) return (false);
+
+    static const EGLint fdAttribs[OGL_DMABUF_MAX_PLANES]     = { EGL_DMA_BUF_PLANE0_FD_EXT, EGL_DMA_BUF_PLANE1_FD_EXT, EGL_DMA_BUF_PLANE2_FD_EXT };
+    static const EGLint offsetAttribs[OGL_DMABUF_MAX_PLANES] = { EGL_DMA_BUF_PLANE0_OFFSET_EXT, EGL_DMA_BUF_PLANE1_OFFSET_EXT, EGL_DMA_BUF_PLANE2_OFFSET_EXT };
+    static const EGLint pitchAttribs[OGL_DMABUF_MAX_PLANES]  = { EGL_DMA_BUF_PLANE0_PITCH_EXT, EGL_DMA_BUF_PLANE1_PITCH_EXT, EGL_DMA_BUF_PLANE2_PITCH_EXT };
+    static const EGLint modLoAttribs[OGL_DMABUF_MAX_PLANES]  = { EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE1_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE2_MODIFIER_LO_EXT };
+    static const EGLint modHiAttribs[OGL_DMABUF_MAX_PLANES]  = { EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT, EGL_DMA_BUF_PLANE1_MODIFIER_HI_EXT, EGL_DMA_BUF_PLANE2_MODIFIER_HI_EXT };
+
+    EGLint attribs[6 + OGL_DMABUF_MAX_PLANES * 10 + 5];
+    int count = 0;
+    attribs[count++] = EGL_WIDTH;                    attribs[count++] = (EGLint)frame.width;
+    attribs[count++] = EGL_HEIGHT;                   attribs[count++] = (EGLint)frame.height;
+    attribs[count++] = EGL_LINUX_DRM_FOURCC_EXT;     attribs[count++] = (EGLint)frame.fourcc;
+    for (unsigned int p = 0; p < frame.planeCount; p++) {
+        attribs[count++] = fdAttribs[p];             attribs[count++] = frame.fd[p];
+        attribs[count++] = offsetAttribs[p];         attribs[count++] = (EGLint)frame.offset[p];
+        attribs[count++] = pitchAttribs[p];          attribs[count++] = (EGLint)frame.pitch[p];
+        if (sendModifier) {
+            attribs[count++] = modLoAttribs[p];      attribs[count++] = (EGLint)(frame.modifier & 0xFFFFFFFFu);
+            attribs[count++] = modHiAttribs[p];      attribs[count++] = (EGLint)(frame.modifier >> 32);
+        }
+    }
+    attribs[count++] = EGL_YUV_COLOR_SPACE_HINT_EXT; attribs[count++] = frame.bt709 ? EGL_ITU_REC709_EXT : EGL_ITU_REC601_EXT;
+    attribs[count++] = EGL_SAMPLE_RANGE_HINT_EXT;    attribs[count++] = frame.fullRange ? EGL_YUV_FULL_RANGE_EXT : EGL_YUV_NARROW_RANGE_EXT;
+    attribs[count++] = EGL_NONE;
+
+    EGLImageKHR image = m_eglCreateImage(m_display, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT, nullptr, attribs);
+    if (image == EGL_NO_IMAGE_KHR) return (false);
+
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    oglBindExternalTexture(texture);
+    glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    for (int i = 0; i < 8 && glGetError() != GL_NO_ERROR; i++) {}   // clear stale errors so the check below is ours
+    m_glEGLImageTargetTexture2D(GL_TEXTURE_EXTERNAL_OES, (void*)image);
+    m_glCallCount += 7;
+    if (glGetError() != GL_NO_ERROR) {
+        glDeleteTextures(1, &texture);
+        m_eglDestroyImage(m_display, image);
+        return (false);
+    }
+
+    // Full cache - drop the buffer shown longest ago
+    if (videoPlanes.dmabufImages.size() >= OGL_DMABUF_IMAGE_CACHE) {
+        size_t oldest = 0;
+        for (size_t i = 1; i < videoPlanes.dmabufImages.size(); i++) {
+            if (videoPlanes.dmabufImages[i].lastUsed < videoPlanes.dmabufImages[oldest].lastUsed) oldest = i;
+        }
+        glDeleteTextures(1, &videoPlanes.dmabufImages[oldest].texture);
+        m_eglDestroyImage(m_display, videoPlanes.dmabufImages[oldest].image);
+        videoPlanes.dmabufImages.erase(videoPlanes.dmabufImages.begin() + oldest);
+    }
+
+    stOglDmabufImage imported;
+    imported.frame = frame;
+    imported.image = image;
+    imported.texture = texture;
+    imported.lastUsed = videoPlanes.importCount;
+    videoPlanes.dmabufImages.push_back(imported);
+    videoPlanes.externalTex = texture;
+
+    return (true);
+}
+
+// Destroy every EGLImage / external texture imported for a video texture
+void PBOGLES::oglReleaseDmabufImages(stOglVideoPlanes& planes) {
+    for (size_t i = 0; i < planes.dmabufImages.size(); i++) {
+        glDeleteTextures(1, &planes.dmabufImages[i].texture);
+        if (m_eglDestroyImage != nullptr) m_eglDestroyImage(m_display, planes.dmabufImages[i].image);
+    }
+    planes.dmabufImages.clear();
+    planes.externalTex = 0;
+}
+
+// External textures use their own bind target, which the 2D texture cache does not track
+void PBOGLES::oglBindExternalTexture(GLuint textureId) {
+    if (m_activeTextureUnit != 0) {
+        glActiveTexture(GL_TEXTURE0);
+        m_activeTextureUnit = 0;
+        m_glCallCount++;
+    }
+    glBindTexture(GL_TEXTURE_EXTERNAL_OES, textureId);
+    m_glCallCount++;
+}
+
+void PBOGLES::oglUseExternalVideoProgram(const stOglVideoPlanes& planes, bool useTexAlpha, float texAlpha) {
+    oglUseProgram(m_externalVideoProgram);
+    oglSetUniform1f(m_externalTexAlpha, texAlpha, &m_cachedExternalTexAlpha);
+    oglSetUniform1f(m_externalUseTexAlpha, useTexAlpha ? 1.0f : 0.0f, &m_cachedExternalUseTexAlpha);
+    oglBindExternalTexture(planes.externalTex);
+}
+
+// Draw a batch of textured quads with one instanced draw call.  All instances share textureId and useTexAlpha.
+// Bounding boxes are not computed; callers that need them should render those sprites through oglRenderQuad.
+void PBOGLES::oglRenderQuadInstances(const stOglSpriteInstance* instances, unsigned int count, bool useTexAlpha, unsigned int textureId) {
+
+    if (instances == nullptr || count == 0) return;
+
+    // No instancing support - transform each quad on the CPU as before.  Video textures resolve their upload set
+    // (and planar ones the YUV program) there.
+    if (m_spriteInstProgram == 0 || (textureId != 0 && m_videoPlaneList.count(textureId) != 0)) {
+        for (unsigned int i = 0; i < count; i++) {
+            const stOglSpriteInstance& inst = instances[i];
+            float x1 = inst.x1, y1 = inst.y1, x2 = inst.x2, y2 = inst.y2;
+            oglRenderQuad(&x1, &y1, &x2, &y2, inst.u1, inst.v1, inst.u2, inst.v2, inst.pivotCenter > 0.5f, useTexAlpha, inst.texAlpha, textureId,
+                          inst.red, inst.green, inst.blue, inst.alpha, inst.scale, inst.rotateRadians * 180.0f / 3.14159f, false);
+        }
+        return;
+    }
+
+    oglUseProgram(m_spriteInstProgram);
+    oglBindVertexArray(m_spriteInstVao);
+
+    // Stream the instance data.  Grow the buffer when needed, otherwise orphan it so the driver
+    // does not stall waiting for the previous batch to finish reading it.
+    GLsizeiptr dataSize = (GLsizeiptr)(count * sizeof(stOglSpriteInstance));
+    oglBindBuffer(GL_ARRAY_BUFFER, m_spriteInstVbo);
+    if (count > m_spriteInstCapacity) {
+        m_spriteInstCapacity = count;
+        glBufferData(GL_ARRAY_BUFFER, dataSize, instances, GL_STREAM_DRAW);
+        m_glCallCount++;
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(m_spriteInstCapacity * sizeof(stOglSpriteInstance)), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, dataSize, instances);
+        m_glCallCount += 2;
+    }
+
+    oglSetUniform1f(m_spriteInstUseTexAlpha, useTexAlpha ? 1.0f : 0.0f, &m_cachedInstUseTexAlpha);
+    oglSetUniform1f(m_spriteInstUseTexture, (textureId != 0) ? 1.0f : 0.0f, &m_cachedInstUseTexture);
+    if (textureId != 0) oglBindTexture(0, textureId);
+
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, (void*)0, (GLsizei)count);
+    m_glCallCount++;
+}
+
+// ============================================================================
+// Off-screen render targets — retained layers are drawn once into an FBO and
+// composited every frame until their content changes.
+// ============================================================================
+
+// Render targets match the default framebuffer size so the viewport and scissor math is shared
+unsigned long PBOGLES::oglGetRenderTargetBytes() {
+#ifdef SIMULATOR_SMALL_WINDOW
+    return ((unsigned long)m_surfaceWidth * (unsigned long)m_surfaceHeight * 4);
+#else
+    return ((unsigned long)m_width * (unsigned long)m_height * 4);
+#endif
+}
+
+bool PBOGLES::oglCreateRenderTarget(GLuint* framebuffer, GLuint* textureId) {
+
+#ifdef SIMULATOR_SMALL_WINDOW
+    GLsizei width = (GLsizei)m_surfaceWidth, height = (GLsizei)m_surfaceHeight;
+#else
+    GLsizei width = (GLsizei)m_width, height = (GLsizei)m_height;
+#endif
+
+    GLuint texture = 0, fbo = 0;
+    glGenTextures(1, &texture);
+    oglBindTextureForUpload(0, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenFramebuffers(1, &fbo);
+    oglBindFramebuffer(fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    oglBindFramebuffer(0);
+    m_glCallCount += 9;
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "Error: render target framebuffer incomplete (0x" << std::hex << status << std::dec << ")\n";
+        oglDestroyRenderTarget(fbo, texture);
+        return (false);
+    }
+
+    *framebuffer = fbo;
+    *textureId = texture;
+    return (true);
+}
+
+void PBOGLES::oglDestroyRenderTarget(GLuint framebuffer, GLuint textureId) {
+    if (m_boundFramebuffer == framebuffer) oglBindFramebuffer(0);
+    if (framebuffer) glDeleteFramebuffers(1, &framebuffer);
+    oglForgetTexture(textureId);
+    if (textureId) glDeleteTextures(1, &textureId);
+}
+
+// Redirect 2D drawing into the render target.  Colour is blended normally but alpha accumulates as coverage,
+// leaving premultiplied alpha in the target so the composite matches drawing straight to the screen.
+void PBOGLES::oglBeginRenderTarget(GLuint framebuffer) {
+    oglBindFramebuffer(framebuffer);
+    oglSetScissor(false, 0, 0, 0, 0);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    m_glCallCount += 2;
+    oglBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void PBOGLES::oglEndRenderTarget() {
+    oglBindFramebuffer(0);
+    oglBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+// Draw a render target over the whole screen.  FBO textures are bottom-up, hence V1 = 0 / V2 = 1.
+void PBOGLES::oglCompositeRenderTarget(GLuint textureId) {
+    float x1 = -1.0f, y1 = 1.0f, x2 = 1.0f, y2 = -1.0f;
+    oglBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    oglRenderQuad(&x1, &y1, &x2, &y2, 0.0f, 0.0f, 1.0f, 1.0f, false, false, 1.0f, textureId,
+                  1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, false);
+    oglBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
 // Delete a texture from a sprite.  You can keep the sprite, but release the texture
 bool   PBOGLES::oglUnloadTexture(GLuint textureId){
+
+    // Video textures own their other planes and upload sets as well
+    std::map<GLuint, stOglVideoPlanes>::iterator it = m_videoPlaneList.find(textureId);
+    if (it != m_videoPlaneList.end()) {
+        oglReleaseDmabufImages(it->second);
+        oglDeleteVideoPlanes(it->second);
+        m_videoPlaneList.erase(it);
+        if (m_videoUniformTexture == textureId) m_videoUniformTexture = 0;
+    }
+
+    oglForgetTexture(textureId);
     glDeleteTextures(1, &textureId);
     return (true);
 }
@@ -460,12 +1009,17 @@ GLuint PBOGLES::oglLoadTexture(const char* filename, oglTexType type, unsigned i
         case OGL_BMP: tempTexture = oglLoadBMPTexture (filename, width, height); break;
         case OGL_PNG: tempTexture = oglLoadPNGTexture (filename, width, height); break;
         case OGL_VIDEO:
-            // For video textures, filename contains "widthxheight" format (e.g., "1920x1080")
-            // Parse the dimensions and create an empty texture
+            // For video textures, filename contains "widthxheight" format (e.g., "1920x1080"), optionally followed
+            // by ":i420" or ":nv12" for planar YUV, or ":dmabuf" for imported decoder buffers.  Parse the dimensions and create an empty texture
             {
                 int vidWidth = 0, vidHeight = 0;
-                if (sscanf(filename, "%dx%d", &vidWidth, &vidHeight) == 2) {
-                    tempTexture = oglCreateVideoTexture(vidWidth, vidHeight);
+                char vidFormat[8] = "";
+                if (sscanf(filename, "%dx%d:%7s", &vidWidth, &vidHeight, vidFormat) >= 2 && vidWidth > 0 && vidHeight > 0) {
+                    oglVideoFormat format = OGL_VIDEO_RGBA;
+                    if (strcmp(vidFormat, "i420") == 0) format = OGL_VIDEO_I420;
+                    else if (strcmp(vidFormat, "nv12") == 0) format = OGL_VIDEO_NV12;
+                    else if (strcmp(vidFormat, "dmabuf") == 0) format = OGL_VIDEO_DMABUF;
+                    tempTexture = oglCreateVideoTexture(vidWidth, vidHeight, format);
                     *width = vidWidth;
                     *height = vidHeight;
                 }
@@ -480,11 +1034,52 @@ GLuint PBOGLES::oglLoadTexture(const char* filename, oglTexType type, unsigned i
 }
 
 GLuint PBOGLES::oglLoadBMPTexture (const char* filename, unsigned int* width, unsigned int* height){
+
+    stOglImageData image;
+    if (!oglDecodeTexture(filename, OGL_BMP, &image)) return (0);
+
+    GLuint texture = oglUploadTexture(&image);
+    oglFreeImageData(&image);
+    if (texture == 0) return (0);
+
+    *width = image.width;
+    *height = image.height;
+    return (texture);
+}
+
+// Decode a BMP or PNG file into CPU memory.  Makes no GL calls so it can run on a worker thread.
+// The caller owns the returned pixels and must release them with oglFreeImageData.
+bool PBOGLES::oglDecodeTexture(const char* filename, oglTexType type, stOglImageData* image){
+
+    image->pixels = nullptr;
+    image->width = 0;
+    image->height = 0;
+    image->channels = 0;
+    image->stbiOwned = false;
+
+    if (type == OGL_PNG) {
+        int texWidth, texHeight, texChannels;
+        unsigned char* data = stbi_load(filename, &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+        if (!data) {
+            std::cout << "Error: Unable to load image " << filename << std::endl;
+            return (false);
+        }
+
+        image->pixels = data;
+        image->width = texWidth;
+        image->height = texHeight;
+        image->channels = 4;
+        image->stbiOwned = true;
+        return (true);
+    }
+
+    if (type != OGL_BMP) return (false);
+
     std::ifstream file(filename, std::ios::binary);
     if (!file) {
         // Fix this error output l
         std::cout << "Error: Unable to open file " << filename << std::endl;
-        return false;
+        return (false);
     }
 
      int tempWidth, tempHeight;
@@ -523,28 +1118,44 @@ GLuint PBOGLES::oglLoadBMPTexture (const char* filename, unsigned int* width, un
         }
     }
 
-    // Now create and bind the texture to a texture ID
-    GLuint texture;
+    image->pixels = rgbData;
+    image->width = tempWidth;
+    image->height = tempHeight;
+    image->channels = 3;
+    image->stbiOwned = false;
+    return (true);
+}
 
-    glGenTextures(1, &texture);
-    if (texture == 0) {
-        delete[] rgbData;
-        return (0);
+// Release the pixel memory of a decoded image
+void PBOGLES::oglFreeImageData(stOglImageData* image){
+    if (image->pixels) {
+        if (image->stbiOwned) stbi_image_free(image->pixels);
+        else delete[] image->pixels;
     }
+    image->pixels = nullptr;
+}
+
+// Create a GL texture from a decoded image.  Must be called on the render thread.
+GLuint PBOGLES::oglUploadTexture(const stOglImageData* image){
+
+    if (!image->pixels) return (0);
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    if (texture == 0) return (0);
 
     // Create the texture.  NOTE:  We don't force power of two textures, nor does the system have ability
     // to assign UV texture coodiates within a texture (sprites always use full texture).  If non-power of two 
     // textures start to be a problem, thenwe will need to add code to handle this and pick sub rectagles within 
     // the texture.
+    GLenum format = (image->channels == 4) ? GL_RGBA : GL_RGB;
 
-    glBindTexture(GL_TEXTURE_2D, texture);
+    oglBindTextureForUpload(0, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, image->width, image->height, 0, format, GL_UNSIGNED_BYTE, image->pixels);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, tempWidth, tempHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, rgbData);
-   
-    delete[] rgbData; 
-    
-    *width = tempWidth;
-    *height = tempHeight;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    m_glCallCount += 4;
+
     return (texture);
 }
 
@@ -558,97 +1169,503 @@ unsigned int PBOGLES::oglGetScreenWidth(){
 // Function to load a PNG texture
 GLuint PBOGLES::oglLoadPNGTexture (const char* filename, unsigned int* width, unsigned int* height){ 
 
-    int texWidth, texHeight, texChannels;
-    unsigned char* data = stbi_load(filename, &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-    if (!data) {
-        std::cout << "Error: Unable to load image " << filename << std::endl;
-        return 0;
-    }
-
-    GLuint texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texWidth, texHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    stOglImageData image;
+    if (!oglDecodeTexture(filename, OGL_PNG, &image)) return (0);
 
-    stbi_image_free(data);
+    GLuint texture = oglUploadTexture(&image);
+    oglFreeImageData(&image);
+    if (texture == 0) return (0);
 
-    *width = texWidth;
-    *height = texHeight;
+    *width = image.width;
+    *height = image.height;
     return texture;
 }
 
-// Create an empty texture for video playback (will be updated dynamically)
-GLuint PBOGLES::oglCreateVideoTexture(unsigned int width, unsigned int height) {
+// Size and pixel layout of one plane of a video frame.  Chroma planes are subsampled 2x2, rounding up for odd sizes.
+static void oglVideoPlaneLayout(oglVideoFormat format, int plane, unsigned int width, unsigned int height,
+                                GLsizei* planeWidth, GLsizei* planeHeight, GLenum* internalFormat, GLenum* pixelFormat,
+                                int* bytesPerPixel) {
+    bool chroma = (plane > 0);
+    *planeWidth = (GLsizei)(chroma ? (width + 1) / 2 : width);
+    *planeHeight = (GLsizei)(chroma ? (height + 1) / 2 : height);
+    if (format == OGL_VIDEO_RGBA) {
+        *internalFormat = GL_RGBA8;  *pixelFormat = GL_RGBA;  *bytesPerPixel = 4;
+    } else if (chroma && format == OGL_VIDEO_NV12) {
+        *internalFormat = GL_RG8;    *pixelFormat = GL_RG;    *bytesPerPixel = 2;
+    } else {
+        *internalFormat = GL_R8;     *pixelFormat = GL_RED;   *bytesPerPixel = 1;
+    }
+}
+
+static int oglVideoPlaneCount(oglVideoFormat format) {
+    return (format == OGL_VIDEO_I420) ? 3 : (format == OGL_VIDEO_NV12) ? 2 : 1;
+}
+
+// Create an empty texture for video playback (will be updated dynamically).  The sprite's texture ID is the
+// first plane of the first upload set; the remaining planes and sets are recorded against it.  Planar formats
+// need the YUV shader, so fail without it.  DMA buffer textures only reserve the ID - storage comes from the
+// imported buffers.
+GLuint PBOGLES::oglCreateVideoTexture(unsigned int width, unsigned int height, oglVideoFormat format) {
+    if (format != OGL_VIDEO_RGBA && m_videoProgram == 0) return 0;
+    if (format == OGL_VIDEO_DMABUF && !m_dmabufImportAvailable) return 0;
+
     GLuint texture;
     glGenTextures(1, &texture);
     if (texture == 0) return 0;
-    
-    glBindTexture(GL_TEXTURE_2D, texture);
-    
-    // Create an empty RGBA texture
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    
-    // Set texture parameters for video (no mipmaps, linear filtering)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    
+
+    stOglVideoPlanes planes;
+    for (int set = 0; set < OGL_VIDEO_MAX_UPLOAD_SETS; set++) {
+        for (int plane = 0; plane < OGL_VIDEO_MAX_PLANES; plane++) planes.planeTex[set][plane] = 0;
+        planes.uploadPbo[set] = 0;
+        planes.uploadPboSize[set] = 0;
+    }
+    planes.setCount = 0;
+    planes.currentSet = 0;
+    planes.format = (format == OGL_VIDEO_DMABUF) ? OGL_VIDEO_NV12 : format;
+    planes.width = width;
+    planes.height = height;
+    planes.bt709 = false;
+    planes.fullRange = false;
+    planes.dmabuf = (format == OGL_VIDEO_DMABUF);
+    planes.planesAllocated = false;
+    planes.externalTex = 0;
+    planes.importCount = 0;
+
+    if (!planes.dmabuf && !oglAllocVideoPlanes(texture, planes)) {
+        oglDeleteVideoPlanes(planes);
+        glDeleteTextures(1, &texture);
+        return 0;
+    }
+
+    m_videoPlaneList[texture] = planes;
     return texture;
 }
 
+// Create the plane textures of every upload set for planes.format, plus a pixel buffer per set when uploads
+// are buffered.  The pixel buffers are sized on the first upload, when the decoder's strides are known.
+bool PBOGLES::oglAllocVideoPlanes(GLuint lumaTexture, stOglVideoPlanes& planes) {
+    unsigned int setCount = VIDEO_UPLOAD_BUFFERS;
+    if (setCount < 1) setCount = 1;
+    if (setCount > OGL_VIDEO_MAX_UPLOAD_SETS) setCount = OGL_VIDEO_MAX_UPLOAD_SETS;
+
+    int planeCount = oglVideoPlaneCount(planes.format);
+    for (unsigned int set = 0; set < setCount; set++) {
+        for (int plane = 0; plane < planeCount; plane++) {
+            GLuint texture = lumaTexture;
+            if (set != 0 || plane != 0) {
+                glGenTextures(1, &texture);
+                if (texture == 0) return (false);
+            }
+            planes.planeTex[set][plane] = texture;
+
+            GLsizei planeWidth, planeHeight;
+            GLenum  internalFormat, pixelFormat;
+            int     bytesPerPixel;
+            oglVideoPlaneLayout(planes.format, plane, planes.width, planes.height, &planeWidth, &planeHeight,
+                                &internalFormat, &pixelFormat, &bytesPerPixel);
+
+            oglBindTextureForUpload(0, texture);
+            glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, planeWidth, planeHeight, 0, pixelFormat, GL_UNSIGNED_BYTE, nullptr);
+
+            // Set texture parameters for video (no mipmaps, linear filtering)
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+
+        if (setCount > 1) glGenBuffers(1, &planes.uploadPbo[set]);
+        planes.uploadPboSize[set] = 0;
+    }
+
+    planes.setCount = setCount;
+    planes.currentSet = 0;
+    planes.planesAllocated = true;
+    return (true);
+}
+
+// Delete the plane textures and pixel buffers of every upload set, except the sprite's own texture ID
+void PBOGLES::oglDeleteVideoPlanes(stOglVideoPlanes& planes) {
+    for (int set = 0; set < OGL_VIDEO_MAX_UPLOAD_SETS; set++) {
+        for (int plane = 0; plane < OGL_VIDEO_MAX_PLANES; plane++) {
+            GLuint texture = planes.planeTex[set][plane];
+            if (texture == 0 || (set == 0 && plane == 0)) continue;
+            oglForgetTexture(texture);
+            glDeleteTextures(1, &texture);
+            planes.planeTex[set][plane] = 0;
+        }
+        if (planes.uploadPbo[set] != 0) {
+            glDeleteBuffers(1, &planes.uploadPbo[set]);
+            planes.uploadPbo[set] = 0;
+            planes.uploadPboSize[set] = 0;
+        }
+    }
+    planes.setCount = 0;
+    planes.currentSet = 0;
+}
+
 // Restore full 2D rendering state after a 3D pass.
 // Called by PB3D::pb3dEnd() so that the 3D layer never needs to know
 // about the internal 2D shader program, attrib layout or GL state.
 void PBOGLES::oglRestore2DState() {
     // Disable 3D-specific state
-    if (m_depthTestEnabled) { glDisable(GL_DEPTH_TEST); m_depthTestEnabled = false; }
-    if (m_cullFaceEnabled)  { glDisable(GL_CULL_FACE);  m_cullFaceEnabled  = false; }
+    oglSetCapability(GL_DEPTH_TEST, false);
+    oglSetCapability(GL_CULL_FACE, false);
     // Disable depth writes — 2D sprites must not write to the depth buffer.
     // Per the OpenGL ES spec, depth writes occur even when GL_DEPTH_TEST is disabled
     // if glDepthMask is GL_TRUE, causing major unnecessary memory bandwidth.
-    glDepthMask(GL_FALSE);
+    oglDepthMask(false);
 
     // Re-enable standard alpha blending for 2D sprites
-    if (!m_blendEnabled) { glEnable(GL_BLEND); m_blendEnabled = true; }
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    oglSetCapability(GL_BLEND, true);
+    oglBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     // Unbind VAO so 2D CPU-pointer vertex calls work correctly
-    glBindVertexArray(0);
+    oglBindVertexArray(0);
 
     // Restore 2D sprite shader program
-    glUseProgram(m_shaderProgram);
+    oglUseProgram(m_shaderProgram);
 
-    // Unbind VBOs: GL_ARRAY_BUFFER is global state — if left bound,
-    // oglRenderQuad's CPU vertex pointers are misread as VBO offsets.
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    // Unbind VBOs: GL_ELEMENT_ARRAY_BUFFER on VAO 0 must be zero for the CPU index array
+    // in oglRenderQuad; GL_ARRAY_BUFFER is cleared so later pointer setup reads CPU memory.
+    oglBindBuffer(GL_ARRAY_BUFFER, 0);
+    oglBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-    // Re-enable 2D vertex attrib arrays (may have been disrupted by VAO binding)
-    glEnableVertexAttribArray(m_posAttrib);
-    glEnableVertexAttribArray(m_colorAttrib);
-    glEnableVertexAttribArray(m_texCoordAttrib);
+    // 2D attrib pointers / enables live on VAO 0, which the 3D pass never modifies
+    oglSet2DAttribPointers();
 
-    // Reset 2D texture cache: 3D rendering binds textures outside our tracking.
-    oglResetTextureCache();
+    // 3D texture binds go through the state cache, so the 2D texture tracking stays valid
 }
 
-// Update an existing texture with new video frame data
+// Update an existing texture with new video frame data.  Video textures upload through their ring of texture sets.
 bool PBOGLES::oglUpdateTexture(GLuint textureId, const uint8_t* data, unsigned int width, unsigned int height) {
     if (textureId == 0 || data == nullptr) {
         return false;
     }
     
-    glBindTexture(GL_TEXTURE_2D, textureId);
+    std::map<GLuint, stOglVideoPlanes>::iterator it = m_videoPlaneList.find(textureId);
+    if (it != m_videoPlaneList.end()) {
+        if (it->second.format != OGL_VIDEO_RGBA || width != it->second.width || height != it->second.height) {
+            return false;
+        }
+        const uint8_t* planes[3] = { data, nullptr, nullptr };
+        const int strides[3] = { (int)(width * 4), 0, 0 };
+        return oglUploadVideoFrame(it->second, planes, strides);
+    }
+    
+    oglBindTextureForUpload(0, textureId);
     
     // Update the texture with new RGBA data
     glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    m_glCallCount++;
     
     return true;
 }
 
+// Upload a decoded frame's planes into a planar video texture.  Strides are the decoder's line sizes, which are
+// usually padded past the width, so rows are unpacked with GL_UNPACK_ROW_LENGTH rather than repacked on the CPU.
+bool PBOGLES::oglUpdateVideoPlanes(GLuint textureId, const uint8_t* const planes[3], const int strides[3],
+                                   unsigned int width, unsigned int height, bool bt709, bool fullRange) {
+    std::map<GLuint, stOglVideoPlanes>::iterator it = m_videoPlaneList.find(textureId);
+    if (it == m_videoPlaneList.end() || planes == nullptr || strides == nullptr) return (false);
+
+    stOglVideoPlanes& videoPlanes = it->second;
+    if (videoPlanes.format == OGL_VIDEO_RGBA) return (false);
+    if (width != videoPlanes.width || height != videoPlanes.height) return (false);
+
+    // A DMA buffer video falling back to uploads: the layout is whatever the decoder handed over
+    if (!videoPlanes.planesAllocated) {
+        videoPlanes.format = (planes[2] != nullptr) ? OGL_VIDEO_I420 : OGL_VIDEO_NV12;
+        if (!oglAllocVideoPlanes(textureId, videoPlanes)) {
+            oglDeleteVideoPlanes(videoPlanes);
+            return (false);
+        }
+    }
+    videoPlanes.externalTex = 0;
+
+    // Colour description changes are rare, pick up the new matrix on the next draw
+    if (videoPlanes.bt709 != bt709 || videoPlanes.fullRange != fullRange) {
+        videoPlanes.bt709 = bt709;
+        videoPlanes.fullRange = fullRange;
+        if (m_videoUniformTexture == textureId) m_videoUniformTexture = 0;
+    }
+
+    return (oglUploadVideoFrame(videoPlanes, planes, strides));
+}
+
+// Write a frame into the next upload set and make it the one drawn.  The set being written was last drawn two
+// frames ago (triple buffering), so glTexSubImage2D does not wait on a texture the GPU is still sampling.  With a
+// pixel buffer the planes are copied into it as they are (strides included) and the texture transfer is queued
+// on the GPU; without one the planes go straight from client memory.
+bool PBOGLES::oglUploadVideoFrame(stOglVideoPlanes& video, const uint8_t* const planes[3], const int strides[3]) {
+    if (video.setCount == 0) return (false);
+
+    std::chrono::steady_clock::time_point uploadStart = std::chrono::steady_clock::now();
+
+    int planeCount = oglVideoPlaneCount(video.format);
+    unsigned int set = (video.currentSet + 1) % video.setCount;
+
+    GLsizei planeWidth[OGL_VIDEO_MAX_PLANES], planeHeight[OGL_VIDEO_MAX_PLANES];
+    GLenum  internalFormat[OGL_VIDEO_MAX_PLANES], pixelFormat[OGL_VIDEO_MAX_PLANES];
+    int     bytesPerPixel[OGL_VIDEO_MAX_PLANES];
+    size_t  planeOffset[OGL_VIDEO_MAX_PLANES];
+    size_t  frameBytes = 0;
+    for (int i = 0; i < planeCount; i++) {
+        oglVideoPlaneLayout(video.format, i, video.width, video.height, &planeWidth[i], &planeHeight[i],
+                            &internalFormat[i], &pixelFormat[i], &bytesPerPixel[i]);
+        if (planes[i] == nullptr || strides[i] < planeWidth[i] * bytesPerPixel[i]) return (false);
+        planeOffset[i] = frameBytes;
+        frameBytes += (size_t)strides[i] * planeHeight[i];
+    }
+
+    const uint8_t* source[OGL_VIDEO_MAX_PLANES] = { planes[0], planes[1], planes[2] };
+    bool usePbo = false;
+    if (video.uploadPbo[set] != 0) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, video.uploadPbo[set]);
+        m_glCallCount++;
+        if (video.uploadPboSize[set] != (GLsizeiptr)frameBytes) {
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)frameBytes, nullptr, GL_STREAM_DRAW);
+            video.uploadPboSize[set] = (GLsizeiptr)frameBytes;
+            m_glCallCount++;
+        }
+
+        // Invalidating lets the driver hand out fresh storage if the previous transfer is still pending
+        void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)frameBytes,
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        m_glCallCount++;
+        if (mapped != nullptr) {
+            for (int i = 0; i < planeCount; i++) {
+                memcpy((uint8_t*)mapped + planeOffset[i], planes[i], (size_t)strides[i] * planeHeight[i]);
+            }
+            usePbo = (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE);
+            m_glCallCount++;
+        }
+
+        if (usePbo) {
+            for (int i = 0; i < planeCount; i++) source[i] = reinterpret_cast<const uint8_t*>(planeOffset[i]);
+        } else {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            m_glCallCount++;
+        }
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int i = 0; i < planeCount; i++) {
+        oglBindTextureForUpload(0, video.planeTex[set][i]);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, strides[i] / bytesPerPixel[i]);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, planeWidth[i], planeHeight[i], pixelFormat[i], GL_UNSIGNED_BYTE, source[i]);
+        m_glCallCount += 2;
+    }
+
+    // Everything else uploads tightly packed rows from client memory
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    m_glCallCount += 2;
+    if (usePbo) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        m_glCallCount++;
+    }
+
+    video.currentSet = set;
+
+    m_videoUploads++;
+    m_videoUploadBytes += (unsigned long)frameBytes;
+    m_videoUploadMicros += (unsigned int)std::chrono::duration_cast<std::chrono::microseconds>(
+                               std::chrono::steady_clock::now() - uploadStart).count();
+    return (true);
+}
+
+// Texture memory of a video texture (all planes of every upload set), 0 for any other texture
+unsigned long PBOGLES::oglGetVideoTextureBytes(GLuint textureId) {
+    std::map<GLuint, stOglVideoPlanes>::iterator it = m_videoPlaneList.find(textureId);
+    if (it == m_videoPlaneList.end()) return (0);
+
+    unsigned long setBytes = 0;
+    for (int i = 0; i < oglVideoPlaneCount(it->second.format); i++) {
+        GLsizei planeWidth, planeHeight;
+        GLenum  internalFormat, pixelFormat;
+        int     bytesPerPixel;
+        oglVideoPlaneLayout(it->second.format, i, it->second.width, it->second.height, &planeWidth, &planeHeight,
+                            &internalFormat, &pixelFormat, &bytesPerPixel);
+        setBytes += (unsigned long)planeWidth * planeHeight * bytesPerPixel;
+    }
+
+    // DMA buffer textures have no sets until a frame has to be uploaded
+    unsigned long setCount = (it->second.setCount > 0) ? it->second.setCount : 1;
+    return (setBytes * setCount);
+}
+
+// ============================================================================
+// GL state cache — shadows program, VAO / buffer, texture-unit, capability,
+// blend / depth and selected uniform state so that redundant driver calls are
+// skipped.  Every issued call bumps m_glCallCount, every skipped one
+// m_glSkippedCount; oglSwap() publishes both for the diagnostics overlay.
+// ============================================================================
+
+void PBOGLES::oglUseProgram(GLuint program) {
+    if (m_boundProgram == program) { m_glSkippedCount++; return; }
+    glUseProgram(program);
+    m_boundProgram = program;
+    m_glCallCount++;
+}
+
+// Binding a VAO also swaps the GL_ELEMENT_ARRAY_BUFFER binding (it is VAO state)
+void PBOGLES::oglBindVertexArray(GLuint vao) {
+    if (m_boundVao == vao) { m_glSkippedCount++; return; }
+    glBindVertexArray(vao);
+    m_boundVao = vao;
+    m_boundElementBuffer = OGL_UNKNOWN_BINDING;
+    m_glCallCount++;
+}
+
+void PBOGLES::oglBindBuffer(GLenum target, GLuint buffer) {
+    GLuint* cached = nullptr;
+    if (target == GL_ARRAY_BUFFER) cached = &m_boundArrayBuffer;
+    else if (target == GL_ELEMENT_ARRAY_BUFFER) cached = &m_boundElementBuffer;
+
+    if (cached && *cached == buffer) { m_glSkippedCount++; return; }
+    glBindBuffer(target, buffer);
+    if (cached) *cached = buffer;
+    m_glCallCount++;
+}
+
+void PBOGLES::oglBindTexture(unsigned int unit, GLuint textureId) {
+    if (unit >= OGL_MAX_TEXTURE_UNITS) return;
+    if (m_boundTexture[unit] == textureId) { m_glSkippedCount++; return; }
+    if (m_activeTextureUnit != unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        m_activeTextureUnit = unit;
+        m_glCallCount++;
+    }
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    m_boundTexture[unit] = textureId;
+    m_glCallCount++;
+}
+
+// glTexImage / glTexSubImage act on the active unit, which a cached (skipped) bind leaves wherever the last
+// issued bind put it.  Uploads bind through here so the target texture is the one actually modified.
+void PBOGLES::oglBindTextureForUpload(unsigned int unit, GLuint textureId) {
+    if (unit >= OGL_MAX_TEXTURE_UNITS) return;
+    oglBindTexture(unit, textureId);
+    if (m_activeTextureUnit != unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        m_activeTextureUnit = unit;
+        m_glCallCount++;
+    }
+}
+
+// Forget all texture bindings - the next bind on every unit is issued to the driver
+void PBOGLES::oglResetTextureCache() {
+    for (int i = 0; i < OGL_MAX_TEXTURE_UNITS; i++) m_boundTexture[i] = OGL_UNKNOWN_BINDING;
+    m_activeTextureUnit = OGL_MAX_TEXTURE_UNITS;
+}
+
+// Enable / disable a capability.  Blend, depth test, cull face and scissor are shadowed; others pass through.
+void PBOGLES::oglSetCapability(GLenum cap, bool enable) {
+    bool* cached = nullptr;
+    switch (cap) {
+        case GL_BLEND:        cached = &m_blendEnabled;     break;
+        case GL_DEPTH_TEST:   cached = &m_depthTestEnabled; break;
+        case GL_CULL_FACE:    cached = &m_cullFaceEnabled;  break;
+        case GL_SCISSOR_TEST: cached = &m_scissorEnabled;   break;
+        default: break;
+    }
+
+    if (cached && *cached == enable) { m_glSkippedCount++; return; }
+    if (enable) glEnable(cap);
+    else glDisable(cap);
+    if (cached) *cached = enable;
+    m_glCallCount++;
+}
+
+void PBOGLES::oglBlendFunc(GLenum srcFactor, GLenum dstFactor) {
+    oglBlendFuncSeparate(srcFactor, dstFactor, srcFactor, dstFactor);
+}
+
+void PBOGLES::oglBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) {
+    if (m_blendSrc == srcRGB && m_blendDst == dstRGB && m_blendSrcAlpha == srcAlpha && m_blendDstAlpha == dstAlpha) {
+        m_glSkippedCount++;
+        return;
+    }
+    glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+    m_blendSrc = srcRGB;
+    m_blendDst = dstRGB;
+    m_blendSrcAlpha = srcAlpha;
+    m_blendDstAlpha = dstAlpha;
+    m_glCallCount++;
+}
+
+void PBOGLES::oglBindFramebuffer(GLuint framebuffer) {
+    if (m_boundFramebuffer == framebuffer) { m_glSkippedCount++; return; }
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    m_boundFramebuffer = framebuffer;
+    m_glCallCount++;
+}
+
+void PBOGLES::oglDepthMask(bool enable) {
+    if (m_depthMaskEnabled == enable) { m_glSkippedCount++; return; }
+    glDepthMask(enable ? GL_TRUE : GL_FALSE);
+    m_depthMaskEnabled = enable;
+    m_glCallCount++;
+}
+
+void PBOGLES::oglDepthFunc(GLenum func) {
+    if (m_depthFunc == func) { m_glSkippedCount++; return; }
+    glDepthFunc(func);
+    m_depthFunc = func;
+    m_glCallCount++;
+}
+
+// Set a float (or bool) uniform on the current program.  The cache slot belongs to that program's location.
+void PBOGLES::oglSetUniform1f(GLint location, float value, float* cachedValue) {
+    if (*cachedValue == value) { m_glSkippedCount++; return; }
+    glUniform1f(location, value);
+    *cachedValue = value;
+    m_glCallCount++;
+}
+
+// Point the 2D sprite attributes at m_quadVertices.  This is VAO 0 state, so it only needs doing once
+// per context: the 3D pass uses its own VAOs and never touches VAO 0's attribute setup.
+void PBOGLES::oglSet2DAttribPointers() {
+    if (m_2dAttribsSet) return;
+
+    oglBindVertexArray(0);
+    oglBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glEnableVertexAttribArray(m_posAttrib);
+    glEnableVertexAttribArray(m_colorAttrib);
+    glEnableVertexAttribArray(m_texCoordAttrib);
+    glVertexAttribPointer(m_posAttrib, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(GLfloat), m_quadVertices);
+    glVertexAttribPointer(m_colorAttrib, 4, GL_FLOAT, GL_FALSE, 9 * sizeof(GLfloat), m_quadVertices + 3);
+    glVertexAttribPointer(m_texCoordAttrib, 2, GL_FLOAT, GL_FALSE, 9 * sizeof(GLfloat), m_quadVertices + 7);
+    m_glCallCount += 6;
+
+    m_2dAttribsSet = true;
+}
+
+// Deleting a bound object silently rebinds zero, so drop any cached binding to it
+void PBOGLES::oglForgetTexture(GLuint textureId) {
+    for (int i = 0; i < OGL_MAX_TEXTURE_UNITS; i++) {
+        if (m_boundTexture[i] == textureId) m_boundTexture[i] = OGL_UNKNOWN_BINDING;
+    }
+}
+
+void PBOGLES::oglForgetVertexArray(GLuint vao) {
+    if (m_boundVao == vao) {
+        m_boundVao = OGL_UNKNOWN_BINDING;
+        m_boundElementBuffer = OGL_UNKNOWN_BINDING;
+    }
+}
+
+void PBOGLES::oglForgetBuffer(GLuint buffer) {
+    if (m_boundArrayBuffer == buffer) m_boundArrayBuffer = OGL_UNKNOWN_BINDING;
+    if (m_boundElementBuffer == buffer) m_boundElementBuffer = OGL_UNKNOWN_BINDING;
+}
+
+void PBOGLES::oglForgetProgram(GLuint program) {
+    if (m_boundProgram == program) m_boundProgram = OGL_UNKNOWN_BINDING;
+}
+
 // ============================================================================
 // 3D rendering backend — all OpenGL ES calls for the 3D pass live here.
 // PB3D delegates every GL operation to these methods; PB3D itself makes no
@@ -679,7 +1696,9 @@ bool PBOGLES::ogl3dInitShader(const char* vertSrc, const char* fragSrc) {
 // Delete the 3D shader program and reset cached locations.
 void PBOGLES::ogl3dDestroyShader() {
     if (m_3dShaderProgram) {
+        oglForgetProgram(m_3dShaderProgram);
         glDeleteProgram(m_3dShaderProgram);
+        m_cached3dAlpha      = -1.0f;
         m_3dShaderProgram    = 0;
         m_3dMVPUniform       = -1;
         m_3dModelUniform     = -1;
@@ -706,12 +1725,12 @@ bool PBOGLES::ogl3dCreateMesh(const float* vertData, size_t vertFloatCount,
     glGenBuffers(1, &vbo);
     glGenBuffers(1, &ebo);
 
-    glBindVertexArray(vao);
+    oglBindVertexArray(vao);
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    oglBindBuffer(GL_ARRAY_BUFFER, vbo);
     glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(vertFloatCount * sizeof(float)), vertData, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    oglBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(idxCount * sizeof(unsigned int)), idxData, GL_STATIC_DRAW);
 
     GLsizei stride = 8 * sizeof(float);
@@ -728,11 +1747,22 @@ bool PBOGLES::ogl3dCreateMesh(const float* vertData, size_t vertFloatCount,
         glVertexAttribPointer(m_3dTexCoordAttrib, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
     }
 
-    glBindVertexArray(0);
+    // Per-instance model matrix for the instanced program: four vec4 columns advancing once per
+    // instance.  The static program has no input at these locations, so its draws ignore them.
+    if (m_3dInstVbo) {
+        oglBindBuffer(GL_ARRAY_BUFFER, m_3dInstVbo);
+        for (int i = 0; i < 4; i++) {
+            glEnableVertexAttribArray(OGL_3D_INSTANCE_ATTRIB + i);
+            glVertexAttribPointer(OGL_3D_INSTANCE_ATTRIB + i, 4, GL_FLOAT, GL_FALSE, 16 * sizeof(float), (void*)(i * 4 * sizeof(float)));
+            glVertexAttribDivisor(OGL_3D_INSTANCE_ATTRIB + i, 1);
+        }
+    }
+
+    oglBindVertexArray(0);
     // Unbind VBOs: GL_ARRAY_BUFFER is global state — if left bound,
-    // oglRenderQuad's CPU vertex pointers are misread as VBO offsets.
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    // later CPU vertex pointer setup would be misread as VBO offsets.
+    oglBindBuffer(GL_ARRAY_BUFFER, 0);
+    oglBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     outVao = (unsigned int)vao;
     outVbo = (unsigned int)vbo;
@@ -745,6 +1775,9 @@ void PBOGLES::ogl3dDestroyMesh(unsigned int vao, unsigned int vbo, unsigned int
     GLuint glVao = (GLuint)vao;
     GLuint glVbo = (GLuint)vbo;
     GLuint glEbo = (GLuint)ebo;
+    oglForgetVertexArray(glVao);
+    oglForgetBuffer(glVbo);
+    oglForgetBuffer(glEbo);
     if (glVao) glDeleteVertexArrays(1, &glVao);
     if (glVbo) glDeleteBuffers(1, &glVbo);
     if (glEbo) glDeleteBuffers(1, &glEbo);
@@ -754,7 +1787,7 @@ void PBOGLES::ogl3dDestroyMesh(unsigned int vao, unsigned int vbo, unsigned int
 unsigned int PBOGLES::ogl3dCreateTexture(const unsigned char* pixels, int width, int height) {
     GLuint texId;
     glGenTextures(1, &texId);
-    glBindTexture(GL_TEXTURE_2D, texId);
+    oglBindTextureForUpload(0, texId);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -767,7 +1800,7 @@ unsigned int PBOGLES::ogl3dCreateTexture(const unsigned char* pixels, int width,
 unsigned int PBOGLES::ogl3dCreateFallbackTexture() {
     GLuint texId;
     glGenTextures(1, &texId);
-    glBindTexture(GL_TEXTURE_2D, texId);
+    oglBindTextureForUpload(0, texId);
     const unsigned char white[] = {255, 255, 255, 255};
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -777,6 +1810,7 @@ unsigned int PBOGLES::ogl3dCreateFallbackTexture() {
 // Delete a 3D texture by its opaque handle.
 void PBOGLES::ogl3dDestroyTexture(unsigned int texId) {
     GLuint glTex = (GLuint)texId;
+    oglForgetTexture(glTex);
     if (glTex) glDeleteTextures(1, &glTex);
 }
 
@@ -784,13 +1818,14 @@ void PBOGLES::ogl3dDestroyTexture(unsigned int texId) {
 void PBOGLES::ogl3dBeginPass() {
     // Re-enable depth writes and clear before 3D draws.
     // glDepthMask is GL_FALSE during 2D — must set TRUE before glClear(DEPTH) is effective.
-    glDepthMask(GL_TRUE);
+    oglDepthMask(true);
     glClear(GL_DEPTH_BUFFER_BIT);
-    if (!m_depthTestEnabled) { glEnable(GL_DEPTH_TEST);  m_depthTestEnabled = true; }
-    glDepthFunc(GL_LEQUAL);
+    m_glCallCount++;
+    oglSetCapability(GL_DEPTH_TEST, true);
+    oglDepthFunc(GL_LEQUAL);
     // Backface culling disabled — glTF winding-order varies by exporter.
-    if (m_cullFaceEnabled)    { glDisable(GL_CULL_FACE); m_cullFaceEnabled  = false; }
-    glUseProgram(m_3dShaderProgram);
+    oglSetCapability(GL_CULL_FACE, false);
+    oglUseProgram(m_3dShaderProgram);
 }
 
 // Upload scene-level uniforms: light direction/colour/ambient and camera eye.
@@ -803,6 +1838,7 @@ void PBOGLES::ogl3dSetSceneUniforms(float lightDirX, float lightDirY, float ligh
     glUniform3f(m_3dLightColorUniform, lightColR, lightColG, lightColB);
     glUniform3f(m_3dAmbientUniform,    ambR,      ambG,      ambB);
     glUniform3f(m_3dCameraEyeUniform,  eyeX,      eyeY,      eyeZ);
+    m_glCallCount += 4;
 }
 
 // Upload scene-level uniforms for the skinned shader pass.
@@ -814,6 +1850,7 @@ void PBOGLES::ogl3dSetSkinnedSceneUniforms(float lightDirX, float lightDirY, flo
     glUniform3f(m_3dSk_LightColUniform,  lightColR, lightColG, lightColB);
     glUniform3f(m_3dSk_AmbientUniform,   ambR,      ambG,      ambB);
     glUniform3f(m_3dSk_CameraEyeUniform, eyeX,      eyeY,      eyeZ);
+    m_glCallCount += 4;
 }
 
 // Upload per-instance uniforms: MVP matrix, model matrix, and alpha.
@@ -821,27 +1858,26 @@ void PBOGLES::ogl3dSetSkinnedSceneUniforms(float lightDirX, float lightDirY, flo
 void PBOGLES::ogl3dSetInstanceUniforms(const float mvp[16], const float modelMat[16], float alpha) {
     glUniformMatrix4fv(m_3dMVPUniform,   1, GL_FALSE, mvp);
     glUniformMatrix4fv(m_3dModelUniform, 1, GL_FALSE, modelMat);
-    glUniform1f(m_3dAlphaUniform, alpha);
+    m_glCallCount += 2;
+    oglSetUniform1f(m_3dAlphaUniform, alpha, &m_cached3dAlpha);
 }
 
 // Enable or disable alpha blending for transparent 3D instances.
 void PBOGLES::ogl3dSetBlend(bool enable) {
-    if (enable) {
-        if (!m_blendEnabled) { glEnable(GL_BLEND); m_blendEnabled = true; }
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    } else {
-        if (m_blendEnabled) { glDisable(GL_BLEND); m_blendEnabled = false; }
-    }
+    oglSetCapability(GL_BLEND, enable);
+    if (enable) oglBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
 // Draw one mesh primitive using its VAO and texture handle.
 // ogl3dSetInstanceUniforms() must be called before the first mesh of each instance.
-void PBOGLES::ogl3dDrawMeshPrimitive(unsigned int vao, unsigned int textureId, unsigned int indexCount) {
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray((GLuint)vao);
-    glBindTexture(GL_TEXTURE_2D, (GLuint)textureId);
-    glDrawElements(GL_TRIANGLES, (GLsizei)indexCount, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+// The VAO is left bound; consecutive draws of the same mesh skip the rebind and
+// oglRestore2DState() returns to VAO 0 at the end of the pass.
+void PBOGLES::ogl3dDrawMeshPrimitive(unsigned int vao, unsigned int textureId, unsigned int indexCount,
+                                     unsigned int firstIndex) {
+    oglBindVertexArray((GLuint)vao);
+    oglBindTexture(0, (GLuint)textureId);
+    glDrawElements(GL_TRIANGLES, (GLsizei)indexCount, GL_UNSIGNED_INT, (const void*)((size_t)firstIndex * sizeof(GLuint)));
+    m_glCallCount++;
 }
 
 // ============================================================================
@@ -861,6 +1897,13 @@ bool PBOGLES::ogl3dInitSkinnedShader(const char* vertSrc, const char* fragSrc) {
     m_3dSk_CameraEyeUniform = glGetUniformLocation(m_3dSkinnedShaderProgram, "uCameraEye");
     m_3dSk_AlphaUniform     = glGetUniformLocation(m_3dSkinnedShaderProgram, "uAlpha");
     m_3dSk_BonesUniform     = glGetUniformLocation(m_3dSkinnedShaderProgram, "uBones");
+    m_3dSk_PaletteUniform   = glGetUniformLocation(m_3dSkinnedShaderProgram, "uBonePalette");
+    if (m_3dSk_PaletteUniform >= 0) {
+        // The sampler never changes unit, set it once
+        oglUseProgram(m_3dSkinnedShaderProgram);
+        glUniform1i(m_3dSk_PaletteUniform, OGL_BONE_PALETTE_UNIT);
+        m_glCallCount++;
+    }
 
     m_3dSk_PosAttrib        = glGetAttribLocation(m_3dSkinnedShaderProgram, "aPosition");
     m_3dSk_NormalAttrib     = glGetAttribLocation(m_3dSkinnedShaderProgram, "aNormal");
@@ -874,7 +1917,9 @@ bool PBOGLES::ogl3dInitSkinnedShader(const char* vertSrc, const char* fragSrc) {
 // Delete the skinned 3D shader program and reset cached locations.
 void PBOGLES::ogl3dDestroySkinnedShader() {
     if (m_3dSkinnedShaderProgram) {
+        oglForgetProgram(m_3dSkinnedShaderProgram);
         glDeleteProgram(m_3dSkinnedShaderProgram);
+        m_cached3dSkAlpha        = -1.0f;
         m_3dSkinnedShaderProgram = 0;
         m_3dSk_MVPUniform       = -1;
         m_3dSk_ModelUniform     = -1;
@@ -884,6 +1929,7 @@ void PBOGLES::ogl3dDestroySkinnedShader() {
         m_3dSk_CameraEyeUniform = -1;
         m_3dSk_AlphaUniform     = -1;
         m_3dSk_BonesUniform     = -1;
+        m_3dSk_PaletteUniform   = -1;
         m_3dSk_PosAttrib        = -1;
         m_3dSk_NormalAttrib     = -1;
         m_3dSk_TexCoordAttrib   = -1;
@@ -905,12 +1951,12 @@ bool PBOGLES::ogl3dCreateSkinnedMesh(const float* vertData, size_t vertFloatCoun
     glGenBuffers(1, &vbo);
     glGenBuffers(1, &ebo);
 
-    glBindVertexArray(vao);
+    oglBindVertexArray(vao);
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    oglBindBuffer(GL_ARRAY_BUFFER, vbo);
     glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(vertFloatCount * sizeof(float)), vertData, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    oglBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(idxCount * sizeof(unsigned int)), idxData, GL_STATIC_DRAW);
 
     GLsizei stride = 16 * sizeof(float);
@@ -935,9 +1981,9 @@ bool PBOGLES::ogl3dCreateSkinnedMesh(const float* vertData, size_t vertFloatCoun
         glVertexAttribPointer(m_3dSk_WeightsAttrib, 4, GL_FLOAT, GL_FALSE, stride, (void*)(12 * sizeof(float)));
     }
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    oglBindVertexArray(0);
+    oglBindBuffer(GL_ARRAY_BUFFER, 0);
+    oglBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     outVao = (unsigned int)vao;
     outVbo = (unsigned int)vbo;
@@ -951,22 +1997,23 @@ bool PBOGLES::ogl3dCreateSkinnedMesh(const float* vertData, size_t vertFloatCoun
 // depth buffer (appropriate only at frame start) and is reserved for a
 // potential future "skinned-only frame" path.
 void PBOGLES::ogl3dBeginSkinnedPass() {
-    glDepthMask(GL_TRUE);
+    oglDepthMask(true);
     glClear(GL_DEPTH_BUFFER_BIT);   // WARNING: clears depth — only call at frame start
-    if (!m_depthTestEnabled) { glEnable(GL_DEPTH_TEST);  m_depthTestEnabled = true; }
-    glDepthFunc(GL_LEQUAL);
-    if (m_cullFaceEnabled)   { glDisable(GL_CULL_FACE);  m_cullFaceEnabled  = false; }
-    glUseProgram(m_3dSkinnedShaderProgram);
+    m_glCallCount++;
+    oglSetCapability(GL_DEPTH_TEST, true);
+    oglDepthFunc(GL_LEQUAL);
+    oglSetCapability(GL_CULL_FACE, false);
+    oglUseProgram(m_3dSkinnedShaderProgram);
 }
 
 // Switch between static and skinned shader programs mid-frame without
 // re-clearing the depth buffer.  Scene uniforms must already be uploaded.
 void PBOGLES::ogl3dActivateStaticShader() {
-    glUseProgram(m_3dShaderProgram);
+    oglUseProgram(m_3dShaderProgram);
 }
 void PBOGLES::ogl3dActivateSkinnedShader() {
     if (m_3dSkinnedShaderProgram) {
-        glUseProgram(m_3dSkinnedShaderProgram);
+        oglUseProgram(m_3dSkinnedShaderProgram);
     }
 }
 
@@ -976,8 +2023,152 @@ void PBOGLES::ogl3dSetSkinnedInstanceUniforms(const float mvp[16], const float m
                                                const float* boneMatrices, int numBones) {
     glUniformMatrix4fv(m_3dSk_MVPUniform,   1, GL_FALSE, mvp);
     glUniformMatrix4fv(m_3dSk_ModelUniform, 1, GL_FALSE, modelMat);
-    glUniform1f(m_3dSk_AlphaUniform, alpha);
+    m_glCallCount += 2;
+    oglSetUniform1f(m_3dSk_AlphaUniform, alpha, &m_cached3dSkAlpha);
     if (m_3dSk_BonesUniform >= 0 && boneMatrices && numBones > 0) {
         glUniformMatrix4fv(m_3dSk_BonesUniform, numBones, GL_FALSE, boneMatrices);
+        m_glCallCount++;
     }
+}
+
+bool PBOGLES::ogl3dUsesBonePalette() {
+    return (m_3dSk_PaletteUniform >= 0);
+}
+
+// Create a bone palette texture with storage for numBones rows (contents undefined until updated)
+unsigned int PBOGLES::ogl3dCreateBonePalette(int numBones) {
+    GLuint texId;
+    glGenTextures(1, &texId);
+    oglBindTextureForUpload(OGL_BONE_PALETTE_UNIT, texId);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, 3, numBones, 0, GL_RGBA, GL_FLOAT, nullptr);
+    // Float textures are not filterable - the shader uses texelFetch, but the texture must still be complete
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    m_glCallCount += 6;
+    return (unsigned int)texId;
+}
+
+// Upload numBones packed rows (12 floats per bone) to a palette texture
+void PBOGLES::ogl3dUpdateBonePalette(unsigned int paletteTex, const float* packedRows, int numBones) {
+    oglBindTextureForUpload(OGL_BONE_PALETTE_UNIT, (GLuint)paletteTex);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 3, numBones, GL_RGBA, GL_FLOAT, packedRows);
+    m_glCallCount++;
+}
+
+// Per-instance uniforms for the palette path: the bones are a texture bind instead of a uniform upload
+void PBOGLES::ogl3dSetSkinnedPaletteUniforms(const float mvp[16], const float modelMat[16],
+                                             float alpha, unsigned int paletteTex) {
+    glUniformMatrix4fv(m_3dSk_MVPUniform,   1, GL_FALSE, mvp);
+    glUniformMatrix4fv(m_3dSk_ModelUniform, 1, GL_FALSE, modelMat);
+    m_glCallCount += 2;
+    oglSetUniform1f(m_3dSk_AlphaUniform, alpha, &m_cached3dSkAlpha);
+    oglBindTexture(OGL_BONE_PALETTE_UNIT, (GLuint)paletteTex);
+}
+
+// ============================================================================
+// Instanced static meshes
+// ============================================================================
+
+// Compile the instanced static-mesh shader and create the streamed model matrix buffer.
+// The vertex shader must use the same attribute locations as the static shader (pos 0,
+// normal 1, uv 2) so both programs can draw from the same VAO.
+bool PBOGLES::ogl3dInitInstancedShader(const char* vertSrc, const char* fragSrc) {
+    m_3dInstProgram = oglCreateProgram(vertSrc, fragSrc);
+    if (m_3dInstProgram == 0) return (false);
+
+    if (glGetAttribLocation(m_3dInstProgram, "iModel") != OGL_3D_INSTANCE_ATTRIB ||
+        glGetAttribLocation(m_3dInstProgram, "aPosition") != m_3dPosAttrib) {
+        oglForgetProgram(m_3dInstProgram);
+        glDeleteProgram(m_3dInstProgram);
+        m_3dInstProgram = 0;
+        return (false);
+    }
+
+    m_3dInst_ViewProjUniform  = glGetUniformLocation(m_3dInstProgram, "uViewProj");
+    m_3dInst_LightDirUniform  = glGetUniformLocation(m_3dInstProgram, "uLightDir");
+    m_3dInst_LightColUniform  = glGetUniformLocation(m_3dInstProgram, "uLightColor");
+    m_3dInst_AmbientUniform   = glGetUniformLocation(m_3dInstProgram, "uAmbientColor");
+    m_3dInst_CameraEyeUniform = glGetUniformLocation(m_3dInstProgram, "uCameraEye");
+
+    // Only opaque meshes are instanced, so alpha is fixed at 1
+    oglUseProgram(m_3dInstProgram);
+    glUniform1f(glGetUniformLocation(m_3dInstProgram, "uAlpha"), 1.0f);
+    m_glCallCount++;
+
+    // The buffer starts with room for a few sets of dice so static draws never reference an empty buffer
+    glGenBuffers(1, &m_3dInstVbo);
+    oglBindBuffer(GL_ARRAY_BUFFER, m_3dInstVbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(OGL_3D_INSTANCE_INIT * 16 * sizeof(float)), nullptr, GL_STREAM_DRAW);
+    oglBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_3dInstCapacity = OGL_3D_INSTANCE_INIT;
+
+    return (true);
+}
+
+// Delete the instanced program and its buffer.
+void PBOGLES::ogl3dDestroyInstancedShader() {
+    if (m_3dInstProgram) {
+        oglForgetProgram(m_3dInstProgram);
+        glDeleteProgram(m_3dInstProgram);
+        m_3dInstProgram           = 0;
+        m_3dInst_ViewProjUniform  = -1;
+        m_3dInst_LightDirUniform  = -1;
+        m_3dInst_LightColUniform  = -1;
+        m_3dInst_AmbientUniform   = -1;
+        m_3dInst_CameraEyeUniform = -1;
+    }
+    if (m_3dInstVbo) {
+        oglForgetBuffer(m_3dInstVbo);
+        glDeleteBuffers(1, &m_3dInstVbo);
+        m_3dInstVbo      = 0;
+        m_3dInstCapacity = 0;
+    }
+}
+
+// Upload scene-level uniforms for the instanced program.  Leaves the instanced program bound;
+// callers switch back with ogl3dActivateStaticShader().
+void PBOGLES::ogl3dSetInstancedSceneUniforms(float lightDirX, float lightDirY, float lightDirZ,
+                                             float lightColR, float lightColG, float lightColB,
+                                             float ambR,      float ambG,      float ambB,
+                                             float eyeX,      float eyeY,      float eyeZ,
+                                             const float viewProj[16]) {
+    if (m_3dInstProgram == 0) return;
+    oglUseProgram(m_3dInstProgram);
+    glUniform3f(m_3dInst_LightDirUniform,  lightDirX, lightDirY, lightDirZ);
+    glUniform3f(m_3dInst_LightColUniform,  lightColR, lightColG, lightColB);
+    glUniform3f(m_3dInst_AmbientUniform,   ambR,      ambG,      ambB);
+    glUniform3f(m_3dInst_CameraEyeUniform, eyeX,      eyeY,      eyeZ);
+    glUniformMatrix4fv(m_3dInst_ViewProjUniform, 1, GL_FALSE, viewProj);
+    m_glCallCount += 5;
+}
+
+// Draw count copies of a static mesh with one call, each with its own model matrix.
+// Blend state is the caller's; only opaque meshes should come through here.
+void PBOGLES::ogl3dDrawMeshInstanced(unsigned int vao, unsigned int textureId, unsigned int indexCount,
+                                     unsigned int firstIndex, const float* models, unsigned int count) {
+    if (m_3dInstProgram == 0 || models == nullptr || count == 0) return;
+
+    oglUseProgram(m_3dInstProgram);
+
+    // Stream the matrices.  Grow the buffer when needed, otherwise orphan it so the driver
+    // does not stall waiting for the previous run to finish reading it.
+    GLsizeiptr dataSize = (GLsizeiptr)(count * 16 * sizeof(float));
+    oglBindBuffer(GL_ARRAY_BUFFER, m_3dInstVbo);
+    if (count > m_3dInstCapacity) {
+        m_3dInstCapacity = count;
+        glBufferData(GL_ARRAY_BUFFER, dataSize, models, GL_STREAM_DRAW);
+        m_glCallCount++;
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(m_3dInstCapacity * 16 * sizeof(float)), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, dataSize, models);
+        m_glCallCount += 2;
+    }
+
+    oglBindVertexArray((GLuint)vao);
+    oglBindTexture(0, (GLuint)textureId);
+    glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)indexCount, GL_UNSIGNED_INT,
+                            (const void*)((size_t)firstIndex * sizeof(GLuint)), (GLsizei)count);
+    m_glCallCount++;
 }
\ No newline at end of file
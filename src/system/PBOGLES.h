@@ -19,16 +19,114 @@
 //#include "include_ogl/egl.h"
 //#include "include_ogl/gl31.h"
 #include <egl.h>
+#include <eglext.h>
 #include <gl31.h>
 #include <stdio.h>
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <cstring>
+#include <map>
+#include <vector>
 #include "3rdparty/stb_image.h"
 
 #define OGLES_BLACKCOLOR 0x0 
 #define OGLES_WHITECOLOR 0x1
 
+#define OGL_MAX_TEXTURE_UNITS 8             // Texture units tracked by the GL state cache
+#define OGL_BONE_PALETTE_UNIT 1             // Texture unit the skinned shader reads bone palettes from
+#define OGL_3D_INSTANCE_ATTRIB 3            // First of four attribute locations holding the instanced 3D model matrix
+#define OGL_3D_INSTANCE_INIT   64           // Model matrices the instanced 3D buffer holds before it first grows
+#define OGL_UNKNOWN_BINDING   0xFFFFFFFF    // State cache value meaning "driver state not known, always issue the call"
+#define OGL_VIDEO_CHROMA_UNIT 1             // First texture unit the YUV video shader reads chroma planes from (U, then V)
+#define OGL_DMABUF_MAX_PLANES 3
+#define OGL_DMABUF_IMAGE_CACHE 24           // Imported EGLImages kept per video - decoders cycle a fixed set of buffers
+#define OGL_DMABUF_NO_MODIFIER 0x00ffffffffffffffULL   // DRM_FORMAT_MOD_INVALID: buffer layout is implied by the fourcc
+#define OGL_DMABUF_LINEAR_MODIFIER 0ULL                 // DRM_FORMAT_MOD_LINEAR
+#define OGL_VIDEO_MAX_PLANES 3              // Texture planes of one video frame (RGBA 1, NV12 2, I420 3)
+#define OGL_VIDEO_MAX_UPLOAD_SETS 4         // Upper bound for VIDEO_UPLOAD_BUFFERS
+
+#ifndef GL_TEXTURE_EXTERNAL_OES
+#define GL_TEXTURE_EXTERNAL_OES 0x8D65      // GL_OES_EGL_image_external (gl2ext.h is not in every include set)
+#endif
+typedef void (GL_APIENTRY *oglEGLImageTargetTexture2DProc)(GLenum target, void* image);
+
+// CPU-side decoded texture image.  Produced by oglDecodeTexture (safe to call from any thread,
+// no GL calls) and consumed by oglUploadTexture on the render thread.
+struct stOglImageData {
+    unsigned char* pixels;
+    unsigned int   width;
+    unsigned int   height;
+    unsigned int   channels;    // 3 = RGB (BMP), 4 = RGBA (PNG)
+    bool           stbiOwned;   // true if pixels must be released with stbi_image_free, otherwise delete[]
+};
+
+// Pixel layout of a video texture.  The planar layouts keep the decoder's planes in single channel
+// textures (chroma at half width and height) and convert to RGB in the fragment shader.
+enum oglVideoFormat {
+    OGL_VIDEO_RGBA = 0,     // One RGBA texture, colour converted on the CPU
+    OGL_VIDEO_I420 = 1,     // Y, U and V planes
+    OGL_VIDEO_NV12 = 2,     // Y plane plus one interleaved UV plane
+    OGL_VIDEO_DMABUF = 3    // Decoder DMA buffers imported as EGLImages; planes are uploaded only as a fallback
+};
+
+// A decoded frame that lives in DMA buffers (Linux), described by its DRM fourcc, modifier and planes
+struct stOglDmabufFrame {
+    int          fd[OGL_DMABUF_MAX_PLANES];
+    unsigned int offset[OGL_DMABUF_MAX_PLANES];
+    unsigned int pitch[OGL_DMABUF_MAX_PLANES];
+    unsigned int planeCount;
+    uint32_t     fourcc;
+    uint64_t     modifier;          // OGL_DMABUF_NO_MODIFIER when the buffer has none
+    unsigned int width;
+    unsigned int height;
+    bool         bt709;
+    bool         fullRange;
+};
+
+// One imported buffer.  The decoder hands the same buffers back frame after frame, so the EGLImage and
+// its external texture are kept and reused as long as the buffer layout matches.
+struct stOglDmabufImage {
+    stOglDmabufFrame frame;
+    EGLImageKHR      image;
+    GLuint           texture;       // GL_TEXTURE_EXTERNAL_OES
+    unsigned long    lastUsed;
+};
+
+// Textures and colour conversion of a video texture, stored under the sprite's texture ID.  Frames are uploaded
+// into a ring of texture sets (VIDEO_UPLOAD_BUFFERS) through pixel buffer objects, and the renderer draws the set
+// written last.  Set 0, plane 0 is the sprite's texture ID itself.  DMA buffer video textures use the same entry:
+// the imported image to draw, and plane textures allocated only if a frame has to be uploaded instead.
+struct stOglVideoPlanes {
+    GLuint         planeTex[OGL_VIDEO_MAX_UPLOAD_SETS][OGL_VIDEO_MAX_PLANES];  // RGBA or Y, then U and V (I420) or UV (NV12)
+    GLuint         uploadPbo[OGL_VIDEO_MAX_UPLOAD_SETS];                       // 0 uploads straight from client memory
+    GLsizeiptr     uploadPboSize[OGL_VIDEO_MAX_UPLOAD_SETS];
+    unsigned int   setCount;        // texture sets allocated
+    unsigned int   currentSet;      // set the renderer draws
+    oglVideoFormat format;
+    unsigned int   width;
+    unsigned int   height;
+    bool           bt709;           // BT.709 matrix, otherwise BT.601
+    bool           fullRange;       // 0-255 levels, otherwise 16-235 video levels
+    bool           dmabuf;          // created as OGL_VIDEO_DMABUF
+    bool           planesAllocated; // luma / chroma storage exists (always true unless dmabuf)
+    GLuint         externalTex;     // imported frame to draw, 0 to draw the planes
+    unsigned long  importCount;     // frames imported, doubles as the LRU clock of dmabufImages
+    std::vector<stOglDmabufImage> dmabufImages;
+};
+
+// One sprite in an instanced sprite batch.  Positions are NDC, the transform is applied in the vertex shader
+// exactly as oglRenderQuad does on the CPU (scale / rotate around the center or the first corner).
+struct stOglSpriteInstance {
+    float x1, y1, x2, y2;           // Unrotated quad corners
+    float u1, v1, u2, v2;
+    float red, green, blue, alpha;  // Vertex colour
+    float scale;
+    float rotateRadians;
+    float pivotCenter;              // 1.0 = rotate around the quad center, 0.0 = around (x1, y1)
+    float texAlpha;                 // Used in place of the texture alpha when the batch sets useTexAlpha
+};
+
 // Define a class for the OGL ES code
 class PBOGLES {
 
@@ -52,21 +150,61 @@ public:
     unsigned int oglGetScreenHeight();
     unsigned int oglGetScreenWidth();
 
+    // GL call statistics for the last completed frame (driver calls issued / redundant calls skipped by the state cache)
+    unsigned int oglGetGLCallsLastFrame() { return m_glCallsLastFrame; }
+    unsigned int oglGetGLCallsSkippedLastFrame() { return m_glSkippedLastFrame; }
+    unsigned int oglGetGLCallsThisFrame() { return m_glCallCount; }
+
+    // Video frame uploads in the last completed frame: frames, bytes, and CPU time spent in the upload calls
+    unsigned int  oglGetVideoUploadsLastFrame() { return m_videoUploadsLastFrame; }
+    unsigned long oglGetVideoUploadBytesLastFrame() { return m_videoUploadBytesLastFrame; }
+    unsigned int  oglGetVideoUploadMicrosLastFrame() { return m_videoUploadMicrosLastFrame; }
+
 protected:
     bool   oglUnloadTexture(GLuint textureId);
     GLuint oglLoadTexture(const char* filename, oglTexType type, unsigned int* width, unsigned int* height);
     GLuint oglLoadBMPTexture (const char* filename, unsigned int* width, unsigned int* height);
     GLuint oglLoadPNGTexture (const char* filename, unsigned int* width, unsigned int* height);
-    GLuint oglCreateVideoTexture(unsigned int width, unsigned int height);
+
+    // Split texture loading: decode (file read + image decode, thread safe) and upload (render thread only)
+    static bool oglDecodeTexture(const char* filename, oglTexType type, stOglImageData* image);
+    static void oglFreeImageData(stOglImageData* image);
+    GLuint oglUploadTexture(const stOglImageData* image);
+    GLuint oglCreateVideoTexture(unsigned int width, unsigned int height, oglVideoFormat format = OGL_VIDEO_RGBA);
     bool   oglUpdateTexture(GLuint textureId, const uint8_t* data, unsigned int width, unsigned int height);
+
+    // Planar video textures - created by oglLoadTexture(OGL_VIDEO) from a "WxH:i420" or "WxH:nv12" name.
+    // Planes are uploaded straight from the decoder (strides in bytes) and drawn through the YUV shader.
+    bool   oglVideoPlanesAvailable() { return (m_videoProgram != 0); }
+    bool   oglUpdateVideoPlanes(GLuint textureId, const uint8_t* const planes[3], const int strides[3],
+                                unsigned int width, unsigned int height, bool bt709, bool fullRange);
+    unsigned long oglGetVideoTextureBytes(GLuint textureId);  // all planes and upload sets, 0 if not a video texture
+
+    // DMA buffer video textures - created from a "WxH:dmabuf" name when oglDmabufImportAvailable().  A frame is
+    // wrapped in an EGLImage and sampled directly; if the import fails the caller uploads planes instead.
+    bool   oglDmabufImportAvailable() { return (m_dmabufImportAvailable); }
+    bool   oglUpdateVideoDmabuf(GLuint textureId, const stOglDmabufFrame& frame);
     void   oglRenderQuad (float* X1, float* Y1, float* X2, float* Y2, float U1, float V1, float U2, float V2, 
                           bool useCenter, bool useTexAlpha, float texAlpha, unsigned int textureId, 
                           float vertRed, float vertGreen, float vertBlue, float vertAlpha, 
                           float scale, float rotateDegrees, bool returnBoundingBox);
     void   scaleAndRotateVertices(float* x, float* y, float scale, float rotateDegrees);
+
+    // Instanced sprite path - every instance shares the texture, one draw call per batch
+    bool   oglSpriteInstancingAvailable() { return (m_spriteInstProgram != 0); }
+    void   oglRenderQuadInstances(const stOglSpriteInstance* instances, unsigned int count, bool useTexAlpha, unsigned int textureId);
+
+    // Off-screen render targets (screen sized FBO + RGBA texture) used for retained layers.  Content drawn between
+    // Begin / End is stored with premultiplied alpha, oglCompositeRenderTarget draws it over the current frame.
+    bool   oglCreateRenderTarget(GLuint* framebuffer, GLuint* textureId);
+    void   oglDestroyRenderTarget(GLuint framebuffer, GLuint textureId);
+    void   oglBeginRenderTarget(GLuint framebuffer);
+    void   oglEndRenderTarget();
+    void   oglCompositeRenderTarget(GLuint textureId);
+    unsigned long oglGetRenderTargetBytes();
     GLuint oglCompileShader(GLenum type, const char* source);
     GLuint oglCreateProgram(const char* vertexSource, const char* fragmentSource);
-    void   oglResetTextureCache() { m_lastTextureId = 0; }  // Call after any external glBindTexture to keep 2D cache valid
+    void   oglResetTextureCache();  // Call after any glBindTexture made outside the state cache
     void   oglRestore2DState();  // Restore full 2D rendering state after 3D pass (shader, attribs, blend, VBO unbind)
 
     // -----------------------------------------------------------------------
@@ -82,6 +220,12 @@ protected:
     bool         ogl3dInitSkinnedShader(const char* vertSrc, const char* fragSrc);
     void         ogl3dDestroySkinnedShader();
 
+    // Instanced static-mesh shader (per-instance model matrix at OGL_3D_INSTANCE_ATTRIB).  Must be created
+    // before any mesh so ogl3dCreateMesh can attach the instance buffer to every static VAO.
+    bool         ogl3dInitInstancedShader(const char* vertSrc, const char* fragSrc);
+    void         ogl3dDestroyInstancedShader();
+    bool         ogl3dInstancingAvailable() { return (m_3dInstProgram != 0); }
+
     // Mesh GPU resource management (interleaved layout: pos3 + norm3 + uv2 = 8 floats/vertex)
     bool         ogl3dCreateMesh(const float* vertData, size_t vertFloatCount,
                                  const unsigned int* idxData, size_t idxCount,
@@ -127,10 +271,30 @@ protected:
     void         ogl3dSetSkinnedInstanceUniforms(const float mvp[16], const float modelMat[16],
                                                  float alpha,
                                                   const float* boneMatrices, int numBones);
+
+    // Bone palette textures - used when the skinned shader reads uBonePalette instead of the uBones[]
+    // uniform array.  RGBA32F, one row per bone, three texels holding the top three matrix rows.
+    bool         ogl3dUsesBonePalette();
+    unsigned int ogl3dCreateBonePalette(int numBones);
+    void         ogl3dUpdateBonePalette(unsigned int paletteTex, const float* packedRows, int numBones);
+    void         ogl3dSetSkinnedPaletteUniforms(const float mvp[16], const float modelMat[16],
+                                                float alpha, unsigned int paletteTex);
     void         ogl3dSetBlend(bool enable);
 
-    // Draw one mesh primitive (VAO + texture already bound by caller)
-    void         ogl3dDrawMeshPrimitive(unsigned int vao, unsigned int textureId, unsigned int indexCount);
+    // Draw one mesh primitive (VAO + texture already bound by caller).  firstIndex selects a range of
+    // the index buffer, e.g. a simplified detail level stored after the full mesh.
+    void         ogl3dDrawMeshPrimitive(unsigned int vao, unsigned int textureId, unsigned int indexCount,
+                                        unsigned int firstIndex = 0);
+
+    // Instanced static-mesh pass: scene uniforms (binds the instanced program), then one draw per
+    // run of identical meshes.  models holds count column-major 4x4 matrices.
+    void         ogl3dSetInstancedSceneUniforms(float lightDirX, float lightDirY, float lightDirZ,
+                                                float lightColR, float lightColG, float lightColB,
+                                                float ambR,      float ambG,      float ambB,
+                                                float eyeX,      float eyeY,      float eyeZ,
+                                                const float viewProj[16]);
+    void         ogl3dDrawMeshInstanced(unsigned int vao, unsigned int textureId, unsigned int indexCount,
+                                        unsigned int firstIndex, const float* models, unsigned int count);
 
 private:
     // 2D shader variables
@@ -147,12 +311,76 @@ private:
     long m_surfaceWidth;
     long m_surfaceHeight;
 #endif
-    unsigned int m_lastTextureId;
     bool m_started;
     bool m_scissorEnabled;          // cached scissor test state — avoids redundant D3D11 rasterizer state churn on ANGLE
     bool m_depthTestEnabled;        // cached GL_DEPTH_TEST state — avoids redundant D3D11 rasterizer state churn on ANGLE
     bool m_cullFaceEnabled;         // cached GL_CULL_FACE state  — avoids redundant D3D11 rasterizer state churn on ANGLE
     bool m_blendEnabled;            // cached GL_BLEND state      — avoids redundant D3D11 rasterizer state churn on ANGLE
+
+    // Shadowed GL state (see oglUseProgram and friends)
+    GLuint m_boundProgram;
+    GLuint m_boundVao;
+    GLuint m_boundArrayBuffer;
+    GLuint m_boundElementBuffer;
+    GLuint m_boundTexture[OGL_MAX_TEXTURE_UNITS];
+    unsigned int m_activeTextureUnit;
+    GLenum m_blendSrc, m_blendDst;
+    GLenum m_blendSrcAlpha, m_blendDstAlpha;
+    GLuint m_boundFramebuffer;
+    GLenum m_depthFunc;
+    bool   m_depthMaskEnabled;
+    int    m_scissorX, m_scissorY, m_scissorW, m_scissorH;
+    bool   m_2dAttribsSet;          // 2D attrib pointers into m_quadVertices are set on VAO 0
+    float  m_cachedTexAlpha, m_cachedUseTexAlpha, m_cachedUseTexture;  // 2D program uniforms (-1 = unknown)
+    float  m_cached3dAlpha, m_cached3dSkAlpha;                          // 3D program alpha uniforms (-1 = unknown)
+
+    // GL call counters (current frame, and the last completed frame)
+    unsigned int m_glCallCount;
+    unsigned int m_glSkippedCount;
+    unsigned int m_glCallsLastFrame;
+    unsigned int m_glSkippedLastFrame;
+
+    // Video upload counters (current frame, and the last completed frame)
+    unsigned int  m_videoUploads, m_videoUploadsLastFrame;
+    unsigned long m_videoUploadBytes, m_videoUploadBytesLastFrame;
+    unsigned int  m_videoUploadMicros, m_videoUploadMicrosLastFrame;
+
+    // Instanced sprite program, static unit quad and streamed per-instance buffer
+    GLuint m_spriteInstProgram;
+    GLuint m_spriteInstVao;
+    GLuint m_spriteInstQuadVbo;
+    GLuint m_spriteInstEbo;
+    GLuint m_spriteInstVbo;
+    unsigned int m_spriteInstCapacity;      // Instances the streamed buffer can hold without reallocating
+    GLint  m_spriteInstUseTexture;
+    GLint  m_spriteInstUseTexAlpha;
+    float  m_cachedInstUseTexture, m_cachedInstUseTexAlpha;
+
+    // YUV video program (same vertex shader and attribute locations as the 2D program) and the chroma
+    // planes of every planar video texture, keyed by luma texture ID
+    GLuint m_videoProgram;
+    GLint  m_videoTexAlpha;
+    GLint  m_videoUseTexAlpha;
+    GLint  m_videoInterleavedUV;
+    GLint  m_videoYuvMatrix;
+    GLint  m_videoYuvOffset;
+    GLuint m_videoUniformTexture;           // Luma texture the colour conversion uniforms were last set for
+    float  m_cachedVideoTexAlpha, m_cachedVideoUseTexAlpha;
+    std::map<GLuint, stOglVideoPlanes> m_videoPlaneList;
+
+    // DMA buffer import (EGL_EXT_image_dma_buf_import + GL_OES_EGL_image_external), resolved at init
+    bool   m_dmabufImportAvailable;
+    bool   m_dmabufModifiersAvailable;      // EGL_EXT_image_dma_buf_import_modifiers
+    PFNEGLCREATEIMAGEKHRPROC       m_eglCreateImage;
+    PFNEGLDESTROYIMAGEKHRPROC      m_eglDestroyImage;
+    oglEGLImageTargetTexture2DProc m_glEGLImageTargetTexture2D;
+    GLuint m_externalVideoProgram;
+    GLint  m_externalTexAlpha;
+    GLint  m_externalUseTexAlpha;
+    float  m_cachedExternalTexAlpha, m_cachedExternalUseTexAlpha;
+
+    // CPU vertex storage for the 2D quad.  A fixed address means the attrib pointers only need setting once.
+    GLfloat m_quadVertices[4 * 9];
     float m_quadRed, m_quadGreen, m_quadBlue, m_quadAlpha;
     
     // OGLES Context variables
@@ -168,6 +396,36 @@ private:
 
     void   oglCreateShaders();
     void   oglCleanup();
+    bool   oglInitSpriteInstancing();
+    bool   oglInitVideoShader();
+    bool   oglInitDmabufImport();
+    bool   oglAllocVideoPlanes(GLuint lumaTexture, stOglVideoPlanes& planes);
+    void   oglDeleteVideoPlanes(stOglVideoPlanes& planes);
+    bool   oglUploadVideoFrame(stOglVideoPlanes& video, const uint8_t* const planes[3], const int strides[3]);
+    void   oglReleaseDmabufImages(stOglVideoPlanes& planes);
+    void   oglUseVideoProgram(GLuint textureId, const stOglVideoPlanes& planes, bool useTexAlpha, float texAlpha);
+    void   oglUseExternalVideoProgram(const stOglVideoPlanes& planes, bool useTexAlpha, float texAlpha);
+
+    // GL state cache - state changes go through these so redundant driver calls are skipped.
+    // Anything that deletes a GL object must also call the matching forget function.
+    void   oglUseProgram(GLuint program);
+    void   oglBindVertexArray(GLuint vao);
+    void   oglBindBuffer(GLenum target, GLuint buffer);
+    void   oglBindTexture(unsigned int unit, GLuint textureId);
+    void   oglBindTextureForUpload(unsigned int unit, GLuint textureId);
+    void   oglBindExternalTexture(GLuint textureId);
+    void   oglSetCapability(GLenum cap, bool enable);
+    void   oglBlendFunc(GLenum srcFactor, GLenum dstFactor);
+    void   oglBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+    void   oglBindFramebuffer(GLuint framebuffer);
+    void   oglDepthMask(bool enable);
+    void   oglDepthFunc(GLenum func);
+    void   oglSetUniform1f(GLint location, float value, float* cachedValue);
+    void   oglSet2DAttribPointers();
+    void   oglForgetTexture(GLuint textureId);
+    void   oglForgetVertexArray(GLuint vao);
+    void   oglForgetBuffer(GLuint buffer);
+    void   oglForgetProgram(GLuint program);
 
     // 3D shader program and cached uniform / attribute locations
     GLuint m_3dShaderProgram;
@@ -180,9 +438,17 @@ private:
     GLint  m_3dSk_MVPUniform,    m_3dSk_ModelUniform,   m_3dSk_LightDirUniform;
     GLint  m_3dSk_LightColUniform, m_3dSk_AmbientUniform, m_3dSk_CameraEyeUniform, m_3dSk_AlphaUniform;
     GLint  m_3dSk_BonesUniform;
+    GLint  m_3dSk_PaletteUniform;
     GLint  m_3dSk_PosAttrib,     m_3dSk_NormalAttrib,   m_3dSk_TexCoordAttrib;
     GLint  m_3dSk_JointsAttrib,  m_3dSk_WeightsAttrib;
 
+    // Instanced static-mesh program and the streamed model matrix buffer shared by every static VAO
+    GLuint m_3dInstProgram;
+    GLint  m_3dInst_ViewProjUniform, m_3dInst_LightDirUniform, m_3dInst_LightColUniform;
+    GLint  m_3dInst_AmbientUniform,  m_3dInst_CameraEyeUniform;
+    GLuint m_3dInstVbo;
+    unsigned int m_3dInstCapacity;          // Model matrices the streamed buffer can hold without reallocating
+
     // Shaders used for sprite rendering.  All sprites are quads, with textures and an overall alpha control value
     // Vertex shader source code
     const char* vertexShaderSource = R"(
@@ -213,6 +479,88 @@ private:
             gl_FragColor = texColor * fColor;
         }
     )";
+
+    // YUV video fragment shader.  uTexU holds interleaved UV for NV12, the matrix and offset are picked for
+    // BT.601 / BT.709 and the video or full level range in oglUseVideoProgram.
+    const char* videoFragmentShaderSource = R"(
+        precision mediump float;
+        varying vec4 fColor;
+        varying vec2 fTexCoord;
+        uniform sampler2D uTexY;
+        uniform sampler2D uTexU;
+        uniform sampler2D uTexV;
+        uniform bool uInterleavedUV;
+        uniform mat3 uYuvMatrix;
+        uniform vec3 uYuvOffset;
+        uniform float uTexAlpha;
+        uniform bool useTexAlpha;
+        void main() {
+            vec3 yuv;
+            yuv.x = texture2D(uTexY, fTexCoord).r;
+            yuv.yz = uInterleavedUV ? texture2D(uTexU, fTexCoord).rg
+                                    : vec2(texture2D(uTexU, fTexCoord).r, texture2D(uTexV, fTexCoord).r);
+            vec3 rgb = clamp(uYuvMatrix * (yuv - uYuvOffset), 0.0, 1.0);
+            gl_FragColor = vec4(rgb, useTexAlpha ? uTexAlpha : 1.0) * fColor;
+        }
+    )";
+
+    // Imported DMA buffer frames.  The driver samples the YUV buffer and converts it to RGB itself, using the
+    // colour space and range hints the image was created with.
+    const char* externalVideoFragmentShaderSource = R"(
+        #extension GL_OES_EGL_image_external : require
+        precision mediump float;
+        varying vec4 fColor;
+        varying vec2 fTexCoord;
+        uniform samplerExternalOES uTexture;
+        uniform float uTexAlpha;
+        uniform bool useTexAlpha;
+        void main() {
+            vec3 rgb = texture2D(uTexture, fTexCoord).rgb;
+            gl_FragColor = vec4(rgb, useTexAlpha ? uTexAlpha : 1.0) * fColor;
+        }
+    )";
+
+    // Instanced sprite shaders.  aCorner is the unit quad corner (0,0 = x1,y1 / 1,1 = x2,y2); the per-instance
+    // attributes match stOglSpriteInstance.  Scale and rotation are done in aspect-corrected space so quads stay square.
+    const char* spriteInstVertexShaderSource = R"(#version 300 es
+        in vec2 aCorner;
+        in vec4 iRect;
+        in vec4 iUV;
+        in vec4 iColor;
+        in vec4 iXform;
+        uniform float uAspect;
+        out vec4 fColor;
+        out vec2 fTexCoord;
+        out float fTexAlpha;
+        void main() {
+            vec2 pos = mix(iRect.xy, iRect.zw, aCorner);
+            vec2 pivot = (iXform.z > 0.5) ? (iRect.xy + iRect.zw) * 0.5 : iRect.xy;
+            vec2 local = (pos - pivot) * vec2(1.0, uAspect) * iXform.x;
+            float c = cos(iXform.y);
+            float s = sin(iXform.y);
+            local = vec2(local.x * c - local.y * s, local.x * s + local.y * c);
+            gl_Position = vec4(pivot + local * vec2(1.0, 1.0 / uAspect), 0.0, 1.0);
+            fColor = iColor;
+            fTexCoord = vec2(mix(iUV.x, iUV.z, aCorner.x), mix(iUV.w, iUV.y, aCorner.y));
+            fTexAlpha = iXform.w;
+        }
+    )";
+
+    const char* spriteInstFragmentShaderSource = R"(#version 300 es
+        precision mediump float;
+        in vec4 fColor;
+        in vec2 fTexCoord;
+        in float fTexAlpha;
+        uniform sampler2D uTexture;
+        uniform bool useTexture;
+        uniform bool useTexAlpha;
+        out vec4 fragColor;
+        void main() {
+            vec4 texColor = useTexture ? texture(uTexture, fTexCoord) : vec4(1.0);
+            texColor.a = useTexAlpha ? fTexAlpha : texColor.a;
+            fragColor = texColor * fColor;
+        }
+    )";
 };
 
 #endif // PBOGLES_h
@@ -4,28 +4,28 @@
 
 #include "PBSound.h"
 #include "PBVideo.h"
-
-#if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
-PBSound* PBSound::instance = nullptr;
-#endif
+#include "PBSoundMath.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
 
 PBSound::PBSound() : initialized(false), masterVolume(100), musicVolume(100), videoVolume(100) {
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
-    currentMusic = nullptr;
-    for (int i = 0; i < 4; i++) {
-        effectSlots[i] = nullptr;
-        effectChannels[i] = -1;
-        effectActive[i] = false;
-        effectLoop[i] = false;
-        effectFilePath[i] = "";
-    }
-    // Initialize video audio streaming system with double-buffering
-    videoAudioChunk = nullptr;
-    videoAudioChunkPending = nullptr;
-    pendingChunkReady = false;
+    musicGain = 1.0f;
+    musicStreaming = false;
+    for (int i = 0; i < EFFECT_VOICES; i++) {
+        releaseVoice(i);
+    }
+    nextEffectId = 1;
+    effectStartCount = 0;
+    soundBankDecoded = 0;
+    soundBankAbort = false;
+    // Initialize video audio streaming system
+    videoSilenceChunk = nullptr;
+    videoSilenceBuffer = nullptr;
+    videoGain = 1.0f;
     videoAudioStreaming = false;
     videoProvider = nullptr;
-    instance = this;  // Set singleton for callback
 #endif
 }
 
@@ -53,14 +53,29 @@ bool PBSound::pbsInitialize() {
         return false;
     }
     
-    // Allocate 5 mixing channels: 4 for effects, 1 reserved for video audio
-    Mix_AllocateChannels(5);
+    // One mixing channel per effect voice, plus one reserved for video audio
+    Mix_AllocateChannels(EFFECT_VOICES + 1);
     
-    // Register channel finished callback for continuous audio streaming
-    Mix_ChannelFinished(channelFinishedCallback);
+    // Music and video audio are written into the mix as 16-bit stereo, so only set them up if the device opened that way
+    int frequency = 0;
+    Uint16 format = 0;
+    int channels = 0;
+    if (Mix_QuerySpec(&frequency, &format, &channels) && format == AUDIO_S16SYS && channels == 2) {
+        // Music streams through the hook in the same format
+        if (music.pbmInitialize(frequency)) {
+            Mix_HookMusic(musicHook, this);
+            musicStreaming = true;
+        }
+        
+        Uint32 silenceBytes = 4096 * 2 * sizeof(Sint16);
+        videoSilenceBuffer = (Uint8*)SDL_calloc(1, silenceBytes);
+        if (videoSilenceBuffer) {
+            videoSilenceChunk = Mix_QuickLoad_RAW(videoSilenceBuffer, silenceBytes);
+        }
+    }
     
     // Set initial volumes
-    Mix_VolumeMusic(convertVolumeToSDL(musicVolume));
+    musicGain = (float)musicVolume / 100.0f;
     Mix_Volume(-1, convertVolumeToSDL(masterVolume));
     
     initialized = true;
@@ -77,18 +92,29 @@ void PBSound::pbsShutdown() {
         return;
     }
     
-    // Stop and free music
-    if (currentMusic) {
-        Mix_HaltMusic();
-        Mix_FreeMusic(currentMusic);
-        currentMusic = nullptr;
+    // The bank thread may still be decoding - stop it before its chunks are freed
+    stopSoundBankThread();
+    
+    // Stop music - unhooking takes the mixer lock, so the hook is not running once it returns
+    if (musicStreaming) {
+        Mix_HookMusic(nullptr, nullptr);
+        musicStreaming = false;
     }
+    music.pbmShutdown();
     
     // Stop all effects and free chunks
     pbsStopAllEffects();
     
     // Stop video audio
     pbsStopVideoAudio();
+    if (videoSilenceChunk) {
+        Mix_FreeChunk(videoSilenceChunk);  // does not own the buffer
+        videoSilenceChunk = nullptr;
+    }
+    if (videoSilenceBuffer) {
+        SDL_free(videoSilenceBuffer);
+        videoSilenceBuffer = nullptr;
+    }
     
     // Free cached effects
     for (auto& pair : loadedEffects) {
@@ -96,6 +122,17 @@ void PBSound::pbsShutdown() {
     }
     loadedEffects.clear();
     
+    // Free the sound bank (only entries below soundBankDecoded were ever filled)
+    int decoded = soundBankDecoded;
+    for (int i = 0; i < decoded; i++) {
+        if (soundBank[i].chunk) {
+            Mix_FreeChunk(soundBank[i].chunk);
+        }
+    }
+    soundBank.clear();
+    soundBankIndex.clear();
+    soundBankDecoded = 0;
+    
     // Close SDL_mixer and SDL
     Mix_CloseAudio();
     SDL_Quit();
@@ -104,64 +141,106 @@ void PBSound::pbsShutdown() {
 #endif
 }
 
-bool PBSound::pbsPlayMusic(const std::string& mp3FilePath) {
+bool PBSound::pbsPlayMusic(const std::string& mp3FilePath, int crossfadeMs) {
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
-    if (!initialized) {
+    if (!initialized || !musicStreaming) {
         return false;
     }
     
-    // Stop current music if playing
-    if (currentMusic) {
-        Mix_HaltMusic();
-        Mix_FreeMusic(currentMusic);
-        currentMusic = nullptr;
-    }
-    
-    // Load new music
-    currentMusic = Mix_LoadMUS(mp3FilePath.c_str());
-    if (!currentMusic) {
+    // A paused track stays paused, the new one starts playing
+    music.pbmSetPaused(false);
+    return music.pbmPlay(mp3FilePath, crossfadeMs, true);
+#else
+    // Windows stub
+    return false;
+#endif
+}
+
+bool PBSound::pbsQueueMusic(const std::string& mp3FilePath, bool loop) {
+#if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
+    if (!initialized || !musicStreaming) {
         return false;
     }
     
-    // Play music with infinite loops (-1)
-    if (Mix_PlayMusic(currentMusic, -1) == -1) {
-        Mix_FreeMusic(currentMusic);
-        currentMusic = nullptr;
+    return music.pbmQueue(mp3FilePath, loop);
+#else
+    // Windows stub
+    return false;
+#endif
+}
+
+bool PBSound::pbsPrebufferMusic(const std::string& mp3FilePath) {
+#if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
+    if (!initialized || !musicStreaming) {
         return false;
     }
     
-    return true;
+    return music.pbmPrebuffer(mp3FilePath);
 #else
     // Windows stub
     return false;
 #endif
 }
 
-void PBSound::pbsStopMusic() {
+void PBSound::pbsStopMusic(int fadeMs) {
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
-    if (initialized && currentMusic) {
-        Mix_HaltMusic();
+    if (initialized && musicStreaming) {
+        music.pbmStop(fadeMs);
     }
 #endif
 }
 
 void PBSound::pbsPauseMusic() {
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
-    if (initialized && currentMusic && Mix_PlayingMusic()) {
-        Mix_PauseMusic();
+    if (initialized && musicStreaming && music.pbmIsPlaying()) {
+        music.pbmSetPaused(true);
     }
 #endif
 }
 
 void PBSound::pbsResumeMusic() {
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
-    if (initialized && currentMusic && Mix_PausedMusic()) {
-        Mix_ResumeMusic();
+    if (initialized && musicStreaming && music.pbmIsPaused()) {
+        music.pbmSetPaused(false);
+    }
+#endif
+}
+
+bool PBSound::pbsLoadSoundBank(const stSoundBankEntry* entries, int count) {
+#if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
+    // The bank is loaded once, at boot - its chunks may be playing on any voice afterwards
+    if (!initialized || !entries || count <= 0 || !soundBank.empty()) {
+        return false;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        if (!entries[i].filePath || soundBankIndex.count(entries[i].filePath)) {
+            continue;
+        }
+        soundBankIndex[entries[i].filePath] = (int)soundBank.size();
+        soundBank.push_back({ entries[i].filePath, entries[i].priority, nullptr });
     }
+    
+    soundBankDecoded = 0;
+    soundBankAbort = false;
+    soundBankThread = std::thread(&PBSound::decodeSoundBank, this);
+    return true;
+#else
+    // Windows stub
+    return false;
 #endif
 }
 
-int PBSound::pbsPlayEffect(const std::string& mp3FilePath, bool loop) {
+bool PBSound::pbsIsSoundBankReady() {
+#if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
+    return soundBankDecoded.load(std::memory_order_acquire) == (int)soundBank.size();
+#else
+    // Windows stub
+    return false;
+#endif
+}
+
+int PBSound::pbsPlayEffect(const std::string& mp3FilePath, bool loop, int priority) {
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
     if (!initialized) {
         return 0;
@@ -170,33 +249,54 @@ int PBSound::pbsPlayEffect(const std::string& mp3FilePath, bool loop) {
     // Update effect status first
     updateEffectStatus();
     
-    // Find a free effect slot
-    int slotIndex = findFreeEffectSlot();
-    if (slotIndex == -1) {
-        return 0; // No free slots
+    // Use the decoded bank chunk for banked effects, otherwise load (and cache) the effect now
+    Mix_Chunk* effect = nullptr;
+    int bankPriority = PBS_PRIORITY_NORMAL;
+    auto bankEntry = soundBankIndex.find(mp3FilePath);
+    if (bankEntry != soundBankIndex.end()) {
+        if (bankEntry->second >= soundBankDecoded.load(std::memory_order_acquire)) {
+            return 0;  // Still pending on the bank thread - drop the hit rather than decode it a second time here
+        }
+        effect = soundBank[bankEntry->second].chunk;
+        if (!effect) {
+            return 0;  // The bank already failed to decode it - don't retry on every hit
+        }
+        bankPriority = soundBank[bankEntry->second].priority;
+    }
+    if (priority < 0) {
+        priority = bankPriority;
     }
-    
-    // Load the effect (use cache if available)
-    Mix_Chunk* effect = loadEffect(mp3FilePath);
     if (!effect) {
-        return 0;
+        effect = loadEffect(mp3FilePath);
+        if (!effect) {
+            return 0;
+        }
+    }
+    
+    // Find a free voice, or steal one
+    int voice = findEffectVoice(priority);
+    if (voice == -1) {
+        return 0; // Every voice is playing something more important
     }
     
-    // Play the effect - use SDL_mixer's loop parameter
+    // Play the effect on the voice's own channel (this cuts off a stolen voice)
     // 0 = play once, -1 = loop infinitely
-    int channel = Mix_PlayChannel(-1, effect, loop ? -1 : 0);
-    if (channel == -1) {
+    releaseVoice(voice);
+    if (Mix_PlayChannel(voice, effect, loop ? -1 : 0) == -1) {
         return 0;
     }
     
     // Store effect information
-    effectSlots[slotIndex] = effect;
-    effectChannels[slotIndex] = channel;
-    effectActive[slotIndex] = true;
-    effectLoop[slotIndex] = loop;
-    effectFilePath[slotIndex] = mp3FilePath;
-    
-    return slotIndex + 1; // Return 1-based effect ID
+    stEffectVoice& v = effectVoices[voice];
+    v.chunk = effect;
+    v.effectId = nextEffectId;
+    v.priority = priority;
+    v.loop = loop;
+    v.startOrder = ++effectStartCount;
+    v.filePath = mp3FilePath;
+    nextEffectId = (nextEffectId == INT_MAX) ? 1 : nextEffectId + 1;
+    
+    return v.effectId;
 #else
     // Windows stub
     return 0;
@@ -205,16 +305,15 @@ int PBSound::pbsPlayEffect(const std::string& mp3FilePath, bool loop) {
 
 bool PBSound::pbsIsEffectPlaying(int effectId) {
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
-    if (!initialized || effectId < 1 || effectId > 4) {
+    if (!initialized || effectId < 1) {
         return false;
     }
     
-    int slotIndex = effectId - 1;
-    
     // Update status first
     updateEffectStatus();
     
-    return effectActive[slotIndex];
+    // A finished or stolen effect no longer owns a voice
+    return findVoiceById(effectId) != -1;
 #else
     // Windows stub
     return false;
@@ -223,19 +322,14 @@ bool PBSound::pbsIsEffectPlaying(int effectId) {
 
 void PBSound::pbsStopEffect(int effectId) {
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
-    if (!initialized || effectId < 1 || effectId > 4) {
+    if (!initialized || effectId < 1) {
         return;
     }
     
-    int slotIndex = effectId - 1;
-    
-    if (effectActive[slotIndex] && effectChannels[slotIndex] != -1) {
-        Mix_HaltChannel(effectChannels[slotIndex]);
-        effectActive[slotIndex] = false;
-        effectChannels[slotIndex] = -1;
-        effectSlots[slotIndex] = nullptr;
-        effectLoop[slotIndex] = false;
-        effectFilePath[slotIndex] = "";
+    int voice = findVoiceById(effectId);
+    if (voice != -1) {
+        Mix_HaltChannel(voice);
+        releaseVoice(voice);
     }
 #endif
 }
@@ -246,16 +340,13 @@ void PBSound::pbsStopAllEffects() {
         return;
     }
     
-    // Halt all channels
+    // Halt all channels (this includes video audio, halting removes its effect)
     Mix_HaltChannel(-1);
+    videoAudioStreaming = false;
     
-    // Reset all effect slots
-    for (int i = 0; i < 4; i++) {
-        effectSlots[i] = nullptr;
-        effectChannels[i] = -1;
-        effectActive[i] = false;
-        effectLoop[i] = false;
-        effectFilePath[i] = "";
+    // Free all voices
+    for (int i = 0; i < EFFECT_VOICES; i++) {
+        releaseVoice(i);
     }
 #endif
 }
@@ -282,9 +373,8 @@ void PBSound::pbsSetMusicVolume(int volume) {
     musicVolume = volume;
     
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
-    if (initialized) {
-        Mix_VolumeMusic(convertVolumeToSDL(musicVolume));
-    }
+    // Applied by the music hook during conversion
+    musicGain = (float)musicVolume / 100.0f;
 #endif
 }
 
@@ -296,49 +386,61 @@ void PBSound::pbsSetVideoVolume(int volume) {
     videoVolume = volume;
     
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
-    if (initialized) {
-        Mix_Volume(VIDEO_AUDIO_CHANNEL, convertVolumeToSDL(videoVolume));
-    }
+    // Applied by the video channel's effect during conversion, so the channel itself stays at the master volume
+    videoGain = (float)videoVolume / 100.0f;
 #endif
 }
 
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
-int PBSound::findFreeEffectSlot() {
-    for (int i = 0; i < 4; i++) {
-        if (!effectActive[i]) {
+int PBSound::findEffectVoice(int priority) {
+    // A free voice first, otherwise steal the lowest priority (then oldest) voice that is not more
+    // important than the new effect.  Critical effects are never stolen.
+    int best = -1;
+    for (int i = 0; i < EFFECT_VOICES; i++) {
+        const stEffectVoice& v = effectVoices[i];
+        if (v.effectId == 0) {
             return i;
         }
+        if (v.priority > priority || v.priority >= PBS_PRIORITY_CRITICAL) {
+            continue;
+        }
+        if (best == -1 || v.priority < effectVoices[best].priority ||
+            (v.priority == effectVoices[best].priority && v.startOrder < effectVoices[best].startOrder)) {
+            best = i;
+        }
     }
-    return -1; // No free slots
+    return best;
+}
+
+int PBSound::findVoiceById(int effectId) {
+    for (int i = 0; i < EFFECT_VOICES; i++) {
+        if (effectVoices[i].effectId == effectId) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void PBSound::releaseVoice(int voice) {
+    stEffectVoice& v = effectVoices[voice];
+    v.chunk = nullptr;
+    v.effectId = 0;
+    v.priority = PBS_PRIORITY_LOW;
+    v.loop = false;
+    v.startOrder = 0;
+    v.filePath.clear();
 }
 
 void PBSound::updateEffectStatus() {
-    for (int i = 0; i < 4; i++) {
-        if (effectActive[i] && effectChannels[i] != -1) {
-            // Check if channel is still playing
-            if (!Mix_Playing(effectChannels[i])) {
-                // Check if this effect should loop
-                if (effectLoop[i] && !effectFilePath[i].empty()) {
-                    // Restart the looping effect
-                    Mix_Chunk* effect = loadEffect(effectFilePath[i]);
-                    if (effect) {
-                        int channel = Mix_PlayChannel(-1, effect, 0);
-                        if (channel != -1) {
-                            // Update channel info but keep loop settings
-                            effectSlots[i] = effect;
-                            effectChannels[i] = channel;
-                            // effectActive, effectLoop, and effectFilePath remain unchanged
-                            continue; // Skip the cleanup below
-                        }
-                    }
-                }
-                // Effect finished and not looping (or loop restart failed)
-                effectActive[i] = false;
-                effectChannels[i] = -1;
-                effectSlots[i] = nullptr;
-                effectLoop[i] = false;
-                effectFilePath[i] = "";
+    for (int i = 0; i < EFFECT_VOICES; i++) {
+        stEffectVoice& v = effectVoices[i];
+        if (v.effectId != 0 && !Mix_Playing(i)) {
+            // Restart a looping effect on its own voice, keeping its ID
+            if (v.loop && v.chunk && Mix_PlayChannel(i, v.chunk, -1) != -1) {
+                continue;
             }
+            // Effect finished and not looping (or loop restart failed)
+            releaseVoice(i);
         }
     }
 }
@@ -351,7 +453,11 @@ Mix_Chunk* PBSound::loadEffect(const std::string& filePath) {
     }
     
     // Load new effect
-    Mix_Chunk* effect = Mix_LoadWAV(filePath.c_str());
+    Mix_Chunk* effect = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mixerLoadMutex);
+        effect = Mix_LoadWAV(filePath.c_str());
+    }
     if (effect) {
         // Add to cache
         loadedEffects[filePath] = effect;
@@ -360,45 +466,77 @@ Mix_Chunk* PBSound::loadEffect(const std::string& filePath) {
     return effect;
 }
 
+// Sound bank decode thread.  Mix_LoadWAV decodes the whole file and converts it to the format the mixer
+// was opened with, so a banked effect plays with no work left on the first hit.
+void PBSound::decodeSoundBank() {
+    for (size_t i = 0; i < soundBank.size() && !soundBankAbort; i++) {
+        Mix_Chunk* chunk = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mixerLoadMutex);
+            chunk = Mix_LoadWAV(soundBank[i].filePath.c_str());
+        }
+        soundBank[i].chunk = chunk;
+        soundBankDecoded.store((int)i + 1, std::memory_order_release);
+    }
+}
+
+void PBSound::stopSoundBankThread() {
+    if (soundBankThread.joinable()) {
+        soundBankAbort = true;
+        soundBankThread.join();
+    }
+}
+
 int PBSound::convertVolumeToSDL(int percentage) {
     // Convert 0-100% to SDL's 0-128 range
     return (percentage * MIX_MAX_VOLUME) / 100;
 }
 
-Mix_Chunk* PBSound::createAudioChunkFromSamples(const float* audioSamples, int numSamples, int sampleRate) {
-    if (!audioSamples || numSamples <= 0) {
-        return nullptr;
-    }
-    
-    // numSamples is total samples (already accounts for stereo channels)
-    // For stereo: numSamples = frames * 2
-    // Each sample converts to Sint16, so buffer size = numSamples * sizeof(Sint16)
-    int bufferSize = numSamples * sizeof(Sint16);
-    Sint16* buffer = (Sint16*)SDL_malloc(bufferSize);
-    if (!buffer) {
-        return nullptr;
+// Runs on the mixer thread for every mix buffer while the video channel plays.  'stream' holds the
+// silent chunk's samples; replace them with the video's audio, leaving silence where the ring runs short
+void PBSound::videoAudioEffect(int channel, void* stream, int length, void* userData) {
+    (void)channel;
+    PBSound* sound = (PBSound*)userData;
+    Sint16* output = (Sint16*)stream;
+    int framesLeft = length / (2 * (int)sizeof(Sint16));
+    float samples[VIDEO_AUDIO_BLOCK * 2];
+    float gain = sound->videoGain.load(std::memory_order_relaxed);
+    
+    while (framesLeft > 0 && sound->videoProvider) {
+        int framesWanted = std::min(framesLeft, VIDEO_AUDIO_BLOCK);
+        int framesRead = sound->videoProvider->pbvGetAudioSamples(samples, framesWanted);
+        
+        // Apply the video volume, saturate and convert float to Sint16 in one pass
+        pbsMathFloatToS16(samples, output, framesRead * 2, gain);
+        output += framesRead * 2;
+        framesLeft -= framesRead;
+        
+        if (framesRead < framesWanted) {
+            break;  // ring ran dry (underrun or end of stream) - the rest stays silent
+        }
     }
     
-    for (int i = 0; i < numSamples; i++) {
-        // Clamp and convert float [-1.0, 1.0] to Sint16 [-32768, 32767]
-        float sample = audioSamples[i];
-        if (sample > 1.0f) sample = 1.0f;
-        if (sample < -1.0f) sample = -1.0f;
-        buffer[i] = (Sint16)(sample * 32767.0f);
+    if (framesLeft > 0) {
+        memset(output, 0, framesLeft * 2 * sizeof(Sint16));
     }
-    
-    // Create Mix_Chunk from buffer
-    Mix_Chunk* chunk = (Mix_Chunk*)SDL_calloc(1, sizeof(Mix_Chunk));
-    if (!chunk) {
-        SDL_free(buffer);
-        return nullptr;
+}
+
+// Runs on the mixer thread for every mix buffer, before the channels are mixed in.  Fills 'stream' with the
+// streamed music at the music volume (silence when nothing is playing)
+void PBSound::musicHook(void* userData, Uint8* stream, int length) {
+    PBSound* sound = (PBSound*)userData;
+    Sint16* output = (Sint16*)stream;
+    int framesLeft = length / (2 * (int)sizeof(Sint16));
+    float samples[MUSIC_BLOCK * 2];
+    float gain = sound->musicGain.load(std::memory_order_relaxed);
+    
+    while (framesLeft > 0) {
+        int frames = std::min(framesLeft, MUSIC_BLOCK);
+        sound->music.pbmMix(samples, frames);
+        pbsMathFloatToS16(samples, output, frames * 2, gain);
+        output += frames * 2;
+        framesLeft -= frames;
     }
-    chunk->allocated = 1;
-    chunk->abuf = (Uint8*)buffer;
-    chunk->alen = bufferSize;
-    chunk->volume = MIX_MAX_VOLUME;
-    
-    return chunk;
 }
 #endif
 
@@ -406,50 +544,35 @@ Mix_Chunk* PBSound::createAudioChunkFromSamples(const float* audioSamples, int n
 
 void PBSound::pbsSetVideoAudioProvider(PBVideo* provider) {
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
+    // The mixer thread reads videoProvider, so it only changes while the stream is stopped
+    if (provider != videoProvider && videoAudioStreaming) {
+        pbsStopVideoAudio();
+    }
     videoProvider = provider;
 #endif
 }
 
 bool PBSound::pbsStartVideoAudioStream() {
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
-    if (!initialized || !videoProvider) {
+    if (!initialized || !videoProvider || !videoSilenceChunk) {
         return false;
     }
+    if (videoAudioStreaming) {
+        return true;
+    }
     
-    videoAudioStreaming = true;
-    pendingChunkReady = false;
-    
-    // Use larger chunk size for smoother streaming
-    // 4096 sample frames (stereo pairs) = ~93ms at 44.1kHz
-    // This reduces callback frequency and the chance of buffer underruns that cause pops/clicks
-    const int STREAM_CHUNK_SIZE = 4096;  // Sample frames (stereo pairs)
-    float audioSamples[STREAM_CHUNK_SIZE * 2];  // stereo (L+R for each frame)
-    
-    int samplesRead = videoProvider->pbvGetAudioSamples(audioSamples, STREAM_CHUNK_SIZE);
-    if (samplesRead > 0) {
-        // samplesRead is mono count, but we need total stereo samples for createAudioChunkFromSamples
-        videoAudioChunk = createAudioChunkFromSamples(audioSamples, samplesRead * 2, 44100);
-        if (videoAudioChunk) {
-            int result = Mix_PlayChannel(VIDEO_AUDIO_CHANNEL, videoAudioChunk, 0);
-            if (result == -1) {
-                // Failed to play - clean up
-                if (videoAudioChunk->abuf) {
-                    delete[] (Sint16*)videoAudioChunk->abuf;
-                }
-                delete videoAudioChunk;
-                videoAudioChunk = nullptr;
-                videoAudioStreaming = false;
-                return false;
-            }
-            // Pre-buffer the next chunk immediately to ensure seamless playback
-            preparePendingAudioChunk();
-            return true;
-        }
+    // Loop silence forever on the video channel and let the effect pull the video's samples into it.
+    // The video pre-fills its audio ring before playback starts, so the first mix buffer is already full
+    if (Mix_PlayChannel(VIDEO_AUDIO_CHANNEL, videoSilenceChunk, -1) == -1) {
+        return false;
+    }
+    if (!Mix_RegisterEffect(VIDEO_AUDIO_CHANNEL, videoAudioEffect, nullptr, this)) {
+        Mix_HaltChannel(VIDEO_AUDIO_CHANNEL);
+        return false;
     }
     
-    // No audio available
-    videoAudioStreaming = false;
-    return false;
+    videoAudioStreaming = true;
+    return true;
 #else
     return false;
 #endif
@@ -457,47 +580,24 @@ bool PBSound::pbsStartVideoAudioStream() {
 
 void PBSound::pbsStopVideoAudio() {
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
-    if (!initialized) {
+    if (!initialized || !videoAudioStreaming) {
         return;
     }
     
-    videoAudioStreaming = false;
-    pendingChunkReady = false;
-    
-    // Stop channel 4
+    // Unregistering takes the mixer lock, so the effect is not running (and will not run) once it returns
+    Mix_UnregisterEffect(VIDEO_AUDIO_CHANNEL, videoAudioEffect);
     Mix_HaltChannel(VIDEO_AUDIO_CHANNEL);
-    
-    // Clean up current chunk
-    if (videoAudioChunk) {
-        if (videoAudioChunk->abuf) {
-            delete[] (Sint16*)videoAudioChunk->abuf;
-        }
-        delete videoAudioChunk;
-        videoAudioChunk = nullptr;
-    }
-    
-    // Clean up pending chunk if any
-    if (videoAudioChunkPending) {
-        if (videoAudioChunkPending->abuf) {
-            delete[] (Sint16*)videoAudioChunkPending->abuf;
-        }
-        delete videoAudioChunkPending;
-        videoAudioChunkPending = nullptr;
-    }
+    videoAudioStreaming = false;
 #endif
 }
 
 void PBSound::pbsRestartVideoAudioStream() {
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
-    // Stop current stream and restart
-    pbsStopVideoAudio();
-    
-    // Small delay to ensure channel is fully stopped and hardware buffer clears
-    // Increased from 5ms to 10ms for more reliable cleanup
-    SDL_Delay(10);
-    
-    // Restart streaming
-    pbsStartVideoAudioStream();
+    // The stream carries on across a video loop - PBVideo drops the previous pass's audio tail from its
+    // ring itself - so only start it if it is not running
+    if (!videoAudioStreaming) {
+        pbsStartVideoAudioStream();
+    }
 #endif
 }
 
@@ -512,103 +612,3 @@ bool PBSound::pbsIsVideoAudioPlaying() {
     return false;
 #endif
 }
-
-// Static callback function - called by SDL_mixer when a channel finishes
-#if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
-void PBSound::channelFinishedCallback(int channel) {
-    if (instance) {
-        instance->handleChannelFinished(channel);
-    }
-}
-
-void PBSound::handleChannelFinished(int channel) {
-    // Only handle our video audio channel
-    if (channel != VIDEO_AUDIO_CHANNEL || !videoAudioStreaming || !videoProvider) {
-        return;
-    }
-    
-    // Clean up previous chunk
-    if (videoAudioChunk) {
-        if (videoAudioChunk->abuf) {
-            delete[] (Sint16*)videoAudioChunk->abuf;
-        }
-        delete videoAudioChunk;
-        videoAudioChunk = nullptr;
-    }
-    
-    // Double-buffering: Use pre-prepared pending chunk if available (reduces latency)
-    // This eliminates the delay of creating chunks during the callback
-    if (pendingChunkReady && videoAudioChunkPending) {
-        videoAudioChunk = videoAudioChunkPending;
-        videoAudioChunkPending = nullptr;
-        pendingChunkReady = false;
-        
-        int result = Mix_PlayChannel(VIDEO_AUDIO_CHANNEL, videoAudioChunk, 0);
-        if (result == -1) {
-            // Failed to play - clean up and stop streaming
-            if (videoAudioChunk->abuf) {
-                delete[] (Sint16*)videoAudioChunk->abuf;
-            }
-            delete videoAudioChunk;
-            videoAudioChunk = nullptr;
-            videoAudioStreaming = false;
-            return;
-        }
-        
-        // Immediately prepare the next chunk for seamless playback
-        preparePendingAudioChunk();
-        return;
-    }
-    
-    // Fallback: Pull next audio chunk from video provider directly
-    // 4096 sample frames (stereo pairs) = ~93ms at 44.1kHz
-    // Larger chunks reduce callback frequency and minimize underrun risk
-    const int STREAM_CHUNK_SIZE = 4096;  // Sample frames (stereo pairs)
-    float audioSamples[STREAM_CHUNK_SIZE * 2];  // stereo (L+R for each frame)
-    
-    int samplesRead = videoProvider->pbvGetAudioSamples(audioSamples, STREAM_CHUNK_SIZE);
-    if (samplesRead > 0) {
-        // samplesRead is mono count, but we need total stereo samples for createAudioChunkFromSamples
-        videoAudioChunk = createAudioChunkFromSamples(audioSamples, samplesRead * 2, 44100);
-        if (videoAudioChunk) {
-            int result = Mix_PlayChannel(VIDEO_AUDIO_CHANNEL, videoAudioChunk, 0);
-            if (result == -1) {
-                // Failed to play - clean up and stop streaming
-                if (videoAudioChunk->abuf) {
-                    delete[] (Sint16*)videoAudioChunk->abuf;
-                }
-                delete videoAudioChunk;
-                videoAudioChunk = nullptr;
-                videoAudioStreaming = false;
-            } else {
-                // Successfully started playing, prepare next chunk
-                preparePendingAudioChunk();
-            }
-        } else {
-            videoAudioStreaming = false;
-        }
-    } else {
-        // No more audio available, stop streaming
-        videoAudioStreaming = false;
-    }
-}
-
-void PBSound::preparePendingAudioChunk() {
-    // Pre-buffer the next audio chunk to eliminate delay during callback
-    // This double-buffering technique prevents gaps between chunks that cause pops
-    if (!videoProvider || !videoAudioStreaming || pendingChunkReady) {
-        return;
-    }
-    
-    const int STREAM_CHUNK_SIZE = 4096;  // Sample frames (stereo pairs)
-    float audioSamples[STREAM_CHUNK_SIZE * 2];  // stereo (L+R for each frame)
-    
-    int samplesRead = videoProvider->pbvGetAudioSamples(audioSamples, STREAM_CHUNK_SIZE);
-    if (samplesRead > 0) {
-        videoAudioChunkPending = createAudioChunkFromSamples(audioSamples, samplesRead * 2, 44100);
-        if (videoAudioChunkPending) {
-            pendingChunkReady = true;
-        }
-    }
-}
-#endif
@@ -21,9 +21,26 @@ To use PBSound on Raspberry Pi, you need to install SDL2 and SDL_mixer:
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_mixer.h>
+#include "PBMusic.h"
 #include <map>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
 #endif
 
+// Effect priorities - a new effect may take over (steal) a voice playing an effect of equal or lower priority
+#define PBS_PRIORITY_LOW 0
+#define PBS_PRIORITY_NORMAL 1
+#define PBS_PRIORITY_HIGH 2
+#define PBS_PRIORITY_CRITICAL 3   // never stolen, even by another critical effect
+
+// One sound bank manifest entry: an effect decoded at boot and its voice priority
+struct stSoundBankEntry {
+    const char* filePath;
+    int priority;
+};
+
 class PBSound {
 public:
     PBSound();
@@ -35,11 +52,18 @@ public:
     // Cleanup and shutdown
     void pbsShutdown();
     
-    // Play background music (looping)
-    bool pbsPlayMusic(const std::string& mp3FilePath);
+    // Play background music (looping).  The file is opened and decoded on a background thread, so this
+    // returns at once; with crossfadeMs > 0 the current track fades out as the new one fades in.
+    bool pbsPlayMusic(const std::string& mp3FilePath, int crossfadeMs = 0);
+    
+    // Start a track with no gap when the current one ends (the current track stops looping)
+    bool pbsQueueMusic(const std::string& mp3FilePath, bool loop = true);
     
-    // Stop current music
-    void pbsStopMusic();
+    // Open and buffer a track ahead of time, so pbsPlayMusic / pbsQueueMusic start it without waiting
+    bool pbsPrebufferMusic(const std::string& mp3FilePath);
+    
+    // Stop current music (fadeMs > 0 fades it out)
+    void pbsStopMusic(int fadeMs = 0);
     
     // Pause current music
     void pbsPauseMusic();
@@ -47,8 +71,15 @@ public:
     // Resume paused music
     void pbsResumeMusic();
     
-    // Play sound effect (returns effect ID 1-4, or 0 on failure)
-    int pbsPlayEffect(const std::string& mp3FilePath, bool loop = false);
+    // Decode every effect in the manifest into the mixer's native format on a background thread.
+    // A banked effect played before the thread reaches it is dropped (returns 0); effects not in the
+    // bank still load on first play, as before.
+    bool pbsLoadSoundBank(const stSoundBankEntry* entries, int count);
+    bool pbsIsSoundBankReady();
+    
+    // Play sound effect (returns an effect ID, or 0 on failure).  When all voices are busy the
+    // lowest priority, oldest voice is stolen.  Priority defaults to the bank entry's (or normal).
+    int pbsPlayEffect(const std::string& mp3FilePath, bool loop = false, int priority = -1);
     
     // Check if effect is still playing (true = still playing, false = completed/not found)
     bool pbsIsEffectPlaying(int effectId);
@@ -59,10 +90,10 @@ public:
     // Stop all effects
     void pbsStopAllEffects();
     
-    // Video audio streaming functions (Raspberry Pi only, channel 4 reserved for video)
+    // Video audio streaming functions (Raspberry Pi only, the channel after the effect voices is reserved for video)
     bool pbsStartVideoAudioStream();  // Initialize the streaming system
     void pbsStopVideoAudio();
-    void pbsRestartVideoAudioStream();  // Restart stream (for looping video)
+    void pbsRestartVideoAudioStream();  // Make sure the stream runs after a video loop
     bool pbsIsVideoAudioPlaying();
     void pbsSetVideoAudioProvider(class PBVideo* provider);  // Set the video object for callbacks
     
@@ -87,36 +118,68 @@ private:
     int videoVolume;   // 0-100%
     
 #if defined(EXE_MODE_RASPI) || defined(EXE_MODE_DEBIAN)
-    Mix_Music* currentMusic;
-    Mix_Chunk* effectSlots[4];  // Up to 4 simultaneous effects
-    int effectChannels[4];      // Channel assignments for effects
-    bool effectActive[4];       // Track which effects are active
-    bool effectLoop[4];         // Track which effects should loop
-    std::string effectFilePath[4];  // Track file path for each effect (for restarting loops)
-    std::map<std::string, Mix_Chunk*> loadedEffects;  // Cache for loaded effects
-    
-    // Video audio streaming system (dedicated channel 4)
-    static const int VIDEO_AUDIO_CHANNEL = 4;
-    Mix_Chunk* videoAudioChunk;          // Single chunk for streaming
+    // Streaming music - PBMusic decodes on its own thread and SDL_mixer's music hook mixes it on the mixer
+    // thread, converting to 16-bit with the music volume as gain (the hook bypasses Mix_VolumeMusic)
+    static const int MUSIC_BLOCK = 1024;  // Sample frames mixed per step
+    PBMusic music;
+    std::atomic<float> musicGain;         // musicVolume as 0.0-1.0, read by the hook on the mixer thread
+    bool musicStreaming;                  // Hook installed (the mixer opened as 16-bit stereo)
+    
+    // Effect voices - voice i always plays on mixer channel i
+    static const int EFFECT_VOICES = 16;
+    struct stEffectVoice {
+        Mix_Chunk* chunk;
+        int effectId;           // ID handed back to the caller, 0 when the voice is free
+        int priority;
+        bool loop;
+        unsigned long startOrder;  // Age, for stealing the oldest of equal priority
+        std::string filePath;   // For restarting loops
+    };
+    stEffectVoice effectVoices[EFFECT_VOICES];
+    int nextEffectId;
+    unsigned long effectStartCount;
+    std::map<std::string, Mix_Chunk*> loadedEffects;  // Cache for effects loaded on first play
+    
+    // Sound bank - the entries and the path lookup are fixed before the decode thread starts.  The thread
+    // fills the chunks in order and publishes how many are done through soundBankDecoded.
+    struct stSoundBankSlot {
+        std::string filePath;
+        int priority;
+        Mix_Chunk* chunk;
+    };
+    std::vector<stSoundBankSlot> soundBank;
+    std::map<std::string, int> soundBankIndex;
+    std::atomic<int> soundBankDecoded;
+    std::atomic<bool> soundBankAbort;
+    std::thread soundBankThread;
+    std::mutex mixerLoadMutex;   // SDL_mixer's decoders are not thread safe - every Mix_LoadWAV holds this
+    
+    // Video audio streaming system (dedicated channel after the effect voices)
+    // The channel loops a silent chunk and an effect registered on it fills each mix buffer straight from
+    // the video's audio ring on the mixer thread - no chunks are built per block and there is no gap between
+    // them.  The video volume is applied as a gain inside the effect's float->16-bit conversion (one pass,
+    // see PBSoundMath.h); SDL_mixer then applies the channel volume, which follows the master volume.
+    static const int VIDEO_AUDIO_CHANNEL = EFFECT_VOICES;
+    static const int VIDEO_AUDIO_BLOCK = 1024;  // Sample frames pulled from the video per step
+    Mix_Chunk* videoSilenceChunk;        // Looping silence that keeps the channel (and the effect) running
+    Uint8* videoSilenceBuffer;
+    std::atomic<float> videoGain;        // videoVolume as 0.0-1.0, read by the effect on the mixer thread
     bool videoAudioStreaming;            // Is stream active?
-    class PBVideo* videoProvider;        // Reference to video for pulling audio
-    
-    // Double-buffering for smoother audio streaming
-    Mix_Chunk* videoAudioChunkPending;   // Next chunk ready to play (prevents gaps)
-    bool pendingChunkReady;              // Flag indicating pending chunk is prepared
+    class PBVideo* videoProvider;        // Reference to video for pulling audio; only changed while not streaming
     
     // Internal helper methods
-    int findFreeEffectSlot();
+    int findEffectVoice(int priority);
+    int findVoiceById(int effectId);
+    void releaseVoice(int voice);
     void updateEffectStatus();
     Mix_Chunk* loadEffect(const std::string& filePath);
+    void decodeSoundBank();
+    void stopSoundBankThread();
     int convertVolumeToSDL(int percentage);
-    Mix_Chunk* createAudioChunkFromSamples(const float* audioSamples, int numSamples, int sampleRate);
-    void preparePendingAudioChunk();     // Pre-buffer next audio chunk for seamless playback
     
-    // Static callback for SDL_mixer channel finished
-    static void channelFinishedCallback(int channel);
-    static PBSound* instance;  // Singleton for callback access
-    void handleChannelFinished(int channel);
+    // SDL_mixer effect on the video channel and music hook (mixer thread)
+    static void videoAudioEffect(int channel, void* stream, int length, void* userData);
+    static void musicHook(void* userData, Uint8* stream, int length);
 #endif
 };
 
@@ -0,0 +1,83 @@
+// PBSoundMath - sample conversion kernels used by PBSound's mixer-thread audio paths
+// NEON on ARM (Pi), SSE on x86 (Windows / Linux simulator), plain C++ everywhere else.
+// Samples are interleaved float in [-1.0, 1.0]; output is interleaved signed 16-bit.
+// The *Scalar versions are always compiled - they are the reference the SIMD paths are checked against
+// by pbmathtest (src/PButils, run by ctest).
+
+// Copyright (c) 2025 Jeffrey D. Bock, unless otherwise noted. Licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+// The license can be found here: <https://creativecommons.org/licenses/by-nc/4.0/>.
+// Additional details can also be found in the license file in the root of the project.
+
+#ifndef PBSoundMath_h
+#define PBSoundMath_h
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PBS_MATH_NEON
+#define PBS_MATH_ISA "NEON"
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PBS_MATH_SSE
+#define PBS_MATH_ISA "SSE"
+#else
+#define PBS_MATH_ISA "Scalar"
+#endif
+
+// ============================================================================
+// Scalar reference kernels
+// ============================================================================
+
+// out = saturate(in * gain) as 16-bit, rounded to nearest.  'count' is in samples (frames * channels).
+inline void pbsMathFloatToS16Scalar(const float* in, int16_t* out, int count, float gain) {
+    float scale = gain * 32767.0f;
+    for (int i = 0; i < count; i++) {
+        float sample = in[i] * scale;
+        if (sample > 32767.0f) sample = 32767.0f;
+        if (sample < -32767.0f) sample = -32767.0f;
+        out[i] = (int16_t)lrintf(sample);
+    }
+}
+
+// ============================================================================
+// SIMD kernels (fall back to the scalar versions when no SIMD is available)
+// ============================================================================
+
+// Same contract as pbsMathFloatToS16Scalar.  Eight samples per step: gain and scale, clamp, convert and
+// a saturating narrow to 16-bit, with the remainder finished by the scalar kernel.
+inline void pbsMathFloatToS16(const float* in, int16_t* out, int count, float gain) {
+    int i = 0;
+#if defined(PBS_MATH_NEON)
+    float32x4_t g = vdupq_n_f32(gain * 32767.0f);
+    float32x4_t hi = vdupq_n_f32(32767.0f), lo = vdupq_n_f32(-32767.0f);
+    for (; i + 8 <= count; i += 8) {
+        float32x4_t a = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(in + i), g), lo), hi);
+        float32x4_t b = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(in + i + 4), g), lo), hi);
+#if defined(__aarch64__)
+        int32x4_t ia = vcvtnq_s32_f32(a), ib = vcvtnq_s32_f32(b);
+#else
+        // ARMv7 NEON only truncates, so round half away from zero first
+        float32x4_t half = vdupq_n_f32(0.5f);
+        uint32x4_t signMask = vdupq_n_u32(0x80000000u);
+        float32x4_t ha = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(a), signMask), vreinterpretq_u32_f32(half)));
+        float32x4_t hb = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(b), signMask), vreinterpretq_u32_f32(half)));
+        int32x4_t ia = vcvtq_s32_f32(vaddq_f32(a, ha)), ib = vcvtq_s32_f32(vaddq_f32(b, hb));
+#endif
+        vst1q_s16(out + i, vcombine_s16(vqmovn_s32(ia), vqmovn_s32(ib)));
+    }
+#elif defined(PBS_MATH_SSE)
+    __m128 g = _mm_set1_ps(gain * 32767.0f);
+    __m128 hi = _mm_set1_ps(32767.0f), lo = _mm_set1_ps(-32767.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i), g), lo), hi);
+        __m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i + 4), g), lo), hi);
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+        _mm_storeu_si128((__m128i*)(out + i), packed);
+    }
+#endif
+    if (i < count) pbsMathFloatToS16Scalar(in + i, out + i, count - i, gain);
+}
+
+#endif // PBSoundMath_h
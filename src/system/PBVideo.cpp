@@ -8,6 +8,7 @@
 #include <cstring>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
 
 extern "C" {
 #include <libavcodec/avcodec.h>
@@ -18,6 +19,33 @@ extern "C" {
 #include <libavutil/opt.h>
 #include <libavutil/channel_layout.h>
 #include <libavutil/log.h>
+#include <libavutil/buffer.h>
+#include <libavutil/hwcontext.h>
+#include <libavutil/hwcontext_drm.h>
+}
+
+#if ENABLE_VIDEO_DMABUF_TEST && !defined(EXE_MODE_WINDOWS)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/udmabuf.h>
+#endif
+
+// DRM fourccs of the test mode buffers (drm_fourcc.h is not always installed)
+#define PBV_DRM_FORMAT_YUV420 0x32315559u   // 'Y','U','1','2'
+#define PBV_DRM_FORMAT_NV12   0x3231564Eu   // 'N','V','1','2'
+#define PBV_DMABUF_PITCH_ALIGN 256
+
+// V4L2 M2M decoders offer DRM_PRIME (frames left in the decoder's DMA buffers) next to their
+// system memory formats; take it whenever it is on the list
+static AVPixelFormat selectDrmPrimeFormat(AVCodecContext* context, const AVPixelFormat* formats) {
+    for (const AVPixelFormat* format = formats; *format != AV_PIX_FMT_NONE; format++) {
+        if (*format == AV_PIX_FMT_DRM_PRIME) {
+            return *format;
+        }
+    }
+    return avcodec_default_get_format(context, formats);
 }
 
 PBVideo::PBVideo() {
@@ -53,15 +81,46 @@ PBVideo::PBVideo() {
     audioClock = 0.0;
     
     frameBuffer = nullptr;
+    displayFrame = nullptr;
+    retiredFrame = nullptr;
+    dmabufOutput = true;
     frameBufferSize = 0;
     newFrameAvailable = false;
     
     audioBuffer = nullptr;
     audioBufferSize = 0;
-    audioSamplesAvailable = 0;
-    audioAccumulatorIndex = 0;
-    
-    videoInfo = {"", 0, 0, 0.0f, 0.0f, false, false};
+    audioRingWrite = 0;
+    audioRingRead = 0;
+    
+    decodeThreadStop = false;
+    seekRequested = false;
+    seekTargetSec = 0.0f;
+    videoEndOfStream = false;
+    audioEndOfStream = false;
+    loopBoundaryPending = false;
+    audioLoopBoundary = 0;
+    for (int i = 0; i < PBV_FRAME_RING_SIZE; i++) {
+        frameRing[i].pixels = nullptr;
+        frameRing[i].frame = nullptr;
+        frameRing[i].ptsSec = 0.0;
+        frameRing[i].loopStart = false;
+    }
+    frameRingRead = 0;
+    frameRingCount = 0;
+    videoStartSec = 0.0;
+    clockBaseSec = 0.0;
+    dmabufTestPool = nullptr;
+    udmabufDevice = -1;
+    for (int i = 0; i < PBV_PACKET_QUEUE_SIZE; i++) {
+        videoPacketQueue.packets[i] = nullptr;
+        audioPacketQueue.packets[i] = nullptr;
+    }
+    videoPacketQueue.head = videoPacketQueue.count = 0;
+    audioPacketQueue.head = audioPacketQueue.count = 0;
+    convertPool = nullptr;
+    convertPoolBufferSize = 0;
+    
+    videoInfo = {"", 0, 0, 0.0f, 0.0f, false, false, PBV_FRAME_RGBA, false, false};
     decoderConfigInfo = "";
 }
 
@@ -94,7 +153,7 @@ void PBVideo::pbvShutdown() {
     initialized = false;
 }
 
-bool PBVideo::pbvLoadVideo(const std::string& videoFilePath) {
+bool PBVideo::pbvLoadVideo(const std::string& videoFilePath, bool allowPlanar, bool allowDmabuf) {
     if (!initialized) {
         return false;
     }
@@ -114,7 +173,7 @@ bool PBVideo::pbvLoadVideo(const std::string& videoFilePath) {
     }
     
     // Open codecs
-    if (!openCodecs()) {
+    if (!openCodecs(allowPlanar, allowPlanar && allowDmabuf)) {
         pbvUnloadVideo();
         return false;
     }
@@ -128,6 +187,9 @@ bool PBVideo::pbvLoadVideo(const std::string& videoFilePath) {
     if (videoStreamIndex >= 0) {
         AVRational timeBase = formatContext->streams[videoStreamIndex]->time_base;
         videoTimeBase = (double)timeBase.num / (double)timeBase.den;
+        
+        int64_t startTime = formatContext->streams[videoStreamIndex]->start_time;
+        videoStartSec = (startTime != AV_NOPTS_VALUE) ? startTime * videoTimeBase : 0.0;
     }
     
     if (audioStreamIndex >= 0) {
@@ -158,12 +220,37 @@ bool PBVideo::pbvLoadVideo(const std::string& videoFilePath) {
             videoInfo.durationSec = 0.0f;
         }
         
-        // Allocate frame buffer for RGBA conversion
-        frameBufferSize = videoInfo.width * videoInfo.height * 4; // RGBA
-        frameBuffer = new uint8_t[frameBufferSize];
-        memset(frameBuffer, 0, frameBufferSize);
+        if (videoInfo.frameFormat == PBV_FRAME_RGBA) {
+            // Allocate frame buffer for RGBA conversion
+            frameBufferSize = videoInfo.width * videoInfo.height * 4; // RGBA
+            frameBuffer = new uint8_t[frameBufferSize];
+            memset(frameBuffer, 0, frameBufferSize);
+            
+            // Decode-ahead slots; pbvUpdateFrame swaps the due one with frameBuffer
+            for (int i = 0; i < PBV_FRAME_RING_SIZE; i++) {
+                frameRing[i].pixels = new uint8_t[frameBufferSize];
+            }
+        } else {
+            // Planar output keeps references to the decoder's frames, nothing is copied
+            displayFrame = av_frame_alloc();
+            bool framesAllocated = (displayFrame != nullptr);
+            if (videoInfo.frameFormat == PBV_FRAME_DMABUF) {
+                retiredFrame = av_frame_alloc();
+                framesAllocated = framesAllocated && (retiredFrame != nullptr);
+            }
+            for (int i = 0; i < PBV_FRAME_RING_SIZE; i++) {
+                frameRing[i].frame = av_frame_alloc();
+                framesAllocated = framesAllocated && (frameRing[i].frame != nullptr);
+            }
+            if (!framesAllocated) {
+                pbvUnloadVideo();
+                return false;
+            }
+        }
     }
     
+    dmabufOutput = true;
+    
     if (videoInfo.hasAudio) {
         // Allocate audio buffer (estimate 1 second of audio at 48kHz stereo)
         audioBufferSize = 48000 * 2; // stereo
@@ -174,11 +261,23 @@ bool PBVideo::pbvLoadVideo(const std::string& videoFilePath) {
     videoLoaded = true;
     playbackState = PBV_STOPPED;
     
+    // Start demuxing and decoding straight away so the first frames and the audio pre-fill
+    // are usually ready by the time pbvPlay() is called
+    startDecodeThread();
+    
     return true;
 }
 
 void PBVideo::pbvUnloadVideo() {
+    stopDecodeThread();
     pbvStop();
+    resetDecodeState();
+    if (displayFrame) {
+        av_frame_unref(displayFrame);
+    }
+    if (retiredFrame) {
+        av_frame_unref(retiredFrame);
+    }
     
     clearPacketQueues();
     closeCodecs();
@@ -193,7 +292,7 @@ void PBVideo::pbvUnloadVideo() {
     videoLoaded = false;
     videoStreamIndex = -1;
     audioStreamIndex = -1;
-    videoInfo = {"", 0, 0, 0.0f, 0.0f, false, false};
+    videoInfo = {"", 0, 0, 0.0f, 0.0f, false, false, PBV_FRAME_RGBA, false, false};
     videoTimeBase = 0.0;
     audioTimeBase = 0.0;
     masterClock = 0.0;
@@ -214,20 +313,25 @@ bool PBVideo::pbvPlay() {
         // Start from beginning
         startTick = 0; // Will be set on first update
         pauseDuration = 0;
-        lastFrameTimeSec = 0.0f;
+        lastFrameTimeSec = (float)clockBaseSec;
         playbackState = PBV_PLAYING;
         
-        // Pre-fill audio buffer for streaming to work immediately
-        // Fill to 80% capacity to prevent initial popping and provide headroom
-        // for system load variations. Higher fill ensures smooth start.
-        if (videoInfo.hasAudio && audioEnabled) {
-            while (audioAccumulatorIndex < AUDIO_ACCUMULATOR_SIZE * 0.80f) {
-                if (!decodeNextAudioFrame()) {
-                    break;
-                }
+        // Wait for the decode thread's pre-roll so streaming works immediately: the first
+        // frame decoded and audio pre-filled to 80% capacity to prevent initial popping.
+        // Normally already done in the background since pbvLoadVideo()
+        std::unique_lock<std::mutex> lock(decodeMutex);
+        readyCondition.wait(lock, [this]() {
+            if (decodeThreadStop) {
+                return true;
             }
-            audioSamplesAvailable = audioAccumulatorIndex;
-        }
+            if (seekRequested) {
+                return false;
+            }
+            bool videoReady = (frameRingCount > 0 || videoEndOfStream);
+            bool audioReady = (!videoInfo.hasAudio || !audioEnabled || audioEndOfStream ||
+                               audioRingFill() >= AUDIO_RING_SIZE * 0.80f);
+            return videoReady && audioReady;
+        });
     }
     
     return true;
@@ -246,13 +350,12 @@ void PBVideo::pbvStop() {
     pauseTick = 0;
     pauseDuration = 0;
     lastFrameTimeSec = 0.0f;
+    clockBaseSec = 0.0;
     newFrameAvailable = false;
-    audioSamplesAvailable = 0;
-    audioAccumulatorIndex = 0;
     
     // Seek back to beginning if video is loaded
     if (videoLoaded) {
-        seekToFrame(0.0f);
+        requestSeek(0.0f);
     }
 }
 
@@ -266,25 +369,8 @@ bool PBVideo::pbvUpdateFrame(unsigned long currentTick) {
         startTick = currentTick;
     }
     
-    // Fill packet queues if they're getting low
-    if (videoPacketQueue.size() < 5 || audioPacketQueue.size() < 5) {
-        fillPacketQueues();
-    }
-    
-    // Always try to keep audio buffer filled independently of video
-    if (videoInfo.hasAudio && audioEnabled) {
-        // Keep buffer at 80% capacity for smooth streaming without gaps
-        // Higher buffer prevents popping/crackling from underruns during system load
-        while (audioAccumulatorIndex < AUDIO_ACCUMULATOR_SIZE * 0.80f) {
-            if (!decodeNextAudioFrame()) {
-                break; // No more audio frames available
-            }
-        }
-        // Make available samples accessible
-        audioSamplesAvailable = audioAccumulatorIndex;
-    }
-    
-    // Check if we need to decode a new frame
+    // Demuxing, decoding and audio fill all happen on the decode thread; here we only
+    // pick the frame that matches the playback clock
     if (!videoInfo.hasVideo) {
         return false;
     }
@@ -295,40 +381,100 @@ bool PBVideo::pbvUpdateFrame(unsigned long currentTick) {
     // Calculate the time per frame
     float frameTime = 1.0f / videoInfo.fps;
     
-    // Check if it's time for the next frame (small tolerance to prevent frame rushing)
-    if (currentTimeSec >= lastFrameTimeSec + frameTime - 0.001f) { // 1ms tolerance
-        // Decode next video frame
-        bool success = decodeNextVideoFrame();
-        
-        if (success) {
-            lastFrameTimeSec = currentTimeSec;
-            newFrameAvailable = true;
+    std::lock_guard<std::mutex> lock(decodeMutex);
+    
+    // Ring contents are from before a pending seek
+    if (seekRequested) {
+        return false;
+    }
+    
+    // The decode thread has already started the next pass of a looping video.  Cross over
+    // once the last frame of this pass has had its time on screen (1ms tolerance)
+    if (frameRingCount > 0 && frameRing[frameRingRead].loopStart &&
+        currentTimeSec >= lastFrameTimeSec + frameTime - 0.001f) {
+        frameRing[frameRingRead].loopStart = false;
+        discardAudioUntil(audioLoopBoundary);  // tail of the previous pass, for a clean restart
+        loopBoundaryPending = false;
+        startTick = currentTick;
+        pauseDuration = 0;
+        clockBaseSec = 0.0;
+        lastFrameTimeSec = 0.0f;
+        currentTimeSec = 0.0f;
+        justLooped = true;  // Signal that we looped
+    }
+    
+    // Drop frames the clock has already passed, then show the newest one that is due
+    while (frameRingCount > 1 && !frameRing[frameRingRead].loopStart) {
+        const stVideoRingFrame& next = frameRing[(frameRingRead + 1) % PBV_FRAME_RING_SIZE];
+        if (next.loopStart || next.ptsSec > currentTimeSec) {
+            break;
+        }
+        if (frameRing[frameRingRead].frame) {
+            av_frame_unref(frameRing[frameRingRead].frame);  // give the decoder its buffer back now
+        }
+        frameRingRead = (frameRingRead + 1) % PBV_FRAME_RING_SIZE;
+        frameRingCount--;
+    }
+    
+    if (frameRingCount > 0) {
+        stVideoRingFrame& frame = frameRing[frameRingRead];
+        if (!frame.loopStart && frame.ptsSec <= currentTimeSec + 0.001f) {
+            showRingFrame();
             return true;
-        } else {
-            // End of video
-            if (looping) {
-                // Loop back to beginning
-                seekToFrame(0.0f);
-                startTick = currentTick;
-                pauseDuration = 0;
-                lastFrameTimeSec = 0.0f;
-                audioAccumulatorIndex = 0;
-                videoClock = 0.0;
-                audioClock = 0.0;
-                justLooped = true;  // Signal that we looped
-                return pbvUpdateFrame(currentTick);
-            } else {
-                playbackState = PBV_FINISHED;
-                return false;
-            }
         }
+    } else if (videoEndOfStream && !looping && currentTimeSec >= lastFrameTimeSec + frameTime - 0.001f) {
+        // End of video
+        playbackState = PBV_FINISHED;
     }
     
     return false;
 }
 
+bool PBVideo::pbvPrimeFirstFrame(bool waitForDecode) {
+    if (!videoLoaded || !videoInfo.hasVideo || playbackState != PBV_STOPPED) {
+        return false;
+    }
+    
+    std::unique_lock<std::mutex> lock(decodeMutex);
+    if (waitForDecode && decodeThread.joinable()) {
+        readyCondition.wait(lock, [this]() {
+            return decodeThreadStop || (!seekRequested && (frameRingCount > 0 || videoEndOfStream));
+        });
+    }
+    
+    // Ring contents from before a pending seek are not the start of the video
+    if (seekRequested || frameRingCount == 0 || frameRing[frameRingRead].loopStart) {
+        return false;
+    }
+    
+    showRingFrame();
+    return true;
+}
+
+// Hand the frame at the head of the ring to the caller and give the slot our old buffer.
+// Caller holds decodeMutex
+void PBVideo::showRingFrame() {
+    stVideoRingFrame& frame = frameRing[frameRingRead];
+    if (retiredFrame) {
+        // DMA buffers go back to the decoder one frame late, the GPU may still be sampling them
+        av_frame_unref(retiredFrame);
+        std::swap(displayFrame, frame.frame);
+        std::swap(retiredFrame, frame.frame);
+    } else if (displayFrame) {
+        std::swap(displayFrame, frame.frame);
+        av_frame_unref(frame.frame);
+    } else {
+        std::swap(frameBuffer, frame.pixels);
+    }
+    lastFrameTimeSec = (float)frame.ptsSec;
+    frameRingRead = (frameRingRead + 1) % PBV_FRAME_RING_SIZE;
+    frameRingCount--;
+    newFrameAvailable = true;
+    decodeCondition.notify_one();
+}
+
 const uint8_t* PBVideo::pbvGetFrameData(unsigned int* frameWidth, unsigned int* frameHeight) {
-    if (!videoLoaded || !videoInfo.hasVideo || !newFrameAvailable) {
+    if (!videoLoaded || !videoInfo.hasVideo || !newFrameAvailable || !frameBuffer) {
         *frameWidth = 0;
         *frameHeight = 0;
         return nullptr;
@@ -339,32 +485,101 @@ const uint8_t* PBVideo::pbvGetFrameData(unsigned int* frameWidth, unsigned int*
     return frameBuffer;
 }
 
-// Overload for buffer-based retrieval (used by streaming callback)
+bool PBVideo::pbvGetFramePlanes(const uint8_t* planes[3], int strides[3], unsigned int* frameWidth, unsigned int* frameHeight) {
+    if (!videoLoaded || !videoInfo.hasVideo || !newFrameAvailable || !displayFrame || !displayFrame->data[0]) {
+        *frameWidth = 0;
+        *frameHeight = 0;
+        return false;
+    }
+    
+    // Per frame: DMA buffer output hands over copied-back frames here as well
+    int planeCount = 0;
+    if (displayFrame->format == AV_PIX_FMT_NV12) {
+        planeCount = 2;
+    } else if (displayFrame->format == AV_PIX_FMT_YUV420P || displayFrame->format == AV_PIX_FMT_YUVJ420P) {
+        planeCount = 3;
+    } else {
+        *frameWidth = 0;
+        *frameHeight = 0;
+        return false;
+    }
+    
+    for (int i = 0; i < 3; i++) {
+        planes[i] = (i < planeCount) ? displayFrame->data[i] : nullptr;
+        strides[i] = (i < planeCount) ? displayFrame->linesize[i] : 0;
+    }
+    
+    *frameWidth = videoInfo.width;
+    *frameHeight = videoInfo.height;
+    return true;
+}
+
+bool PBVideo::pbvGetFrameDmabuf(stVideoDmabufFrame* frame, unsigned int* frameWidth, unsigned int* frameHeight) {
+    *frameWidth = 0;
+    *frameHeight = 0;
+    if (!videoLoaded || !videoInfo.hasVideo || !newFrameAvailable || !displayFrame ||
+        displayFrame->format != AV_PIX_FMT_DRM_PRIME || !displayFrame->data[0]) {
+        return false;
+    }
+    
+    // Decoders export 4:2:0 as one layer: NV12 (2 planes) or YUV420 (3 planes)
+    const AVDRMFrameDescriptor* descriptor = (const AVDRMFrameDescriptor*)displayFrame->data[0];
+    if (descriptor->nb_layers != 1 || descriptor->layers[0].nb_planes < 1 ||
+        descriptor->layers[0].nb_planes > PBV_DMABUF_MAX_PLANES) {
+        return false;
+    }
+    
+    const AVDRMLayerDescriptor& layer = descriptor->layers[0];
+    frame->fourcc = layer.format;
+    frame->planeCount = layer.nb_planes;
+    frame->modifier = descriptor->objects[layer.planes[0].object_index].format_modifier;
+    for (int i = 0; i < PBV_DMABUF_MAX_PLANES; i++) {
+        if (i < layer.nb_planes) {
+            frame->fd[i] = descriptor->objects[layer.planes[i].object_index].fd;
+            frame->offset[i] = (unsigned int)layer.planes[i].offset;
+            frame->pitch[i] = (unsigned int)layer.planes[i].pitch;
+        } else {
+            frame->fd[i] = -1;
+            frame->offset[i] = 0;
+            frame->pitch[i] = 0;
+        }
+    }
+    
+    *frameWidth = videoInfo.width;
+    *frameHeight = videoInfo.height;
+    return true;
+}
+
+void PBVideo::pbvSetDmabufOutput(bool enabled) {
+    std::lock_guard<std::mutex> lock(decodeMutex);
+    dmabufOutput = enabled;
+}
+
+// Overload for buffer-based retrieval (used by the audio mixer callback).  Lock-free on the ring; see
+// audioRing in PBVideo.h for the flush handshake
 int PBVideo::pbvGetAudioSamples(float* buffer, int requestedSamples) {
-    if (!videoLoaded || !videoInfo.hasAudio || !audioEnabled || audioSamplesAvailable == 0 || !buffer) {
+    if (!videoLoaded || !videoInfo.hasAudio || !audioEnabled || !buffer) {
         return 0;
     }
     
-    int samplesToProvide = std::min(audioSamplesAvailable, requestedSamples * 2); // stereo
-    
-    // Copy samples to provided buffer
-    memcpy(buffer, audioAccumulator, samplesToProvide * sizeof(float));
+    std::unique_lock<std::mutex> flushLock(audioFlushMutex, std::try_to_lock);
+    if (!flushLock.owns_lock()) {
+        return 0;  // a seek is flushing the ring right now
+    }
+    int samplesToProvide = readAudioRing(buffer, requestedSamples * 2); // stereo
+    flushLock.unlock();
     
-    // Shift remaining samples to front of accumulator
-    int remainingSamples = audioAccumulatorIndex - samplesToProvide;
-    if (remainingSamples > 0) {
-        memmove(audioAccumulator, audioAccumulator + samplesToProvide, 
-                remainingSamples * sizeof(float));
+    // Room in the ring again - let the decode thread top it up
+    if (samplesToProvide > 0) {
+        decodeCondition.notify_one();
     }
-    audioAccumulatorIndex = remainingSamples;
-    audioSamplesAvailable = audioAccumulatorIndex;
     
     return samplesToProvide / 2;  // Return mono sample count
 }
 
 // Original version for compatibility
 const float* PBVideo::pbvGetAudioSamples(int* numSamples) {
-    if (!videoLoaded || !videoInfo.hasAudio || !audioEnabled || audioSamplesAvailable == 0) {
+    if (!videoLoaded || !videoInfo.hasAudio || !audioEnabled || !audioBuffer) {
         *numSamples = 0;
         return nullptr;
     }
@@ -383,24 +598,18 @@ const float* PBVideo::pbvGetAudioSamples(int* numSamples) {
         if (targetSamplesPerFrame > 4410) targetSamplesPerFrame = 4410;  // Max ~100ms
     }
     
-    int samplesToProvide = std::min(audioSamplesAvailable, targetSamplesPerFrame);
-    
-    // Copy samples to audio buffer for retrieval
-    for (int i = 0; i < samplesToProvide && i < audioBufferSize; i++) {
-        audioBuffer[i] = audioAccumulator[i];
+    std::unique_lock<std::mutex> flushLock(audioFlushMutex, std::try_to_lock);
+    int samplesToProvide = 0;
+    if (flushLock.owns_lock()) {
+        samplesToProvide = readAudioRing(audioBuffer, std::min(targetSamplesPerFrame, audioBufferSize));
+        flushLock.unlock();
     }
-    
-    // Shift remaining samples to front of accumulator (avoid gaps)
-    int remainingSamples = audioAccumulatorIndex - samplesToProvide;
-    if (remainingSamples > 0) {
-        memmove(audioAccumulator, audioAccumulator + samplesToProvide, 
-                remainingSamples * sizeof(float));
+    if (samplesToProvide > 0) {
+        decodeCondition.notify_one();
     }
-    audioAccumulatorIndex = remainingSamples;
-    audioSamplesAvailable = audioAccumulatorIndex;
     
     *numSamples = samplesToProvide;
-    return audioBuffer;
+    return (samplesToProvide > 0) ? audioBuffer : nullptr;
 }
 
 stVideoInfo PBVideo::pbvGetVideoInfo() const {
@@ -423,18 +632,38 @@ bool PBVideo::pbvIsLoaded() const {
     return videoLoaded;
 }
 
+unsigned long PBVideo::pbvGetMemoryBytes() const {
+    if (!videoLoaded) {
+        return 0;
+    }
+    
+    // Decoded frames: the ring plus the displayed one (and the one held back for the GPU with DMA buffers)
+    unsigned long pixelCount = (unsigned long)videoInfo.width * videoInfo.height;
+    unsigned long frameBytes = (videoInfo.frameFormat == PBV_FRAME_RGBA) ? pixelCount * 4 : pixelCount * 3 / 2;
+    unsigned long frameCount = PBV_FRAME_RING_SIZE + 1 + (retiredFrame ? 1 : 0);
+    
+    unsigned long bytes = frameBytes * frameCount;
+    bytes += (unsigned long)audioBufferSize * sizeof(float);
+    bytes += (unsigned long)convertPoolBufferSize * PBV_FRAME_RING_SIZE;
+    bytes += 2 * PBV_PACKET_QUEUE_SIZE * sizeof(AVPacket*);
+    return bytes;
+}
+
 bool PBVideo::pbvSeekTo(float timeSec) {
     if (!videoLoaded) {
         return false;
     }
     
-    bool wasPlaying = (playbackState == PBV_PLAYING);
-    pbvStop();
-    
-    if (!seekToFrame(timeSec)) {
+    if (timeSec < 0.0f) {
         return false;
     }
     
+    bool wasPlaying = (playbackState == PBV_PLAYING);
+    pbvStop();
+    
+    // Replaces the seek to 0 queued by pbvStop(); the clock restarts from timeSec
+    requestSeek(timeSec);
+    clockBaseSec = timeSec;
     lastFrameTimeSec = timeSec;
     
     if (wasPlaying) {
@@ -451,11 +680,15 @@ void PBVideo::pbvSetPlaybackSpeed(float speed) {
 }
 
 void PBVideo::pbvSetAudioEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(decodeMutex);
     audioEnabled = enabled;
+    decodeCondition.notify_one();
 }
 
 void PBVideo::pbvSetLooping(bool loop) {
+    std::lock_guard<std::mutex> lock(decodeMutex);
     looping = loop;
+    decodeCondition.notify_one();
 }
 
 bool PBVideo::pbvDidJustLoop() {
@@ -493,7 +726,7 @@ bool PBVideo::findStreamInfo() {
     return (videoStreamIndex >= 0); // At minimum we need video
 }
 
-bool PBVideo::openCodecs() {
+bool PBVideo::openCodecs(bool allowPlanar, bool allowDmabuf) {
     // Open video codec
     if (videoStreamIndex >= 0) {
         AVCodecParameters* codecParams = formatContext->streams[videoStreamIndex]->codecpar;
@@ -550,6 +783,7 @@ bool PBVideo::openCodecs() {
             return false;
         }
         
+        bool drmPrimeRequested = false;
 #if defined(EXE_MODE_RASPI) && ENABLE_HW_VIDEO_DECODE
         // Configure hardware decoder specific options
         if (strstr(codec->name, "v4l2m2m") != nullptr) {
@@ -558,7 +792,15 @@ bool PBVideo::openCodecs() {
             // Just configure buffer counts for better performance
             av_opt_set_int(videoCodecContext->priv_data, "num_output_buffers", 16, 0);
             av_opt_set_int(videoCodecContext->priv_data, "num_capture_buffers", 16, 0);
+            
+            // Keep decoded frames in the decoder's DMA buffers for zero-copy import
+            if (allowDmabuf) {
+                videoCodecContext->get_format = selectDrmPrimeFormat;
+                drmPrimeRequested = true;
+            }
         }
+#else
+        (void)allowDmabuf;  // Zero-copy import needs the Pi hardware decoder
 #endif
         
         if (avcodec_open2(videoCodecContext, codec, nullptr) < 0) {
@@ -567,6 +809,7 @@ bool PBVideo::openCodecs() {
             if (strstr(codec->name, "v4l2m2m") != nullptr) {
                 // Clean up failed hardware context
                 avcodec_free_context(&videoCodecContext);
+                drmPrimeRequested = false;
                 
                 // Try software decoder
                 codec = avcodec_find_decoder(codecParams->codec_id);
@@ -596,34 +839,78 @@ bool PBVideo::openCodecs() {
 #endif
         }
         
-        // Allocate video frames
-        videoFrame = av_frame_alloc();
-        videoFrameRGB = av_frame_alloc();
-        
-        if (!videoFrame || !videoFrameRGB) {
-            return false;
+        // 4:2:0 decoder output can go to the GPU as planes, which skips sws_scale and the RGBA copy.
+        // Anything else (and callers without the YUV shader) is converted to RGBA here.
+        // A decoder asked for DRM_PRIME hands over DMA buffers; its frames are dispatched on their format
+        // so any that arrive in system memory still take the planar path.
+        videoInfo.frameFormat = PBV_FRAME_RGBA;
+        if (drmPrimeRequested) {
+            videoInfo.frameFormat = PBV_FRAME_DMABUF;
+        } else if (allowPlanar) {
+            if (videoCodecContext->pix_fmt == AV_PIX_FMT_YUV420P || videoCodecContext->pix_fmt == AV_PIX_FMT_YUVJ420P) {
+                videoInfo.frameFormat = PBV_FRAME_I420;
+            } else if (videoCodecContext->pix_fmt == AV_PIX_FMT_NV12) {
+                videoInfo.frameFormat = PBV_FRAME_NV12;
+            }
         }
         
-        // Allocate buffer for RGB frame
-        int numBytes = av_image_get_buffer_size(AV_PIX_FMT_RGBA, 
-                                                 videoCodecContext->width,
-                                                 videoCodecContext->height, 1);
-        uint8_t* buffer = (uint8_t*)av_malloc(numBytes * sizeof(uint8_t));
-        
-        av_image_fill_arrays(videoFrameRGB->data, videoFrameRGB->linesize, buffer,
-                            AV_PIX_FMT_RGBA, videoCodecContext->width, 
-                            videoCodecContext->height, 1);
+#if ENABLE_VIDEO_DMABUF_TEST && !defined(EXE_MODE_WINDOWS)
+        // Software decoder test mode: planar frames are copied into udmabuf buffers to exercise the import path
+        if (allowDmabuf && videoInfo.frameFormat != PBV_FRAME_RGBA && videoInfo.frameFormat != PBV_FRAME_DMABUF &&
+            openDmabufTestPool()) {
+            videoInfo.frameFormat = PBV_FRAME_DMABUF;
+        }
+#endif
         
-        // Initialize SWS context for color conversion
-        // Use SWS_FAST_BILINEAR for better performance, especially with software decode
-        swsContext = sws_getContext(videoCodecContext->width, videoCodecContext->height,
-                                    videoCodecContext->pix_fmt,
-                                    videoCodecContext->width, videoCodecContext->height,
-                                    AV_PIX_FMT_RGBA, SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+        // Untagged streams follow the usual convention: BT.709 for HD, BT.601 below it
+        if (videoCodecContext->colorspace == AVCOL_SPC_UNSPECIFIED) {
+            videoInfo.bt709 = (videoCodecContext->height >= 720);
+        } else {
+            videoInfo.bt709 = (videoCodecContext->colorspace == AVCOL_SPC_BT709);
+        }
+        videoInfo.fullRange = (videoCodecContext->color_range == AVCOL_RANGE_JPEG ||
+                               videoCodecContext->pix_fmt == AV_PIX_FMT_YUVJ420P);
         
-        if (!swsContext) {
+        // Allocate video frames
+        videoFrame = av_frame_alloc();
+        if (!videoFrame) {
             return false;
         }
+        
+        if (videoInfo.frameFormat == PBV_FRAME_DMABUF) {
+            decoderConfigInfo += dmabufTestPool ? ", udmabuf test frames (DMA buffer import)"
+                                                : ", DRM PRIME frames (DMA buffer import)";
+        } else if (videoInfo.frameFormat != PBV_FRAME_RGBA) {
+            decoderConfigInfo += (videoInfo.frameFormat == PBV_FRAME_NV12) ? ", NV12 planes (GPU colour conversion)"
+                                                                          : ", YUV420 planes (GPU colour conversion)";
+        } else {
+            videoFrameRGB = av_frame_alloc();
+            
+            if (!videoFrameRGB) {
+                return false;
+            }
+            
+            // Allocate buffer for RGB frame
+            int numBytes = av_image_get_buffer_size(AV_PIX_FMT_RGBA, 
+                                                     videoCodecContext->width,
+                                                     videoCodecContext->height, 1);
+            uint8_t* buffer = (uint8_t*)av_malloc(numBytes * sizeof(uint8_t));
+            
+            av_image_fill_arrays(videoFrameRGB->data, videoFrameRGB->linesize, buffer,
+                                AV_PIX_FMT_RGBA, videoCodecContext->width, 
+                                videoCodecContext->height, 1);
+            
+            // Initialize SWS context for color conversion
+            // Use SWS_FAST_BILINEAR for better performance, especially with software decode
+            swsContext = sws_getContext(videoCodecContext->width, videoCodecContext->height,
+                                        videoCodecContext->pix_fmt,
+                                        videoCodecContext->width, videoCodecContext->height,
+                                        AV_PIX_FMT_RGBA, SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+            
+            if (!swsContext) {
+                return false;
+            }
+        }
     }
     
     // Open audio codec
@@ -667,11 +954,15 @@ bool PBVideo::openCodecs() {
         }
     }
     
-    // Allocate packet
+    // Allocate the read packet and the queue slots - the only packets this video will use
     packet = av_packet_alloc();
     if (!packet) {
         return false;
     }
+    if ((videoStreamIndex >= 0 && !allocPacketQueue(videoPacketQueue)) ||
+        (audioStreamIndex >= 0 && !allocPacketQueue(audioPacketQueue))) {
+        return false;
+    }
     
     return true;
 }
@@ -719,6 +1010,16 @@ void PBVideo::closeCodecs() {
         av_packet_free(&packet);
         packet = nullptr;
     }
+    
+    freePacketQueue(videoPacketQueue);
+    freePacketQueue(audioPacketQueue);
+    
+    // Frames still holding pool buffers release them into a freed pool safely
+    if (convertPool) {
+        av_buffer_pool_uninit(&convertPool);
+        convertPool = nullptr;
+        convertPoolBufferSize = 0;
+    }
 }
 
 void PBVideo::freeBuffers() {
@@ -733,26 +1034,87 @@ void PBVideo::freeBuffers() {
         audioBuffer = nullptr;
         audioBufferSize = 0;
     }
+    
+    for (int i = 0; i < PBV_FRAME_RING_SIZE; i++) {
+        if (frameRing[i].pixels) {
+            delete[] frameRing[i].pixels;
+            frameRing[i].pixels = nullptr;
+        }
+        if (frameRing[i].frame) {
+            av_frame_free(&frameRing[i].frame);
+            frameRing[i].frame = nullptr;
+        }
+    }
+    
+    if (displayFrame) {
+        av_frame_free(&displayFrame);
+        displayFrame = nullptr;
+    }
+    
+    if (retiredFrame) {
+        av_frame_free(&retiredFrame);
+        retiredFrame = nullptr;
+    }
+    
+    // Every frame wrapping a test buffer has been released by now
+    closeDmabufTestPool();
+}
+
+bool PBVideo::allocPacketQueue(stPacketQueue& queue) {
+    for (int i = 0; i < PBV_PACKET_QUEUE_SIZE; i++) {
+        if (!queue.packets[i]) {
+            queue.packets[i] = av_packet_alloc();
+            if (!queue.packets[i]) {
+                return false;
+            }
+        }
+    }
+    queue.head = 0;
+    queue.count = 0;
+    return true;
+}
+
+void PBVideo::freePacketQueue(stPacketQueue& queue) {
+    for (int i = 0; i < PBV_PACKET_QUEUE_SIZE; i++) {
+        if (queue.packets[i]) {
+            av_packet_free(&queue.packets[i]);
+            queue.packets[i] = nullptr;
+        }
+    }
+    queue.head = 0;
+    queue.count = 0;
+}
+
+// Move 'packet' into the tail slot.  A full queue belongs to a stream nobody decodes right now, so the
+// oldest packet makes room.
+void PBVideo::pushPacket(stPacketQueue& queue) {
+    if (queue.count == PBV_PACKET_QUEUE_SIZE) {
+        popPacket(queue);
+    }
+    unsigned int tail = (queue.head + queue.count) % PBV_PACKET_QUEUE_SIZE;
+    av_packet_move_ref(queue.packets[tail], packet);
+    queue.count++;
+}
+
+void PBVideo::popPacket(stPacketQueue& queue) {
+    av_packet_unref(queue.packets[queue.head]);
+    queue.head = (queue.head + 1) % PBV_PACKET_QUEUE_SIZE;
+    queue.count--;
 }
 
 void PBVideo::clearPacketQueues() {
-    // Free all packets in video queue
-    while (!videoPacketQueue.empty()) {
-        AVPacket* pkt = videoPacketQueue.front();
-        videoPacketQueue.pop();
-        av_packet_free(&pkt);
+    while (videoPacketQueue.count > 0) {
+        popPacket(videoPacketQueue);
     }
-    
-    // Free all packets in audio queue
-    while (!audioPacketQueue.empty()) {
-        AVPacket* pkt = audioPacketQueue.front();
-        audioPacketQueue.pop();
-        av_packet_free(&pkt);
+    while (audioPacketQueue.count > 0) {
+        popPacket(audioPacketQueue);
     }
+    videoPacketQueue.head = 0;
+    audioPacketQueue.head = 0;
 }
 
 bool PBVideo::fillPacketQueues() {
-    if (!formatContext) {
+    if (!formatContext || !packet) {
         return false;
     }
     
@@ -760,25 +1122,19 @@ bool PBVideo::fillPacketQueues() {
     // Stop after reading 10 packets to avoid blocking too long
     int packetsRead = 0;
     while (packetsRead < 10) {
-        AVPacket* pkt = av_packet_alloc();
-        if (!pkt) {
-            break;
-        }
-        
-        int result = av_read_frame(formatContext, pkt);
+        int result = av_read_frame(formatContext, packet);
         if (result < 0) {
-            av_packet_free(&pkt);
             return false; // End of stream or error
         }
         
         // Route packet to appropriate queue
-        if (pkt->stream_index == videoStreamIndex) {
-            videoPacketQueue.push(pkt);
-        } else if (pkt->stream_index == audioStreamIndex) {
-            audioPacketQueue.push(pkt);
+        if (packet->stream_index == videoStreamIndex) {
+            pushPacket(videoPacketQueue);
+        } else if (packet->stream_index == audioStreamIndex) {
+            pushPacket(audioPacketQueue);
         } else {
             // Unknown stream, discard
-            av_packet_free(&pkt);
+            av_packet_unref(packet);
         }
         
         packetsRead++;
@@ -787,36 +1143,69 @@ bool PBVideo::fillPacketQueues() {
     return true;
 }
 
+// Give 'frame' a buffer from convertPool, recreating the pool when the frame size changes.  The pool
+// allocates until enough buffers circulate between the ring and the display, then only recycles.
+bool PBVideo::allocPooledFrame(AVFrame* frame, int format, int width, int height) {
+    int bufferSize = av_image_get_buffer_size((AVPixelFormat)format, width, height, 32);
+    if (bufferSize <= 0) {
+        return false;
+    }
+    
+    if (!convertPool || convertPoolBufferSize != bufferSize) {
+        if (convertPool) {
+            av_buffer_pool_uninit(&convertPool);  // buffers still in use are freed when released
+        }
+        convertPool = av_buffer_pool_init(bufferSize, nullptr);
+        convertPoolBufferSize = bufferSize;
+        if (!convertPool) {
+            return false;
+        }
+    }
+    
+    frame->buf[0] = av_buffer_pool_get(convertPool);
+    if (!frame->buf[0]) {
+        return false;
+    }
+    frame->format = format;
+    frame->width = width;
+    frame->height = height;
+    if (av_image_fill_arrays(frame->data, frame->linesize, frame->buf[0]->data,
+                             (AVPixelFormat)format, width, height, 32) < 0) {
+        av_frame_unref(frame);
+        return false;
+    }
+    return true;
+}
+
 bool PBVideo::decodeNextVideoFrame() {
     if (!videoCodecContext || videoStreamIndex < 0) {
         return false;
     }
     
-    // Fill queue if empty
-    if (videoPacketQueue.empty()) {
-        fillPacketQueues();
+    // Fill queue if empty (a batch may hold only audio packets, so keep reading until EOF)
+    while (videoPacketQueue.count == 0) {
+        if (!fillPacketQueues()) {
+            break;
+        }
     }
     
     // Try to decode from queued packets
-    while (!videoPacketQueue.empty()) {
-        AVPacket* pkt = videoPacketQueue.front();
-        videoPacketQueue.pop();
+    while (videoPacketQueue.count > 0) {
+        AVPacket* pkt = videoPacketQueue.packets[videoPacketQueue.head];
         
         // Send packet to decoder
-        if (avcodec_send_packet(videoCodecContext, pkt) < 0) {
-            av_packet_free(&pkt);
+        int sendResult = avcodec_send_packet(videoCodecContext, pkt);
+        popPacket(videoPacketQueue);
+        if (sendResult < 0) {
             continue;
         }
         
         // Receive frame from decoder
         int ret = avcodec_receive_frame(videoCodecContext, videoFrame);
-        av_packet_free(&pkt);
         
         if (ret == 0) {
             // Successfully decoded a frame
-            // FUTURE: Update video clock for A/V sync improvements
             videoClock = getVideoClock();
-            convertFrameToRGBA();
             return true;
         }
     }
@@ -830,24 +1219,25 @@ bool PBVideo::decodeNextAudioFrame() {
     }
     
     // Fill queue if empty
-    if (audioPacketQueue.empty()) {
-        fillPacketQueues();
+    while (audioPacketQueue.count == 0) {
+        if (!fillPacketQueues()) {
+            break;
+        }
     }
     
     // Try to decode from queued packets
-    while (!audioPacketQueue.empty()) {
-        AVPacket* pkt = audioPacketQueue.front();
-        audioPacketQueue.pop();
+    while (audioPacketQueue.count > 0) {
+        AVPacket* pkt = audioPacketQueue.packets[audioPacketQueue.head];
         
         // Send packet to decoder
-        if (avcodec_send_packet(audioCodecContext, pkt) < 0) {
-            av_packet_free(&pkt);
+        int sendResult = avcodec_send_packet(audioCodecContext, pkt);
+        popPacket(audioPacketQueue);
+        if (sendResult < 0) {
             continue;
         }
         
         // Receive frame from decoder
         int ret = avcodec_receive_frame(audioCodecContext, audioFrame);
-        av_packet_free(&pkt);
         
         if (ret == 0) {
             // Successfully decoded a frame
@@ -861,8 +1251,8 @@ bool PBVideo::decodeNextAudioFrame() {
     return false; // No more frames available
 }
 
-void PBVideo::convertFrameToRGBA() {
-    if (!videoFrame || !videoFrameRGB || !swsContext || !frameBuffer) {
+void PBVideo::convertFrameToRGBA(uint8_t* destination) {
+    if (!videoFrame || !videoFrameRGB || !swsContext || !destination) {
         return;
     }
     
@@ -870,8 +1260,258 @@ void PBVideo::convertFrameToRGBA() {
     sws_scale(swsContext, videoFrame->data, videoFrame->linesize, 0,
               videoCodecContext->height, videoFrameRGB->data, videoFrameRGB->linesize);
     
-    // Copy to our frame buffer
-    memcpy(frameBuffer, videoFrameRGB->data[0], frameBufferSize);
+    // Copy to the ring slot
+    memcpy(destination, videoFrameRGB->data[0], frameBufferSize);
+}
+
+// Planar output: move the decoded frame into a ring slot by reference, no pixels are copied.  A frame
+// in a different layout than the one picked at load (e.g. a mid-stream format change) is converted to it.
+bool PBVideo::queuePlanarFrame(AVFrame* destination) {
+    if (!videoFrame || !destination) {
+        return false;
+    }
+    
+    av_frame_unref(destination);
+    
+    // DMA buffer output takes either 4:2:0 layout, pbvGetFramePlanes goes by the frame's format
+    AVPixelFormat planarFormat = (videoInfo.frameFormat == PBV_FRAME_NV12) ? AV_PIX_FMT_NV12 : AV_PIX_FMT_YUV420P;
+    bool formatMatches = (videoFrame->format == planarFormat ||
+                          (planarFormat == AV_PIX_FMT_YUV420P && videoFrame->format == AV_PIX_FMT_YUVJ420P) ||
+                          (videoInfo.frameFormat == PBV_FRAME_DMABUF && videoFrame->format == AV_PIX_FMT_NV12));
+    if (formatMatches && videoFrame->width == (int)videoInfo.width && videoFrame->height == (int)videoInfo.height) {
+        av_frame_move_ref(destination, videoFrame);
+        return true;
+    }
+    
+    if (!allocPooledFrame(destination, planarFormat, videoInfo.width, videoInfo.height)) {
+        return false;
+    }
+    
+    swsContext = sws_getCachedContext(swsContext, videoFrame->width, videoFrame->height,
+                                      (AVPixelFormat)videoFrame->format,
+                                      videoInfo.width, videoInfo.height, planarFormat,
+                                      SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+    if (!swsContext) {
+        av_frame_unref(destination);
+        return false;
+    }
+    
+    sws_scale(swsContext, videoFrame->data, videoFrame->linesize, 0, videoFrame->height,
+              destination->data, destination->linesize);
+    return true;
+}
+
+// DMA buffer output: DRM frames are queued by reference while the renderer imports them, otherwise
+// copied back to system memory.  System memory frames go through the test pool when there is one.
+bool PBVideo::queueDmabufFrame(AVFrame* destination, bool exportDmabuf) {
+    if (!videoFrame || !destination) {
+        return false;
+    }
+    
+    av_frame_unref(destination);
+    
+    if (videoFrame->format == AV_PIX_FMT_DRM_PRIME) {
+        if (exportDmabuf) {
+            av_frame_move_ref(destination, videoFrame);
+            return true;
+        }
+        
+        // Copy into a pooled buffer in the frames' own layout; let FFmpeg pick (and allocate) if that fails
+        bool pooled = false;
+        if (videoFrame->hw_frames_ctx) {
+            const AVHWFramesContext* framesContext = (const AVHWFramesContext*)videoFrame->hw_frames_ctx->data;
+            pooled = allocPooledFrame(destination, framesContext->sw_format, videoFrame->width, videoFrame->height);
+        }
+        if (!pooled || av_hwframe_transfer_data(destination, videoFrame, 0) < 0) {
+            av_frame_unref(destination);
+            if (av_hwframe_transfer_data(destination, videoFrame, 0) < 0) {
+                return false;
+            }
+        }
+        if (destination->format == AV_PIX_FMT_NV12 || destination->format == AV_PIX_FMT_YUV420P) {
+            return true;
+        }
+        
+        // Transferred in some other layout: convert it like any other odd frame
+        av_frame_unref(videoFrame);
+        av_frame_move_ref(videoFrame, destination);
+        return queuePlanarFrame(destination);
+    }
+    
+    if (exportDmabuf && dmabufTestPool && queueDmabufTestFrame(destination)) {
+        return true;
+    }
+    return queuePlanarFrame(destination);
+}
+
+bool PBVideo::openDmabufTestPool() {
+#if ENABLE_VIDEO_DMABUF_TEST && !defined(EXE_MODE_WINDOWS)
+    if (dmabufTestPool) {
+        return true;
+    }
+    
+    udmabufDevice = open("/dev/udmabuf", O_RDWR | O_CLOEXEC);
+    if (udmabufDevice < 0) {
+        return false;
+    }
+    
+    // Big enough for either 4:2:0 layout with the pitches queueDmabufTestFrame uses
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t lumaPitch = ((size_t)videoCodecContext->width + PBV_DMABUF_PITCH_ALIGN - 1) & ~(size_t)(PBV_DMABUF_PITCH_ALIGN - 1);
+    size_t chromaHeight = ((size_t)videoCodecContext->height + 1) / 2;
+    size_t bufferSize = lumaPitch * videoCodecContext->height + 2 * lumaPitch * chromaHeight;
+    bufferSize = (bufferSize + pageSize - 1) & ~(pageSize - 1);
+    
+    dmabufTestPool = new stDmabufTestBuffer[PBV_DMABUF_TEST_BUFFERS];
+    bool poolCreated = true;
+    for (int i = 0; i < PBV_DMABUF_TEST_BUFFERS; i++) {
+        stDmabufTestBuffer& buffer = dmabufTestPool[i];
+        buffer.memFd = -1;
+        buffer.dmabufFd = -1;
+        buffer.mapping = nullptr;
+        buffer.size = bufferSize;
+        buffer.descriptor = new AVDRMFrameDescriptor();
+        buffer.inUse = false;
+        if (!poolCreated) {
+            continue;
+        }
+        
+        // udmabuf wants a sealed memfd that cannot shrink under the buffer
+        buffer.memFd = memfd_create("pbvideo", MFD_ALLOW_SEALING | MFD_CLOEXEC);
+        if (buffer.memFd < 0 || ftruncate(buffer.memFd, (off_t)bufferSize) < 0 ||
+            fcntl(buffer.memFd, F_ADD_SEALS, F_SEAL_SHRINK) < 0) {
+            poolCreated = false;
+            continue;
+        }
+        
+        struct udmabuf_create create;
+        memset(&create, 0, sizeof(create));
+        create.memfd = buffer.memFd;
+        create.flags = UDMABUF_FLAGS_CLOEXEC;
+        create.offset = 0;
+        create.size = bufferSize;
+        buffer.dmabufFd = ioctl(udmabufDevice, UDMABUF_CREATE, &create);
+        
+        void* mapping = mmap(nullptr, bufferSize, PROT_READ | PROT_WRITE, MAP_SHARED, buffer.memFd, 0);
+        buffer.mapping = (mapping != MAP_FAILED) ? (uint8_t*)mapping : nullptr;
+        poolCreated = (buffer.dmabufFd >= 0 && buffer.mapping != nullptr);
+    }
+    
+    if (!poolCreated) {
+        closeDmabufTestPool();
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PBVideo::closeDmabufTestPool() {
+#if ENABLE_VIDEO_DMABUF_TEST && !defined(EXE_MODE_WINDOWS)
+    if (dmabufTestPool) {
+        for (int i = 0; i < PBV_DMABUF_TEST_BUFFERS; i++) {
+            stDmabufTestBuffer& buffer = dmabufTestPool[i];
+            if (buffer.mapping) {
+                munmap(buffer.mapping, buffer.size);
+            }
+            if (buffer.dmabufFd >= 0) {
+                close(buffer.dmabufFd);
+            }
+            if (buffer.memFd >= 0) {
+                close(buffer.memFd);
+            }
+            delete (AVDRMFrameDescriptor*)buffer.descriptor;
+        }
+        delete[] dmabufTestPool;
+        dmabufTestPool = nullptr;
+    }
+    
+    if (udmabufDevice >= 0) {
+        close(udmabufDevice);
+        udmabufDevice = -1;
+    }
+#endif
+}
+
+// Copies the decoded 4:2:0 frame into a free test buffer and wraps it as a DRM PRIME frame
+bool PBVideo::queueDmabufTestFrame(AVFrame* destination) {
+    bool nv12 = (videoFrame->format == AV_PIX_FMT_NV12);
+    if (!nv12 && videoFrame->format != AV_PIX_FMT_YUV420P && videoFrame->format != AV_PIX_FMT_YUVJ420P) {
+        return false;
+    }
+    if (videoFrame->width != (int)videoInfo.width || videoFrame->height != (int)videoInfo.height) {
+        return false;
+    }
+    
+    stDmabufTestBuffer* buffer = nullptr;
+    for (int i = 0; i < PBV_DMABUF_TEST_BUFFERS && !buffer; i++) {
+        bool expected = false;
+        if (dmabufTestPool[i].inUse.compare_exchange_strong(expected, true)) {
+            buffer = &dmabufTestPool[i];
+        }
+    }
+    if (!buffer) {
+        return false;
+    }
+    
+    unsigned int width = videoInfo.width;
+    unsigned int height = videoInfo.height;
+    unsigned int chromaWidth = (width + 1) / 2;
+    unsigned int chromaHeight = (height + 1) / 2;
+    unsigned int lumaPitch = (width + PBV_DMABUF_PITCH_ALIGN - 1) & ~(unsigned int)(PBV_DMABUF_PITCH_ALIGN - 1);
+    unsigned int chromaPitch = nv12 ? lumaPitch :
+                               ((chromaWidth + PBV_DMABUF_PITCH_ALIGN - 1) & ~(unsigned int)(PBV_DMABUF_PITCH_ALIGN - 1));
+    
+    AVDRMFrameDescriptor* descriptor = (AVDRMFrameDescriptor*)buffer->descriptor;
+    memset(descriptor, 0, sizeof(AVDRMFrameDescriptor));
+    descriptor->nb_objects = 1;
+    descriptor->objects[0].fd = buffer->dmabufFd;
+    descriptor->objects[0].size = buffer->size;
+    descriptor->objects[0].format_modifier = 0;   // DRM_FORMAT_MOD_LINEAR
+    descriptor->nb_layers = 1;
+    
+    AVDRMLayerDescriptor& layer = descriptor->layers[0];
+    layer.format = nv12 ? PBV_DRM_FORMAT_NV12 : PBV_DRM_FORMAT_YUV420;
+    layer.nb_planes = nv12 ? 2 : 3;
+    
+    size_t planeOffset = 0;
+    for (int plane = 0; plane < layer.nb_planes; plane++) {
+        unsigned int pitch = (plane == 0) ? lumaPitch : chromaPitch;
+        unsigned int rows = (plane == 0) ? height : chromaHeight;
+        unsigned int rowBytes = (plane == 0) ? width : (nv12 ? chromaWidth * 2 : chromaWidth);
+        
+        layer.planes[plane].object_index = 0;
+        layer.planes[plane].offset = (ptrdiff_t)planeOffset;
+        layer.planes[plane].pitch = (ptrdiff_t)pitch;
+        
+        const uint8_t* source = videoFrame->data[plane];
+        uint8_t* target = buffer->mapping + planeOffset;
+        for (unsigned int row = 0; row < rows; row++) {
+            memcpy(target + (size_t)row * pitch, source + (size_t)row * videoFrame->linesize[plane], rowBytes);
+        }
+        planeOffset += (size_t)pitch * rows;
+    }
+    
+    destination->buf[0] = av_buffer_create((uint8_t*)descriptor, sizeof(AVDRMFrameDescriptor),
+                                           releaseDmabufTestBuffer, buffer, AV_BUFFER_FLAG_READONLY);
+    if (!destination->buf[0]) {
+        buffer->inUse = false;
+        return false;
+    }
+    destination->data[0] = (uint8_t*)descriptor;
+    destination->format = AV_PIX_FMT_DRM_PRIME;
+    destination->width = width;
+    destination->height = height;
+    destination->pts = videoFrame->pts;
+    av_frame_unref(videoFrame);
+    return true;
+}
+
+// The last reference to a wrapped test frame is gone (display swap, ring reset or unload)
+void PBVideo::releaseDmabufTestBuffer(void* opaque, uint8_t* data) {
+    (void)data;
+    ((stDmabufTestBuffer*)opaque)->inUse = false;
 }
 
 void PBVideo::convertAudioToFloat() {
@@ -890,23 +1530,28 @@ void PBVideo::convertAudioToFloat() {
                                  (const uint8_t**)audioFrame->data, audioFrame->nb_samples);
     
     if (outSamples > 0) {
-        // Accumulate samples into accumulator buffer
+        // Append to the audio ring; samples that do not fit are dropped
         // outSamples is in frames (each frame = 2 samples for stereo)
         int totalSamples = outSamples * 2; // Convert frames to samples (stereo)
         
-        for (int i = 0; i < totalSamples && audioAccumulatorIndex < AUDIO_ACCUMULATOR_SIZE; i++) {
-            audioAccumulator[audioAccumulatorIndex++] = tempBuffer[i];
-        }
+        unsigned int write = audioRingWrite.load(std::memory_order_relaxed);
+        unsigned int space = AUDIO_RING_SIZE - (write - audioRingRead.load(std::memory_order_acquire));
+        int count = std::min(totalSamples, (int)space);
+        int start = write & (AUDIO_RING_SIZE - 1);
+        int firstPart = std::min(count, AUDIO_RING_SIZE - start);
+        memcpy(audioRing + start, tempBuffer, firstPart * sizeof(float));
+        memcpy(audioRing, tempBuffer + firstPart, (count - firstPart) * sizeof(float));
+        audioRingWrite.store(write + count, std::memory_order_release);
     }
 }
 
 float PBVideo::getCurrentPlaybackTimeSec(unsigned long currentTick) const {
     if (startTick == 0) {
-        return 0.0f;
+        return (float)clockBaseSec;
     }
     
     float elapsedSec = (float)(currentTick - startTick - pauseDuration) / 1000.0f;
-    return elapsedSec * playbackSpeed;
+    return (float)clockBaseSec + elapsedSec * playbackSpeed;
 }
 
 bool PBVideo::seekToFrame(float timeSec) {
@@ -934,13 +1579,214 @@ bool PBVideo::seekToFrame(float timeSec) {
         avcodec_flush_buffers(audioCodecContext);
     }
     
-    // Reset audio accumulator
-    audioAccumulatorIndex = 0;
-    audioSamplesAvailable = 0;
-    
     return true;
 }
 
+// Decode thread
+// One producer per video demuxes and decodes ahead of the display into frameRing and the
+// audio ring.  It blocks when both are full (back-pressure) and is woken when
+// pbvUpdateFrame takes a frame, the audio callback drains samples, or a seek/stop arrives.
+// It is the only thread that touches the FFmpeg contexts while running, so seeks are queued
+// with requestSeek() and loops are handled here.
+
+void PBVideo::startDecodeThread() {
+    if (decodeThread.joinable()) {
+        return;
+    }
+    
+    decodeThreadStop = false;
+    decodeThread = std::thread(&PBVideo::decodeThreadMain, this);
+}
+
+void PBVideo::stopDecodeThread() {
+    if (!decodeThread.joinable()) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(decodeMutex);
+        decodeThreadStop = true;
+        seekRequested = false;
+    }
+    decodeCondition.notify_all();
+    readyCondition.notify_all();
+    decodeThread.join();
+}
+
+void PBVideo::requestSeek(float timeSec) {
+    if (!decodeThread.joinable()) {
+        seekToFrame(timeSec);
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(decodeMutex);
+        seekRequested = true;
+        seekTargetSec = timeSec;
+    }
+    decodeCondition.notify_one();
+}
+
+// Caller holds decodeMutex (or the decode thread is not running)
+void PBVideo::resetDecodeState() {
+    frameRingRead = 0;
+    frameRingCount = 0;
+    for (int i = 0; i < PBV_FRAME_RING_SIZE; i++) {
+        frameRing[i].loopStart = false;
+        if (frameRing[i].frame) {
+            av_frame_unref(frameRing[i].frame);
+        }
+    }
+    discardAudioUntil(audioRingWrite.load(std::memory_order_relaxed));
+    audioLoopBoundary = 0;
+    loopBoundaryPending = false;
+    videoEndOfStream = false;
+    audioEndOfStream = false;
+}
+
+// Samples in the audio ring (producer or consumer side)
+unsigned int PBVideo::audioRingFill() const {
+    return audioRingWrite.load(std::memory_order_acquire) - audioRingRead.load(std::memory_order_acquire);
+}
+
+// Consumer side: copy up to sampleCount samples out of the ring.  Caller holds audioFlushMutex
+int PBVideo::readAudioRing(float* buffer, int sampleCount) {
+    unsigned int read = audioRingRead.load(std::memory_order_relaxed);
+    unsigned int available = audioRingWrite.load(std::memory_order_acquire) - read;
+    int count = std::min(sampleCount, (int)available);
+    if (count <= 0) {
+        return 0;
+    }
+    
+    int start = read & (AUDIO_RING_SIZE - 1);
+    int firstPart = std::min(count, AUDIO_RING_SIZE - start);
+    memcpy(buffer, audioRing + start, firstPart * sizeof(float));
+    memcpy(buffer + firstPart, audioRing, (count - firstPart) * sizeof(float));
+    audioRingRead.store(read + count, std::memory_order_release);
+    return count;
+}
+
+// Drop queued audio up to 'position' (a write position already reached).  Waits for a running
+// audio callback to finish its copy, which takes microseconds
+void PBVideo::discardAudioUntil(unsigned int position) {
+    std::lock_guard<std::mutex> flushLock(audioFlushMutex);
+    unsigned int read = audioRingRead.load(std::memory_order_relaxed);
+    if ((int)(position - read) > 0) {
+        audioRingRead.store(position, std::memory_order_release);
+    }
+}
+
+void PBVideo::decodeThreadMain() {
+    double lastQueuedPtsSec = -1.0;   // keeps ring timestamps increasing when pts is missing
+    bool markLoopStart = false;       // next queued frame is the first of a new loop pass
+    
+    std::unique_lock<std::mutex> lock(decodeMutex);
+    
+    while (!decodeThreadStop) {
+        if (seekRequested) {
+            float targetSec = seekTargetSec;
+            lock.unlock();
+            seekToFrame(targetSec);
+            lock.lock();
+            
+            if (seekTargetSec != targetSec) {
+                continue;  // a newer seek arrived meanwhile
+            }
+            seekRequested = false;
+            resetDecodeState();
+            lastQueuedPtsSec = -1.0;
+            markLoopStart = false;
+            continue;
+        }
+        
+        // Audio is kept at 80% of the ring for smooth streaming without gaps
+        bool audioActive = (videoInfo.hasAudio && audioEnabled);
+        bool exportDmabuf = dmabufOutput;
+        bool wantAudio = (audioActive && !audioEndOfStream &&
+                          audioRingFill() < AUDIO_RING_SIZE * 0.80f);
+        bool wantVideo = (videoInfo.hasVideo && !videoEndOfStream &&
+                          frameRingCount < PBV_FRAME_RING_SIZE);
+        
+        if (!wantAudio && !wantVideo) {
+            // Audio still waiting for room in the ring belongs to this pass too
+            bool passFinished = (videoEndOfStream &&
+                                 (audioEndOfStream || !audioActive || audioPacketQueue.count == 0));
+            if (passFinished && looping && !loopBoundaryPending) {
+                // Start the next pass now so its first frames are ready when the display gets
+                // there.  Audio of this pass stays queued until pbvUpdateFrame crosses over.
+                loopBoundaryPending = true;
+                audioLoopBoundary = audioRingWrite.load(std::memory_order_relaxed);
+                videoEndOfStream = false;
+                audioEndOfStream = false;
+                lock.unlock();
+                seekToFrame(0.0f);
+                lock.lock();
+                lastQueuedPtsSec = -1.0;
+                markLoopStart = true;
+                continue;
+            }
+            
+            // The audio callback frees ring space without taking decodeMutex, so its wake-up can slip in
+            // between the checks above and this wait - poll while audio is still to be decoded
+            if (audioActive && !audioEndOfStream) {
+                decodeCondition.wait_for(lock, std::chrono::milliseconds(PBV_AUDIO_POLL_MS));
+            } else {
+                decodeCondition.wait(lock);
+            }
+            continue;
+        }
+        
+        // The tail slot stays ours while unlocked: the display only reads queued slots
+        unsigned int slot = (frameRingRead + frameRingCount) % PBV_FRAME_RING_SIZE;
+        lock.unlock();
+        
+        // Audio first so the audio ring never runs dry behind a slow video frame
+        bool audioDecoded = (wantAudio && decodeNextAudioFrame());
+        bool videoDecoded = (wantVideo && decodeNextVideoFrame());
+        bool frameReady = videoDecoded;
+        double ptsSec = 0.0;
+        if (videoDecoded) {
+            if (videoInfo.frameFormat == PBV_FRAME_RGBA) {
+                convertFrameToRGBA(frameRing[slot].pixels);
+            } else if (videoInfo.frameFormat == PBV_FRAME_DMABUF) {
+                frameReady = queueDmabufFrame(frameRing[slot].frame, exportDmabuf);
+            } else {
+                frameReady = queuePlanarFrame(frameRing[slot].frame);
+            }
+        }
+        if (frameReady) {
+            ptsSec = videoClock - videoStartSec;
+            if (ptsSec <= lastQueuedPtsSec) {
+                ptsSec = lastQueuedPtsSec + 1.0 / videoInfo.fps;
+            }
+            lastQueuedPtsSec = ptsSec;
+        }
+        
+        lock.lock();
+        
+        if (seekRequested) {
+            continue;  // decoded from the old position, dropped by the seek
+        }
+        
+        if (wantAudio && !audioDecoded) {
+            audioEndOfStream = true;
+        }
+        
+        if (wantVideo) {
+            if (frameReady) {
+                frameRing[slot].ptsSec = ptsSec;
+                frameRing[slot].loopStart = markLoopStart;
+                markLoopStart = false;
+                frameRingCount++;
+            } else if (!videoDecoded) {
+                videoEndOfStream = true;
+            }
+        }
+        
+        readyCondition.notify_all();
+    }
+}
+
 // FUTURE: Synchronization methods for advanced A/V sync
 // These methods implement timestamp-based synchronization for improved
 // audio/video sync with variable frame rate content or complex timing scenarios.
@@ -9,7 +9,10 @@
 #include "PBBuildSwitch.h"
 #include <string>
 #include <cstdint>
-#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 // Forward declarations for FFmpeg structures to avoid including FFmpeg headers in this header
 extern "C" {
@@ -19,8 +22,45 @@ extern "C" {
     struct AVPacket;
     struct SwsContext;
     struct SwrContext;
+    struct AVBufferPool;
+    struct AVBufferRef;
 }
 
+// Decoded frames the decode thread may run ahead of the display clock.  Each slot costs
+// width x height x 4 bytes for RGBA output, or holds one decoder frame (1.5 bytes per pixel) for planar output.
+#define PBV_FRAME_RING_SIZE 4
+
+// DMA buffer frames: planes per frame, and udmabuf buffers in the software test mode (ring, displayed,
+// retired and decoding)
+#define PBV_DMABUF_MAX_PLANES 3
+#define PBV_DMABUF_TEST_BUFFERS (PBV_FRAME_RING_SIZE + 3)
+
+// Demuxed packets each stream queue holds (about 8 seconds at 30 fps).  A stream that is not being
+// decoded (audio disabled) drops its oldest packets once the queue is full.
+#define PBV_PACKET_QUEUE_SIZE 256
+
+// How often the decode thread re-checks the audio ring while it waits (the audio callback does not lock)
+#define PBV_AUDIO_POLL_MS 10
+
+// Pixel layout handed to the renderer.  Planar layouts are the decoder's own YUV 4:2:0 planes,
+// colour converted by the GPU instead of sws_scale.
+enum pbvFrameFormat {
+    PBV_FRAME_RGBA = 0,
+    PBV_FRAME_I420 = 1,    // Y, U, V planes
+    PBV_FRAME_NV12 = 2,    // Y plane, interleaved UV plane
+    PBV_FRAME_DMABUF = 3   // Decoder DMA buffers (DRM PRIME) for zero-copy import, planes as the fallback
+};
+
+// A frame left in DMA buffers by the decoder: DRM fourcc / modifier and per-plane fd, offset and pitch
+struct stVideoDmabufFrame {
+    int fd[PBV_DMABUF_MAX_PLANES];
+    unsigned int offset[PBV_DMABUF_MAX_PLANES];
+    unsigned int pitch[PBV_DMABUF_MAX_PLANES];
+    unsigned int planeCount;
+    uint32_t fourcc;
+    uint64_t modifier;
+};
+
 // Video playback states
 enum pbvPlaybackState {
     PBV_STOPPED = 0,
@@ -38,6 +78,9 @@ struct stVideoInfo {
     float durationSec;
     bool hasAudio;
     bool hasVideo;
+    pbvFrameFormat frameFormat;
+    bool bt709;         // BT.709 colour matrix, otherwise BT.601 (planar formats)
+    bool fullRange;     // 0-255 levels, otherwise 16-235 video levels (planar formats)
 };
 
 class PBVideo {
@@ -52,7 +95,10 @@ public:
     void pbvShutdown();
     
     // Load a video file (prepares for playback but doesn't start)
-    bool pbvLoadVideo(const std::string& videoFilePath);
+    // allowPlanar: deliver 4:2:0 YUV planes (pbvGetFramePlanes) instead of RGBA when the decoder outputs them
+    // allowDmabuf: leave hardware decoded frames in DMA buffers (pbvGetFrameDmabuf) - needs allowPlanar too,
+    // since frames the renderer cannot import are handed over as planes
+    bool pbvLoadVideo(const std::string& videoFilePath, bool allowPlanar = false, bool allowDmabuf = false);
     
     // Unload current video and free resources
     void pbvUnloadVideo();
@@ -67,14 +113,34 @@ public:
     void pbvStop();
     
     // Update video frame based on current time (call this every frame)
-    // Returns true if a new frame was decoded
+    // Picks the newest decoded frame whose timestamp has been reached; decoding runs on a
+    // background thread.  Returns true if a new frame is ready in pbvGetFrameData()
     bool pbvUpdateFrame(unsigned long currentTick);
     
+    // Pre-roll: while stopped, take the first decoded frame as the current frame before the clock starts,
+    // so it can be uploaded ahead of pbvPlay() and is on screen the moment playback begins.
+    // waitForDecode blocks until the decode thread has the frame.  Returns true if a new frame is ready
+    bool pbvPrimeFirstFrame(bool waitForDecode);
+    
     // Get current video frame data (RGBA format for texture upload)
     // Returns pointer to frame buffer or nullptr if no frame available
     // frameWidth and frameHeight will be set to actual frame dimensions
     const uint8_t* pbvGetFrameData(unsigned int* frameWidth, unsigned int* frameHeight);
     
+    // Get current video frame planes (planar frame formats, see stVideoInfo::frameFormat)
+    // planes / strides receive Y, U, V (I420) or Y, UV, nullptr (NV12) straight from the decoder;
+    // they stay valid until the next pbvUpdateFrame().  Returns false if no planar frame is available
+    bool pbvGetFramePlanes(const uint8_t* planes[3], int strides[3], unsigned int* frameWidth, unsigned int* frameHeight);
+    
+    // Get current video frame as DMA buffers (PBV_FRAME_DMABUF)
+    // The buffers stay valid until the next pbvUpdateFrame().  Returns false if the frame is not in DMA buffers
+    // (use pbvGetFramePlanes then)
+    bool pbvGetFrameDmabuf(stVideoDmabufFrame* frame, unsigned int* frameWidth, unsigned int* frameHeight);
+    
+    // Call with false when the renderer cannot import the DMA buffers: the decode thread then copies
+    // frames back to system memory and they are delivered through pbvGetFramePlanes
+    void pbvSetDmabufOutput(bool enabled);
+    
     // Get audio samples for current frame (for integration with PBSound)
     // Returns pointer to audio buffer (stereo float format) and number of samples
     // This is designed to be called once per video frame update
@@ -108,6 +174,9 @@ public:
     std::string pbvGetDecoderInfo() const;  // Returns decoder configuration string
     void pbvPrintDecoderInfo() const;  // Deprecated - kept for compatibility
     
+    // Approximate system memory held by the loaded video: decoded frames, packet queues and audio buffers
+    unsigned long pbvGetMemoryBytes() const;
+    
     // Set looping behavior
     void pbvSetLooping(bool loop);
     bool pbvIsLooping() const { return looping; }
@@ -138,7 +207,7 @@ private:
     bool initialized;
     bool videoLoaded;
     bool looping;
-    bool audioEnabled;
+    std::atomic<bool> audioEnabled;
     float playbackSpeed;
     bool justLooped;  // Flag set when video loops (cleared by pbvDidJustLoop())
     
@@ -158,40 +227,119 @@ private:
     
     // Frame buffers
     uint8_t* frameBuffer;          // RGBA frame data for texture upload
+    AVFrame* displayFrame;         // planar output: decoder frame currently handed to the caller
+    AVFrame* retiredFrame;         // DMA buffer output: previous display frame, the GPU may still be reading it
+    bool dmabufOutput;             // DMA buffer output: hand DRM frames over as-is (false: copy to system memory)
     unsigned int frameBufferSize;
     bool newFrameAvailable;
     
     // Audio buffers
     float* audioBuffer;            // Stereo float audio buffer
     int audioBufferSize;
-    int audioSamplesAvailable;
     
-    // Packet queues for separate video/audio demuxing
-    std::queue<AVPacket*> videoPacketQueue;
-    std::queue<AVPacket*> audioPacketQueue;
+    // Packet queues for separate video/audio demuxing.  The AVPackets are allocated once per video and
+    // reused: av_read_frame fills 'packet', which is moved into the tail slot.
+    struct stPacketQueue {
+        AVPacket* packets[PBV_PACKET_QUEUE_SIZE];
+        unsigned int head;
+        unsigned int count;
+    };
+    stPacketQueue videoPacketQueue;
+    stPacketQueue audioPacketQueue;
+    
+    // Buffers for frames converted on the decode thread (odd pixel formats, DMA buffers copied back),
+    // recycled instead of allocated per frame
+    AVBufferPool* convertPool;
+    int convertPoolBufferSize;
     
-    // Audio accumulation buffer for smooth playback
-    // Increased to ~1.5 seconds at 44.1kHz stereo for better buffer headroom
-    // This prevents underruns during heavy system load or video seeking
-    static const int AUDIO_ACCUMULATOR_SIZE = 132300;
-    float audioAccumulator[AUDIO_ACCUMULATOR_SIZE];
-    int audioAccumulatorIndex;
+    // Decode thread - owns the FFmpeg contexts while it runs.  The fields below and the frame
+    // ring are shared with it and guarded by decodeMutex (the audio ring has its own scheme).
+    std::thread decodeThread;
+    std::mutex decodeMutex;
+    std::condition_variable decodeCondition;   // decode thread: ring slot free, seek, stop
+    std::condition_variable readyCondition;    // pbvPlay: pre-roll finished
+    bool decodeThreadStop;
+    bool seekRequested;
+    float seekTargetSec;
+    bool videoEndOfStream;         // decode thread has queued the last frame of the pass
+    bool audioEndOfStream;
+    bool loopBoundaryPending;      // decode thread looped, display has not caught up yet
+    unsigned int audioLoopBoundary;  // audio ring position where the next pass starts
+    
+    // Ring of decoded frames waiting for their presentation time
+    struct stVideoRingFrame {
+        uint8_t* pixels;           // RGBA, frameBufferSize bytes
+        AVFrame* frame;            // planar output: reference to the decoder's frame
+        double ptsSec;             // presentation time from the start of the stream
+        bool loopStart;            // first frame after the decode thread looped
+    };
+    stVideoRingFrame frameRing[PBV_FRAME_RING_SIZE];
+    unsigned int frameRingRead;
+    unsigned int frameRingCount;   // the decode thread writes the slot after the last one
+    double videoStartSec;          // stream start_time, subtracted from every pts
+    double clockBaseSec;           // playback clock value at startTick (non-zero after a seek)
+    
+    // Software decoder test mode for the DMA buffer path (ENABLE_VIDEO_DMABUF_TEST): decoded frames are
+    // copied into udmabuf buffers and wrapped as DRM PRIME frames, released when the last frame ref goes
+    struct stDmabufTestBuffer {
+        int memFd;
+        int dmabufFd;
+        uint8_t* mapping;
+        size_t size;
+        void* descriptor;          // AVDRMFrameDescriptor, the wrapped frame's data[0]
+        std::atomic<bool> inUse;
+    };
+    stDmabufTestBuffer* dmabufTestPool;
+    int udmabufDevice;
+    
+    // Decoded audio (stereo float, 44.1kHz) in a single-producer / single-consumer ring of about 1.5 seconds.
+    // The decode thread writes, the audio callback reads; neither takes decodeMutex.  Positions count samples
+    // since the video was loaded and wrap around naturally, the ring index is position & (AUDIO_RING_SIZE - 1).
+    // Seeks and loop crossovers move the read position while holding audioFlushMutex; the audio callback
+    // only try-locks it and returns no samples for that call if it is busy, so it never blocks.
+    static const int AUDIO_RING_SIZE = 131072;
+    float audioRing[AUDIO_RING_SIZE];
+    std::atomic<unsigned int> audioRingWrite;
+    std::atomic<unsigned int> audioRingRead;
+    std::mutex audioFlushMutex;
     
     // Internal helper methods
     bool openVideoFile(const std::string& filePath);
     bool findStreamInfo();
-    bool openCodecs();
+    bool openCodecs(bool allowPlanar, bool allowDmabuf);
     void closeCodecs();
     void freeBuffers();
+    bool allocPacketQueue(stPacketQueue& queue);
+    void freePacketQueue(stPacketQueue& queue);
+    void pushPacket(stPacketQueue& queue);
+    void popPacket(stPacketQueue& queue);
     void clearPacketQueues();
     bool fillPacketQueues();
+    bool allocPooledFrame(AVFrame* frame, int format, int width, int height);
     bool decodeNextVideoFrame();
     bool decodeNextAudioFrame();
-    void convertFrameToRGBA();
+    void convertFrameToRGBA(uint8_t* destination);
+    bool queuePlanarFrame(AVFrame* destination);
+    bool queueDmabufFrame(AVFrame* destination, bool exportDmabuf);
+    bool openDmabufTestPool();
+    void closeDmabufTestPool();
+    bool queueDmabufTestFrame(AVFrame* destination);
+    static void releaseDmabufTestBuffer(void* opaque, uint8_t* data);
     void convertAudioToFloat();
     float getCurrentPlaybackTimeSec(unsigned long currentTick) const;
     bool seekToFrame(float timeSec);
     
+    // Decode thread helpers
+    void startDecodeThread();
+    void stopDecodeThread();
+    void decodeThreadMain();
+    void requestSeek(float timeSec);
+    void resetDecodeState();
+    unsigned int audioRingFill() const;
+    int readAudioRing(float* buffer, int sampleCount);
+    void discardAudioUntil(unsigned int position);
+    void showRingFrame();
+    
     // FUTURE: Advanced A/V synchronization methods (preserved for potential future use)
     double getVideoClock();
     double getAudioClock();
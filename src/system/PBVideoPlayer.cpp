@@ -13,6 +13,10 @@ PBVideoPlayer::PBVideoPlayer(PBGfx* gfx, PBSound* sound) {
     videoSpriteId = NOSPRITE;
     videoLoaded = false;
     audioEnabled = true;
+    videoBt709 = false;
+    videoFullRange = false;
+    prerolled = false;
+    lastUpdateTick = 0;
     
     // Initialize video system
     m_video.pbvInitialize();
@@ -27,8 +31,9 @@ unsigned int PBVideoPlayer::pbvpLoadVideo(const std::string& videoFilePath, int
     // Unload any existing video
     pbvpUnloadVideo();
     
-    // Load the video file
-    if (!m_video.pbvLoadVideo(videoFilePath)) {
+    // Load the video file - keep it in YUV planes when the GPU can do the colour conversion, and in the
+    // decoder's DMA buffers when the GPU can import them
+    if (!m_video.pbvLoadVideo(videoFilePath, m_gfx->gfxVideoPlanesAvailable(), m_gfx->gfxDmabufImportAvailable())) {
         return NOSPRITE;
     }
     
@@ -54,9 +59,13 @@ unsigned int PBVideoPlayer::pbvpLoadVideo(const std::string& videoFilePath, int
     }
     
     // Create a video sprite with dimensions matching the video
-    // The "filename" for video textures is in the format "widthxheight"
+    // The "filename" for video textures is in the format "widthxheight", plus ":i420" / ":nv12" for planar frames
+    // or ":dmabuf" for imported DMA buffers
     std::ostringstream dimensions;
     dimensions << info.width << "x" << info.height;
+    if (info.frameFormat == PBV_FRAME_I420) dimensions << ":i420";
+    else if (info.frameFormat == PBV_FRAME_NV12) dimensions << ":nv12";
+    else if (info.frameFormat == PBV_FRAME_DMABUF) dimensions << ":dmabuf";
     
     videoSpriteId = m_gfx->gfxLoadSprite(
         "VideoSprite_" + videoFilePath,
@@ -78,6 +87,8 @@ unsigned int PBVideoPlayer::pbvpLoadVideo(const std::string& videoFilePath, int
     
     videoLoaded = true;
     audioEnabled = info.hasAudio;
+    videoBt709 = info.bt709;
+    videoFullRange = info.fullRange;
     
     return videoSpriteId;
 }
@@ -93,16 +104,41 @@ void PBVideoPlayer::pbvpUnloadVideo() {
         
         m_video.pbvUnloadVideo();
         videoLoaded = false;
+        prerolled = false;
     }
 }
 
+bool PBVideoPlayer::pbvpPreroll(bool waitForDecode) {
+    if (!videoLoaded) {
+        return false;
+    }
+    if (prerolled) {
+        return true;
+    }
+    
+    pbvPlaybackState state = m_video.pbvGetPlaybackState();
+    if (state != PBV_STOPPED) {
+        // Rewind; the decode thread seeks and refills in the background
+        pbvpStop();
+    }
+    
+    if (!m_video.pbvPrimeFirstFrame(waitForDecode)) {
+        return false;
+    }
+    
+    uploadCurrentFrame();
+    prerolled = true;
+    return true;
+}
+
 bool PBVideoPlayer::pbvpPlay() {
     if (!videoLoaded) {
         return false;
     }
     
-    // Start the video
+    // Start the video - a pre-rolled video already shows its first frame
     bool success = m_video.pbvPlay();
+    prerolled = false;
     
     // Start audio streaming if we have sound and audio is enabled
     if (success && m_sound && audioEnabled) {
@@ -120,6 +156,7 @@ void PBVideoPlayer::pbvpPause() {
 }
 
 void PBVideoPlayer::pbvpStop() {
+    prerolled = false;
     if (videoLoaded) {
         m_video.pbvStop();
         
@@ -135,6 +172,7 @@ bool PBVideoPlayer::pbvpUpdate(unsigned long currentTick) {
         return false;
     }
     
+    lastUpdateTick = currentTick;
     pbvPlaybackState state = m_video.pbvGetPlaybackState();
     
     // Check if we're still playing
@@ -151,20 +189,60 @@ bool PBVideoPlayer::pbvpUpdate(unsigned long currentTick) {
     }
     
     if (newFrame) {
-        // Get the new frame data
-        unsigned int frameWidth, frameHeight;
+        uploadCurrentFrame();
+        
+        // Note: Audio is now handled automatically via SDL_mixer callback streaming
+        // No need to queue audio per-frame anymore
+    }
+    
+    return true;
+}
+
+// Send the current frame to the video sprite's texture
+void PBVideoPlayer::uploadCurrentFrame() {
+    // Get the new frame data
+    unsigned int frameWidth, frameHeight;
+    const uint8_t* planes[3];
+    int strides[3];
+    stVideoDmabufFrame dmabuf;
+    if (m_video.pbvGetFrameDmabuf(&dmabuf, &frameWidth, &frameHeight)) {
+        // DMA buffer frame - imported as an EGLImage, no pixels pass through the CPU
+        stOglDmabufFrame frame;
+        for (int i = 0; i < OGL_DMABUF_MAX_PLANES; i++) {
+            frame.fd[i] = dmabuf.fd[i];
+            frame.offset[i] = dmabuf.offset[i];
+            frame.pitch[i] = dmabuf.pitch[i];
+        }
+        frame.planeCount = dmabuf.planeCount;
+        frame.fourcc = dmabuf.fourcc;
+        frame.modifier = dmabuf.modifier;
+        frame.width = frameWidth;
+        frame.height = frameHeight;
+        frame.bt709 = videoBt709;
+        frame.fullRange = videoFullRange;
+        
+        if (!m_gfx->gfxUpdateVideoDmabuf(videoSpriteId, frame)) {
+            // The driver cannot import this buffer layout: have the decoder copy frames back to
+            // system memory for the rest of this video (planes are uploaded from the next frame on)
+            m_video.pbvSetDmabufOutput(false);
+            static bool importFailureLogged = false;
+            if (!importFailureLogged) {
+                importFailureLogged = true;
+                PBEngine* engine = static_cast<PBEngine*>(m_gfx);
+                engine->pbeSendConsole("PBVideo: DMA buffer import failed, using texture uploads");
+            }
+        }
+    } else if (m_video.pbvGetFramePlanes(planes, strides, &frameWidth, &frameHeight)) {
+        // Planar frame - the decoder's planes go straight to the texture, the shader converts to RGB
+        m_gfx->gfxUpdateVideoPlanes(videoSpriteId, planes, strides, frameWidth, frameHeight, videoBt709, videoFullRange);
+    } else {
         const uint8_t* frameData = m_video.pbvGetFrameData(&frameWidth, &frameHeight);
         
         if (frameData) {
             // Update the video texture
             m_gfx->gfxUpdateVideoTexture(videoSpriteId, frameData, frameWidth, frameHeight);
         }
-        
-        // Note: Audio is now handled automatically via SDL_mixer callback streaming
-        // No need to queue audio per-frame anymore
     }
-    
-    return true;
 }
 
 bool PBVideoPlayer::pbvpRender() {
@@ -212,6 +290,12 @@ bool PBVideoPlayer::pbvpSeekTo(float timeSec) {
         return false;
     }
     
+    // A pre-rolled video is already stopped at the start - seeking would throw its decoded frames away
+    if (prerolled && timeSec == 0.0f) {
+        return true;
+    }
+    prerolled = false;
+    
     return m_video.pbvSeekTo(timeSec);
 }
 
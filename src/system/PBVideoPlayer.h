@@ -14,6 +14,10 @@
 // Forward declaration
 class PBEngine;
 
+// A registered pre-roll video that has not been updated for this long is treated as hidden: it is rewound
+// and primed again in the background so its next start is instant
+#define PBVP_PREROLL_IDLE_MS 250
+
 // Video player wrapper that combines video, graphics, and sound
 class PBVideoPlayer {
 public:
@@ -27,6 +31,12 @@ public:
     // Unload the video and free all resources
     void pbvpUnloadVideo();
     
+    // Pre-roll: rewind if needed and upload the first frame while stopped, so pbvpPlay() starts with the
+    // first frame already in the sprite and it can be rendered on the same tick.  Without waitForDecode
+    // this never blocks and returns false until the decode thread has the frame - call it again later.
+    bool pbvpPreroll(bool waitForDecode = false);
+    bool pbvpIsPrerolled() const { return prerolled; }
+    
     // Start or resume playback
     bool pbvpPlay();
     
@@ -56,6 +66,8 @@ public:
     pbvPlaybackState pbvpGetPlaybackState() const;
     float pbvpGetCurrentTimeSec() const;
     bool pbvpIsLoaded() const;
+    unsigned long pbvpGetLastUpdateTick() const { return lastUpdateTick; }
+    unsigned long pbvpGetMemoryBytes() const { return m_video.pbvGetMemoryBytes(); }
     
     // Control functions
     bool pbvpSeekTo(float timeSec);
@@ -71,6 +83,8 @@ public:
     void pbvpSetRotation(float degrees);
     
 private:
+    void uploadCurrentFrame();
+    
     PBGfx* m_gfx;
     PBSound* m_sound;
     PBVideo m_video;
@@ -78,6 +92,10 @@ private:
     unsigned int videoSpriteId;
     bool videoLoaded;
     bool audioEnabled;
+    bool videoBt709;        // colour description of planar frames, passed with every upload
+    bool videoFullRange;
+    bool prerolled;         // stopped at the start with the first frame already uploaded
+    unsigned long lastUpdateTick;
 };
 
 #endif // PBVideoPlayer_h
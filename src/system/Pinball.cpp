@@ -1425,6 +1425,47 @@ bool PBProcessIO() {
 
 // End the platform specific code and functions
 
+// Sound bank manifest - every table effect, decoded at boot so the first hit never waits on an MP3 decode.
+// Music is streamed separately and does not belong here.
+static const stSoundBankEntry g_soundBankManifest[] = {
+    { SOUNDCLICK,     PBS_PRIORITY_NORMAL },
+    { SOUNDSWORDCUT,  PBS_PRIORITY_NORMAL },
+    { SOUNDDOORCLOSE, PBS_PRIORITY_HIGH },
+    { SOUNDTORCHES,   PBS_PRIORITY_HIGH },
+};
+
+// Model export manifest - every model the table loads, written as a sibling .pbm by "--export-pbm" so
+// pb3dLoadModel maps the pre-processed file instead of parsing the .glb.  Keep the load options here in
+// step with the pb3dLoadModel calls, since a .pbm is only used by loads with matching settings.
+struct stModelExportEntry {
+    const char* glbFilePath;
+    bool forceStatic;
+    const char* boneListPath;
+    unsigned int lodLevels;
+};
+
+static const stModelExportEntry g_modelExportManifest[] = {
+    { PB3D_MODEL_PATH "d20dice.glb",     false, nullptr, 1 },
+    { PB3D_MODEL_PATH "diceset.glb",     false, nullptr, 1 },
+    { PB3D_MODEL_PATH "crystalwing.glb", false, nullptr, 1 },
+};
+
+// Write a .pbm for every model in the manifest.  Runs after PBInitRender since the export uses the
+// engine's own loader.  Returns the number of models that failed.
+static int PBExportModels() {
+    int count = (int)(sizeof(g_modelExportManifest) / sizeof(g_modelExportManifest[0]));
+    int failed = 0;
+    for (int i = 0; i < count; i++) {
+        const stModelExportEntry& entry = g_modelExportManifest[i];
+        if (!g_PBEngine.pb3dExportModel(entry.glbFilePath, nullptr, entry.forceStatic, entry.boneListPath, entry.lodLevels)) {
+            g_PBEngine.pbeSendConsole("RasPin: ERROR Failed to export " + std::string(entry.glbFilePath));
+            failed++;
+        }
+    }
+    g_PBEngine.pbeSendConsole("RasPin: Exported " + std::to_string(count - failed) + " of " + std::to_string(count) + " models");
+    return (failed);
+}
+
 // Main program start!!   
 int main(int argc, char const *argv[])
 {
@@ -1445,6 +1486,13 @@ int main(int argc, char const *argv[])
 
     g_PBEngine.pbeSendConsole("OpenGL ES: Successful");
 
+    // Asset step: "--export-pbm" writes the table's pre-processed model files and exits
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--export-pbm") == 0) {
+            return (PBExportModels() == 0 ? 0 : 1);
+        }
+    }
+
     temp = "Screen Width: " + std::to_string(g_PBEngine.oglGetScreenWidth()) + " Screen Height: " + std::to_string(g_PBEngine.oglGetScreenHeight());
     g_PBEngine.pbeSendConsole(temp);
 
@@ -1485,6 +1533,12 @@ int main(int argc, char const *argv[])
     g_PBEngine.m_soundSystem.pbsSetMasterVolume(100);
     g_PBEngine.m_soundSystem.pbsSetMusicVolume(g_PBEngine.m_saveFileData.musicVolume * 10);
 
+    // Decode the effects in the background while the menus come up
+    int soundBankCount = (int)(sizeof(g_soundBankManifest) / sizeof(g_soundBankManifest[0]));
+    if (g_PBEngine.m_soundSystem.pbsLoadSoundBank(g_soundBankManifest, soundBankCount)) {
+        g_PBEngine.pbeSendConsole("RasPin: Decoding sound bank (" + std::to_string(soundBankCount) + " effects)");
+    }
+
     g_PBEngine.pbeSendConsole("RasPin: Starting main processing loop");    
    
     // Main loop for the pinball game                                
@@ -1550,6 +1604,12 @@ int main(int argc, char const *argv[])
                 fpsLastTime = currentTick;
             }
 
+            // Upload any textures the async loader has finished decoding, within the per-frame budget
+            g_PBEngine.gfxProcessAsyncLoads(GFX_ASYNC_UPLOAD_BUDGET_MS);
+            
+            // Keep off-screen event videos rewound with their first frame uploaded
+            g_PBEngine.pbeUpdatePrerollVideos(currentTick);
+
             if (!g_PBEngine.m_GameStarted)g_PBEngine.pbeRenderScreen(currentTick, lastTick);
             else g_PBEngine.pbeRenderGameScreen(currentTick, lastTick);
 
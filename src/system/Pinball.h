@@ -85,6 +85,9 @@
 #define SOUNDSWORDCUT "src/user/resources/sound/swordcut.mp3"
 #define SOUNDTORCHES "src/user/resources/sound/torches.mp3"
 
+// Crossfade between the table's music tracks (door theme -> main theme)
+#define MUSIC_CROSSFADE_MS 1500
+
 bool PBInitRender (long width, long height);
 
 // Version display function
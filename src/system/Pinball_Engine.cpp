@@ -6,6 +6,8 @@
 #include "Pinball.h"
 #include "PBSequences.h"
 #include "PBDevice.h"
+#include "PB3DMath.h"
+#include "PBSoundMath.h"
 #include <cmath>
 #include <algorithm>
 #include <fstream>
@@ -73,6 +75,9 @@ unsigned char g_NeoPixelSPIBuffer1[g_NeoPixelSPIBufferSize[1]];
     m_bench3DModelId = 0;
     for (int i = 0; i < 4; i++) m_bench3DDiceInstance[i] = 0;
     m_bench3DDiceLoaded = false;
+    m_benchSkinModelId = 0;
+    for (int i = 0; i < PB_BENCH_SKIN_INSTANCES; i++) m_benchSkinInstance[i] = 0;
+    m_benchSkinLoaded = false;
 
     // Test Sandbox variables
     m_RestartTestSandbox = true;
@@ -177,6 +182,7 @@ unsigned char g_NeoPixelSPIBuffer1[g_NeoPixelSPIBufferSize[1]];
     m_extraBallVideoPlayer = nullptr;
     m_extraBallVideoSpriteId = NOSPRITE;
     m_extraBallVideoLoaded = false;
+    m_prerollVideoBytes = 0;
     
     // Reset state initialization
     m_ResetButtonPressed = false;
@@ -272,6 +278,7 @@ unsigned char g_NeoPixelSPIBuffer1[g_NeoPixelSPIBufferSize[1]];
     
     // Clean up extra ball video player
     if (m_extraBallVideoPlayer) {
+        pbeUnregisterPrerollVideo(m_extraBallVideoPlayer);
         delete m_extraBallVideoPlayer;
         m_extraBallVideoPlayer = nullptr;
     }
@@ -750,24 +757,30 @@ bool PBEngine::pbeRenderStartMenu(unsigned long currentTick, unsigned long lastT
     // Render the default background
     pbeRenderDefaultBackground (currentTick, lastTick);
 
-    int tempX = PB_SCREENWIDTH / 2;
+    // Title, menu and instructions only change with the selection, so they are kept in a retained layer
+    // If self-test failed, disable "Play Pinball" menu item (index 0)
+    unsigned int disabledItemsMask = m_PassSelfTest ? 0x0 : (1 << 0);  // Bit 0 = "Play Pinball"
+    unsigned long layerKey = gfxLayerKey(gfxLayerKey(0, m_CurrentMenuItem), disabledItemsMask);
 
-    gfxSetColor(m_StartMenuFontId, 255 ,165, 0, 255);
-    gfxSetScaleFactor(m_StartMenuFontId, 2.0, false);
-    gfxRenderShadowString(m_StartMenuFontId, MenuTitle, tempX, 15, 2, GFX_TEXTCENTER, 0, 0, 0, 255, 6);
-    gfxSetScaleFactor(m_StartMenuFontId, 1.5, false);
+    if (gfxBeginLayer(PB_LAYER_STARTMENU, layerKey)) {
+        int tempX = PB_SCREENWIDTH / 2;
 
-    gfxSetColor(m_StartMenuFontId, 255 ,255, 255, 255);
+        gfxSetColor(m_StartMenuFontId, 255 ,165, 0, 255);
+        gfxSetScaleFactor(m_StartMenuFontId, 2.0, false);
+        gfxRenderShadowString(m_StartMenuFontId, MenuTitle, tempX, 15, 2, GFX_TEXTCENTER, 0, 0, 0, 255, 6);
+        gfxSetScaleFactor(m_StartMenuFontId, 1.5, false);
 
-    // Render the menu items with shadow depending on the selected item
-    // If self-test failed, disable "Play Pinball" menu item (index 0)
-    unsigned int disabledItemsMask = m_PassSelfTest ? 0x0 : (1 << 0);  // Bit 0 = "Play Pinball"
-    pbeRenderGenericMenu(m_StartMenuSwordId, m_StartMenuFontId, m_CurrentMenuItem, 620, 260, 25, &g_mainMenu, true, true, 64, 0, 255, 255, 8, disabledItemsMask);
+        gfxSetColor(m_StartMenuFontId, 255 ,255, 255, 255);
 
-    // Add insturctions to the bottom of the screen - calculate the x position based on string length
-    gfxSetColor(m_defaultFontSpriteId, 255, 255, 255, 255);
-    gfxRenderShadowString(m_defaultFontSpriteId, "L/R flip = move", PB_SCREENWIDTH - 200, PB_SCREENHEIGHT - 50, 1, GFX_TEXTLEFT, 0,0,0,255,2);
-    gfxRenderShadowString(m_defaultFontSpriteId, "L/R active = select", PB_SCREENWIDTH - 200, PB_SCREENHEIGHT - 25, 1, GFX_TEXTLEFT, 0,0,0,255,2);
+        // Render the menu items with shadow depending on the selected item
+        pbeRenderGenericMenu(m_StartMenuSwordId, m_StartMenuFontId, m_CurrentMenuItem, 620, 260, 25, &g_mainMenu, true, true, 64, 0, 255, 255, 8, disabledItemsMask);
+
+        // Add insturctions to the bottom of the screen - calculate the x position based on string length
+        gfxSetColor(m_defaultFontSpriteId, 255, 255, 255, 255);
+        gfxRenderShadowString(m_defaultFontSpriteId, "L/R flip = move", PB_SCREENWIDTH - 200, PB_SCREENHEIGHT - 50, 1, GFX_TEXTLEFT, 0,0,0,255,2);
+        gfxRenderShadowString(m_defaultFontSpriteId, "L/R active = select", PB_SCREENWIDTH - 200, PB_SCREENHEIGHT - 25, 1, GFX_TEXTLEFT, 0,0,0,255,2);
+    }
+    gfxEndLayer(PB_LAYER_STARTMENU);
 
     return (true);
 }
@@ -1117,6 +1130,35 @@ bool PBEngine::pbeRenderOverlay(unsigned long currentTick, unsigned long lastTic
         gfxRenderShadowString(m_defaultFontSpriteId, stateText, x + 225, y, 0.4, GFX_TEXTLEFT, 0, 0, 0, 255, 1);
     }
 
+    // RENDER STATS Section - texture residency, centered above the I2C scan line
+    stTextureStats texStats = gfxGetTextureStats();
+    std::string texDisplay = "Textures: " + std::to_string(texStats.residentBytes / (1024 * 1024)) + "/" +
+                             std::to_string(texStats.budgetBytes / (1024 * 1024)) + " MB  Resident: " +
+                             std::to_string(texStats.residentCount) + "  Evicted: " + std::to_string(texStats.evictionCount) +
+                             "  Reloaded: " + std::to_string(texStats.reloadCount) +
+                             "  Streaming: " + std::to_string(gfxAsyncLoadsPending()) +
+                             "  Layers: " + std::to_string(texStats.layerCount) + " (" + std::to_string(texStats.layerBytes / (1024 * 1024)) +
+                             " MB, " + std::to_string(texStats.layerRedraws) + " redraws)";
+
+    if (texStats.residentBytes > texStats.budgetBytes) gfxSetColor(m_defaultFontSpriteId, 255, 128, 0, 255);  // Orange when over budget
+    else gfxSetColor(m_defaultFontSpriteId, 0, 255, 255, 255);  // Cyan otherwise
+    gfxRenderShadowString(m_defaultFontSpriteId, texDisplay, (PB_SCREENWIDTH / 2), PB_SCREENHEIGHT - 54, 0.4, GFX_TEXTCENTER, 0, 0, 0, 255, 1);
+
+    // GL call counts from the PBOGLES state cache for the previous frame
+    unsigned int culledInstances, culledPoses;
+    pb3dGetCullStats(culledInstances, culledPoses);
+    std::string glDisplay = "GL calls/frame: " + std::to_string(oglGetGLCallsLastFrame()) +
+                            "  Skipped (cached): " + std::to_string(oglGetGLCallsSkippedLastFrame()) +
+                            "  3D culled: " + std::to_string(culledInstances) + " instances, " +
+                            std::to_string(culledPoses) + " poses  LOD: " +
+                            std::to_string(pb3dGetLodInstances());
+    if (oglGetVideoUploadsLastFrame() > 0) {
+        glDisplay += "  Video upload: " + std::to_string(oglGetVideoUploadMicrosLastFrame()) + " us (" +
+                     std::to_string(oglGetVideoUploadBytesLastFrame() / 1024) + " KB)";
+    }
+    gfxSetColor(m_defaultFontSpriteId, 0, 255, 255, 255);
+    gfxRenderShadowString(m_defaultFontSpriteId, glDisplay, (PB_SCREENWIDTH / 2), PB_SCREENHEIGHT - 78, 0.4, GFX_TEXTCENTER, 0, 0, 0, 255, 1);
+
     // I2C scan result strings - rendered serially on one line, centered as a group at the bottom
     // Each segment may be a different color (yellow = WARNING, white = normal)
     // Only render when scan data is available (strings are populated by pbeScanI2CBus)
@@ -1193,39 +1235,49 @@ bool PBEngine::pbeRenderSettings(unsigned long currentTick, unsigned long lastTi
         return (false); 
     } 
 
-    std::map<unsigned int, std::string> tempMenu = g_settingsMenu;
-
     gfxClear(0.0f, 0.0f, 0.0f, 1.0f, false);
  
     // Render the default background
     pbeRenderDefaultBackground (currentTick, lastTick);
- 
-    gfxSetColor(m_StartMenuFontId, 255 ,165, 0, 255);
-    gfxSetScaleFactor(m_StartMenuFontId, 2.0, false);
-    gfxRenderShadowString(m_StartMenuFontId, MenuSettings, (PB_SCREENWIDTH/2), 15, 2, GFX_TEXTCENTER, 0, 0, 0, 255, 6);
-    gfxSetScaleFactor(m_StartMenuFontId, 1.5, false);
-    gfxSetColor(m_StartMenuFontId, 255 ,255, 255, 255);
 
-    gfxSetScaleFactor(m_StartMenuSwordId, 0.9, false);
-    gfxSetRotateDegrees(m_StartMenuSwordId, 0.0f, false);
+    // Everything above the background depends only on the selection and the setting values - keep it in a retained layer
+    unsigned long layerKey = gfxLayerKey(0, m_CurrentSettingsItem);
+    layerKey = gfxLayerKey(layerKey, m_saveFileData.mainVolume);
+    layerKey = gfxLayerKey(layerKey, m_saveFileData.musicVolume);
+    layerKey = gfxLayerKey(layerKey, m_saveFileData.ballsPerGame);
+    layerKey = gfxLayerKey(layerKey, m_saveFileData.difficulty);
 
-    // Add the extra data to the menu strings before displaying
-    tempMenu[0] += std::to_string(m_saveFileData.mainVolume);
-    tempMenu[1] += std::to_string(m_saveFileData.musicVolume);
-    tempMenu[2] += std::to_string(m_saveFileData.ballsPerGame);
-    switch (m_saveFileData.difficulty) {
-        case PB_EASY: tempMenu[3] += "Easy"; break;
-        case PB_NORMAL: tempMenu[3] += "Normal"; break;
-        case PB_HARD: tempMenu[3] += "Hard"; break;
-        case PB_EPIC: tempMenu[3] += "Epic"; break;
-    }
-    
-    // Render the menu items with shadow depending on the selected item
-    pbeRenderGenericMenu(m_StartMenuSwordId, m_StartMenuFontId, m_CurrentSettingsItem, (PB_SCREENWIDTH/2) - 470, 250, 15, &tempMenu, true, true, 64, 0, 255, 255, 8);
+    if (gfxBeginLayer(PB_LAYER_SETTINGS, layerKey)) {
+        std::map<unsigned int, std::string> tempMenu = g_settingsMenu;
 
-    // Add insturctions how to exit
-    gfxSetColor(m_defaultFontSpriteId, 255, 255, 255, 255);
-    gfxRenderShadowString(m_defaultFontSpriteId, "Start = exit", PB_SCREENWIDTH - 130, PB_SCREENHEIGHT - 25, 1, GFX_TEXTLEFT, 0,0,0,255,2);
+        gfxSetColor(m_StartMenuFontId, 255 ,165, 0, 255);
+        gfxSetScaleFactor(m_StartMenuFontId, 2.0, false);
+        gfxRenderShadowString(m_StartMenuFontId, MenuSettings, (PB_SCREENWIDTH/2), 15, 2, GFX_TEXTCENTER, 0, 0, 0, 255, 6);
+        gfxSetScaleFactor(m_StartMenuFontId, 1.5, false);
+        gfxSetColor(m_StartMenuFontId, 255 ,255, 255, 255);
+
+        gfxSetScaleFactor(m_StartMenuSwordId, 0.9, false);
+        gfxSetRotateDegrees(m_StartMenuSwordId, 0.0f, false);
+
+        // Add the extra data to the menu strings before displaying
+        tempMenu[0] += std::to_string(m_saveFileData.mainVolume);
+        tempMenu[1] += std::to_string(m_saveFileData.musicVolume);
+        tempMenu[2] += std::to_string(m_saveFileData.ballsPerGame);
+        switch (m_saveFileData.difficulty) {
+            case PB_EASY: tempMenu[3] += "Easy"; break;
+            case PB_NORMAL: tempMenu[3] += "Normal"; break;
+            case PB_HARD: tempMenu[3] += "Hard"; break;
+            case PB_EPIC: tempMenu[3] += "Epic"; break;
+        }
+        
+        // Render the menu items with shadow depending on the selected item
+        pbeRenderGenericMenu(m_StartMenuSwordId, m_StartMenuFontId, m_CurrentSettingsItem, (PB_SCREENWIDTH/2) - 470, 250, 15, &tempMenu, true, true, 64, 0, 255, 255, 8);
+
+        // Add insturctions how to exit
+        gfxSetColor(m_defaultFontSpriteId, 255, 255, 255, 255);
+        gfxRenderShadowString(m_defaultFontSpriteId, "Start = exit", PB_SCREENWIDTH - 130, PB_SCREENHEIGHT - 25, 1, GFX_TEXTLEFT, 0,0,0,255,2);
+    }
+    gfxEndLayer(PB_LAYER_SETTINGS);
         
      return (true);
 }
@@ -1438,6 +1490,8 @@ bool PBEngine::pbeLoadTestSandbox(){
     if (!m_sandboxWingLoaded) {
         m_sandboxWingModelId = pb3dLoadModel("src/user/resources/3d/crystalwing.glb");
         if (m_sandboxWingModelId != 0) {
+            // The wing clips only ever loop - play them from baked palettes
+            pb3dBakeAnimClips(m_sandboxWingModelId);
             m_sandboxWingInstance = pb3dCreateInstance(m_sandboxWingModelId);
             // Position: center screen shifted right 25px, up 50px
             pb3dSetInstancePositionPx(m_sandboxWingInstance, 985.0f, 795.0f, 0.0f);
@@ -1857,7 +1911,8 @@ bool PBEngine::pbeRenderHighScores(unsigned long currentTick, unsigned long last
 
     if (m_RestartHighScores) {
         m_RestartHighScores = false;
-        // No per-restart initialization required; resources are loaded via pbeLoadStartMenu()
+        // Scores may have changed since the screen was last shown
+        gfxInvalidateLayer(PB_LAYER_HIGHSCORES);
     }
 
     gfxClear(0.0f, 0.0f, 0.0f, 1.0f, false);
@@ -1865,46 +1920,50 @@ bool PBEngine::pbeRenderHighScores(unsigned long currentTick, unsigned long last
     // Render the default background
     pbeRenderDefaultBackground(currentTick, lastTick);
 
-    int centerX = PB_SCREENWIDTH / 2;
-
-    // Render screen title "High Scores" in orange at the top
-    gfxSetColor(m_StartMenuFontId, 255, 165, 0, 255);
-    gfxSetScaleFactor(m_StartMenuFontId, 1.25, false);
-    gfxRenderShadowString(m_StartMenuFontId, "High Scores", centerX, 15, 2, GFX_TEXTCENTER, 0, 0, 0, 255, 6);
-
-    // Grand Champion section (first high score) - same orange as title
-    gfxSetColor(m_StartMenuFontId, 255, 165, 0, 255);
-    gfxSetScaleFactor(m_StartMenuFontId, 1.0, false);
-    gfxRenderShadowString(m_StartMenuFontId, "Grand Champion", centerX, 145, 10, GFX_TEXTCENTER, 0, 0, 0, 255, 3);
-
-    gfxSetScaleFactor(m_StartMenuFontId, 1.0, false);
-    gfxRenderShadowString(m_StartMenuFontId, m_saveFileData.highScores[0].playerInitials, centerX, 230, 10, GFX_TEXTCENTER, 0, 0, 0, 255, 3);
-
-    gfxSetScaleFactor(m_StartMenuFontId, 1.0, false);
-    std::string gcScoreText = std::to_string(m_saveFileData.highScores[0].highScore) + " (L:" + std::to_string(m_saveFileData.highScores[0].dungeonLevel) + " F:" + std::to_string(m_saveFileData.highScores[0].dungeonFloor) + ")";
-    gfxRenderShadowString(m_StartMenuFontId, gcScoreText, centerX, 315, 10, GFX_TEXTCENTER, 0, 0, 0, 255, 3);
+    // The score table is static while the screen is shown, so it lives in a retained layer
+    if (gfxBeginLayer(PB_LAYER_HIGHSCORES, 0)) {
+        int centerX = PB_SCREENWIDTH / 2;
+
+        // Render screen title "High Scores" in orange at the top
+        gfxSetColor(m_StartMenuFontId, 255, 165, 0, 255);
+        gfxSetScaleFactor(m_StartMenuFontId, 1.25, false);
+        gfxRenderShadowString(m_StartMenuFontId, "High Scores", centerX, 15, 2, GFX_TEXTCENTER, 0, 0, 0, 255, 6);
+
+        // Grand Champion section (first high score) - same orange as title
+        gfxSetColor(m_StartMenuFontId, 255, 165, 0, 255);
+        gfxSetScaleFactor(m_StartMenuFontId, 1.0, false);
+        gfxRenderShadowString(m_StartMenuFontId, "Grand Champion", centerX, 145, 10, GFX_TEXTCENTER, 0, 0, 0, 255, 3);
+
+        gfxSetScaleFactor(m_StartMenuFontId, 1.0, false);
+        gfxRenderShadowString(m_StartMenuFontId, m_saveFileData.highScores[0].playerInitials, centerX, 230, 10, GFX_TEXTCENTER, 0, 0, 0, 255, 3);
+
+        gfxSetScaleFactor(m_StartMenuFontId, 1.0, false);
+        std::string gcScoreText = std::to_string(m_saveFileData.highScores[0].highScore) + " (L:" + std::to_string(m_saveFileData.highScores[0].dungeonLevel) + " F:" + std::to_string(m_saveFileData.highScores[0].dungeonFloor) + ")";
+        gfxRenderShadowString(m_StartMenuFontId, gcScoreText, centerX, 315, 10, GFX_TEXTCENTER, 0, 0, 0, 255, 3);
+
+        // Render remaining high scores (2-10) in white
+        gfxSetScaleFactor(m_StartMenuFontId, 0.75, false);
+        int scoreStartY = 435;
+        int scoreSpacing = 69;
+        for (int i = 1; i < NUM_HIGHSCORES; i++) {
+            std::string rankText = std::to_string(i + 1) + ":";
+            std::string initialsText = m_saveFileData.highScores[i].playerInitials;
+            std::string scoreText = std::to_string(m_saveFileData.highScores[i].highScore) + " (L:" + std::to_string(m_saveFileData.highScores[i].dungeonLevel) + " F:" + std::to_string(m_saveFileData.highScores[i].dungeonFloor) + ")";
+            int yPos = scoreStartY + ((i - 1) * scoreSpacing);
+
+            gfxSetColor(m_StartMenuFontId, 255, 255, 255, 255);
+            gfxRenderShadowString(m_StartMenuFontId, rankText, centerX - 280, yPos, 10, GFX_TEXTRIGHT, 0, 0, 0, 255, 3);
+            gfxRenderShadowString(m_StartMenuFontId, initialsText, centerX - 255, yPos, 10, GFX_TEXTLEFT, 0, 0, 0, 255, 3);
+            gfxRenderShadowString(m_StartMenuFontId, scoreText, centerX + 310, yPos, 3, GFX_TEXTRIGHT, 0, 0, 0, 255, 3);
+        }
 
-    // Render remaining high scores (2-10) in white
-    gfxSetScaleFactor(m_StartMenuFontId, 0.75, false);
-    int scoreStartY = 435;
-    int scoreSpacing = 69;
-    for (int i = 1; i < NUM_HIGHSCORES; i++) {
-        std::string rankText = std::to_string(i + 1) + ":";
-        std::string initialsText = m_saveFileData.highScores[i].playerInitials;
-        std::string scoreText = std::to_string(m_saveFileData.highScores[i].highScore) + " (L:" + std::to_string(m_saveFileData.highScores[i].dungeonLevel) + " F:" + std::to_string(m_saveFileData.highScores[i].dungeonFloor) + ")";
-        int yPos = scoreStartY + ((i - 1) * scoreSpacing);
+        gfxSetScaleFactor(m_StartMenuFontId, 1.0, false);
 
-        gfxSetColor(m_StartMenuFontId, 255, 255, 255, 255);
-        gfxRenderShadowString(m_StartMenuFontId, rankText, centerX - 280, yPos, 10, GFX_TEXTRIGHT, 0, 0, 0, 255, 3);
-        gfxRenderShadowString(m_StartMenuFontId, initialsText, centerX - 255, yPos, 10, GFX_TEXTLEFT, 0, 0, 0, 255, 3);
-        gfxRenderShadowString(m_StartMenuFontId, scoreText, centerX + 310, yPos, 3, GFX_TEXTRIGHT, 0, 0, 0, 255, 3);
+        // Render exit instructions in lower right
+        gfxSetColor(m_defaultFontSpriteId, 255, 255, 255, 255);
+        gfxRenderShadowString(m_defaultFontSpriteId, "Start = exit", PB_SCREENWIDTH - 150, PB_SCREENHEIGHT - 25, 1, GFX_TEXTLEFT, 0, 0, 0, 255, 2);
     }
-
-    gfxSetScaleFactor(m_StartMenuFontId, 1.0, false);
-
-    // Render exit instructions in lower right
-    gfxSetColor(m_defaultFontSpriteId, 255, 255, 255, 255);
-    gfxRenderShadowString(m_defaultFontSpriteId, "Start = exit", PB_SCREENWIDTH - 150, PB_SCREENHEIGHT - 25, 1, GFX_TEXTLEFT, 0, 0, 0, 255, 2);
+    gfxEndLayer(PB_LAYER_HIGHSCORES);
 
     return (true);
 }
@@ -1918,9 +1977,11 @@ bool PBEngine::pbeLoadBenchmark(){
         return (false); 
     }
 
-    // Load 3D diceset model for the 3D rendering benchmark scene
+    // Load 3D diceset model for the 3D rendering benchmark scene.  The model stays resident across
+    // benchmark restarts (and is shared with other screens through the model cache); only the
+    // instances are re-created.
     if (!m_bench3DDiceLoaded) {
-        m_bench3DModelId = pb3dLoadModel("src/user/resources/3d/diceset.glb");
+        if (m_bench3DModelId == 0) m_bench3DModelId = pb3dLoadModel("src/user/resources/3d/diceset.glb");
         if (m_bench3DModelId != 0) {
             // Create 4 instances arranged in a 2x2 grid centred on screen
             const float posX[4] = { PB_SCREENWIDTH * 0.33f, PB_SCREENWIDTH * 0.67f,
@@ -1957,6 +2018,21 @@ bool PBEngine::pbeLoadBenchmark(){
         }
     }
 
+    // Load the crystal wing for the parallel pose benchmark - instances are animated but never drawn
+    if (!m_benchSkinLoaded) {
+        if (m_benchSkinModelId == 0) m_benchSkinModelId = pb3dLoadModel("src/user/resources/3d/crystalwing.glb");
+        if (m_benchSkinModelId != 0 && !pb3dListAnimClips(m_benchSkinModelId).empty()) {
+            for (int i = 0; i < PB_BENCH_SKIN_INSTANCES; i++) {
+                m_benchSkinInstance[i] = pb3dCreateInstance(m_benchSkinModelId);
+                pb3dSetInstanceVisible(m_benchSkinInstance[i], false);
+            }
+            m_benchSkinLoaded = true;
+        } else {
+            if (m_benchSkinModelId) { pb3dUnloadModel(m_benchSkinModelId); m_benchSkinModelId = 0; }
+            pbeSendConsole("WARNING: Failed to load animated crystalwing.glb for pose benchmark");
+        }
+    }
+
     return (true);
 }
 
@@ -1964,6 +2040,15 @@ bool PBEngine::pbeRenderBenchmark(unsigned long currentTick, unsigned long lastT
 
     static unsigned int FPSSwap, smallSpriteCount, spriteTransformCount, bigSpriteCount, bench3DCount;
     static unsigned int msForSwapTest, msForSmallSprite, msForTransformSprite, msForBigSprite, msFor3DRender;
+    static unsigned int bench3DQueuedCount, msFor3DQueued, bench3DCalls, bench3DQueuedCalls;
+    static unsigned int skelForwardCount, skelSeekCount, msForSkelForward, msForSkelSeek;
+    static unsigned int skinSerialCount, skinParallelCount, msForSkinSerial, msForSkinParallel, skinTick;
+    static unsigned int skinBakedCount, msForSkinBaked;
+    static unsigned int mathScalarCount, mathSimdCount, msForMathScalar, msForMathSimd;
+    static float mathMaxError;
+    static unsigned int audioScalarCount, audioSimdCount, msForAudioScalar, msForAudioSimd;
+    static int audioMaxError;
+    static float skelTime;
     unsigned int msRender = 25;
     
     if (!pbeLoadBenchmark()) {
@@ -1977,17 +2062,32 @@ bool PBEngine::pbeRenderBenchmark(unsigned long currentTick, unsigned long lastT
         m_RestartBenchmark = false;
         FPSSwap = 0; smallSpriteCount = 0; spriteTransformCount = 0; bigSpriteCount = 0; bench3DCount = 0;
         msForSwapTest = 0; msForSmallSprite = 0; msForTransformSprite = 0; msForBigSprite = 0; msFor3DRender = 0;
+        bench3DQueuedCount = 0; msFor3DQueued = 0; bench3DCalls = 0; bench3DQueuedCalls = 0;
+        skelForwardCount = 0; skelSeekCount = 0; msForSkelForward = 0; msForSkelSeek = 0; skelTime = 0.0f;
+        skinSerialCount = 0; skinParallelCount = 0; msForSkinSerial = 0; msForSkinParallel = 0; skinTick = 1;
+        skinBakedCount = 0; msForSkinBaked = 0;
+        mathScalarCount = 0; mathSimdCount = 0; msForMathScalar = 0; msForMathSimd = 0; mathMaxError = -1.0f;
+        audioScalarCount = 0; audioSimdCount = 0; msForAudioScalar = 0; msForAudioSimd = 0; audioMaxError = -1;
         m_TicksPerScene = 3000; m_CountDownTicks = 4000;
 
-        // Destroy 3D resources so they are re-created with fresh animations on the next run
+        // Destroy 3D instances so they are re-created with fresh animations on the next run.
+        // The models stay loaded.
         if (m_bench3DDiceLoaded) {
             pb3dAnimateClear(0);
             for (int i = 0; i < 4; i++) {
                 if (m_bench3DDiceInstance[i]) { pb3dDestroyInstance(m_bench3DDiceInstance[i]); m_bench3DDiceInstance[i] = 0; }
             }
-            if (m_bench3DModelId) { pb3dUnloadModel(m_bench3DModelId); m_bench3DModelId = 0; }
             m_bench3DDiceLoaded = false;
         }
+        if (m_benchSkinLoaded) {
+            for (int i = 0; i < PB_BENCH_SKIN_INSTANCES; i++) {
+                if (m_benchSkinInstance[i]) { pb3dDestroyInstance(m_benchSkinInstance[i]); m_benchSkinInstance[i] = 0; }
+            }
+            // The wing may be shared with the sandbox, which bakes it - the serial and parallel
+            // segments measure live evaluation, so start every run unbaked
+            pb3dUnbakeAnimClips(m_benchSkinModelId);
+            m_benchSkinLoaded = false;
+        }
 
         return (true);
     }
@@ -2086,10 +2186,14 @@ bool PBEngine::pbeRenderBenchmark(unsigned long currentTick, unsigned long lastT
     // Each draw call repositions, reorients, and rescales the instance before rendering so the
     // GPU workload is representative (no batching of identical transforms).
     // pb3dBegin/End wraps the whole burst to avoid distorting the count with state-switch overhead.
+    // First half draws each instance immediately, second half submits to the render queue (sorted,
+    // repeated meshes instanced).  GL calls issued by each burst are counted for the results.
     if (elapsedTime < ((m_TicksPerScene * 5) + m_CountDownTicks)) {
         gfxClear(0.0f, 0.0f, 0.0f, 1.0f, false);
 
+        bool queued = elapsedTime >= ((m_TicksPerScene * 4) + (m_TicksPerScene / 2) + m_CountDownTicks);
         if (m_bench3DDiceLoaded) {
+            unsigned int callsStart = oglGetGLCallsThisFrame();
             pb3dBegin();
             while ((GetTickCountGfx() - currentTick) < msRender) {
                 unsigned int idx = bench3DCount % 4;
@@ -2104,18 +2208,185 @@ bool PBEngine::pbeRenderBenchmark(unsigned long currentTick, unsigned long lastT
                 pb3dSetInstancePositionPx(m_bench3DDiceInstance[idx], px, py, pz);
                 pb3dSetInstanceRotation  (m_bench3DDiceInstance[idx], rx, ry, rz);
                 pb3dSetInstanceScale     (m_bench3DDiceInstance[idx], scale);
-                pb3dRenderInstance(m_bench3DDiceInstance[idx]);
-                bench3DCount++;
+                if (queued) {
+                    pb3dSubmitInstance(m_bench3DDiceInstance[idx]);
+                    bench3DQueuedCount++;
+                } else {
+                    pb3dRenderInstance(m_bench3DDiceInstance[idx]);
+                    bench3DCount++;
+                }
             }
             pb3dEnd();
+            if (queued) bench3DQueuedCalls += oglGetGLCallsThisFrame() - callsStart;
+            else bench3DCalls += oglGetGLCallsThisFrame() - callsStart;
         }
 
-        msFor3DRender += GetTickCountGfx() - currentTick;
-        gfxRenderShadowString(m_defaultFontSpriteId, "3D Rendering Test", tempX, 200, 1, GFX_TEXTCENTER, 0, 0, 255, 255, 2);
+        if (queued) msFor3DQueued += GetTickCountGfx() - currentTick;
+        else msFor3DRender += GetTickCountGfx() - currentTick;
+        gfxRenderShadowString(m_defaultFontSpriteId, queued ? "3D Rendering Test (Queued)" : "3D Rendering Test", tempX, 200, 1, GFX_TEXTCENTER, 0, 0, 255, 255, 2);
+        return (true);
+    }
+
+    // Skeletal pose sampling - full PB3D_MAX_BONES skeleton evaluated on the CPU, poses per second.
+    // First half of the scene plays forward at 60 Hz steps (keyframe cursors hit), second half seeks
+    // to a random time every pose (binary search path).
+    if (elapsedTime < ((m_TicksPerScene * 6) + m_CountDownTicks)) {
+        gfxClear(0.0f, 0.0f, 0.0f, 1.0f, false);
+
+        if (m_benchSkeleton.bones.empty()) {
+            pb3dBuildBenchSkeleton(m_benchSkeleton, PB3D_MAX_BONES, 64, 4.0f);
+            m_benchSkelCursors.assign(m_benchSkeleton.clips[0].channels.size(), 0);
+            m_benchSkelMatrices.assign(m_benchSkeleton.bones.size() * 16, 0.0f);
+        }
+
+        const st3DAnimClip& clip = m_benchSkeleton.clips[0];
+        bool forward = elapsedTime < ((m_TicksPerScene * 5) + (m_TicksPerScene / 2) + m_CountDownTicks);
+        while ((GetTickCountGfx() - currentTick) < msRender) {
+            if (forward) {
+                skelTime += 1.0f / 60.0f;
+                if (skelTime > clip.duration) skelTime -= clip.duration;
+                pb3dComputeBoneMatrices(m_benchSkeleton, clip, skelTime, m_benchSkelMatrices.data(), m_benchSkelCursors.data());
+                skelForwardCount++;
+            } else {
+                float seekTime = clip.duration * (float)(rand() % 10000) / 10000.0f;
+                pb3dComputeBoneMatrices(m_benchSkeleton, clip, seekTime, m_benchSkelMatrices.data(), nullptr);
+                skelSeekCount++;
+            }
+        }
+
+        if (forward) msForSkelForward += GetTickCountGfx() - currentTick;
+        else msForSkelSeek += GetTickCountGfx() - currentTick;
+        temp = std::string("Skeletal Pose Test (") + std::to_string(PB3D_MAX_BONES) + " bones, " + (forward ? "forward" : "seek") + ")";
+        gfxRenderShadowString(m_defaultFontSpriteId, temp, tempX, 200, 1, GFX_TEXTCENTER, 0, 0, 255, 255, 2);
+        return (true);
+    }
+
+    // Skinned instance poses - PB_BENCH_SKIN_INSTANCES wings all playing a clip, instance poses per second.
+    // The scene is split in thirds: serial evaluation, the pose worker pool, then the worker pool
+    // playing baked palettes.  Each step advances a synthetic 60 Hz tick so the rate does not depend
+    // on the display refresh.
+    if (elapsedTime < ((m_TicksPerScene * 7) + m_CountDownTicks)) {
+        gfxClear(0.0f, 0.0f, 0.0f, 1.0f, false);
+
+        unsigned long sceneTime = elapsedTime - ((m_TicksPerScene * 6) + m_CountDownTicks);
+        int segment = (int)((sceneTime * 3) / m_TicksPerScene);   // 0 = serial, 1 = parallel, 2 = baked
+        if (m_benchSkinLoaded) {
+            if (!pb3dIsAnimClipPlaying(m_benchSkinInstance[0])) {
+                for (int i = 0; i < PB_BENCH_SKIN_INSTANCES; i++) pb3dPlayAnimClip(m_benchSkinInstance[i], 0, true);
+            }
+            if ((segment == 2) && (skinBakedCount == 0)) pb3dBakeAnimClips(m_benchSkinModelId);
+            pb3dSetParallelPoses(segment != 0);
+            while ((GetTickCountGfx() - currentTick) < msRender) {
+                skinTick += 16;
+                pb3dAnimateInstance(0, skinTick);
+                pb3dWaitSkelPoses();
+                if (segment == 0) skinSerialCount += PB_BENCH_SKIN_INSTANCES;
+                else if (segment == 1) skinParallelCount += PB_BENCH_SKIN_INSTANCES;
+                else skinBakedCount += PB_BENCH_SKIN_INSTANCES;
+            }
+            pb3dSetParallelPoses(true);
+        }
+
+        if (segment == 0) msForSkinSerial += GetTickCountGfx() - currentTick;
+        else if (segment == 1) msForSkinParallel += GetTickCountGfx() - currentTick;
+        else msForSkinBaked += GetTickCountGfx() - currentTick;
+        const char* segmentName[3] = { "serial", "parallel", "baked" };
+        temp = "Skinned Instance Pose Test (" + std::to_string(PB_BENCH_SKIN_INSTANCES) + " wings, " + segmentName[std::min(segment, 2)] + ")";
+        gfxRenderShadowString(m_defaultFontSpriteId, temp, tempX, 200, 1, GFX_TEXTCENTER, 0, 0, 255, 255, 2);
+        return (true);
+    }
+
+    // Math kernels - one PB3D_MAX_BONES chain per step: TRS build, hierarchy concatenation, skinning
+    // multiply and affine inverse.  First half of the scene uses the scalar reference kernels, second
+    // half the SIMD kernels.  Both are run once on the same input to report the largest difference.
+    if (elapsedTime < ((m_TicksPerScene * 8) + m_CountDownTicks)) {
+        static std::vector<float> trs, local, world, skin, inverse, check;
+        static std::vector<int> order, parents;
+        gfxClear(0.0f, 0.0f, 0.0f, 1.0f, false);
+
+        if (mathMaxError < 0.0f) {
+            trs.resize(PB3D_MAX_BONES * 10);
+            local.assign(PB3D_MAX_BONES * 16, 0.0f); world = local; skin = local; inverse = local; check = local;
+            order.resize(PB3D_MAX_BONES); parents.resize(PB3D_MAX_BONES);
+            for (int bi = 0; bi < PB3D_MAX_BONES; bi++) {
+                float* b = &trs[bi * 10];   // T xyz, R xyzw, S xyz
+                float angle = (float)(rand() % 100) / 200.0f;
+                b[0] = 0.0f; b[1] = 0.01f; b[2] = 0.0f;
+                b[3] = 0.0f; b[4] = 0.0f; b[5] = sinf(angle); b[6] = cosf(angle);
+                b[7] = b[8] = b[9] = 1.0f;
+                order[bi] = bi; parents[bi] = bi - 1;
+            }
+            // Accuracy check: identical input through both kernel sets
+            for (int bi = 0; bi < PB3D_MAX_BONES; bi++) pb3dMathMat4FromTRSScalar(&trs[bi*10], &trs[bi*10+3], &trs[bi*10+7], &local[bi*16]);
+            pb3dMathConcatHierarchyScalar(order.data(), parents.data(), PB3D_MAX_BONES, local.data(), check.data());
+            for (int bi = 0; bi < PB3D_MAX_BONES; bi++) pb3dMathMat4FromTRS(&trs[bi*10], &trs[bi*10+3], &trs[bi*10+7], &local[bi*16]);
+            pb3dMathConcatHierarchy(order.data(), parents.data(), PB3D_MAX_BONES, local.data(), world.data());
+            mathMaxError = 0.0f;
+            for (size_t i = 0; i < world.size(); i++) mathMaxError = std::max(mathMaxError, fabsf(world[i] - check[i]));
+        }
+
+        bool simd = elapsedTime >= ((m_TicksPerScene * 7) + (m_TicksPerScene / 2) + m_CountDownTicks);
+        while ((GetTickCountGfx() - currentTick) < msRender) {
+            if (simd) {
+                for (int bi = 0; bi < PB3D_MAX_BONES; bi++) pb3dMathMat4FromTRS(&trs[bi*10], &trs[bi*10+3], &trs[bi*10+7], &local[bi*16]);
+                pb3dMathConcatHierarchy(order.data(), parents.data(), PB3D_MAX_BONES, local.data(), world.data());
+                pb3dMathMat4MulBatch(world.data(), local.data(), skin.data(), PB3D_MAX_BONES);
+                for (int bi = 0; bi < PB3D_MAX_BONES; bi++) pb3dMathMat4InvertAffine(&skin[bi*16], &inverse[bi*16]);
+                mathSimdCount++;
+            } else {
+                for (int bi = 0; bi < PB3D_MAX_BONES; bi++) pb3dMathMat4FromTRSScalar(&trs[bi*10], &trs[bi*10+3], &trs[bi*10+7], &local[bi*16]);
+                pb3dMathConcatHierarchyScalar(order.data(), parents.data(), PB3D_MAX_BONES, local.data(), world.data());
+                for (int bi = 0; bi < PB3D_MAX_BONES; bi++) pb3dMathMat4MulScalar(&world[bi*16], &local[bi*16], &skin[bi*16]);
+                for (int bi = 0; bi < PB3D_MAX_BONES; bi++) pb3dMathMat4InvertAffineScalar(&skin[bi*16], &inverse[bi*16]);
+                mathScalarCount++;
+            }
+        }
+
+        if (simd) msForMathSimd += GetTickCountGfx() - currentTick;
+        else msForMathScalar += GetTickCountGfx() - currentTick;
+        temp = std::string("Math Kernel Test (") + (simd ? PB3D_MATH_ISA : "Scalar") + ")";
+        gfxRenderShadowString(m_defaultFontSpriteId, temp, tempX, 200, 1, GFX_TEXTCENTER, 0, 0, 255, 255, 2);
+        return (true);
+    }
+
+    // Audio kernels - one 4096 frame stereo block (the mixer's buffer size) converted from float to 16-bit
+    // with a gain per step.  First half scalar, second half SIMD, with the largest difference in LSBs.
+    // This is a throughput check; pbmathtest is the correctness check for pbsMathFloatToS16.
+    if (elapsedTime < ((m_TicksPerScene * 9) + m_CountDownTicks)) {
+        static std::vector<float> samples;
+        static std::vector<int16_t> converted, check;
+        gfxClear(0.0f, 0.0f, 0.0f, 1.0f, false);
+
+        if (audioMaxError < 0) {
+            samples.resize(4096 * 2);
+            converted.assign(4096 * 2, 0); check = converted;
+            // Random samples slightly past full scale so the saturation path is exercised too
+            for (size_t i = 0; i < samples.size(); i++) samples[i] = (float)(rand() % 2401 - 1200) / 1000.0f;
+            pbsMathFloatToS16Scalar(samples.data(), check.data(), (int)samples.size(), 0.8f);
+            pbsMathFloatToS16(samples.data(), converted.data(), (int)samples.size(), 0.8f);
+            audioMaxError = 0;
+            for (size_t i = 0; i < converted.size(); i++) audioMaxError = std::max(audioMaxError, abs((int)converted[i] - (int)check[i]));
+        }
+
+        bool simd = elapsedTime >= ((m_TicksPerScene * 8) + (m_TicksPerScene / 2) + m_CountDownTicks);
+        while ((GetTickCountGfx() - currentTick) < msRender) {
+            if (simd) {
+                pbsMathFloatToS16(samples.data(), converted.data(), (int)samples.size(), 0.8f);
+                audioSimdCount++;
+            } else {
+                pbsMathFloatToS16Scalar(samples.data(), converted.data(), (int)samples.size(), 0.8f);
+                audioScalarCount++;
+            }
+        }
+
+        if (simd) msForAudioSimd += GetTickCountGfx() - currentTick;
+        else msForAudioScalar += GetTickCountGfx() - currentTick;
+        temp = std::string("Audio Kernel Test (") + (simd ? PBS_MATH_ISA : "Scalar") + ")";
+        gfxRenderShadowString(m_defaultFontSpriteId, temp, tempX, 200, 1, GFX_TEXTCENTER, 0, 0, 255, 255, 2);
         return (true);
     }
     
-    if (elapsedTime >= ((m_TicksPerScene * 5) + m_CountDownTicks)) {
+    if (elapsedTime >= ((m_TicksPerScene * 9) + m_CountDownTicks)) {
 
         gfxClear(0.0f, 0.0f, 0.0f, 1.0f, false);
         temp = "Benchmark Complete - Results";
@@ -2128,8 +2399,34 @@ bool PBEngine::pbeRenderBenchmark(unsigned long currentTick, unsigned long lastT
         gfxRenderShadowString(m_defaultFontSpriteId, temp, tempX, 265, 1, GFX_TEXTCENTER, 0, 0, 255, 255, 2);
         temp = "Transformed Sprite Rate: " + std::to_string(msForTransformSprite > 0 ? spriteTransformCount / msForTransformSprite : 0) + "k SPS";
         gfxRenderShadowString(m_defaultFontSpriteId, temp, tempX, 290, 1, GFX_TEXTCENTER, 0, 0, 255, 255, 2);
-        temp = "3D Render Rate: " + std::to_string(msFor3DRender > 0 ? bench3DCount / msFor3DRender : 0) + "k OPS";
+        char callsText[48];
+        snprintf(callsText, sizeof(callsText), " (%.1f / %.1f GL calls per object)",
+                 bench3DCount > 0 ? (float)bench3DCalls / (float)bench3DCount : 0.0f,
+                 bench3DQueuedCount > 0 ? (float)bench3DQueuedCalls / (float)bench3DQueuedCount : 0.0f);
+        temp = "3D Render Rate: " + std::to_string(msFor3DRender > 0 ? bench3DCount / msFor3DRender : 0) + "k immediate / " +
+               std::to_string(msFor3DQueued > 0 ? bench3DQueuedCount / msFor3DQueued : 0) + "k queued OPS" + callsText;
         gfxRenderShadowString(m_defaultFontSpriteId, temp, tempX, 315, 1, GFX_TEXTCENTER, 0, 0, 255, 255, 2);
+        temp = "Skeletal Pose Rate: " + std::to_string(msForSkelForward > 0 ? skelForwardCount * 1000 / msForSkelForward : 0) + " fwd / " +
+               std::to_string(msForSkelSeek > 0 ? skelSeekCount * 1000 / msForSkelSeek : 0) + " seek PPS";
+        gfxRenderShadowString(m_defaultFontSpriteId, temp, tempX, 340, 1, GFX_TEXTCENTER, 0, 0, 255, 255, 2);
+        temp = "Skinned Instance Rate: " + std::to_string(msForSkinSerial > 0 ? skinSerialCount * 1000 / msForSkinSerial : 0) + " serial / " +
+               std::to_string(msForSkinParallel > 0 ? skinParallelCount * 1000 / msForSkinParallel : 0) + " parallel / " +
+               std::to_string(msForSkinBaked > 0 ? skinBakedCount * 1000 / msForSkinBaked : 0) + " baked IPS";
+        gfxRenderShadowString(m_defaultFontSpriteId, temp, tempX, 365, 1, GFX_TEXTCENTER, 0, 0, 255, 255, 2);
+        char errorText[32];
+        snprintf(errorText, sizeof(errorText), "%.1e", mathMaxError);
+        temp = "Math Kernel Rate: " + std::to_string(msForMathScalar > 0 ? mathScalarCount * 1000 / msForMathScalar : 0) + " scalar / " +
+               std::to_string(msForMathSimd > 0 ? mathSimdCount * 1000 / msForMathSimd : 0) + " " + PB3D_MATH_ISA + " skeletons/s (max diff " + errorText + ")";
+        gfxRenderShadowString(m_defaultFontSpriteId, temp, tempX, 390, 1, GFX_TEXTCENTER, 0, 0, 255, 255, 2);
+        temp = "Audio Kernel Rate: " + std::to_string(msForAudioScalar > 0 ? audioScalarCount * 1000 / msForAudioScalar : 0) + " scalar / " +
+               std::to_string(msForAudioSimd > 0 ? audioSimdCount * 1000 / msForAudioSimd : 0) + " " + PBS_MATH_ISA + " blocks/s (max diff " +
+               std::to_string(audioMaxError) + " LSB)";
+        gfxRenderShadowString(m_defaultFontSpriteId, temp, tempX, 415, 1, GFX_TEXTCENTER, 0, 0, 255, 255, 2);
+
+        // Leave the wings idle so other screens animating all instances don't pay for them
+        if (m_benchSkinLoaded && pb3dIsAnimClipPlaying(m_benchSkinInstance[0])) {
+            for (int i = 0; i < PB_BENCH_SKIN_INSTANCES; i++) pb3dStopAnimClip(m_benchSkinInstance[i]);
+        }
 
         m_BenchmarkDone = true;
     }
@@ -3454,6 +3751,63 @@ void PBEngine::pbeExecuteDevices() {
     }
 }
 
+//==============================================================================
+// Video Pre-roll Functions
+//==============================================================================
+
+// Register a loaded video for pre-roll.  Returns false if it does not fit in VIDEO_PREROLL_BUDGET_MB,
+// the video then still plays but loads its first frames when started.
+bool PBEngine::pbeRegisterPrerollVideo(PBVideoPlayer* player) {
+    if (player == nullptr || !player->pbvpIsLoaded()) {
+        return false;
+    }
+    for (auto video : m_prerollVideos) {
+        if (video == player) {
+            return true;
+        }
+    }
+    
+    // Measured again each time - a video's buffers can grow after loading (e.g. conversion buffers)
+    m_prerollVideoBytes = 0;
+    for (auto video : m_prerollVideos) {
+        m_prerollVideoBytes += video->pbvpGetMemoryBytes();
+    }
+    unsigned long videoBytes = player->pbvpGetMemoryBytes();
+    if (m_prerollVideoBytes + videoBytes > (unsigned long)VIDEO_PREROLL_BUDGET_MB * 1024 * 1024) {
+        pbeSendConsole("Video pre-roll budget exceeded, video will load on demand");
+        return false;
+    }
+    
+    m_prerollVideos.push_back(player);
+    m_prerollVideoBytes += videoBytes;
+    player->pbvpPreroll();
+    return true;
+}
+
+// Must be called before a registered player is unloaded or deleted
+void PBEngine::pbeUnregisterPrerollVideo(PBVideoPlayer* player) {
+    for (auto it = m_prerollVideos.begin(); it != m_prerollVideos.end(); ++it) {
+        if (*it == player) {
+            m_prerollVideos.erase(it);
+            break;
+        }
+    }
+    m_prerollVideoBytes = 0;
+    for (auto video : m_prerollVideos) {
+        m_prerollVideoBytes += video->pbvpGetMemoryBytes();
+    }
+}
+
+// Called once per rendered frame.  Videos that have not been updated recently are off screen: rewind
+// them and upload their first frame again so the next start is instant.  Never blocks on the decoder.
+void PBEngine::pbeUpdatePrerollVideos(unsigned long currentTick) {
+    for (auto video : m_prerollVideos) {
+        if (!video->pbvpIsPrerolled() && (currentTick - video->pbvpGetLastUpdateTick()) > PBVP_PREROLL_IDLE_MS) {
+            video->pbvpPreroll();
+        }
+    }
+}
+
 //==============================================================================
 // Timer Functions
 //==============================================================================
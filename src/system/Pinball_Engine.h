@@ -210,6 +210,14 @@ struct stTimerEntry {
 // Console rendering start Y position (below title bar)
 #define CONSOLE_START_Y 42
 
+// Retained layer IDs for mostly static screens (content is cached off-screen, see gfxBeginLayer)
+#define PB_LAYER_STARTMENU  1
+#define PB_LAYER_SETTINGS   2
+#define PB_LAYER_HIGHSCORES 3
+
+// Number of skinned model instances animated by the parallel pose benchmark
+#define PB_BENCH_SKIN_INSTANCES 16
+
 struct stLEDSequenceInfo {
     bool sequenceEnabled;
     bool firstTime;
@@ -372,6 +380,11 @@ public:
     void pbeClearDevices();
     void pbeExecuteDevices();
     
+    // Video pre-roll functions - registered videos are rewound and primed whenever they are not on screen
+    bool pbeRegisterPrerollVideo(PBVideoPlayer* player);
+    void pbeUnregisterPrerollVideo(PBVideoPlayer* player);
+    void pbeUpdatePrerollVideos(unsigned long currentTick);
+    
     // Timer functions
     bool pbeSetTimer(unsigned int timerId, unsigned int timerValueMS, bool repeat = false);
     bool pbeSetWatchdogTimer(unsigned int timerValueMS);
@@ -482,6 +495,14 @@ public:
     unsigned int m_bench3DModelId;
     unsigned int m_bench3DDiceInstance[4];
     bool m_bench3DDiceLoaded;
+    // Skeletal pose sampling benchmark (synthetic PB3D_MAX_BONES chain, no GPU work)
+    st3DSkeleton m_benchSkeleton;
+    std::vector<unsigned int> m_benchSkelCursors;
+    std::vector<float> m_benchSkelMatrices;
+    // Parallel pose benchmark (PB_BENCH_SKIN_INSTANCES animated crystal wings, not drawn)
+    unsigned int m_benchSkinModelId;
+    unsigned int m_benchSkinInstance[PB_BENCH_SKIN_INSTANCES];
+    bool m_benchSkinLoaded;
 
     // Test Sandbox screen variables
     bool m_RestartTestSandbox;
@@ -795,6 +816,7 @@ private:
     bool pbeLoadInitScreen(); // Load the init screen for the pinball game
     bool pbeLoadGameStart(); // Load the start screen for the pinball game
     bool pbeLoadMainScreen(); // Load the main screen for the pinball game
+    bool pbeLoadExtraBallVideo(); // Load and pre-roll the extra ball video
     bool pbeLoadReset(); // Load the reset screen
     bool pbeLoadGameEnd(); // Load the game end screen
     bool pbeLoadPlayerEnd(); // Load the player end screen
@@ -863,6 +885,10 @@ private:
     // Device management - vector of all registered devices
     std::vector<PBDevice*> m_devices;
     
+    // Pre-rolled videos (not owned) and the memory they hold against VIDEO_PREROLL_BUDGET_MB
+    std::vector<PBVideoPlayer*> m_prerollVideos;
+    unsigned long m_prerollVideoBytes;
+    
     // ========================================================================
     // MODE SYSTEM PRIVATE MEMBERS
     // ========================================================================
@@ -204,6 +204,7 @@ void PBEngine::pbeTableReload() {
     
     // Clean up extra ball video player
     if (m_extraBallVideoPlayer) {
+        pbeUnregisterPrerollVideo(m_extraBallVideoPlayer);
         m_extraBallVideoPlayer->pbvpStop();
         m_extraBallVideoPlayer->pbvpUnloadVideo();
         delete m_extraBallVideoPlayer;
@@ -105,4 +105,26 @@
 // BUG / CONFIG ISSUE:  This doesn't seem to work for Raspberry Pi, where it's really needed. Might work later w/ OS updates.
 #define ENABLE_HW_VIDEO_DECODE 0
 
+// Zero-copy display of hardware decoded frames (Linux only).  When the decoder outputs DMA buffers
+// (DRM PRIME) they are wrapped in EGLImages and sampled directly instead of being copied back to
+// the CPU and uploaded.  Needs EGL_EXT_image_dma_buf_import and GL_OES_EGL_image_external, which
+// are checked at startup; frames the driver cannot import fall back to the upload path.
+#define ENABLE_VIDEO_DMABUF_IMPORT 1
+
+// Test mode for the zero-copy path on Linux machines without a V4L2 decoder: software decoded
+// frames are copied into udmabuf DMA buffers (needs /dev/udmabuf) and imported the same way.
+// This adds a copy per frame, so only enable it to exercise the import path.
+#define ENABLE_VIDEO_DMABUF_TEST 0
+
+// Texture sets per video texture for frame uploads.  Each frame goes through a pixel buffer object into
+// the next set while the GPU may still be drawing the previous one, so the upload never waits on a
+// texture in use.  2 = double, 3 = triple buffered, 1 = upload in place with glTexSubImage2D as before.
+// Every extra set costs one more frame of texture memory.
+#define VIDEO_UPLOAD_BUFFERS 3
+
+// System memory budget for pre-rolled event videos (PBEngine::pbeRegisterPrerollVideo).  A pre-rolled
+// video stays loaded with its first frames decoded and uploaded, so it starts on the next render tick.
+// Each one costs roughly its decoded frame ring plus audio buffers (about 8 MB for a 720p clip).
+#define VIDEO_PREROLL_BUDGET_MB 32
+
 #endif
\ No newline at end of file
@@ -250,26 +250,28 @@ bool PBEngine::pbeLoadInTower() {
     // InTower reuses the main screen background resources; ensure they are loaded
     if (!pbeLoadMainScreen()) return (false);
 
-    m_TowerClimbId = gfxLoadSprite("TowerClimb", "src/user/resources/textures/towerclimb.png", GFX_PNG, GFX_NOMAP, GFX_CENTER, true, true);
+    // InTower is entered mid-game, so its textures stream in on the async loader rather than
+    // stalling the frame; the sprites simply don't draw until their upload completes.
+    m_TowerClimbId = gfxLoadSpriteAsync("TowerClimb", "src/user/resources/textures/towerclimb.png", GFX_PNG, GFX_NOMAP, GFX_CENTER, true, true);
     gfxSetColor(m_TowerClimbId, 80, 80, 160, 255);
 
     // Load dungeon door grid sprites
-    m_DoorOpenId = gfxLoadSprite("DoorOpen", "src/user/resources/textures/dooropen.png", GFX_PNG, GFX_NOMAP, GFX_CENTER, true, true);
+    m_DoorOpenId = gfxLoadSpriteAsync("DoorOpen", "src/user/resources/textures/dooropen.png", GFX_PNG, GFX_NOMAP, GFX_CENTER, true, true);
     gfxSetColor(m_DoorOpenId, 255, 255, 255, 255);
 
-    m_DoorClosedId = gfxLoadSprite("DoorClosed", "src/user/resources/textures/doorclosed.png", GFX_PNG, GFX_NOMAP, GFX_CENTER, true, true);
+    m_DoorClosedId = gfxLoadSpriteAsync("DoorClosed", "src/user/resources/textures/doorclosed.png", GFX_PNG, GFX_NOMAP, GFX_CENTER, true, true);
     gfxSetColor(m_DoorClosedId, 255, 255, 255, 255);
 
-    m_DoorBlockedId = gfxLoadSprite("DoorBlocked", "src/user/resources/textures/doorblocked.png", GFX_PNG, GFX_NOMAP, GFX_CENTER, true, true);
+    m_DoorBlockedId = gfxLoadSpriteAsync("DoorBlocked", "src/user/resources/textures/doorblocked.png", GFX_PNG, GFX_NOMAP, GFX_CENTER, true, true);
     gfxSetColor(m_DoorBlockedId, 255, 255, 255, 255);
 
-    m_DoorWall1Id = gfxLoadSprite("DoorWall1", "src/user/resources/textures/doorwall1.png", GFX_PNG, GFX_NOMAP, GFX_CENTER, true, true);
+    m_DoorWall1Id = gfxLoadSpriteAsync("DoorWall1", "src/user/resources/textures/doorwall1.png", GFX_PNG, GFX_NOMAP, GFX_CENTER, true, true);
     gfxSetColor(m_DoorWall1Id, 255, 255, 255, 255);
 
-    m_DoorWall2Id = gfxLoadSprite("DoorWall2", "src/user/resources/textures/doorwall2.png", GFX_PNG, GFX_NOMAP, GFX_CENTER, true, true);
+    m_DoorWall2Id = gfxLoadSpriteAsync("DoorWall2", "src/user/resources/textures/doorwall2.png", GFX_PNG, GFX_NOMAP, GFX_CENTER, true, true);
     gfxSetColor(m_DoorWall2Id, 255, 255, 255, 255);
 
-    m_DoorStairsId = gfxLoadSprite("DoorStairs", "src/user/resources/textures/doorstairs.png", GFX_PNG, GFX_NOMAP, GFX_CENTER, true, true);
+    m_DoorStairsId = gfxLoadSpriteAsync("DoorStairs", "src/user/resources/textures/doorstairs.png", GFX_PNG, GFX_NOMAP, GFX_CENTER, true, true);
     gfxSetColor(m_DoorStairsId, 255, 255, 255, 255);
 
     if (m_DoorOpenId == NOSPRITE || m_DoorClosedId == NOSPRITE || m_DoorBlockedId == NOSPRITE ||
@@ -95,8 +95,11 @@ bool PBEngine::pbeLoadMainScreen(){
     m_PBTBLFireSmall4Id = gfxLoadSprite("FireSmall4", "src/user/resources/textures/firesmall4.png", GFX_PNG, GFX_NOMAP, GFX_UPPERLEFT, true, true);
     gfxSetColor(m_PBTBLFireSmall4Id, 255, 200, 100, 255);
 
-    // Start the main screen music
-    m_soundSystem.pbsPlayMusic(SOUNDMAINTHEME);
+    // Load the extra ball video now so it is pre-rolled before the first award
+    pbeLoadExtraBallVideo();
+
+    // Start the main screen music, crossfading from the door theme
+    m_soundSystem.pbsPlayMusic(SOUNDMAINTHEME, MUSIC_CROSSFADE_MS);
 
     m_mainScreenLoaded = true;
     return (true);
@@ -196,49 +199,61 @@ bool PBEngine::pbeRenderMainScreenKeyObtained(unsigned long currentTick, unsigne
     return (true);
 }
 
+// Loads the extra ball video, centered on the score text, and registers it for pre-roll so the
+// award screen starts on its first frame without waiting for the file and decoder to open
+bool PBEngine::pbeLoadExtraBallVideo(){
+    if (m_extraBallVideoLoaded) return (true);
+    
+    if (!m_extraBallVideoPlayer) {
+        m_extraBallVideoPlayer = new PBVideoPlayer(this, &m_soundSystem);
+    }
+    
+    // Load the extra ball video (initial position, will be centered after loading)
+    m_extraBallVideoSpriteId = m_extraBallVideoPlayer->pbvpLoadVideo(
+        "src/user/resources/videos/extraball.mp4",
+        0, 0,
+        false  // Don't keep resident
+    );
+    
+    if (m_extraBallVideoSpriteId == NOSPRITE) {
+        pbeSendConsole("ERROR: Failed to load extra ball video");
+        return (false);
+    }
+    
+    // Set scale to 95%
+    m_extraBallVideoPlayer->pbvpSetScaleFactor(0.95f);
+    m_extraBallVideoPlayer->pbvpSetVolume(0);  // Set volume to 0 for silent playback
+    
+    // Get video dimensions to calculate centered position
+    stVideoInfo videoInfo = m_extraBallVideoPlayer->pbvpGetVideoInfo();
+    int scaledWidth = (int)(videoInfo.width * 0.95f);
+    int scaledHeight = (int)(videoInfo.height * 0.95f);
+    
+    // Center in active display area (1024x768), aligned with score text center
+    // Score text is centered at ACTIVEDISPX + (1024/3) = ACTIVEDISPX + 341
+    int centerX = ACTIVEDISPX + (1024 / 3);  // Same X as score text
+    int centerY = ACTIVEDISPY + 350;  // Same Y as score text
+    
+    // Calculate upper-left position for centered video, offset 4 pixels left
+    int videoX = centerX - (scaledWidth / 2) - 4;
+    int videoY = centerY - (scaledHeight / 2) + 1;
+    
+    m_extraBallVideoPlayer->pbvpSetXY(videoX, videoY);
+    pbeRegisterPrerollVideo(m_extraBallVideoPlayer);
+    m_extraBallVideoLoaded = true;
+    return (true);
+}
+
 // Renders the extra ball award screen with video
 bool PBEngine::pbeRenderMainScreenExtraBall(unsigned long currentTick, unsigned long lastTick){
     static unsigned long lastScreenStartTick = 0;
     
-    // Load and setup video player if not already done
+    // Normally loaded with the main screen; reload if the table was reset since
     if (!m_extraBallVideoLoaded) {
         // Reset screen tracking when reloading video
         lastScreenStartTick = 0;
         
-        if (!m_extraBallVideoPlayer) {
-            m_extraBallVideoPlayer = new PBVideoPlayer(this, &m_soundSystem);
-        }
-        
-        // Load the extra ball video (initial position, will be centered after loading)
-        m_extraBallVideoSpriteId = m_extraBallVideoPlayer->pbvpLoadVideo(
-            "src/user/resources/videos/extraball.mp4",
-            0, 0,
-            false  // Don't keep resident
-        );
-        
-        if (m_extraBallVideoSpriteId != NOSPRITE) {
-            // Set scale to 95%
-            m_extraBallVideoPlayer->pbvpSetScaleFactor(0.95f);
-            
-            // Get video dimensions to calculate centered position
-            stVideoInfo videoInfo = m_extraBallVideoPlayer->pbvpGetVideoInfo();
-            int scaledWidth = (int)(videoInfo.width * 0.95f);
-            int scaledHeight = (int)(videoInfo.height * 0.95f);
-            
-            // Center in active display area (1024x768), aligned with score text center
-            // Score text is centered at ACTIVEDISPX + (1024/3) = ACTIVEDISPX + 341
-            int centerX = ACTIVEDISPX + (1024 / 3);  // Same X as score text
-            int centerY = ACTIVEDISPY + 350;  // Same Y as score text
-            
-            // Calculate upper-left position for centered video, offset 4 pixels left
-            int videoX = centerX - (scaledWidth / 2) - 4;
-            int videoY = centerY - (scaledHeight / 2) + 1;
-            
-            m_extraBallVideoPlayer->pbvpSetXY(videoX, videoY);
-            m_extraBallVideoLoaded = true;
-        } else {
-            m_extraBallVideoLoaded = false;
-            pbeSendConsole("ERROR: Failed to load extra ball video");
+        if (!pbeLoadExtraBallVideo()) {
             return (false);
         }
     }
@@ -249,23 +264,24 @@ bool PBEngine::pbeRenderMainScreenExtraBall(unsigned long currentTick, unsigned
         
         // Check if this is a new screen activation
         if (lastScreenStartTick != m_currentScreenStartTick) {
-            // Screen was just queued - restart video from beginning
+            // Screen was just queued - restart video from beginning.  A pre-rolled video already has
+            // frame 0 uploaded; otherwise skip rendering this frame to avoid showing a stale frame
+            shouldRender = m_extraBallVideoPlayer->pbvpIsPrerolled();
             m_extraBallVideoPlayer->pbvpSeekTo(0.0f);
             m_extraBallVideoPlayer->pbvpSetVolume(0);  // Set volume to 0 for silent playback
             m_extraBallVideoPlayer->pbvpPlay();
             m_extraBallVideoPlayer->pbvpUpdate(currentTick);  // Update to load frame 0
             lastScreenStartTick = m_currentScreenStartTick;
-            shouldRender = false;  // Skip rendering this frame to avoid showing stale frame
         } else {
             // Normal playback - check if we need to loop
             pbvPlaybackState videoState = m_extraBallVideoPlayer->pbvpGetPlaybackState();
             
             if (videoState == PBV_FINISHED) {
-                // Video finished - restart from beginning
-                m_extraBallVideoPlayer->pbvpSeekTo(0.0f);
+                // Video finished - rewind and restart.  Preroll without waiting on the decoder so the
+                // render loop never blocks; if frame 0 isn't decoded yet, skip rendering this frame
+                shouldRender = m_extraBallVideoPlayer->pbvpPreroll();
                 m_extraBallVideoPlayer->pbvpPlay();
-                m_extraBallVideoPlayer->pbvpUpdate(currentTick);  // Load frame 0
-                shouldRender = false;  // Skip rendering to avoid showing stale last frame
+                m_extraBallVideoPlayer->pbvpUpdate(currentTick);
             } else {
                 // Normal playback
                 m_extraBallVideoPlayer->pbvpUpdate(currentTick);
@@ -651,6 +667,9 @@ bool PBEngine::pbeRenderStatus(unsigned long currentTick, unsigned long lastTick
         const int chestCenterX = treasureX + (int)(256 * 0.42f / 2.0f) + 10;
         const int coinStartY   = treasureY - 10;
 
+        // All coins share one texture, so they are drawn as a single instanced batch
+        unsigned int coinIds[4];
+        unsigned int coinCount = 0;
         for (int i = 0; i < 4; i++) {
             if (!m_coinDropActive[i]) continue;
             float elapsed = (float)(currentTick - m_coinDropStartTick[i]);
@@ -662,8 +681,12 @@ bool PBEngine::pbeRenderStatus(unsigned long currentTick, unsigned long lastTick
             int   coinX    = chestCenterX + m_coinDropXOffset[i];
             int   coinY    = coinStartY + (int)(t * COIN_DROP_DIST);
             float rotation = t * 360.0f;
-            gfxRenderSprite(m_PBTBLDragonCoinSmallInstId[i], coinX, coinY, COIN_SCALE, rotation);
+            gfxSetXY(m_PBTBLDragonCoinSmallInstId[i], coinX, coinY, false);
+            gfxSetScaleFactor(m_PBTBLDragonCoinSmallInstId[i], COIN_SCALE, false);
+            gfxSetRotateDegrees(m_PBTBLDragonCoinSmallInstId[i], rotation, false);
+            coinIds[coinCount++] = m_PBTBLDragonCoinSmallInstId[i];
         }
+        if (coinCount > 0) gfxRenderSpriteBatch(coinIds, coinCount);
     }
 
     // Sword ramp fire animation: cycle firesmall1-4, alpha ramps 50%→75% over 800ms (drawn under sword)
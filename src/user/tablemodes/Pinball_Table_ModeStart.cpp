@@ -124,9 +124,10 @@ bool PBEngine::pbeRenderGameStart(unsigned long currentTick, unsigned long lastT
         m_tableSubScreenState = static_cast<int>(PBTBLStartScreenState::START_START);
         lastScreenState = static_cast<PBTBLStartScreenState>(m_tableSubScreenState);
 
-        // Play torch sound loop and door theme music
+        // Play torch sound loop and door theme music, and buffer the main theme so it is ready to fade in
         torchId = m_soundSystem.pbsPlayEffect(SOUNDTORCHES, true);
-        m_soundSystem.pbsPlayMusic(SOUNDDOORTHEME);
+        m_soundSystem.pbsPlayMusic(SOUNDDOORTHEME, MUSIC_CROSSFADE_MS);
+        m_soundSystem.pbsPrebufferMusic(SOUNDMAINTHEME);
     }
 
     if (!pbeLoadGameStart()) {